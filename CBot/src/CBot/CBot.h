@@ -25,7 +25,10 @@
 
 #include "CBot/CBotFileUtils.h"
 #include "CBot/CBotClass.h"
+#include "CBot/CBotContext.h"
+#include "CBot/CBotInstanceHeap.h"
 #include "CBot/CBotToken.h"
+#include "CBot/CBotProfiler.h"
 #include "CBot/CBotProgram.h"
 #include "CBot/CBotTypResult.h"
 
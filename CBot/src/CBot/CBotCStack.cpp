@@ -21,6 +21,7 @@
 #include "CBot/CBotCStack.h"
 
 #include "CBot/CBotClass.h"
+#include "CBot/CBotContext.h"
 #include "CBot/CBotToken.h"
 #include "CBot/CBotExternalCall.h"
 
@@ -35,6 +36,8 @@ struct CBotCStack::Data
 {
     //! The program currently being compiled
     CBotProgram*  prog   = nullptr;
+    //! User pointer of the program, see SetUserPtr()
+    void*         user   = nullptr;
     //! The current error state of the compile stack
     CBotError     error  = CBotNoErr;
     int           errEnd = 0;
@@ -258,6 +261,18 @@ CBotProgram* CBotCStack::GetProgram()
     return m_data->prog;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void CBotCStack::SetUserPtr(void* user)
+{
+    m_data->user = user;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* CBotCStack::GetUserPtr()
+{
+    return m_data->user;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void CBotCStack::SetRetType(CBotTypResult& type)
 {
@@ -406,7 +421,7 @@ bool CBotCStack::CheckCall(CBotToken* &pToken, CBotDefParam* pParam, const std::
         }
     }
 
-    for (CBotFunction* pp : CBotFunction::m_publicFunctions)
+    for (CBotFunction* pp : CBotContext::GetCurrent()->m_publicFunctions)
     {
         if ( name == pp->GetName() )
         {
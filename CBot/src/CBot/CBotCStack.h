@@ -251,6 +251,20 @@ public:
      */
     CBotProgram* GetProgram();
 
+    /*!
+     * \brief Set user pointer passed to the compile functions of external calls
+     *
+     * Compilation calls only - see CBotStack::SetUserPtr() for execution calls
+     *
+     * \param user User pointer to set
+     */
+    void SetUserPtr(void* user);
+
+    /*!
+     * \brief Get user pointer set with SetUserPtr()
+     */
+    void* GetUserPtr();
+
     /*!
      * \brief CompileCall
      * \param p
@@ -34,6 +34,7 @@
 #include "CBot/CBotExternalCall.h"
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
+#include "CBot/CBotContext.h"
 #include "CBot/CBotDefParam.h"
 #include "CBot/CBotUtils.h"
 
@@ -42,9 +43,6 @@
 namespace CBot
 {
 
-////////////////////////////////////////////////////////////////////////////////
-std::set<CBotClass*> CBotClass::m_publicClasses{};
-
 ////////////////////////////////////////////////////////////////////////////////
 CBotClass::CBotClass(const std::string& name,
                      CBotClass* parent,
@@ -59,13 +57,14 @@ CBotClass::CBotClass(const std::string& name,
     m_bIntrinsic= bIntrinsic;
     m_nbVar     = m_parent == nullptr ? 0 : m_parent->m_nbVar;
 
-    m_publicClasses.insert(this);
+    m_context   = CBotContext::GetCurrent();
+    m_context->m_classes.insert(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 CBotClass::~CBotClass()
 {
-    m_publicClasses.erase(this);
+    m_context->m_classes.erase(this);
 
     delete  m_pVar;
     delete  m_externalMethods;
@@ -82,9 +81,10 @@ CBotClass* CBotClass::Create(const std::string& name,
 ////////////////////////////////////////////////////////////////////////////////
 void CBotClass::ClearPublic()
 {
-    while ( !m_publicClasses.empty() )
+    std::set<CBotClass*>& classes = CBotContext::GetCurrent()->m_classes;
+    while ( !classes.empty() )
     {
-        auto it = m_publicClasses.begin();
+        auto it = classes.begin();
         delete *it; // calling destructor removes the class from the list
     }
 }
@@ -138,7 +138,7 @@ void CBotClass::Unlock()
 ////////////////////////////////////////////////////////////////////////////////
 void CBotClass::FreeLock(CBotProgram* prog)
 {
-    for (CBotClass* pClass : m_publicClasses)
+    for (CBotClass* pClass : CBotContext::GetCurrent()->m_classes)
     {
         if (pClass->m_lockProg.size() > 0 && prog == pClass->m_lockProg[0])
         {
@@ -276,7 +276,7 @@ CBotClass* CBotClass::Find(CBotToken* &pToken)
 ////////////////////////////////////////////////////////////////////////////////
 CBotClass* CBotClass::Find(const std::string& name)
 {
-    for (CBotClass* p : m_publicClasses)
+    for (CBotClass* p : CBotContext::GetCurrent()->m_classes)
     {
         if ( p->GetName() == name ) return p;
     }
@@ -368,7 +368,7 @@ bool CBotClass::SaveStaticState(std::ostream &ostr)
     if (!WriteLong(ostr, CBOTVERSION*2)) return false;
 
     // saves the state of static variables in classes
-    for (CBotClass* p : m_publicClasses)
+    for (CBotClass* p : CBotContext::GetCurrent()->m_classes)
     {
         if (!WriteWord(ostr, 1)) return false;
         // save the name of the class
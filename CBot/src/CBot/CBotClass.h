@@ -32,6 +32,7 @@ namespace CBot
 {
 
 class CBotCallMethode;
+class CBotContext;
 class CBotFunction;
 class CBotProgram;
 class CBotStack;
@@ -124,7 +125,7 @@ public:
     ~CBotClass( );
 
     /*!
-     * \brief Create
+     * \brief Create a class in the current context, see CBotContext
      * \param name
      * \param parent
      * \param intrinsic
@@ -381,9 +382,8 @@ public:
     void Update(CBotVar* var, void* user);
 
 private:
-    //! List of all public classes
-    static std::set<CBotClass*> m_publicClasses;
-
+    //! Context containing this class
+    CBotContext* m_context;
 
     //! true if this class is fully compiled, false if only precompiled
     bool m_IsDef;
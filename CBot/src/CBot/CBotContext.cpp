@@ -0,0 +1,123 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotContext.h"
+
+#include "CBot/CBotExternalCall.h"
+#include "CBot/CBotInstanceHeap.h"
+#include "CBot/CBotProgram.h"
+
+#include "CBot/stdlib/stdlib_public.h"
+
+#include <new>
+
+namespace CBot
+{
+
+namespace
+{
+
+thread_local CBotContext* g_currentContext = nullptr;
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+CBotContext::CBotContext()
+{
+    m_heap.reset(new CBotInstanceHeap(this));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotContext::~CBotContext()
+{
+    {
+        Scope scope(this);
+        CBotProgram::Free();
+        m_heap.reset();
+    }
+
+    while (m_freeBlocks != nullptr)
+    {
+        void* block = m_freeBlocks;
+        m_freeBlocks = *static_cast<void**>(block);
+        ::operator delete(block);
+    }
+    m_freeCount = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotContext::Init()
+{
+    Scope scope(this);
+    CBotProgram::Init();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotInstanceHeap* CBotContext::GetHeap()
+{
+    return m_heap.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotContext::AddFile(std::unique_ptr<CBotFile> file)
+{
+    int handle = m_nextFileId++;
+    m_files[handle] = std::move(file);
+    return handle;
+}
+
+CBotFile* CBotContext::GetFile(int handle)
+{
+    const auto it = m_files.find(handle);
+    if (it == m_files.end()) return nullptr;
+    return it->second.get();
+}
+
+void CBotContext::CloseFile(int handle)
+{
+    m_files.erase(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotContext* CBotContext::GetDefault()
+{
+    // never destroyed, instances may outlive the static objects
+    static CBotContext* context = new CBotContext();
+    return context;
+}
+
+CBotContext* CBotContext::GetCurrent()
+{
+    if (g_currentContext == nullptr) return GetDefault();
+    return g_currentContext;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotContext::Scope::Scope(CBotContext* context)
+{
+    m_previous = g_currentContext;
+    g_currentContext = context;
+}
+
+CBotContext::Scope::~Scope()
+{
+    g_currentContext = m_previous;
+}
+
+} // namespace CBot
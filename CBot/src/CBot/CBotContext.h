@@ -0,0 +1,162 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace CBot
+{
+
+class CBotClass;
+class CBotExternalCallList;
+class CBotFile;
+class CBotFunction;
+class CBotInstanceHeap;
+
+/**
+ * \brief Independent set of classes, functions and constants of the CBot engine
+ *
+ * A context holds everything that programs share: the constants defined with
+ * CBotProgram::DefineNum(), the functions added with CBotProgram::AddFunction(), the classes
+ * (CBotClass::Create() and the public classes of the programs), the public functions and the
+ * class instances (see CBotInstanceHeap). Programs of different contexts don't see each other
+ * and can run at the same time on different threads. The programs of one context must be used
+ * by one thread at a time.
+ *
+ * The default context is used by the static functions of the engine and by the programs
+ * created without a context; CBotProgram::Init() and CBotProgram::Free() initialize and
+ * destroy it. Other contexts are used as follows:
+ *
+ * \code
+ * CBotContext context;
+ * context.Init();
+ * {
+ *     CBotContext::Scope scope(&context);
+ *     CBotProgram::AddFunction("message", rMessage, cMessage);
+ * }
+ *
+ * CBotProgram* program = new CBotProgram(&context, nullptr);
+ * program->Compile(code, externFunctions, nullptr);
+ * // ...
+ * delete program; // before the context
+ * \endcode
+ *
+ * The methods of CBotProgram make the context of the program current on the calling thread,
+ * see Scope. Code manipulating variables of a context outside of these methods (for example
+ * CBotVar::Create() or CBotVar::Destroy() on the "this" variable of a program) must make the
+ * context current itself.
+ */
+class CBotContext
+{
+public:
+    /**
+     * \brief Creates an empty context, call Init() before using it
+     */
+    CBotContext();
+    /**
+     * \brief Destroys the classes and the functions of the context
+     *
+     * The programs of the context must be destroyed before.
+     */
+    ~CBotContext();
+
+    CBotContext(const CBotContext&) = delete;
+    CBotContext& operator=(const CBotContext&) = delete;
+
+    /**
+     * \brief Adds the standard library to the context
+     * \see CBotProgram::Init()
+     */
+    void Init();
+
+    /**
+     * \brief Returns the heap of the instances created outside of the programs of this context
+     */
+    CBotInstanceHeap* GetHeap();
+
+    /**
+     * \brief Adds a file opened by the "file" class of the standard library
+     * \return Handle of the file, valid in this context only
+     */
+    int AddFile(std::unique_ptr<CBotFile> file);
+    //! Returns the file with the given handle, nullptr if it isn't opened in this context
+    CBotFile* GetFile(int handle);
+    //! Closes the file with the given handle
+    void CloseFile(int handle);
+
+    //! Context of the static functions and the programs created without a context
+    static CBotContext* GetDefault();
+    //! Context of the calling thread, the default context if none was set with Scope
+    static CBotContext* GetCurrent();
+
+    /**
+     * \brief Makes a context current on the calling thread for the lifetime of this object
+     */
+    class Scope
+    {
+    public:
+        Scope(CBotContext* context);
+        ~Scope();
+
+    private:
+        CBotContext* m_previous;
+    };
+
+private:
+    friend class CBotClass;
+    friend class CBotCStack;
+    friend class CBotFunction;
+    friend class CBotInstanceHeap;
+    friend class CBotProgram;
+    friend class CBotToken;
+    friend class CBotVar;
+
+    //! Constants, see CBotToken::DefineNum()
+    std::map<std::string, long> m_defineNum;
+    //! Functions, see CBotProgram::AddFunction()
+    std::unique_ptr<CBotExternalCallList> m_externalCalls;
+    //! All the classes
+    std::set<CBotClass*> m_classes;
+    //! Public functions of the programs
+    std::set<CBotFunction*> m_publicFunctions;
+    //! Last unique identifier, see CBotVar::NextUniqNum()
+    long m_identcpt = 0;
+
+    //! Heaps of the context, linked together, see CBotInstanceHeap::Find()
+    CBotInstanceHeap* m_firstHeap = nullptr;
+    //! Heap of the instances created outside of the programs
+    std::unique_ptr<CBotInstanceHeap> m_heap;
+    //! Memory of destroyed instances, see CBotInstanceHeap
+    void* m_freeBlocks = nullptr;
+    long m_freeCount = 0;
+    //! Set while CBotProgram::CompileBatch() compiles on several threads, the free blocks aren't used then
+    bool m_parallel = false;
+
+    //! Files opened by the programs, see AddFile()
+    std::unordered_map<int, std::unique_ptr<CBotFile>> m_files;
+    //! Handle of the next opened file
+    int m_nextFileId = 1;
+};
+
+} // namespace CBot
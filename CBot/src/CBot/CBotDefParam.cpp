@@ -19,6 +19,7 @@
 
 #include "CBot/CBotDefParam.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotInstrUtils.h"
 #include "CBot/CBotInstr/CBotParExpr.h"
 
@@ -26,6 +27,7 @@
 #include "CBot/CBotCStack.h"
 
 #include "CBot/CBotVar/CBotVarClass.h"
+#include "CBot/CBotVar/CBotVarString.h"
 
 #include <cassert>
 
@@ -125,6 +127,20 @@ CBotDefParam* CBotDefParam::Compile(CBotToken* &p, CBotCStack* pStack)
     return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void CBotDefParam::AddVars(CBotCStack* pStack)
+{
+    for (CBotDefParam* p = this; p != nullptr; p = p->m_next)
+    {
+        CBotTypResult type = p->m_type;
+        if ( type.Eq(CBotTypArrayPointer) ) type.SetType(CBotTypArrayBody);
+        CBotVar*    var = CBotVar::Create(p->m_token.GetString(), type);
+        var->SetInit(CBotVar::InitType::IS_POINTER);
+        var->SetUniqNum(p->m_nIdent);
+        pStack->AddVar(var);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotDefParam::Execute(CBotVar** ppVars, CBotStack* &pj)
 {
@@ -199,7 +215,7 @@ bool CBotDefParam::Execute(CBotVar** ppVars, CBotStack* &pj)
                 newvar->SetInit(pVar->GetInit()); // copy nan
                 break;
             case CBotTypString:
-                newvar->SetValString(pVar->GetValString());
+                static_cast<CBotVarString*>(newvar)->SetValue(CBotVarString::FromVar(pVar));
                 break;
             case CBotTypBoolean:
                 newvar->SetValInt(pVar->GetValInt());
@@ -264,6 +280,16 @@ void CBotDefParam::RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotDefParam::CompileBytecode(CBotBytecodeBuilder& builder)
+{
+    for (CBotDefParam* p = this; p != nullptr; p = p->m_next)
+    {
+        if (builder.AddVariable(p->m_nIdent, p->m_type, p->m_token.GetString(), true) < 0) return false;
+    }
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int CBotDefParam::GetType()
 {
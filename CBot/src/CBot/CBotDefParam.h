@@ -26,6 +26,7 @@
 namespace CBot
 {
 
+class CBotBytecodeBuilder;
 class CBotCStack;
 class CBotStack;
 class CBotVar;
@@ -55,6 +56,12 @@ public:
      */
     static CBotDefParam* Compile(CBotToken* &p, CBotCStack* pStack);
 
+    /*!
+     * \brief Adds the parameters as variables to a compile stack, as Compile() does
+     * \param pStack
+     */
+    void AddVars(CBotCStack* pStack);
+
     /*!
      * \brief Execute
      * \param ppVars
@@ -76,6 +83,13 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain);
 
+    /*!
+     * \brief Declares the parameters as variables of a function translated to bytecode
+     * \param builder
+     * \return false if a parameter has a type not supported by the bytecode
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder);
+
     /*!
      * \brief GetType
      * \return
@@ -274,6 +274,7 @@ enum CBotError : int
     CBotErrNotOpen       = 6013, //!< channel not open
     CBotErrRead          = 6014, //!< error while reading
     CBotErrWrite         = 6015, //!< writing error
+    CBotErrOutOfMemory   = 6016, //!< too many instances, see CBotInstanceHeap::SetLimit()
 
     CBotErrMAX, //!< Max errors
 };
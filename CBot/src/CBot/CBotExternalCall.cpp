@@ -22,6 +22,7 @@
 #include "CBot/CBotToken.h"
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
+#include "CBot/CBotProfiler.h"
 #include "CBot/CBotUtils.h"
 
 #include "CBot/CBotVar/CBotVar.h"
@@ -36,19 +37,22 @@ void CBotExternalCallList::Clear()
 
 bool CBotExternalCallList::AddFunction(const std::string& name, std::unique_ptr<CBotExternalCall> call)
 {
+    call->m_name = name;
     m_list[name] = std::move(call);
     return true;
 }
 
 CBotTypResult CBotExternalCallList::CompileCall(CBotToken*& p, CBotVar* thisVar, CBotVar** ppVar, CBotCStack* pStack)
 {
-    if (m_list.count(p->GetString()) == 0)
+    // only lookups, the list is shared by the threads of CBotProgram::CompileBatch()
+    auto it = m_list.find(p->GetString());
+    if (it == m_list.end())
         return -1;
 
-    CBotExternalCall* pt = m_list[p->GetString()].get();
+    CBotExternalCall* pt = it->second.get();
 
     std::unique_ptr<CBotVar> args = std::unique_ptr<CBotVar>(MakeListVars(ppVar));
-    CBotTypResult r = pt->Compile(thisVar, args.get(), m_user);
+    CBotTypResult r = pt->Compile(thisVar, args.get(), pStack->GetUserPtr());
 
     // if a class is returned, it is actually a pointer
     if (r.GetType() == CBotTypClass) r.SetType(CBotTypPointer);
@@ -61,11 +65,6 @@ CBotTypResult CBotExternalCallList::CompileCall(CBotToken*& p, CBotVar* thisVar,
     return r;
 }
 
-void CBotExternalCallList::SetUserPtr(void* pUser)
-{
-    m_user = pUser;
-}
-
 bool CBotExternalCallList::CheckCall(const std::string& name)
 {
     return m_list.count(name) > 0;
@@ -129,6 +128,11 @@ CBotExternalCall::~CBotExternalCall()
 {
 }
 
+const std::string& CBotExternalCall::GetName()
+{
+    return m_name;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 CBotExternalCallDefault::CBotExternalCallDefault(RuntimeFunc rExec, CompileFunc rCompile)
@@ -157,8 +161,13 @@ bool CBotExternalCallDefault::Run(CBotVar* thisVar, CBotStack* pStack)
     CBotVar* result = pile2->GetVar();
 
     int exception = CBotNoErr; // TODO: Change to CBotError
+    CBotProfiler* profiler = pStack->GetProfiler();
+    auto start = profiler != nullptr ? CBotProfiler::Clock::now() : CBotProfiler::Clock::time_point();
+
     bool res = m_rExec(args, result, exception, pStack->GetUserPtr());
 
+    if (profiler != nullptr) profiler->AddExternalCall(GetName(), pStack, start, res);
+
     if (!res)
     {
         if (exception != CBotNoErr)
@@ -200,8 +209,13 @@ bool CBotExternalCallClass::Run(CBotVar* thisVar, CBotStack* pStack)
     CBotVar* result = pile2->GetVar();
 
     int exception = CBotNoErr; // TODO: Change to CBotError
+    CBotProfiler* profiler = pStack->GetProfiler();
+    auto start = profiler != nullptr ? CBotProfiler::Clock::now() : CBotProfiler::Clock::time_point();
+
     bool res = m_rExec(thisVar, args, result, exception, pStack->GetUserPtr());
 
+    if (profiler != nullptr) profiler->AddExternalCall(GetName(), pStack, start, res);
+
     if (!res)
     {
         if (exception != CBotNoErr)
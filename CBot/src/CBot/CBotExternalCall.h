@@ -73,6 +73,16 @@ public:
      * \return false to request program interruption, true otherwise
      */
     virtual bool Run(CBotVar* thisVar, CBotStack* pStack) = 0;
+
+    /**
+     * \brief Name under which the function was added, see CBotExternalCallList::AddFunction()
+     */
+    const std::string& GetName();
+
+private:
+    friend class CBotExternalCallList;
+
+    std::string m_name;
 };
 
 /**
@@ -155,7 +165,8 @@ public:
     /**
      * \brief Find and call compile function
      *
-     * This function sets an error in compilation stack in case of failure
+     * This function sets an error in compilation stack in case of failure.
+     * The compile function gets the user pointer of the stack, see CBotCStack::SetUserPtr().
      *
      * \param p Token representing the function name
      * \param thisVar "this" variable for class calls, nullptr for normal calls
@@ -197,15 +208,6 @@ public:
      */
     bool RestoreCall(CBotToken* token, CBotVar* thisVar, CBotVar** ppVar, CBotStack* pStack);
 
-    /**
-     * \brief Set user pointer to pass to compile functions
-     *
-     * This is for compile functions only, runtime functions use CBotStack::GetUserPtr()
-     *
-     * \param pUser User pointer
-     */
-    void SetUserPtr(void* pUser);
-
     /**
      * \brief Reset the list of registered functions
      */
@@ -213,7 +215,6 @@ public:
 
 private:
     std::map<std::string, std::unique_ptr<CBotExternalCall>> m_list{};
-    void* m_user = nullptr;
 };
 
 } // namespace CBot
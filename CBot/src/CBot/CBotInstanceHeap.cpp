@@ -0,0 +1,342 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotInstanceHeap.h"
+
+#include "CBot/CBotContext.h"
+
+#include "CBot/CBotVar/CBotVarClass.h"
+
+#include <algorithm>
+#include <new>
+
+namespace CBot
+{
+
+namespace
+{
+
+//! Number of instances before the first automatic collection
+const long MIN_COLLECT_COUNT = 1024;
+//! Maximum number of blocks kept in the free list of a context
+const long MAX_FREE_BLOCKS = 1024;
+
+thread_local CBotInstanceHeap* g_currentHeap = nullptr;
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+CBotInstanceHeap::CBotInstanceHeap(CBotContext* context)
+{
+    m_context = context != nullptr ? context : CBotContext::GetCurrent();
+    m_collectAt = MIN_COLLECT_COUNT;
+
+    m_nextHeap = m_context->m_firstHeap;
+    if (m_nextHeap != nullptr) m_nextHeap->m_prevHeap = this;
+    m_context->m_firstHeap = this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotInstanceHeap::~CBotInstanceHeap()
+{
+    if (g_currentHeap == this) g_currentHeap = nullptr;
+
+    if (m_prevHeap != nullptr) m_prevHeap->m_nextHeap = m_nextHeap;
+    else m_context->m_firstHeap = m_nextHeap;
+    if (m_nextHeap != nullptr) m_nextHeap->m_prevHeap = m_prevHeap;
+
+    // the remaining instances may still be referenced by other programs or by the application
+    CBotInstanceHeap* heap = m_context->GetHeap();
+    if (heap == this) heap = nullptr;
+    while (m_first != nullptr)
+    {
+        CBotVarClass* instance = m_first;
+        m_first = instance->m_heapNext;
+
+        instance->m_heap = heap;
+        instance->m_heapPrev = nullptr;
+        instance->m_heapNext = nullptr;
+        if (heap == nullptr) continue;
+
+        instance->m_heapNext = heap->m_first;
+        if (heap->m_first != nullptr) heap->m_first->m_heapPrev = instance;
+        heap->m_first = instance;
+        heap->m_count++;
+    }
+    if (heap != nullptr) heap->m_peak = std::max(heap->m_peak, heap->m_count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long CBotInstanceHeap::GetCount()
+{
+    return m_count;
+}
+
+long CBotInstanceHeap::GetPeakCount()
+{
+    return m_peak;
+}
+
+long CBotInstanceHeap::GetCreatedCount()
+{
+    return m_created;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t CBotInstanceHeap::GetMemoryUsed()
+{
+    std::size_t size = 0;
+    for (CBotVarClass* instance = m_first; instance != nullptr; instance = instance->m_heapNext)
+    {
+        size += sizeof(CBotVarClass);
+        for (CBotVar* var = instance->m_pVar; var != nullptr; var = var->GetNext())
+        {
+            size += sizeof(CBotVar);
+        }
+    }
+    return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotInstanceHeap::SetLimit(long limit)
+{
+    m_limit = std::max(limit, 0L);
+}
+
+long CBotInstanceHeap::GetLimit()
+{
+    return m_limit;
+}
+
+bool CBotInstanceHeap::IsFull()
+{
+    return m_limit > 0 && m_count >= m_limit;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotInstanceHeap::Collect(bool always)
+{
+    if (!always && m_count < m_collectAt) return 0;
+
+    // counts the references coming from the instances of this heap,
+    // an instance referenced from elsewhere is a root
+    std::vector<CBotVarClass*> references;
+    for (CBotVarClass* instance = m_first; instance != nullptr; instance = instance->m_heapNext)
+    {
+        instance->m_gcRefs = instance->m_CptUse;
+    }
+    for (CBotVarClass* instance = m_first; instance != nullptr; instance = instance->m_heapNext)
+    {
+        references.clear();
+        GetReferences(instance->m_pVar, references);
+        for (CBotVarClass* target : references)
+        {
+            if (target->m_heap == this) target->m_gcRefs--;
+        }
+    }
+
+    // marks everything reachable from the roots, an instance without any reference is being
+    // created or is held directly by a variable, it is a root too
+    std::vector<CBotVarClass*> pending;
+    for (CBotVarClass* instance = m_first; instance != nullptr; instance = instance->m_heapNext)
+    {
+        if (instance->m_gcRefs > 0 || instance->m_CptUse == 0)
+        {
+            instance->m_gcRefs = -1;
+            pending.push_back(instance);
+        }
+    }
+    while (!pending.empty())
+    {
+        CBotVarClass* instance = pending.back();
+        pending.pop_back();
+
+        references.clear();
+        GetReferences(instance->m_pVar, references);
+        for (CBotVarClass* target : references)
+        {
+            if (target->m_heap != this || target->m_gcRefs == -1) continue;
+            target->m_gcRefs = -1;
+            pending.push_back(target);
+        }
+    }
+
+    std::vector<CBotVarClass*> garbage;
+    for (CBotVarClass* instance = m_first; instance != nullptr; instance = instance->m_heapNext)
+    {
+        if (instance->m_gcRefs != -1) garbage.push_back(instance);
+    }
+
+    // holds the garbage while breaking the cycles, then releases it
+    for (CBotVarClass* instance : garbage) instance->IncrementUse();
+    for (CBotVarClass* instance : garbage) ClearReferences(instance->m_pVar);
+    for (CBotVarClass* instance : garbage) instance->DecrementUse();
+
+    m_collectAt = std::max(MIN_COLLECT_COUNT, 2 * m_count);
+    return static_cast<int>(garbage.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotInstanceHeap::GetReferences(CBotVar* var, std::vector<CBotVarClass*>& references)
+{
+    for (; var != nullptr; var = var->GetNext())
+    {
+        switch (var->GetType())
+        {
+        case CBotTypPointer:
+        case CBotTypNullPointer:
+        case CBotTypArrayPointer:
+            {
+                CBotVarClass* target = var->GetPointer();
+                if (target != nullptr) references.push_back(target);
+                break;
+            }
+        case CBotTypClass:
+            // an intrinsic object is part of the instance containing it
+            GetReferences(static_cast<CBotVarClass*>(var)->m_pVar, references);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotInstanceHeap::ClearReferences(CBotVar* var)
+{
+    for (; var != nullptr; var = var->GetNext())
+    {
+        switch (var->GetType())
+        {
+        case CBotTypPointer:
+        case CBotTypNullPointer:
+        case CBotTypArrayPointer:
+            if (var->GetPointer() != nullptr) var->SetPointer(nullptr);
+            break;
+        case CBotTypClass:
+            ClearReferences(static_cast<CBotVarClass*>(var)->m_pVar);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotVarClass* CBotInstanceHeap::Find(long ident)
+{
+    for (CBotInstanceHeap* heap = CBotContext::GetCurrent()->m_firstHeap; heap != nullptr; heap = heap->m_nextHeap)
+    {
+        for (CBotVarClass* instance = heap->m_first; instance != nullptr; instance = instance->m_heapNext)
+        {
+            if (instance->m_ItemIdent == ident) return instance;
+        }
+    }
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotInstanceHeap* CBotInstanceHeap::GetDefault()
+{
+    return CBotContext::GetCurrent()->GetHeap();
+}
+
+CBotInstanceHeap* CBotInstanceHeap::GetCurrent()
+{
+    if (g_currentHeap == nullptr) return GetDefault();
+    return g_currentHeap;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotInstanceHeap::Scope::Scope(CBotInstanceHeap* heap)
+{
+    m_previous = g_currentHeap;
+    g_currentHeap = heap;
+}
+
+CBotInstanceHeap::Scope::~Scope()
+{
+    g_currentHeap = m_previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotInstanceHeap::Register(CBotVarClass* instance)
+{
+    CBotInstanceHeap* heap = GetCurrent();
+
+    instance->m_heap = heap;
+    instance->m_heapPrev = nullptr;
+    instance->m_heapNext = heap->m_first;
+    if (heap->m_first != nullptr) heap->m_first->m_heapPrev = instance;
+    heap->m_first = instance;
+
+    heap->m_count++;
+    heap->m_created++;
+    if (heap->m_count > heap->m_peak) heap->m_peak = heap->m_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotInstanceHeap::Unregister(CBotVarClass* instance)
+{
+    CBotInstanceHeap* heap = instance->m_heap;
+    if (heap == nullptr) return;
+
+    if (instance->m_heapPrev != nullptr) instance->m_heapPrev->m_heapNext = instance->m_heapNext;
+    else heap->m_first = instance->m_heapNext;
+    if (instance->m_heapNext != nullptr) instance->m_heapNext->m_heapPrev = instance->m_heapPrev;
+
+    instance->m_heap = nullptr;
+    instance->m_heapPrev = nullptr;
+    instance->m_heapNext = nullptr;
+    heap->m_count--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* CBotInstanceHeap::Allocate(std::size_t size)
+{
+    CBotContext* context = CBotContext::GetCurrent();
+    if (size == sizeof(CBotVarClass) && context->m_freeBlocks != nullptr && !context->m_parallel)
+    {
+        // the first bytes of a free block point to the next one
+        void* block = context->m_freeBlocks;
+        context->m_freeBlocks = *static_cast<void**>(block);
+        context->m_freeCount--;
+        return block;
+    }
+    return ::operator new(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotInstanceHeap::Release(void* block, std::size_t size)
+{
+    if (block == nullptr) return;
+
+    CBotContext* context = CBotContext::GetCurrent();
+    if (size != sizeof(CBotVarClass) || context->m_freeCount >= MAX_FREE_BLOCKS || context->m_parallel)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    *static_cast<void**>(block) = context->m_freeBlocks;
+    context->m_freeBlocks = block;
+    context->m_freeCount++;
+}
+
+} // namespace CBot
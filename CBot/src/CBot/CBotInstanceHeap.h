@@ -0,0 +1,159 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace CBot
+{
+
+class CBotContext;
+class CBotVar;
+class CBotVarClass;
+
+/**
+ * \brief Heap of the class instances and arrays created by a program
+ *
+ * Each CBotProgram has its own heap, see CBotProgram::GetHeap(). The instances created while
+ * a program runs or is restored belong to its heap; the other instances (static members,
+ * instances created by the host application) belong to the default heap of the context, see
+ * CBotContext::GetHeap(). An instance stays in its heap until it is destroyed; the instances
+ * left when a heap is destroyed move to the default heap of its context.
+ *
+ * The instances of a heap are linked together, which makes registering and unregistering
+ * an instance O(1). Their memory comes from a free list kept by the current context.
+ *
+ * Instances are destroyed by reference counting (see CBotVarClass::IncrementUse()). Cycles of
+ * instances which are no longer reachable from anywhere else are found by Collect().
+ */
+class CBotInstanceHeap
+{
+public:
+    /**
+     * \brief Constructor
+     * \param context Context of the heap, nullptr for the current context
+     */
+    CBotInstanceHeap(CBotContext* context = nullptr);
+    ~CBotInstanceHeap();
+
+    CBotInstanceHeap(const CBotInstanceHeap&) = delete;
+    CBotInstanceHeap& operator=(const CBotInstanceHeap&) = delete;
+
+    //! \name Accounting
+    //@{
+
+    //! Number of live instances, including unreachable cycles not collected yet
+    long GetCount();
+    //! Highest number of live instances
+    long GetPeakCount();
+    //! Number of instances created since the heap was created
+    long GetCreatedCount();
+
+    /**
+     * \brief Estimates the memory used by the instances and their members, in bytes
+     *
+     * Walks all the instances, so it is meant for statistics, not to be called on each allocation.
+     */
+    std::size_t GetMemoryUsed();
+
+    /**
+     * \brief Limits the number of live instances
+     *
+     * When the limit is reached, "new" fails with ::CBotErrOutOfMemory.
+     * \param limit Maximum number of instances, 0 for no limit (the default)
+     */
+    void SetLimit(long limit);
+    long GetLimit();
+    //! Checks if the limit set with SetLimit() is reached
+    bool IsFull();
+
+    //@}
+
+    /**
+     * \brief Destroys the cycles of instances which can't be reached any more
+     *
+     * An instance is reachable if it is referenced from outside of the instances of this heap
+     * (a variable on a stack, a static member, an instance of another heap...) or from
+     * a reachable instance. The pointers held by the unreachable instances are set to null
+     * before the instances are released, so their destructors see null members.
+     *
+     * \param always false to collect only when the number of instances doubled since the previous collection
+     * \return Number of destroyed instances
+     */
+    int Collect(bool always = true);
+
+    /**
+     * \brief Finds a live instance by its unique identifier, in all the heaps of the current context
+     * \see CBotVarClass::Find()
+     */
+    static CBotVarClass* Find(long ident);
+
+    //! Heap of the instances created outside of a running program, in the current context
+    static CBotInstanceHeap* GetDefault();
+    //! Heap receiving the new instances on the calling thread
+    static CBotInstanceHeap* GetCurrent();
+
+    /**
+     * \brief Makes a heap current on the calling thread for the lifetime of this object
+     */
+    class Scope
+    {
+    public:
+        Scope(CBotInstanceHeap* heap);
+        ~Scope();
+
+    private:
+        CBotInstanceHeap* m_previous;
+    };
+
+private:
+    friend class CBotVarClass;
+
+    //! Adds a new instance to the current heap
+    static void Register(CBotVarClass* instance);
+    //! Removes an instance from its heap
+    static void Unregister(CBotVarClass* instance);
+
+    //! Memory for a new instance, from the free list of the current context
+    static void* Allocate(std::size_t size);
+    //! Returns the memory of a destroyed instance to the free list of the current context
+    static void Release(void* block, std::size_t size);
+
+    //! Adds the instances referenced by the variables to the list, see Collect()
+    static void GetReferences(CBotVar* var, std::vector<CBotVarClass*>& references);
+    //! Sets to null all the pointers held by the variables
+    static void ClearReferences(CBotVar* var);
+
+    CBotContext* m_context;
+    CBotVarClass* m_first = nullptr;
+    long m_count = 0;
+    long m_peak = 0;
+    long m_created = 0;
+    long m_limit = 0;
+    //! Number of instances triggering the next automatic collection
+    long m_collectAt = 0;
+
+    //! Heaps of the context for Find(), linked together
+    CBotInstanceHeap* m_prevHeap = nullptr;
+    CBotInstanceHeap* m_nextHeap = nullptr;
+};
+
+} // namespace CBot
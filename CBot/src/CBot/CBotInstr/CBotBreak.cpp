@@ -19,6 +19,8 @@
 
 #include "CBot/CBotInstr/CBotBreak.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
+
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
 
@@ -92,6 +94,18 @@ void CBotBreak :: RestoreState(CBotStack* &pj, bool bMain)
     if ( bMain ) pj->RestoreStack(this);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBreak::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    if (!m_label.empty()) return false;
+
+    int label = builder.GetLoopLabel(m_token.GetType() == ID_CONTINUE);
+    if (label < 0) return false;
+
+    builder.EmitJump(CBotOpcode::Jump, label);
+    return true;
+}
+
 std::string CBotBreak::GetDebugData()
 {
     return !m_label.empty() ? "m_label = "+m_label : "";
@@ -56,6 +56,14 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotBreak"; }
     virtual std::string GetDebugData() override;
@@ -0,0 +1,891 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotInstr/CBotBytecode.h"
+
+#include "CBot/CBotDefParam.h"
+#include "CBot/CBotStack.h"
+
+#include "CBot/CBotVar/CBotVar.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+namespace CBot
+{
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBytecodeBuilder::CBotBytecodeBuilder()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBytecodeBuilder::~CBotBytecodeBuilder()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::AddVariable(long ident, const CBotTypResult& type, const std::string& name, bool parameter, bool defined)
+{
+    CBotType t = static_cast<CBotType>(type.GetType());
+    if (t != CBotTypInt && t != CBotTypFloat && t != CBotTypBoolean) return -1;
+
+    CBotBytecodeVariable var;
+    var.reg = static_cast<int>(m_types.size());
+    var.defined = -1;
+    var.ident = ident;
+    var.type = t;
+    var.name = name;
+    m_types.push_back(t);
+
+    if (!defined)
+    {
+        // like a new CBotVar: undefined, with a zero value
+        var.defined = static_cast<int>(m_types.size());
+        m_types.push_back(CBotTypBoolean);
+
+        int zero = t == CBotTypFloat ? FloatConstant(0.0f) : (t == CBotTypInt ? IntConstant(0) : BoolConstant(false));
+        Emit(CBotOpcode::Mov, var.reg, zero);
+        Emit(CBotOpcode::Mov, var.defined, BoolConstant(false));
+    }
+
+    if (parameter) m_params.push_back(var);
+    else           m_locals.push_back(var);
+    return var.reg;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::GetVariable(long ident)
+{
+    for (const CBotBytecodeVariable& var : m_params)
+        if (var.ident == ident) return var.reg;
+    for (const CBotBytecodeVariable& var : m_locals)
+        if (var.ident == ident) return var.reg;
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::CheckDefined(int reg, CBotToken* token)
+{
+    for (const CBotBytecodeVariable& var : m_locals)
+    {
+        if (var.reg == reg && var.defined >= 0)
+            Emit(CBotOpcode::CheckInit, var.defined, 0, 0, AddToken(token));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::IntConstant(int value)
+{
+    CBotRegister r;
+    r.i = value;
+    for (const auto& constant : m_constants)
+    {
+        if (m_types[constant.first] == CBotTypInt && constant.second.i == value) return constant.first;
+    }
+    int reg = static_cast<int>(m_types.size());
+    m_types.push_back(CBotTypInt);
+    m_constants.push_back({reg, r});
+    return reg;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::FloatConstant(float value)
+{
+    CBotRegister r;
+    r.f = value;
+    for (const auto& constant : m_constants)
+    {
+        if (m_types[constant.first] == CBotTypFloat && std::memcmp(&constant.second.f, &value, sizeof(float)) == 0)
+            return constant.first;
+    }
+    int reg = static_cast<int>(m_types.size());
+    m_types.push_back(CBotTypFloat);
+    m_constants.push_back({reg, r});
+    return reg;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::BoolConstant(bool value)
+{
+    CBotRegister r;
+    r.i = 0;
+    r.b = value;
+    for (const auto& constant : m_constants)
+    {
+        if (m_types[constant.first] == CBotTypBoolean && constant.second.b == value) return constant.first;
+    }
+    int reg = static_cast<int>(m_types.size());
+    m_types.push_back(CBotTypBoolean);
+    m_constants.push_back({reg, r});
+    return reg;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::AddTemp(CBotType type)
+{
+    std::size_t index = static_cast<std::size_t>(m_temps++);
+    if (index < m_tempTypes.size()) m_tempTypes[index] = type;
+    else                            m_tempTypes.push_back(type);
+    return TEMP_BASE + static_cast<int>(index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotType CBotBytecodeBuilder::GetType(int reg)
+{
+    if (IsTemp(reg)) return m_tempTypes[reg - TEMP_BASE];
+    return m_types[reg];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::IsVariable(int reg)
+{
+    if (IsTemp(reg)) return false;
+    for (const CBotBytecodeVariable& var : m_params)
+        if (var.reg == reg) return true;
+    for (const CBotBytecodeVariable& var : m_locals)
+        if (var.reg == reg) return true;
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::IsTemp(int reg)
+{
+    return reg >= TEMP_BASE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::Emit(CBotOpcode code, int a, int b, int c, int d)
+{
+    if (code == CBotOpcode::Statement || code == CBotOpcode::Loop)
+    {
+        a += m_pendingTicks;
+        m_pendingTicks = 0;
+    }
+    else if (m_pendingTicks > 0)
+    {
+        m_tickOp = static_cast<int>(m_code.size());
+        m_code.push_back({CBotOpcode::Ticks, m_pendingTicks, 0, 0, 0});
+        m_pendingTicks = 0;
+    }
+
+    m_code.push_back({code, a, b, c, d});
+    if (WritesRegister(code) && IsVariable(a)) m_writes++;
+
+    switch (code)
+    {
+        case CBotOpcode::Statement:
+            m_tickOp = static_cast<int>(m_code.size()) - 1;
+            break;
+        case CBotOpcode::Jump:
+        case CBotOpcode::JumpIfFalse:
+        case CBotOpcode::JumpIfTrue:
+        case CBotOpcode::Loop:
+        case CBotOpcode::Return:
+        case CBotOpcode::ReturnVoid:
+        case CBotOpcode::End:
+            // the following code is reached by another path
+            m_tickOp = -1;
+            break;
+        default:
+            break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::AddTicks(int ticks)
+{
+    // the code since m_tickOp runs without branching, its ticks are consumed there
+    if (m_tickOp >= 0) m_code[m_tickOp].a += ticks;
+    else               m_pendingTicks += ticks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::AddToken(CBotToken* token)
+{
+    m_tokens.push_back(token);
+    return static_cast<int>(m_tokens.size()) - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::NewLabel()
+{
+    m_labels.push_back(-1);
+    return static_cast<int>(m_labels.size()) - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::SetLabel(int label)
+{
+    // the pending ticks belong to the code before the label only
+    if (m_pendingTicks > 0)
+    {
+        m_code.push_back({CBotOpcode::Ticks, m_pendingTicks, 0, 0, 0});
+        m_pendingTicks = 0;
+    }
+    m_tickOp = -1;
+
+    m_labels[label] = static_cast<int>(m_code.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::IsLabelHere()
+{
+    for (int position : m_labels)
+        if (position == static_cast<int>(m_code.size())) return true;
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::EmitJump(CBotOpcode code, int label, int cond)
+{
+    Emit(code, 0, cond, 0, label);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::EmitLoop(int label)
+{
+    Emit(CBotOpcode::Loop, 0, 0, 0, label);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::EnterLoop(int breakLabel, int continueLabel)
+{
+    m_loops.push_back({breakLabel, continueLabel});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::LeaveLoop()
+{
+    m_loops.pop_back();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::GetLoopLabel(bool isContinue)
+{
+    if (m_loops.empty()) return -1;
+    return isContinue ? m_loops.back().second : m_loops.back().first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::GetOperation(int tokenType, CBotType type, CBotOpcode& code)
+{
+    if (type == CBotTypInt)
+    {
+        switch (tokenType)
+        {
+            case ID_ADD:    code = CBotOpcode::AddInt; return true;
+            case ID_SUB:    code = CBotOpcode::SubInt; return true;
+            case ID_MUL:    code = CBotOpcode::MulInt; return true;
+            case ID_DIV:    code = CBotOpcode::DivInt; return true;
+            case ID_MODULO: code = CBotOpcode::ModInt; return true;
+            case ID_POWER:  code = CBotOpcode::PowInt; return true;
+            case ID_AND:    code = CBotOpcode::AndInt; return true;
+            case ID_OR:     code = CBotOpcode::OrInt;  return true;
+            case ID_XOR:    code = CBotOpcode::XorInt; return true;
+            case ID_SL:     code = CBotOpcode::ShlInt; return true;
+            case ID_SR:     code = CBotOpcode::ShrInt; return true;
+            case ID_ASR:    code = CBotOpcode::AsrInt; return true;
+            case ID_LO:     code = CBotOpcode::LoInt;  return true;
+            case ID_HI:     code = CBotOpcode::HiInt;  return true;
+            case ID_LS:     code = CBotOpcode::LsInt;  return true;
+            case ID_HS:     code = CBotOpcode::HsInt;  return true;
+            case ID_EQ:     code = CBotOpcode::EqInt;  return true;
+            case ID_NE:     code = CBotOpcode::NeInt;  return true;
+        }
+    }
+    else if (type == CBotTypFloat)
+    {
+        switch (tokenType)
+        {
+            case ID_ADD:    code = CBotOpcode::AddFloat; return true;
+            case ID_SUB:    code = CBotOpcode::SubFloat; return true;
+            case ID_MUL:    code = CBotOpcode::MulFloat; return true;
+            case ID_DIV:    code = CBotOpcode::DivFloat; return true;
+            case ID_MODULO: code = CBotOpcode::ModFloat; return true;
+            case ID_POWER:  code = CBotOpcode::PowFloat; return true;
+            case ID_LO:     code = CBotOpcode::LoFloat;  return true;
+            case ID_HI:     code = CBotOpcode::HiFloat;  return true;
+            case ID_LS:     code = CBotOpcode::LsFloat;  return true;
+            case ID_HS:     code = CBotOpcode::HsFloat;  return true;
+            case ID_EQ:     code = CBotOpcode::EqFloat;  return true;
+            case ID_NE:     code = CBotOpcode::NeFloat;  return true;
+        }
+    }
+    else if (type == CBotTypBoolean)
+    {
+        switch (tokenType)
+        {
+            case ID_AND:
+            case ID_LOG_AND:
+            case ID_TXT_AND: code = CBotOpcode::AndBool; return true;
+            case ID_OR:
+            case ID_LOG_OR:
+            case ID_TXT_OR:  code = CBotOpcode::OrBool;  return true;
+            case ID_XOR:     code = CBotOpcode::XorBool; return true;
+            case ID_EQ:      code = CBotOpcode::EqBool;  return true;
+            case ID_NE:      code = CBotOpcode::NeBool;  return true;
+        }
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::CompileStatement(CBotInstr* instr)
+{
+    int index = static_cast<int>(m_statements.size());
+    m_statements.push_back(instr);
+
+    // nested blocks start at the same place, keep only the innermost statement
+    if (!m_code.empty() && m_code.back().code == CBotOpcode::Statement && !IsLabelHere())
+        m_code.back().d = index;
+    else
+        Emit(CBotOpcode::Statement, 0, 0, 0, index);
+
+    int temps = m_temps;
+    int reg = -1;
+    bool ok = instr->CompileBytecode(*this, reg);
+    m_temps = temps;
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::CompileValue(CBotInstr* instr, int& reg)
+{
+    reg = -1;
+    if (instr == nullptr || !instr->CompileBytecode(*this, reg)) return false;
+    return reg >= 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::CompileRight(int& left, CBotInstr* right, int& reg)
+{
+    Mark mark = GetMark();
+    int writes = m_writes;
+
+    if (!CompileValue(right, reg)) return false;
+    if (m_writes == writes || !IsVariable(left)) return true;
+
+    // the right operand changes variables, keep a copy of the left value
+    Rewind(mark);
+    int copy = AddTemp(GetType(left));
+    Emit(CBotOpcode::Mov, copy, left);
+    left = copy;
+    return CompileValue(right, reg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::CompileCondition(CBotInstr* condition, int label)
+{
+    int cond;
+    if (!CompileValue(condition, cond) || GetType(cond) != CBotTypBoolean) return false;
+    EmitJump(CBotOpcode::JumpIfFalse, label, cond);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::Convert(int reg, CBotType type)
+{
+    CBotType from = GetType(reg);
+    if (from == type) return reg;
+
+    if (from == CBotTypInt && type == CBotTypFloat)
+    {
+        int temp = AddTemp(CBotTypFloat);
+        Emit(CBotOpcode::IntToFloat, temp, reg);
+        return temp;
+    }
+    if (from == CBotTypFloat && type == CBotTypInt)
+    {
+        int temp = AddTemp(CBotTypInt);
+        Emit(CBotOpcode::FloatToInt, temp, reg);
+        return temp;
+    }
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CBotBytecodeBuilder::Assign(int var, int value)
+{
+    int converted = Convert(value, GetType(var));
+    if (converted < 0) return -1;
+
+    int result = value;
+    if (IsTemp(converted) && !m_code.empty() && WritesRegister(m_code.back().code) &&
+        m_code.back().a == converted && !IsLabelHere())
+    {
+        // store the last result directly into the variable
+        m_code.back().a = var;
+        m_writes++;
+        if (converted == value) result = var;
+    }
+    else
+    {
+        Emit(CBotOpcode::Mov, var, converted);
+    }
+
+    for (const CBotBytecodeVariable& local : m_locals)
+    {
+        if (local.reg == var && local.defined >= 0)
+            Emit(CBotOpcode::Mov, local.defined, BoolConstant(true));
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBytecodeBuilder::Mark CBotBytecodeBuilder::GetMark()
+{
+    int tickOpTicks = m_tickOp >= 0 ? m_code[m_tickOp].a : 0;
+    return { m_code.size(), m_labels.size(), m_temps, m_tickOp, tickOpTicks, m_pendingTicks };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::Rewind(const Mark& mark)
+{
+    m_code.resize(mark.code);
+    m_labels.resize(mark.labels);
+    m_temps = mark.temps;
+    m_tickOp = mark.tickOp;
+    if (m_tickOp >= 0) m_code[m_tickOp].a = mark.tickOpTicks;
+    m_pendingTicks = mark.pendingTicks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecodeBuilder::WritesRegister(CBotOpcode code)
+{
+    switch (code)
+    {
+        case CBotOpcode::CheckNan:
+        case CBotOpcode::CheckInit:
+        case CBotOpcode::Jump:
+        case CBotOpcode::JumpIfFalse:
+        case CBotOpcode::JumpIfTrue:
+        case CBotOpcode::Ticks:
+        case CBotOpcode::Statement:
+        case CBotOpcode::Loop:
+        case CBotOpcode::Return:
+        case CBotOpcode::ReturnVoid:
+        case CBotOpcode::End:
+            return false;
+        default:
+            return true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecodeBuilder::Finish(CBotBytecode* code)
+{
+    int named = static_cast<int>(m_types.size());
+    auto remap = [named](int& reg)
+    {
+        if (reg >= TEMP_BASE) reg = reg - TEMP_BASE + named;
+    };
+
+    for (CBotOperation& op : m_code)
+    {
+        switch (op.code)
+        {
+            case CBotOpcode::Jump:
+            case CBotOpcode::JumpIfFalse:
+            case CBotOpcode::JumpIfTrue:
+                remap(op.b);
+                op.d = m_labels[op.d];
+                break;
+            case CBotOpcode::Loop:
+                op.d = m_labels[op.d];
+                break;
+            case CBotOpcode::Return:
+                remap(op.b);
+                break;
+            case CBotOpcode::CheckNan:
+                remap(op.b);
+                remap(op.c);
+                break;
+            case CBotOpcode::Ticks:
+            case CBotOpcode::Statement:
+            case CBotOpcode::ReturnVoid:
+            case CBotOpcode::End:
+                break;
+            default:
+                remap(op.a);
+                remap(op.b);
+                remap(op.c);
+                break;
+        }
+    }
+
+    code->m_statementAt.resize(m_code.size());
+    int statement = -1;
+    for (std::size_t i = 0; i < m_code.size(); ++i)
+    {
+        if (m_code[i].code == CBotOpcode::Statement) statement = m_code[i].d;
+        code->m_statementAt[i] = statement;
+    }
+
+    code->m_code = std::move(m_code);
+    code->m_registerCount = named + static_cast<int>(m_tempTypes.size());
+    code->m_registers.resize(code->m_registerCount);
+    for (const auto& constant : m_constants) code->m_registers[constant.first] = constant.second;
+    code->m_params = std::move(m_params);
+    code->m_locals = std::move(m_locals);
+    code->m_constants = std::move(m_constants);
+    code->m_tokens = std::move(m_tokens);
+    code->m_statements = std::move(m_statements);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBytecode::CBotBytecode(CBotInstr* block)
+{
+    m_block = block;
+    SetToken(block->GetToken());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBytecode::~CBotBytecode()
+{
+    delete m_block;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotBytecode* CBotBytecode::Compile(CBotInstr* block, CBotDefParam* params)
+{
+    if (block == nullptr) return nullptr;
+
+    CBotBytecodeBuilder builder;
+    if (params != nullptr && !params->CompileBytecode(builder)) return nullptr;
+    if (!builder.CompileStatement(block)) return nullptr;
+    builder.Emit(CBotOpcode::End);
+
+    CBotBytecode* code = new CBotBytecode(block);
+    builder.Finish(code);
+    return code;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecode::Execute(CBotStack* &pj)
+{
+    CBotStack* pile = pj->AddStack(this, CBotStack::BlockVisibilityType::BLOCK);
+    if (pile->StackOver()) return pj->Return(pile);
+
+    int state = pile->GetState();
+    if (state < 0) return ExecuteTree(pj, pile);
+    if (state > static_cast<int>(m_code.size()))
+    {
+        // not a position in this code, the saved state doesn't match the program
+        pile->SetError(CBotErrRead, &m_token);
+        return pj->Return(pile);
+    }
+
+    CBotRegister* regs = m_registers.data();
+
+    if (state == 0)
+    {
+        for (const CBotBytecodeVariable& param : m_params)
+        {
+            CBotVar* var = pile->FindVar(param.ident, false);
+            if (var == nullptr || !var->IsDefined())
+            {
+                // undefined or nan, which registers can't hold
+                pile->SetState(-1);
+                return ExecuteTree(pj, pile);
+            }
+        }
+
+        for (const CBotBytecodeVariable& local : m_locals)
+            pile->AddVar(CBotVar::Create(local.name, CBotTypResult(local.type)));
+    }
+
+    Load(pile, regs);
+    return Run(pj, pile, regs, state == 0 ? 0 : state - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecode::ExecuteTree(CBotStack* &pj, CBotStack* pile)
+{
+    if (!m_block->Execute(pile)) return false;
+    return pj->Return(pile);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecode::Load(CBotStack* pile, CBotRegister* regs)
+{
+    auto load = [regs](const CBotBytecodeVariable& v, CBotVar* var)
+    {
+        switch (v.type)
+        {
+            case CBotTypInt:   regs[v.reg].i = var->GetValInt(); break;
+            case CBotTypFloat: regs[v.reg].f = var->GetValFloat(); break;
+            default:           regs[v.reg].b = var->GetValInt() != 0; break;
+        }
+        if (v.defined >= 0) regs[v.defined].b = var->IsDefined();
+    };
+
+    for (const CBotBytecodeVariable& param : m_params)
+    {
+        CBotVar* var = pile->FindVar(param.ident, false);
+        if (var == nullptr) return false;
+        load(param, var);
+    }
+
+    CBotVar* var = pile->GetVarList();
+    for (const CBotBytecodeVariable& local : m_locals)
+    {
+        if (var == nullptr) return false;
+        load(local, var);
+        var = var->GetNext();
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecode::Suspend(CBotStack* &pj, CBotStack* pile, CBotRegister* regs, int pc)
+{
+    auto store = [regs](const CBotBytecodeVariable& v, CBotVar* var)
+    {
+        switch (v.type)
+        {
+            case CBotTypInt:   var->SetValInt(regs[v.reg].i); break;
+            case CBotTypFloat: var->SetValFloat(regs[v.reg].f); break;
+            default:           var->SetValInt(regs[v.reg].b); break;
+        }
+        if (v.defined >= 0 && !regs[v.defined].b) var->SetInit(CBotVar::InitType::UNDEF);
+    };
+
+    for (const CBotBytecodeVariable& param : m_params)
+    {
+        CBotVar* var = pile->FindVar(param.ident, false);
+        if (var != nullptr) store(param, var);
+    }
+
+    CBotVar* var = pile->GetVarList();
+    for (const CBotBytecodeVariable& local : m_locals)
+    {
+        if (var == nullptr) break;
+        store(local, var);
+        var = var->GetNext();
+    }
+
+    // show the current statement as the running instruction
+    int statement = m_statementAt[pc];
+    if (statement >= 0) pj->RestoreStack(m_statements[statement]);
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecode::Run(CBotStack* &pj, CBotStack* pile, CBotRegister* r, int pc)
+{
+    const CBotOperation* code = m_code.data();
+    bool step = pile->GetTimer() <= 0;
+    // ticks of the Ticks operations since the last statement
+    int ticks = 0;
+
+    while (true)
+    {
+        const CBotOperation& op = code[pc++];
+        switch (op.code)
+        {
+            case CBotOpcode::Mov:        r[op.a] = r[op.b]; break;
+            case CBotOpcode::IntToFloat: r[op.a].f = static_cast<float>(r[op.b].i); break;
+            case CBotOpcode::FloatToInt: r[op.a].i = static_cast<int>(r[op.b].f); break;
+
+            case CBotOpcode::AddInt: r[op.a].i = r[op.b].i + r[op.c].i; break;
+            case CBotOpcode::SubInt: r[op.a].i = r[op.b].i - r[op.c].i; break;
+            case CBotOpcode::MulInt: r[op.a].i = r[op.b].i * r[op.c].i; break;
+            case CBotOpcode::DivInt:
+                if (r[op.c].i == 0)
+                {
+                    pile->SetError(CBotErrZeroDiv, m_tokens[op.d]);
+                    return pj->Return(pile);
+                }
+                r[op.a].i = r[op.b].i / r[op.c].i;
+                break;
+            case CBotOpcode::ModInt:
+                if (r[op.c].i == 0)
+                {
+                    pile->SetError(CBotErrZeroDiv, m_tokens[op.d]);
+                    return pj->Return(pile);
+                }
+                r[op.a].i = r[op.b].i % r[op.c].i;
+                break;
+            case CBotOpcode::PowInt: r[op.a].i = static_cast<int>(pow(r[op.b].i, r[op.c].i)); break;
+            case CBotOpcode::AndInt: r[op.a].i = r[op.b].i & r[op.c].i; break;
+            case CBotOpcode::OrInt:  r[op.a].i = r[op.b].i | r[op.c].i; break;
+            case CBotOpcode::XorInt: r[op.a].i = r[op.b].i ^ r[op.c].i; break;
+            case CBotOpcode::ShlInt: r[op.a].i = r[op.b].i << r[op.c].i; break;
+            case CBotOpcode::ShrInt: r[op.a].i = static_cast<int>(static_cast<unsigned>(r[op.b].i) >> r[op.c].i); break;
+            case CBotOpcode::AsrInt: r[op.a].i = r[op.b].i >> r[op.c].i; break;
+            case CBotOpcode::NegInt: r[op.a].i = -r[op.b].i; break;
+            case CBotOpcode::NotInt: r[op.a].i = ~r[op.b].i; break;
+            case CBotOpcode::IncInt: r[op.a].i++; break;
+            case CBotOpcode::DecInt: r[op.a].i--; break;
+            case CBotOpcode::LoInt:  r[op.a].b = r[op.b].i <  r[op.c].i; break;
+            case CBotOpcode::HiInt:  r[op.a].b = r[op.b].i >  r[op.c].i; break;
+            case CBotOpcode::LsInt:  r[op.a].b = r[op.b].i <= r[op.c].i; break;
+            case CBotOpcode::HsInt:  r[op.a].b = r[op.b].i >= r[op.c].i; break;
+            case CBotOpcode::EqInt:  r[op.a].b = r[op.b].i == r[op.c].i; break;
+            case CBotOpcode::NeInt:  r[op.a].b = r[op.b].i != r[op.c].i; break;
+
+            case CBotOpcode::AddFloat: r[op.a].f = r[op.b].f + r[op.c].f; break;
+            case CBotOpcode::SubFloat: r[op.a].f = r[op.b].f - r[op.c].f; break;
+            case CBotOpcode::MulFloat: r[op.a].f = r[op.b].f * r[op.c].f; break;
+            case CBotOpcode::DivFloat:
+                if (r[op.c].f == 0.0f)
+                {
+                    pile->SetError(CBotErrZeroDiv, m_tokens[op.d]);
+                    return pj->Return(pile);
+                }
+                r[op.a].f = r[op.b].f / r[op.c].f;
+                break;
+            case CBotOpcode::ModFloat:
+                if (r[op.c].f == 0.0f)
+                {
+                    pile->SetError(CBotErrZeroDiv, m_tokens[op.d]);
+                    return pj->Return(pile);
+                }
+                r[op.a].f = fmod(r[op.b].f, r[op.c].f);
+                break;
+            case CBotOpcode::PowFloat: r[op.a].f = pow(r[op.b].f, r[op.c].f); break;
+            case CBotOpcode::NegFloat: r[op.a].f = -r[op.b].f; break;
+            case CBotOpcode::IncFloat: r[op.a].f++; break;
+            case CBotOpcode::DecFloat: r[op.a].f--; break;
+            case CBotOpcode::LoFloat:  r[op.a].b = r[op.b].f <  r[op.c].f; break;
+            case CBotOpcode::HiFloat:  r[op.a].b = r[op.b].f >  r[op.c].f; break;
+            case CBotOpcode::LsFloat:  r[op.a].b = r[op.b].f <= r[op.c].f; break;
+            case CBotOpcode::HsFloat:  r[op.a].b = r[op.b].f >= r[op.c].f; break;
+            case CBotOpcode::EqFloat:
+            case CBotOpcode::NeFloat:
+            {
+                bool leftNan = std::isnan(r[op.b].f);
+                bool rightNan = std::isnan(r[op.c].f);
+                bool equal = (leftNan || rightNan) ? leftNan == rightNan : r[op.b].f == r[op.c].f;
+                r[op.a].b = op.code == CBotOpcode::EqFloat ? equal : !equal;
+                break;
+            }
+            case CBotOpcode::CheckNan:
+                if (std::isnan(r[op.b].f) || std::isnan(r[op.c].f))
+                {
+                    pile->SetError(CBotErrNan, m_tokens[op.d]);
+                    return pj->Return(pile);
+                }
+                break;
+
+            case CBotOpcode::AndBool: r[op.a].b = r[op.b].b && r[op.c].b; break;
+            case CBotOpcode::OrBool:  r[op.a].b = r[op.b].b || r[op.c].b; break;
+            case CBotOpcode::XorBool: r[op.a].b = r[op.b].b != r[op.c].b; break;
+            case CBotOpcode::NotBool: r[op.a].b = !r[op.b].b; break;
+            case CBotOpcode::EqBool:  r[op.a].b = r[op.b].b == r[op.c].b; break;
+            case CBotOpcode::NeBool:  r[op.a].b = r[op.b].b != r[op.c].b; break;
+
+            case CBotOpcode::CheckInit:
+                if (!r[op.a].b)
+                {
+                    pile->SetError(CBotErrNotInit, m_tokens[op.d]);
+                    return pj->Return(pile);
+                }
+                break;
+
+            case CBotOpcode::Jump:
+                pc = op.d;
+                break;
+            case CBotOpcode::JumpIfFalse:
+                if (!r[op.b].b) pc = op.d;
+                break;
+            case CBotOpcode::JumpIfTrue:
+                if (r[op.b].b) pc = op.d;
+                break;
+            case CBotOpcode::Ticks:
+                ticks += op.a;
+                break;
+            case CBotOpcode::Statement:
+                if (!pile->SetStateTicks(pc + 1, ticks + op.a) || step) return Suspend(pj, pile, r, pc);
+                ticks = 0;
+                break;
+            case CBotOpcode::Loop:
+                if (!pile->SetStateTicks(op.d + 1, ticks + op.a) || step) return Suspend(pj, pile, r, op.d);
+                ticks = 0;
+                pc = op.d;
+                break;
+
+            case CBotOpcode::Return:
+            {
+                if (ticks > 0) pile->SetStateTicks(pc, ticks);
+                CBotVar* var = CBotVar::Create("", CBotTypResult(op.c));
+                switch (op.c)
+                {
+                    case CBotTypInt:   var->SetValInt(r[op.b].i); break;
+                    case CBotTypFloat: var->SetValFloat(r[op.b].f); break;
+                    default:           var->SetValInt(r[op.b].b); break;
+                }
+                pile->SetVar(var);
+                pile->SetBreak(3, std::string());
+                return pj->Return(pile);
+            }
+            case CBotOpcode::ReturnVoid:
+                if (ticks > 0) pile->SetStateTicks(pc, ticks);
+                pile->SetBreak(3, std::string());
+                return pj->Return(pile);
+            case CBotOpcode::End:
+                if (ticks > 0) pile->SetStateTicks(pc, ticks);
+                return pj->Return(pile);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotBytecode::RestoreState(CBotStack* &pj, bool bMain)
+{
+    if (!bMain) return;
+
+    CBotStack* pile = pj->RestoreStack(this);
+    if (pile == nullptr) return;
+
+    int state = pile->GetState();
+    if (state < 0)
+    {
+        m_block->RestoreState(pile, true);
+        return;
+    }
+
+    if (state > 0 && state - 1 < static_cast<int>(m_statementAt.size()) && m_statementAt[state - 1] >= 0)
+        pj->RestoreStack(m_statements[m_statementAt[state - 1]]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotBytecode::HasReturn()
+{
+    return m_block->HasReturn();
+}
+
+std::string CBotBytecode::GetDebugData()
+{
+    std::stringstream ss;
+    ss << "registers = " << m_registerCount << ", operations = " << m_code.size();
+    return ss.str();
+}
+
+std::map<std::string, CBotInstr*> CBotBytecode::GetDebugLinks()
+{
+    auto links = CBotInstr::GetDebugLinks();
+    links["m_block"] = m_block;
+    return links;
+}
+
+} // namespace CBot
@@ -0,0 +1,401 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include "CBot/CBotInstr/CBotInstr.h"
+
+#include <string>
+#include <vector>
+
+namespace CBot
+{
+
+class CBotDefParam;
+
+/**
+ * \brief Operations of the register machine, see CBotBytecode
+ *
+ * Operands are register numbers: a is the destination, b and c the sources.
+ * d holds jump targets and indexes of tokens (for error positions) or statements.
+ */
+enum class CBotOpcode : unsigned char
+{
+    Mov,            //!< a = b
+    IntToFloat,     //!< a = float(b)
+    FloatToInt,     //!< a = int(b)
+
+    AddInt,
+    SubInt,
+    MulInt,
+    DivInt,         //!< fails with CBotErrZeroDiv
+    ModInt,         //!< fails with CBotErrZeroDiv
+    PowInt,
+    AndInt,
+    OrInt,
+    XorInt,
+    ShlInt,
+    ShrInt,         //!< logical shift
+    AsrInt,         //!< arithmetic shift
+    NegInt,
+    NotInt,
+    IncInt,         //!< a++
+    DecInt,         //!< a--
+    LoInt,
+    HiInt,
+    LsInt,
+    HsInt,
+    EqInt,
+    NeInt,
+
+    AddFloat,
+    SubFloat,
+    MulFloat,
+    DivFloat,       //!< fails with CBotErrZeroDiv
+    ModFloat,       //!< fails with CBotErrZeroDiv
+    PowFloat,
+    NegFloat,
+    IncFloat,
+    DecFloat,
+    LoFloat,
+    HiFloat,
+    LsFloat,
+    HsFloat,
+    EqFloat,        //!< NaN is equal only to NaN, like in CBotTwoOpExpr
+    NeFloat,
+    CheckNan,       //!< fails with CBotErrNan if b or c is NaN
+
+    AndBool,
+    OrBool,
+    XorBool,
+    NotBool,
+    EqBool,
+    NeBool,
+
+    CheckInit,      //!< fails with CBotErrNotInit if the flag in a is not set
+
+    Jump,           //!< continue at d
+    JumpIfFalse,    //!< continue at d if b is false
+    JumpIfTrue,     //!< continue at d if b is true
+    Ticks,          //!< adds a ticks to be consumed at the next statement, loop or return
+    Statement,      //!< start of a statement, consumes a ticks of the timer and may suspend execution
+    Loop,           //!< jumps back to d, consumes a ticks of the timer and may suspend execution
+    Return,         //!< returns the value of b
+    ReturnVoid,
+    End,            //!< end of the function
+};
+
+/**
+ * \brief One instruction of the register machine
+ */
+struct CBotOperation
+{
+    CBotOpcode code;
+    int a;
+    int b;
+    int c;
+    int d;
+};
+
+/**
+ * \brief Register of the machine, the type of each register is known when the code is generated
+ */
+union CBotRegister
+{
+    int i;
+    float f;
+    bool b;
+};
+
+/**
+ * \brief Variable stored in a register of the machine
+ */
+struct CBotBytecodeVariable
+{
+    //! Register holding the value
+    int reg;
+    //! Register holding the "is defined" flag, -1 for variables that are always defined
+    int defined;
+    //! Unique identifier of the variable, see CBotVar::GetUniqNum()
+    long ident;
+    //! Type of the variable, one of ::CBotTypInt, ::CBotTypFloat or ::CBotTypBoolean
+    CBotType type;
+    //! Name of the variable
+    std::string name;
+};
+
+class CBotBytecode;
+
+/**
+ * \brief Generates bytecode for a function, used by CBotInstr::CompileBytecode()
+ *
+ * Variables and constants have their own registers. Temporary registers are allocated
+ * like a stack and released at the end of each statement, so no temporary is alive
+ * at the points where execution can be suspended.
+ */
+class CBotBytecodeBuilder
+{
+public:
+    CBotBytecodeBuilder();
+    ~CBotBytecodeBuilder();
+
+    //! \name Registers
+    //@{
+
+    /**
+     * \brief Declares a parameter or local variable
+     * \param ident Unique identifier of the variable
+     * \param type Type of the variable
+     * \param name Name of the variable
+     * \param parameter true if the variable is a parameter of the function
+     * \param defined false if the variable is declared without initial value
+     * \return Register of the variable, -1 if its type isn't supported
+     */
+    int AddVariable(long ident, const CBotTypResult& type, const std::string& name, bool parameter, bool defined = true);
+    /**
+     * \brief Returns the register of a variable declared with AddVariable()
+     * \return Register of the variable, -1 if it is unknown (field of a class, unsupported type)
+     */
+    int GetVariable(long ident);
+    //! Emits a check that the variable in register reg was assigned, reported at the given token
+    void CheckDefined(int reg, CBotToken* token);
+
+    //! Returns a register holding a constant
+    int IntConstant(int value);
+    //! \copydoc IntConstant()
+    int FloatConstant(float value);
+    //! \copydoc IntConstant()
+    int BoolConstant(bool value);
+
+    //! Allocates a temporary register, valid until the end of the current statement
+    int AddTemp(CBotType type);
+
+    //! Returns the type of a register
+    CBotType GetType(int reg);
+    //! Checks if a register holds a variable (and therefore may change while an expression is evaluated)
+    bool IsVariable(int reg);
+
+    //@}
+
+    //! \name Code generation
+    //@{
+
+    //! Adds an operation to the code
+    void Emit(CBotOpcode code, int a = 0, int b = 0, int c = 0, int d = 0);
+    //! Returns the index of a token, to be used as operand d of the operations which may fail
+    int AddToken(CBotToken* token);
+
+    //! Creates a new jump target
+    int NewLabel();
+    //! Sets the jump target to the current position
+    void SetLabel(int label);
+    //! Emits a jump to the given target, optionally depending on the value of register cond
+    void EmitJump(CBotOpcode code, int label, int cond = 0);
+    //! Emits a jump back to the beginning of a loop, giving the scheduler a chance to suspend execution
+    void EmitLoop(int label);
+
+    /**
+     * \brief Consumes ticks of the timer at the current position
+     *
+     * Each instruction adds the ticks its Execute() consumes on the same path,
+     * so a function takes as many ticks as with the instruction tree.
+     */
+    void AddTicks(int ticks);
+
+    //! Starts a loop for break and continue
+    void EnterLoop(int breakLabel, int continueLabel);
+    //! Ends the loop started by EnterLoop()
+    void LeaveLoop();
+    //! Returns the target of break or continue in the innermost loop, -1 if not in a loop
+    int GetLoopLabel(bool isContinue);
+
+    /**
+     * \brief Finds the operation for a binary operator
+     * \param tokenType Operator (ID_ADD, ID_LO, ...)
+     * \param type Type in which the operation is done
+     * \param[out] code Operation
+     * \return false if this operator isn't supported for this type
+     */
+    bool GetOperation(int tokenType, CBotType type, CBotOpcode& code);
+
+    //@}
+
+    //! \name Translating instructions
+    //@{
+
+    /**
+     * \brief Translates an instruction as a statement
+     *
+     * Statements are the places where execution can be suspended, the program is then seen as running this instruction.
+     */
+    bool CompileStatement(CBotInstr* instr);
+    //! Translates an expression which has to give a value
+    bool CompileValue(CBotInstr* instr, int& reg);
+    /**
+     * \brief Translates the right operand of an operation
+     *
+     * If the right operand changes the variable holding the left operand, the left operand
+     * is copied first, as the instruction tree evaluates it before the right one.
+     */
+    bool CompileRight(int& left, CBotInstr* right, int& reg);
+    //! Translates a condition and jumps to label if it is false
+    bool CompileCondition(CBotInstr* condition, int label);
+
+    /**
+     * \brief Converts the value of a register to the given type, like CBotVar::SetVal()
+     * \return Register of the converted value, -1 if there is no conversion
+     */
+    int Convert(int reg, CBotType type);
+    /**
+     * \brief Assigns a value to a variable
+     * \return Register with the value of the assignment, -1 on error
+     */
+    int Assign(int var, int value);
+
+    //@}
+
+    /**
+     * \brief Moves the generated code into the given function body
+     */
+    void Finish(CBotBytecode* code);
+
+private:
+    //! Position to rewind to when an expression has to be translated again
+    struct Mark
+    {
+        std::size_t code;
+        std::size_t labels;
+        int temps;
+        int tickOp;
+        int tickOpTicks;
+        int pendingTicks;
+    };
+
+    Mark GetMark();
+    void Rewind(const Mark& mark);
+    bool IsTemp(int reg);
+    bool IsLabelHere();
+    static bool WritesRegister(CBotOpcode code);
+
+    //! Temporaries use numbers from this value until Finish() moves them after the other registers
+    static const int TEMP_BASE = 1 << 24;
+
+    std::vector<CBotOperation> m_code;
+    std::vector<CBotType> m_types;
+    std::vector<CBotType> m_tempTypes;
+    int m_temps = 0;
+    std::vector<CBotBytecodeVariable> m_params;
+    std::vector<CBotBytecodeVariable> m_locals;
+    std::vector<std::pair<int, CBotRegister>> m_constants;
+    std::vector<CBotToken*> m_tokens;
+    std::vector<CBotInstr*> m_statements;
+    std::vector<int> m_labels;
+    std::vector<std::pair<int, int>> m_loops;
+    //! Number of writes to variables, see CompileRight()
+    int m_writes = 0;
+    //! Operation consuming the ticks of the code emitted since, -1 after a jump or a label
+    int m_tickOp = -1;
+    //! Ticks waiting for the next operation when m_tickOp is -1
+    int m_pendingTicks = 0;
+};
+
+/**
+ * \brief Body of a function translated to register bytecode
+ *
+ * Enabled with CBotProgram::SetBytecode(). After a successful compilation, the body
+ * of each function which uses only the supported subset of the language is translated:
+ * int, float and bool variables, literals, assignments, arithmetic and logic operators,
+ * increments, if, while, do, for, unlabeled break and continue, and return.
+ * Other functions keep running on the instruction tree.
+ *
+ * The registers are synchronized with the variables on the stack only when the execution
+ * is suspended, so debugging, GetRunPos() and SaveState() see the same variables as with
+ * the instruction tree. The timer is checked at each statement and at the end of each
+ * loop iteration, and consumes the same number of ticks as the instruction tree, which
+ * keeps the preemption of the instruction tree.
+ *
+ * The original instructions are kept; they are used when a parameter isn't defined or NaN,
+ * which the registers can't represent.
+ */
+class CBotBytecode : public CBotInstr
+{
+public:
+    ~CBotBytecode();
+
+    /**
+     * \brief Translates a function body
+     * \param block Body of the function, taken over by the result on success
+     * \param params Parameters of the function, may be nullptr
+     * \return The translated body, or nullptr if the function uses something not supported
+     */
+    static CBotBytecode* Compile(CBotInstr* block, CBotDefParam* params);
+
+    /**
+     * \brief Execute
+     * \param pj
+     * \return
+     */
+    bool Execute(CBotStack* &pj) override;
+
+    /**
+     * \brief RestoreState
+     * \param pj
+     * \param bMain
+     */
+    void RestoreState(CBotStack* &pj, bool bMain) override;
+
+    bool HasReturn() override;
+
+protected:
+    virtual const std::string GetDebugName() override { return "CBotBytecode"; }
+    virtual std::string GetDebugData() override;
+    virtual std::map<std::string, CBotInstr*> GetDebugLinks() override;
+
+private:
+    CBotBytecode(CBotInstr* block);
+
+    //! Runs the code from the given position
+    bool Run(CBotStack* &pj, CBotStack* pile, CBotRegister* regs, int pc);
+    //! Saves the registers into the variables on the stack and suspends at the given position
+    bool Suspend(CBotStack* &pj, CBotStack* pile, CBotRegister* regs, int pc);
+    //! Reads the registers from the variables on the stack
+    bool Load(CBotStack* pile, CBotRegister* regs);
+    //! Runs the original instructions
+    bool ExecuteTree(CBotStack* &pj, CBotStack* pile);
+
+    friend class CBotBytecodeBuilder;
+
+    //! Original instructions
+    CBotInstr* m_block;
+    std::vector<CBotOperation> m_code;
+    int m_registerCount = 0;
+    //! Registers, with the constants set once; Run() doesn't call other functions, so they are never shared
+    std::vector<CBotRegister> m_registers;
+    std::vector<CBotBytecodeVariable> m_params;
+    std::vector<CBotBytecodeVariable> m_locals;
+    std::vector<std::pair<int, CBotRegister>> m_constants;
+    //! Tokens for the errors
+    std::vector<CBotToken*> m_tokens;
+    //! Statements, shown as the running instruction when suspended
+    std::vector<CBotInstr*> m_statements;
+    //! Index in m_statements for each position in the code
+    std::vector<int> m_statementAt;
+};
+
+} // namespace CBot
@@ -19,6 +19,7 @@
 
 #include "CBot/CBotInstr/CBotDefBoolean.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotLeftExprVar.h"
 #include "CBot/CBotInstr/CBotTwoOpExpr.h"
 #include "CBot/CBotInstr/CBotDefArray.h"
@@ -174,6 +175,30 @@ void CBotDefBoolean::RestoreState(CBotStack* &pj, bool bMain)
          m_next2b->RestoreState(pile, bMain);                // other(s) definition(s)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotDefBoolean::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    CBotLeftExprVar* var = static_cast<CBotLeftExprVar*>(m_var);
+    if (!var->m_typevar.Eq(CBotTypBoolean)) return false;
+
+    if (m_expr != nullptr)
+    {
+        int value;
+        if (!builder.CompileValue(m_expr, value)) return false;
+        int dest = builder.AddVariable(var->m_nIdent, var->m_typevar, var->GetToken()->GetString(), false);
+        if (dest < 0 || builder.Assign(dest, value) < 0) return false;
+    }
+    else
+    {
+        if (builder.AddVariable(var->m_nIdent, var->m_typevar, var->GetToken()->GetString(), false, false) < 0) return false;
+    }
+
+    builder.AddTicks(1);
+    if (m_next2b != nullptr && !m_next2b->CompileBytecode(builder, reg)) return false;
+    reg = -1;
+    return true;
+}
+
 std::map<std::string, CBotInstr*> CBotDefBoolean::GetDebugLinks()
 {
     auto links = CBotInstr::GetDebugLinks();
@@ -57,6 +57,14 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotDefFloat"; }
     virtual std::map<std::string, CBotInstr*> GetDebugLinks() override;
@@ -19,6 +19,7 @@
 
 #include "CBot/CBotInstr/CBotDo.h"
 #include "CBot/CBotInstr/CBotBlock.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotCondition.h"
 
 #include "CBot/CBotStack.h"
@@ -154,6 +155,29 @@ void CBotDo :: RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotDo::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    if (!m_label.empty()) return false;
+
+    int labelBlock = builder.NewLabel();
+    int labelContinue = builder.NewLabel();
+    int labelEnd = builder.NewLabel();
+
+    builder.SetLabel(labelBlock);
+    builder.EnterLoop(labelEnd, labelContinue);
+    if (m_block != nullptr && !builder.CompileStatement(m_block)) return false;
+    builder.LeaveLoop();
+
+    builder.AddTicks(1);                                // not taken by continue, like in Execute()
+    builder.SetLabel(labelContinue);
+    if (!builder.CompileCondition(m_condition, labelEnd)) return false;
+    builder.AddTicks(1);
+    builder.EmitLoop(labelBlock);
+    builder.SetLabel(labelEnd);
+    return true;
+}
+
 std::string CBotDo::GetDebugData()
 {
     return !m_label.empty() ? "m_label = "+m_label : "";
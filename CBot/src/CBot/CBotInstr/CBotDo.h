@@ -55,6 +55,14 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotDo"; }
     virtual std::string GetDebugData() override;
@@ -19,6 +19,8 @@
 
 #include "CBot/CBotInstr/CBotExprLitBool.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
+
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
 
@@ -32,6 +34,11 @@ CBotExprLitBool::CBotExprLitBool()
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+CBotExprLitBool::CBotExprLitBool(bool value) : m_value(value)
+{
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 CBotExprLitBool::~CBotExprLitBool()
 {
@@ -46,7 +53,7 @@ CBotInstr* CBotExprLitBool::Compile(CBotToken* &p, CBotCStack* pStack)
     if ( p->GetType() == ID_TRUE ||
          p->GetType() == ID_FALSE )
     {
-        inst = new CBotExprLitBool();
+        inst = new CBotExprLitBool(p->GetType() == ID_TRUE);
         inst->SetToken(p);  // stores the operation false or true
         p = p->GetNext();
 
@@ -66,8 +73,7 @@ bool CBotExprLitBool::Execute(CBotStack* &pj)
 
     CBotVar*    var = CBotVar::Create("", CBotTypBoolean);
 
-    if (GetTokenType() == ID_TRUE)      var->SetValInt(1);
-    else                              var->SetValInt(0);
+    var->SetValInt(m_value);
 
     pile->SetVar(var);  // put on the stack
     return pj->Return(pile);    // forwards below
@@ -79,4 +85,19 @@ void CBotExprLitBool::RestoreState(CBotStack* &pj, bool bMain)
     if (bMain) pj->RestoreStack(this);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotExprLitBool::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    reg = builder.BoolConstant(m_value);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotVar* CBotExprLitBool::GetConstantValue()
+{
+    CBotVar* var = CBotVar::Create("", CBotTypBoolean);
+    var->SetValInt(m_value);
+    return var;
+}
+
 } // namespace CBot
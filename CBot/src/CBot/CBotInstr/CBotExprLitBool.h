@@ -31,6 +31,10 @@ class CBotExprLitBool : public CBotInstr
 {
 public:
     CBotExprLitBool();
+    /*!
+     * \brief Creates a literal with the given value, see CreateLiteral()
+     */
+    CBotExprLitBool(bool value);
     ~CBotExprLitBool();
 
     /*!
@@ -55,8 +59,22 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
+    CBotVar* GetConstantValue() override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotExprLitBool"; }
+
+private:
+    //! Value of the literal
+    bool m_value = false;
 };
 
 } // namespace CBot
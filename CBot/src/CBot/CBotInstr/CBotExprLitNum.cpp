@@ -18,6 +18,10 @@
  */
 
 #include "CBot/CBotInstr/CBotExprLitNum.h"
+
+#include "CBot/CBotInstr/CBotBytecode.h"
+#include "CBot/CBotInstr/CBotExprLitBool.h"
+
 #include "CBot/CBotStack.h"
 
 #include "CBot/CBotCStack.h"
@@ -152,6 +156,23 @@ CBotInstr* CompileSizeOf(CBotToken* &p, CBotCStack* pStack)
     return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+CBotInstr* CreateLiteral(CBotVar* var, CBotToken* token)
+{
+    CBotInstr* inst = nullptr;
+    switch (var->GetType())
+    {
+        case CBotTypInt:     inst = new CBotExprLitNum<int>(var->GetValInt()); break;
+        case CBotTypLong:    inst = new CBotExprLitNum<long>(var->GetValLong()); break;
+        case CBotTypFloat:   inst = new CBotExprLitNum<float>(var->GetValFloat()); break;
+        case CBotTypDouble:  inst = new CBotExprLitNum<double>(var->GetValDouble()); break;
+        case CBotTypBoolean: inst = new CBotExprLitBool(var->GetValInt() != 0); break;
+        default: return nullptr;
+    }
+    inst->SetToken(token);
+    return inst;
+}
+
 template <typename T>
 bool CBotExprLitNum<T>::Execute(CBotStack* &pj)
 {
@@ -174,12 +195,42 @@ bool CBotExprLitNum<T>::Execute(CBotStack* &pj)
     return pj->Return(pile);                        // it's ok
 }
 
+template <typename T>
+CBotVar* CBotExprLitNum<T>::GetConstantValue()
+{
+    CBotVar*    var = CBotVar::Create("", m_numtype);
+
+    if (m_token.GetType() == TokenTypDef)
+    {
+        var->SetValInt(m_value, m_token.GetString());
+    }
+    else
+    {
+        *var = m_value;
+    }
+    return var;
+}
+
 template <typename T>
 void CBotExprLitNum<T>::RestoreState(CBotStack* &pj, bool bMain)
 {
     if (bMain) pj->RestoreStack(this);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+bool CBotExprLitNum<T>::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    if (m_token.GetType() == TokenTypDef) return false;
+
+    switch (m_numtype)
+    {
+        case CBotTypInt:   reg = builder.IntConstant(static_cast<int>(m_value)); return true;
+        case CBotTypFloat: reg = builder.FloatConstant(static_cast<float>(m_value)); return true;
+        default:           return false;
+    }
+}
+
 template <typename T>
 std::string CBotExprLitNum<T>::GetDebugData()
 {
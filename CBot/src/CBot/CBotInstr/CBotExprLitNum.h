@@ -28,6 +28,14 @@ CBotInstr* CompileExprLitNum(CBotToken* &p, CBotCStack* pStack);
 
 CBotInstr* CompileSizeOf(CBotToken* &p, CBotCStack* pStack);
 
+/**
+ * \brief Creates a literal with the value of a variable, used to replace operations on constants by their result
+ * \param var Value of the literal
+ * \param token Token of the replaced operation, used for the position
+ * \return New CBotExprLitNum or CBotExprLitBool, nullptr if there is no literal for the type of var
+ */
+CBotInstr* CreateLiteral(CBotVar* var, CBotToken* token);
+
 /**
  * \brief A number literal - 5, 1, 2.5, 3.75, etc. or a predefined numerical constant (see CBotToken::DefineNum())
  *
@@ -57,6 +65,16 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
+    CBotVar* GetConstantValue() override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotExprLitNum"; }
     virtual std::string GetDebugData() override;
@@ -163,6 +163,7 @@ CBotInstr* CBotExprLitString::Compile(CBotToken* &p, CBotCStack* pStack)
         {
             CBotExprLitString* inst = new CBotExprLitString();
             inst->m_valstring.swap(valstring);
+            inst->m_value = CBotStringValue(inst->m_valstring);
             inst->SetToken(p);
             p = p->GetNext();
 
@@ -184,9 +185,9 @@ bool CBotExprLitString::Execute(CBotStack* &pj)
 
     if (pile->IfStep()) return false;
 
-    CBotVar*    var = CBotVar::Create("", CBotTypString);
+    CBotVarString* var = static_cast<CBotVarString*>(CBotVar::Create("", CBotTypString));
 
-    var->SetValString(m_valstring);
+    var->SetValue(m_value);
 
     pile->SetVar(var);                            // put on the stack
 
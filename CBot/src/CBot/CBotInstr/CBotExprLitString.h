@@ -21,6 +21,8 @@
 
 #include "CBot/CBotInstr/CBotInstr.h"
 
+#include "CBot/CBotVar/CBotVarString.h"
+
 namespace CBot
 {
 
@@ -61,6 +63,8 @@ protected:
 
 private:
     std::string m_valstring = "";
+    //! The value put on the stack, shared by all executions
+    CBotStringValue m_value;
 };
 
 } // namespace CBot
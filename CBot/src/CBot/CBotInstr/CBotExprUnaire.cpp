@@ -18,6 +18,8 @@
  */
 
 #include "CBot/CBotInstr/CBotExprUnaire.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
+#include "CBot/CBotInstr/CBotExprLitNum.h"
 #include "CBot/CBotInstr/CBotParExpr.h"
 
 #include "CBot/CBotStack.h"
@@ -25,6 +27,8 @@
 
 #include "CBot/CBotVar/CBotVar.h"
 
+#include <memory>
+
 namespace CBot
 {
 
@@ -59,15 +63,15 @@ CBotInstr* CBotExprUnaire::Compile(CBotToken* &p, CBotCStack* pStack, bool bLite
     if (inst->m_expr != nullptr)
     {
         if (op == ID_ADD && pStk->GetType() < CBotTypBoolean)        // only with the number
-            return pStack->Return(inst, pStk);
+            return pStack->Return(FoldConstant(inst), pStk);
         if (op == ID_SUB && pStk->GetType() < CBotTypBoolean)        // only with the numer
-            return pStack->Return(inst, pStk);
+            return pStack->Return(FoldConstant(inst), pStk);
         if (op == ID_NOT && pStk->GetType() < CBotTypFloat)        // only with an integer
-            return pStack->Return(inst, pStk);
+            return pStack->Return(FoldConstant(inst), pStk);
         if (op == ID_LOG_NOT && pStk->GetTypResult().Eq(CBotTypBoolean))// only with boolean
-            return pStack->Return(inst, pStk);
+            return pStack->Return(FoldConstant(inst), pStk);
         if (op == ID_TXT_NOT && pStk->GetTypResult().Eq(CBotTypBoolean))// only with boolean
-            return pStack->Return(inst, pStk);
+            return pStack->Return(FoldConstant(inst), pStk);
 
         pStk->SetError(CBotErrBadType1, &inst->m_token);
     }
@@ -75,6 +79,25 @@ CBotInstr* CBotExprUnaire::Compile(CBotToken* &p, CBotCStack* pStack, bool bLite
     return pStack->Return(nullptr, pStk);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+CBotInstr* CBotExprUnaire::FoldConstant(CBotExprUnaire* inst)
+{
+    int op = inst->GetTokenType();
+    if (op == ID_ADD) return inst;                  // keeps the name of a constant defined with DefineNum()
+
+    std::unique_ptr<CBotVar> var(inst->m_expr->GetConstantValue());
+    if (var == nullptr) return inst;
+
+    if (op == ID_SUB) var->Neg();                   // same as Execute()
+    else              var->Not();
+
+    CBotInstr* literal = CreateLiteral(var.get(), &inst->m_token);
+    if (literal == nullptr) return inst;
+
+    delete inst;
+    return literal;
+}
+
 // executes unary expression
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotExprUnaire::Execute(CBotStack* &pj)
@@ -123,6 +146,40 @@ void CBotExprUnaire::RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotExprUnaire::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    int value;
+    if (!builder.CompileValue(m_expr, value)) return false;
+    builder.AddTicks(1);
+
+    CBotType type = builder.GetType(value);
+    CBotOpcode code;
+    switch (GetTokenType())
+    {
+        case ID_ADD:
+            if (type == CBotTypBoolean) return false;
+            reg = value;
+            return true;
+        case ID_SUB:
+            if (type == CBotTypBoolean) return false;
+            code = type == CBotTypInt ? CBotOpcode::NegInt : CBotOpcode::NegFloat;
+            break;
+        case ID_NOT:
+        case ID_LOG_NOT:
+        case ID_TXT_NOT:
+            if (type == CBotTypFloat) return false;
+            code = type == CBotTypInt ? CBotOpcode::NotInt : CBotOpcode::NotBool;
+            break;
+        default:
+            return false;
+    }
+
+    reg = builder.AddTemp(type);
+    builder.Emit(code, reg, value);
+    return true;
+}
+
 std::map<std::string, CBotInstr*> CBotExprUnaire::GetDebugLinks()
 {
     auto links = CBotInstr::GetDebugLinks();
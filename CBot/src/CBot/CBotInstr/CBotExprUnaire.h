@@ -56,11 +56,26 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotExprUnaire"; }
     virtual std::map<std::string, CBotInstr*> GetDebugLinks() override;
 
 private:
+    /*!
+     * \brief Replaces the operation on a constant by a literal with its result
+     * \param inst Operation, deleted if it is replaced
+     * \return The literal, or inst if the operand isn't a constant
+     */
+    static CBotInstr* FoldConstant(CBotExprUnaire* inst);
+
     //! Expression to be evaluated.
     CBotInstr* m_expr;
 };
@@ -19,6 +19,7 @@
 
 #include <sstream>
 #include "CBot/CBotInstr/CBotExprVar.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotInstrMethode.h"
 #include "CBot/CBotInstr/CBotExpression.h"
 #include "CBot/CBotInstr/CBotIndexExpr.h"
@@ -278,6 +279,21 @@ void CBotExprVar::RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotExprVar::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    if (m_next3 != nullptr) return false;
+
+    reg = builder.GetVariable(m_nIdent);
+    if (reg < 0) return false;
+    builder.AddTicks(1);
+
+    CBotToken* pt = &m_token;
+    while (pt->GetNext() != nullptr) pt = pt->GetNext();
+    builder.CheckDefined(reg, pt);
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotExprVar::ExecuteVar(CBotVar* &pVar, CBotStack* &pj, CBotToken* prevToken, bool bStep)
 {
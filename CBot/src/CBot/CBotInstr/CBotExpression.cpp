@@ -19,6 +19,7 @@
 
 #include "CBot/CBotInstr/CBotExpression.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotInstrUtils.h"
 
 #include "CBot/CBotInstr/CBotTwoOpExpr.h"
@@ -308,6 +309,54 @@ void CBotExpression::RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotExpression::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    int var;
+    if (!m_leftop->CompileBytecode(builder, var) || var < 0) return false;
+    builder.AddTicks(3);
+
+    int value;
+    if (m_token.GetType() == ID_ASS)
+    {
+        if (!builder.CompileValue(m_rightop, value)) return false;
+        reg = builder.Assign(var, value);
+        return reg >= 0;
+    }
+
+    int op;
+    switch (m_token.GetType())
+    {
+        case ID_ASSADD:    op = ID_ADD;    break;
+        case ID_ASSSUB:    op = ID_SUB;    break;
+        case ID_ASSMUL:    op = ID_MUL;    break;
+        case ID_ASSDIV:    op = ID_DIV;    break;
+        case ID_ASSMODULO: op = ID_MODULO; break;
+        case ID_ASSAND:    op = ID_AND;    break;
+        case ID_ASSXOR:    op = ID_XOR;    break;
+        case ID_ASSOR:     op = ID_OR;     break;
+        case ID_ASSSL:     op = ID_SL;     break;
+        case ID_ASSSR:     op = ID_SR;     break;
+        case ID_ASSASR:    op = ID_ASR;    break;
+        default: return false;
+    }
+
+    // the operation is done in the type of the variable, like in Execute()
+    CBotType type = builder.GetType(var);
+    CBotOpcode code;
+    if (!builder.GetOperation(op, type, code)) return false;
+
+    int left = var;
+    if (!builder.CompileRight(left, m_rightop, value)) return false;
+    value = builder.Convert(value, type);
+    if (value < 0) return false;
+
+    int result = builder.AddTemp(type);
+    builder.Emit(code, result, left, value, builder.AddToken(&m_token));
+    reg = builder.Assign(var, result);
+    return reg >= 0;
+}
+
 std::map<std::string, CBotInstr*> CBotExpression::GetDebugLinks()
 {
     auto links = CBotInstr::GetDebugLinks();
@@ -18,6 +18,7 @@
  */
 
 #include "CBot/CBotInstr/CBotFor.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotListExpression.h"
 #include "CBot/CBotInstr/CBotBlock.h"
 #include "CBot/CBotInstr/CBotBoolExpr.h"
@@ -210,6 +211,36 @@ void CBotFor :: RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotFor::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    if (!m_label.empty()) return false;
+
+    if (m_init != nullptr && !m_init->CompileBytecode(builder, reg)) return false;
+    builder.AddTicks(1);
+
+    int labelTest = builder.NewLabel();
+    int labelContinue = builder.NewLabel();
+    int labelEnd = builder.NewLabel();
+
+    builder.SetLabel(labelTest);
+    if (m_test != nullptr && !builder.CompileCondition(m_test, labelEnd)) return false;
+    builder.AddTicks(1);
+
+    builder.EnterLoop(labelEnd, labelContinue);
+    if (m_block != nullptr && !builder.CompileStatement(m_block)) return false;
+    builder.LeaveLoop();
+
+    builder.AddTicks(1);                                // not taken by continue, like in Execute()
+    builder.SetLabel(labelContinue);
+    if (m_incr != nullptr && !m_incr->CompileBytecode(builder, reg)) return false;
+    builder.AddTicks(1);
+    builder.EmitLoop(labelTest);
+    builder.SetLabel(labelEnd);
+    reg = -1;
+    return true;
+}
+
 std::string CBotFor::GetDebugData()
 {
     return !m_label.empty() ? "m_label = "+m_label : "";
@@ -22,6 +22,7 @@
 #include "CBot/CBotInstr/CBotInstrUtils.h"
 
 #include "CBot/CBotInstr/CBotBlock.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotTwoOpExpr.h"
 #include "CBot/CBotInstr/CBotExpression.h"
 #include "CBot/CBotInstr/CBotEmpty.h"
@@ -30,6 +31,7 @@
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
 #include "CBot/CBotClass.h"
+#include "CBot/CBotContext.h"
 #include "CBot/CBotDefParam.h"
 #include "CBot/CBotUtils.h"
 
@@ -54,9 +56,6 @@ CBotFunction::CBotFunction()
     m_bSynchro    = false;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-std::set<CBotFunction*> CBotFunction::m_publicFunctions{};
-
 ////////////////////////////////////////////////////////////////////////////////
 CBotFunction::~CBotFunction()
 {
@@ -66,7 +65,7 @@ CBotFunction::~CBotFunction()
     // remove public list if there is
     if (m_bPublic)
     {
-        m_publicFunctions.erase(this);
+        CBotContext::GetCurrent()->m_publicFunctions.erase(this);
     }
 }
 
@@ -139,12 +138,22 @@ bool CBotFunction::GetPosition(int& start, int& stop, CBotGet modestart, CBotGet
 ////////////////////////////////////////////////////////////////////////////////
 CBotFunction* CBotFunction::Compile(CBotToken* &p, CBotCStack* pStack, CBotFunction* finput, bool bLocal)
 {
-    CBotToken*      pp;
     CBotFunction* func = finput;
     assert(func != nullptr); // a pre-compiled function is required
 
     CBotCStack* pStk = pStack->TokenStack(p, bLocal);
 
+    if (CompileHeader(p, pStk, func) && CompileBody(p, pStk, func))
+        return pStack->ReturnFunc(func, pStk);
+
+    return pStack->ReturnFunc(nullptr, pStk);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotFunction::CompileHeader(CBotToken* &p, CBotCStack* pStk, CBotFunction* func)
+{
+    CBotToken*      pp;
+
     while (true)
     {
         if (IsOfType(p, ID_PRIVATE)) break;
@@ -195,7 +204,7 @@ CBotFunction* CBotFunction::Compile(CBotToken* &p, CBotCStack* pStack, CBotFunct
                 func->m_token = *p;
                 if (!IsOfType(p, TokenTypVar)) goto bad;
                 // check if the class has a method like this
-                if (pClass->CheckCall(pStack->GetProgram(), func->m_param, pp))
+                if (pClass->CheckCall(pStk->GetProgram(), func->m_param, pp))
                 {
                     pStk->SetStartError(func->m_classToken.GetStart());
                     pStk->SetError(CBotErrRedefFunc, pp->GetEnd());
@@ -215,40 +224,57 @@ CBotFunction* CBotFunction::Compile(CBotToken* &p, CBotCStack* pStack, CBotFunct
             func->m_closepar = *(p->GetPrev());
             if (pStk->IsOk())
             {
-                pStk->SetRetType(func->m_retTyp);   // for knowledge what type returns
-
-                if (!func->m_MasterClass.empty())
-                {
-                    CBotClass* pClass = CBotClass::Find(func->m_MasterClass);
-
-                    pStk->CreateVarThis(pClass);
-                    pStk->CreateVarSuper(pClass->GetParent());
-
-                    bool bConstructor = (func->GetName() == func->m_MasterClass);
-                    pStk->CreateMemberVars(pClass, !bConstructor);
-                }
-
-                // and compiles the following instruction block
-                func->m_openblk = *p;
-                func->m_block = CBotBlock::Compile(p, pStk, false);
-                func->m_closeblk = (p != nullptr && p->GetPrev() != nullptr) ? *(p->GetPrev()) : CBotToken();
-                if ( pStk->IsOk() )
-                {
-                    if (!func->m_retTyp.Eq(CBotTypVoid) && !func->HasReturn())
-                    {
-                        int errPos = func->m_closeblk.GetStart();
-                        pStk->ResetError(CBotErrNoReturn, errPos, errPos);
-                        goto bad;
-                    }
-                    return pStack->ReturnFunc(func, pStk);
-                }
+                AddClassVars(pStk, func);
+                return true;
             }
         }
 bad:
         pStk->SetError(CBotErrNoFunc, p);
     }
     pStk->SetError(CBotErrNoType, p);
-    return pStack->ReturnFunc(nullptr, pStk);
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotFunction::CompileBody(CBotToken* &p, CBotCStack* pStk, CBotFunction* func)
+{
+    // compiles the following instruction block
+    func->m_openblk = *p;
+    func->m_block = CBotBlock::Compile(p, pStk, false);
+    func->m_closeblk = (p != nullptr && p->GetPrev() != nullptr) ? *(p->GetPrev()) : CBotToken();
+    if ( !pStk->IsOk() ) return false;
+
+    if (!func->m_retTyp.Eq(CBotTypVoid) && !func->HasReturn())
+    {
+        int errPos = func->m_closeblk.GetStart();
+        pStk->ResetError(CBotErrNoReturn, errPos, errPos);
+        return false;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotFunction::AddBodyVars(CBotCStack* pStk, CBotFunction* func)
+{
+    if (func->m_param != nullptr) func->m_param->AddVars(pStk);
+    AddClassVars(pStk, func);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotFunction::AddClassVars(CBotCStack* pStk, CBotFunction* func)
+{
+    pStk->SetRetType(func->m_retTyp);   // for knowledge what type returns
+
+    if (!func->m_MasterClass.empty())
+    {
+        CBotClass* pClass = CBotClass::Find(func->m_MasterClass);
+
+        pStk->CreateVarThis(pClass);
+        pStk->CreateVarSuper(pClass->GetParent());
+
+        bool bConstructor = (func->GetName() == func->m_MasterClass);
+        pStk->CreateMemberVars(pClass, !bConstructor);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -531,7 +557,7 @@ CBotFunction* CBotFunction::FindLocalOrPublic(const std::list<CBotFunction*>& lo
         }
 
         // search the list of public functions
-        for (CBotFunction* pt : m_publicFunctions)
+        for (CBotFunction* pt : CBotContext::GetCurrent()->m_publicFunctions)
         {
             if (pt->m_nFuncIdent == nIdent)
             {
@@ -641,7 +667,7 @@ void CBotFunction::SearchPublic(const std::string& name, CBotVar** ppVars, CBotT
                                 std::map<CBotFunction*, int>& funcMap, CBotClass* pClass)
 {
     {
-        for (CBotFunction* pt : m_publicFunctions)
+        for (CBotFunction* pt : CBotContext::GetCurrent()->m_publicFunctions)
         {
             if ( pt->m_token.GetString() == name )
             {
@@ -979,7 +1005,7 @@ CBotFunction* CBotFunction::FindMethod(long& nIdent, const std::string& name,
         // search the list of public functions
         if (!skipPublic)
         {
-            for (CBotFunction* pt : m_publicFunctions)
+            for (CBotFunction* pt : CBotContext::GetCurrent()->m_publicFunctions)
             {
                 if (pt->m_nFuncIdent == nIdent)
                 {
@@ -1214,7 +1240,7 @@ const std::string& CBotFunction::GetClassName() const
 ////////////////////////////////////////////////////////////////////////////////
 void CBotFunction::AddPublic(CBotFunction* func)
 {
-    m_publicFunctions.insert(func);
+    CBotContext::GetCurrent()->m_publicFunctions.insert(func);
 }
 
 bool CBotFunction::HasReturn()
@@ -1223,6 +1249,15 @@ bool CBotFunction::HasReturn()
     return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void CBotFunction::TranslateToBytecode()
+{
+    if (!m_MasterClass.empty() || m_block == nullptr) return;
+
+    CBotBytecode* code = CBotBytecode::Compile(m_block, m_param);
+    if (code != nullptr) m_block = code;
+}
+
 std::string CBotFunction::GetDebugData()
 {
     std::stringstream ss;
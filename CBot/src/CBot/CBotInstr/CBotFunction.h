@@ -59,6 +59,37 @@ public:
                                  CBotFunction* pFunc,
                                  bool bLocal = true);
 
+    /*!
+     * \brief Compiles the declaration of a function up to its body, first part of Compile()
+     *
+     * The parameters, "this" and the members of the class are added to \a pStk.
+     *
+     * \param p[in, out] First token of the function, updated to the opening brace of the body
+     * \param pStk Compile stack of the function
+     * \param func Function pre-compiled by Compile1()
+     * \return false in case of error, set on \a pStk
+     */
+    static bool CompileHeader(CBotToken* &p, CBotCStack* pStk, CBotFunction* func);
+
+    /*!
+     * \brief Compiles the body of a function, second part of Compile()
+     *
+     * The declaration must have been compiled by CompileHeader(), on the same stack or on a
+     * stack prepared by AddBodyVars(). The body only changes \a func, so the bodies of
+     * different functions can be compiled on different threads, see CBotProgram::CompileBatch().
+     *
+     * \param p[in, out] Opening brace of the body, updated to the first token after the function
+     * \param pStk Compile stack of the function
+     * \param func Function whose declaration was compiled
+     * \return false in case of error, set on \a pStk
+     */
+    static bool CompileBody(CBotToken* &p, CBotCStack* pStk, CBotFunction* func);
+
+    /*!
+     * \brief Adds to a new stack the variables that CompileHeader() adds for the body
+     */
+    static void AddBodyVars(CBotCStack* pStk, CBotFunction* func);
+
     /*!
      * \brief Pre-compile a new function
      * \param p[in, out] Pointer to first token of the function, will be updated to point to first token after the function definition
@@ -319,12 +350,21 @@ public:
      */
     bool HasReturn() override;
 
+    /*!
+     * \brief Replaces the body of the function with register bytecode when possible, see CBotBytecode.
+     * Methods of classes are not translated.
+     */
+    void TranslateToBytecode();
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotFunction"; }
     virtual std::string GetDebugData() override;
     virtual std::map<std::string, CBotInstr*> GetDebugLinks() override;
 
 private:
+    //! Sets the return type and adds "this" and the members of the class to the stack of the body
+    static void AddClassVars(CBotCStack* pStk, CBotFunction* func);
+
     friend class CBotDebug;
     long m_nFuncIdent;
     //! Synchronized method.
@@ -358,9 +398,6 @@ private:
     CBotToken m_openblk;
     CBotToken m_closeblk;
 
-    //! List of public functions
-    static std::set<CBotFunction*> m_publicFunctions;
-
     friend class CBotProgram;
     friend class CBotClass;
     friend class CBotCStack;
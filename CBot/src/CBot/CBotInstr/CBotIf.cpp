@@ -19,6 +19,7 @@
 
 #include "CBot/CBotInstr/CBotIf.h"
 #include "CBot/CBotInstr/CBotBlock.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotCondition.h"
 
 #include "CBot/CBotStack.h"
@@ -163,6 +164,29 @@ void CBotIf :: RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotIf::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    int labelElse = builder.NewLabel();
+    builder.AddTicks(1);
+    if (!builder.CompileCondition(m_condition, labelElse)) return false;
+    if (m_block != nullptr && !builder.CompileStatement(m_block)) return false;
+
+    if (m_blockElse != nullptr)
+    {
+        int labelEnd = builder.NewLabel();
+        builder.EmitJump(CBotOpcode::Jump, labelEnd);
+        builder.SetLabel(labelElse);
+        if (!builder.CompileStatement(m_blockElse)) return false;
+        builder.SetLabel(labelEnd);
+    }
+    else
+    {
+        builder.SetLabel(labelElse);
+    }
+    return true;
+}
+
 bool CBotIf::HasReturn()
 {
     if (m_block != nullptr && m_blockElse != nullptr)
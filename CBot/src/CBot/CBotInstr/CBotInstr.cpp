@@ -48,8 +48,8 @@ namespace CBot
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-int CBotInstr::m_LoopLvl = 0;
-std::vector<std::string> CBotInstr::m_labelLvl = std::vector<std::string>();
+thread_local int CBotInstr::m_LoopLvl = 0;
+thread_local std::vector<std::string> CBotInstr::m_labelLvl = std::vector<std::string>();
 
 ////////////////////////////////////////////////////////////////////////////////
 CBotInstr::CBotInstr()
@@ -367,6 +367,17 @@ bool CBotInstr::HasReturn()
     return false; // end of the list
 }
 
+bool CBotInstr::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    return false; // not supported by the bytecode
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotVar* CBotInstr::GetConstantValue()
+{
+    return nullptr; // not a constant
+}
+
 std::map<std::string, CBotInstr*> CBotInstr::GetDebugLinks()
 {
     return {
@@ -27,6 +27,7 @@
 namespace CBot
 {
 class CBotDebug;
+class CBotBytecodeBuilder;
 
 /**
  * \brief Class for one CBot instruction
@@ -276,6 +277,22 @@ public:
      */
     virtual bool HasReturn();
 
+    /**
+     * \brief Translates this instruction to register bytecode, see CBotBytecode
+     * \param builder Bytecode of the function being translated
+     * \param[out] reg Register holding the value of this expression, -1 if it has no value
+     * \return false if this instruction can't be translated, the function then keeps running on the instruction tree
+     */
+    virtual bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg);
+
+    /**
+     * \brief Returns the value of this instruction if it is a constant known at compile time
+     *
+     * Used to fold operations on constants during compilation.
+     * \return New variable with the value, to be deleted by the caller, or nullptr if the value isn't constant
+     */
+    virtual CBotVar* GetConstantValue();
+
 protected:
     friend class CBotDebug;
     /**
@@ -307,14 +324,14 @@ protected:
     CBotInstr* m_next3b;
 
     //! Counter of nested loops, to determine the break and continue valid.
-    static int m_LoopLvl;
+    static thread_local int m_LoopLvl;
     friend class CBotDefClass;
     friend class CBotDefInt;
     friend class CBotListArray;
 
 private:
     //! List of labels used.
-    static std::vector<std::string> m_labelLvl;
+    static thread_local std::vector<std::string> m_labelLvl;
 };
 
 } // namespace CBot
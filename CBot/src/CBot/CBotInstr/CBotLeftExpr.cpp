@@ -19,6 +19,7 @@
 
 #include <sstream>
 #include "CBot/CBotInstr/CBotLeftExpr.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotFieldExpr.h"
 #include "CBot/CBotInstr/CBotIndexExpr.h"
 #include "CBot/CBotInstr/CBotExpression.h"
@@ -254,4 +255,13 @@ std::string CBotLeftExpr::GetDebugData()
     return ss.str();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotLeftExpr::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    if (m_next3 != nullptr) return false;
+
+    reg = builder.GetVariable(m_nIdent);
+    return reg >= 0;
+}
+
 } // namespace CBot
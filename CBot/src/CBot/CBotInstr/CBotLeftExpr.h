@@ -90,6 +90,14 @@ public:
      */
     void RestoreStateVar(CBotStack* &pile, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotLeftExpr"; }
     virtual std::string GetDebugData() override;
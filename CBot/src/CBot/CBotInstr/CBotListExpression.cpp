@@ -17,6 +17,7 @@
  * along with this program. If not, see http://gnu.org/licenses
  */
 
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotDefBoolean.h"
 #include "CBot/CBotInstr/CBotDefFloat.h"
 #include "CBot/CBotInstr/CBotDefInt.h"
@@ -127,6 +128,18 @@ void CBotListExpression::RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotListExpression::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    for (CBotInstr* p = m_expr; p != nullptr; p = p->GetNext())
+    {
+        if (p != m_expr) builder.AddTicks(1);
+        if (!p->CompileBytecode(builder, reg)) return false;
+    }
+    reg = -1;
+    return true;
+}
+
 std::map<std::string, CBotInstr*> CBotListExpression::GetDebugLinks()
 {
     auto links = CBotInstr::GetDebugLinks();
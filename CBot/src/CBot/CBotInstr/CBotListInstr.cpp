@@ -19,6 +19,7 @@
 
 #include "CBot/CBotInstr/CBotListInstr.h"
 #include "CBot/CBotInstr/CBotBlock.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
@@ -117,6 +118,17 @@ void CBotListInstr::RestoreState(CBotStack* &pj, bool bMain)
     if (p != nullptr) p->RestoreState(pile, true);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotListInstr::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    for (CBotInstr* p = m_instr; p != nullptr; p = p->GetNext())
+    {
+        if (p != m_instr) builder.AddTicks(1);
+        if (!builder.CompileStatement(p)) return false;
+    }
+    return true;
+}
+
 bool CBotListInstr::HasReturn()
 {
     if (m_instr != nullptr && m_instr->HasReturn()) return true;
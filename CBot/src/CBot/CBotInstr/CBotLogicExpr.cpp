@@ -19,6 +19,8 @@
 
 #include "CBot/CBotInstr/CBotLogicExpr.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
+
 #include "CBot/CBotStack.h"
 
 namespace CBot
@@ -89,6 +91,27 @@ void CBotLogicExpr::RestoreState(CBotStack* &pStack, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotLogicExpr::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    int labelElse = builder.NewLabel();
+    int labelEnd = builder.NewLabel();
+    builder.AddTicks(1);
+    if (!builder.CompileCondition(m_condition, labelElse)) return false;
+
+    int value1, value2;
+    if (!builder.CompileValue(m_op1, value1)) return false;
+    reg = builder.AddTemp(builder.GetType(value1));
+    builder.Emit(CBotOpcode::Mov, reg, value1);
+    builder.EmitJump(CBotOpcode::Jump, labelEnd);
+
+    builder.SetLabel(labelElse);
+    if (!builder.CompileValue(m_op2, value2) || builder.GetType(value2) != builder.GetType(reg)) return false;
+    builder.Emit(CBotOpcode::Mov, reg, value2);
+    builder.SetLabel(labelEnd);
+    return true;
+}
+
 std::map<std::string, CBotInstr*> CBotLogicExpr::GetDebugLinks()
 {
     auto links = CBotInstr::GetDebugLinks();
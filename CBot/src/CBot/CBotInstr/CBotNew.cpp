@@ -23,6 +23,7 @@
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
 #include "CBot/CBotClass.h"
+#include "CBot/CBotInstanceHeap.h"
 
 #include "CBot/CBotInstr/CBotExprRetVar.h"
 #include "CBot/CBotInstr/CBotInstrUtils.h"
@@ -157,6 +158,11 @@ bool CBotNew::Execute(CBotStack* &pj)
         // create an instance of the requested class
         // and initialize the pointer to that object
 
+        if (CBotInstanceHeap::GetCurrent()->IsFull())
+        {
+            pile->SetError(CBotErrOutOfMemory, &m_vartoken);
+            return pj->Return(pile);
+        }
 
         pThis = CBotVar::Create("this", pClass);
         pThis->SetUniqNum(-2) ;
@@ -18,6 +18,7 @@
  */
 
 #include "CBot/CBotInstr/CBotPostIncExpr.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotExprVar.h"
 
 #include "CBot/CBotStack.h"
@@ -80,6 +81,26 @@ void CBotPostIncExpr::RestoreState(CBotStack* &pj, bool bMain)
     if (pile1 != nullptr) pile1->RestoreStack(this);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotPostIncExpr::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    CBotExprVar* expr = static_cast<CBotExprVar*>(m_instr);
+    if (expr->m_next3 != nullptr) return false;
+
+    int var = builder.GetVariable(expr->m_nIdent);
+    if (var < 0 || builder.GetType(var) == CBotTypBoolean) return false;
+
+    builder.CheckDefined(var, &m_token);
+    builder.AddTicks(1);
+    reg = builder.AddTemp(builder.GetType(var));
+    builder.Emit(CBotOpcode::Mov, reg, var);            // the result is the value before incrementation
+
+    bool isInt = builder.GetType(var) == CBotTypInt;
+    if (GetTokenType() == ID_INC) builder.Emit(isInt ? CBotOpcode::IncInt : CBotOpcode::IncFloat, var);
+    else                          builder.Emit(isInt ? CBotOpcode::DecInt : CBotOpcode::DecFloat, var);
+    return true;
+}
+
 std::map<std::string, CBotInstr*> CBotPostIncExpr::GetDebugLinks()
 {
     auto links = CBotInstr::GetDebugLinks();
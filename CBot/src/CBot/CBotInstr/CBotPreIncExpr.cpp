@@ -18,6 +18,7 @@
  */
 
 #include "CBot/CBotInstr/CBotPreIncExpr.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotExprVar.h"
 
 #include "CBot/CBotStack.h"
@@ -87,6 +88,23 @@ void CBotPreIncExpr::RestoreState(CBotStack* &pj, bool bMain)
     m_instr->RestoreState(pile, bMain);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotPreIncExpr::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    CBotExprVar* expr = static_cast<CBotExprVar*>(m_instr);
+    if (expr->m_next3 != nullptr) return false;
+
+    reg = builder.GetVariable(expr->m_nIdent);
+    if (reg < 0 || builder.GetType(reg) == CBotTypBoolean) return false;
+
+    builder.CheckDefined(reg, &m_token);
+    builder.AddTicks(2);                                // the incrementation, then reading the variable
+    bool isInt = builder.GetType(reg) == CBotTypInt;
+    if (GetTokenType() == ID_INC) builder.Emit(isInt ? CBotOpcode::IncInt : CBotOpcode::IncFloat, reg);
+    else                          builder.Emit(isInt ? CBotOpcode::DecInt : CBotOpcode::DecFloat, reg);
+    return true;
+}
+
 std::map<std::string, CBotInstr*> CBotPreIncExpr::GetDebugLinks()
 {
     auto links = CBotInstr::GetDebugLinks();
@@ -19,6 +19,7 @@
 
 #include "CBot/CBotInstr/CBotReturn.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotInstrUtils.h"
 
 #include "CBot/CBotInstr/CBotExpression.h"
@@ -111,6 +112,22 @@ void CBotReturn::RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotReturn::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    builder.AddTicks(1);
+    if (m_instr == nullptr)
+    {
+        builder.Emit(CBotOpcode::ReturnVoid);
+        return true;
+    }
+
+    int value;
+    if (!builder.CompileValue(m_instr, value)) return false;
+    builder.Emit(CBotOpcode::Return, 0, value, builder.GetType(value));
+    return true;
+}
+
 bool CBotReturn::HasReturn()
 {
     return true;
@@ -61,6 +61,14 @@ public:
      */
     bool HasReturn() override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotReturn"; }
     virtual std::map<std::string, CBotInstr*> GetDebugLinks() override;
@@ -19,6 +19,8 @@
 
 #include "CBot/CBotInstr/CBotTwoOpExpr.h"
 
+#include "CBot/CBotInstr/CBotBytecode.h"
+#include "CBot/CBotInstr/CBotExprLitNum.h"
 #include "CBot/CBotInstr/CBotInstrUtils.h"
 
 #include "CBot/CBotInstr/CBotParExpr.h"
@@ -33,6 +35,7 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <memory>
 
 namespace CBot
 {
@@ -134,6 +137,15 @@ static bool TypeOk(int type, int test)
     }
 }
 
+// type of the operands if they are both int, float or bool (see CBotTwoOpExpr::m_typeOp)
+static CBotType GetSimpleType(const CBotTypResult& type1, const CBotTypResult& type2)
+{
+    int type = type1.GetType();
+    if ( type != type2.GetType() ) return CBotTypVoid;
+    if ( type != CBotTypInt && type != CBotTypFloat && type != CBotTypBoolean ) return CBotTypVoid;
+    return static_cast<CBotType>(type);
+}
+
 CBotInstr* CBotTwoOpExpr::Compile(CBotToken* &p, CBotCStack* pStack, int* pOperations, bool bConstExpr)
 {
     int typeMask;
@@ -253,6 +265,8 @@ CBotInstr* CBotTwoOpExpr::Compile(CBotToken* &p, CBotCStack* pStack, int* pOpera
             {
                 // ok so, saves the operand in the object
                 inst->m_leftop = left;
+                inst->m_typeOp = GetSimpleType(type1, type2);
+                CBotInstr* result = FoldConstants(inst);
 
                 // special for evaluation of the operations of the same level from left to right
                 while ( IsInList(p->GetType(), pOperations, typeMask) ) // same operation(s) follows?
@@ -260,7 +274,7 @@ CBotInstr* CBotTwoOpExpr::Compile(CBotToken* &p, CBotCStack* pStack, int* pOpera
                     typeOp = p->GetType();
                     CBotTwoOpExpr* i = new CBotTwoOpExpr();             // element for operation
                     i->SetToken(p);                                     // stores the operation
-                    i->m_leftop = inst;                                 // left operand
+                    i->m_leftop = result;                               // left operand
                     type1 = TypeRes;
 
                     p = p->GetNext();                                       // advance after
@@ -274,9 +288,10 @@ CBotInstr* CBotTwoOpExpr::Compile(CBotToken* &p, CBotCStack* pStack, int* pOpera
                         return pStack->Return(nullptr, pStk);
                     }
 
+                    i->m_typeOp = GetSimpleType(type1, type2);
                     if ( TypeRes != CBotTypString )                     // keep string conversion
                         TypeRes = std::max(type1.GetType(), type2.GetType());
-                    inst = i;
+                    result = FoldConstants(i);
                 }
 
                 CBotTypResult t(type1);
@@ -285,7 +300,7 @@ CBotInstr* CBotTwoOpExpr::Compile(CBotToken* &p, CBotCStack* pStack, int* pOpera
                 pStk->SetVar(CBotVar::Create("", t));
 
                 // and returns the requested object
-                return pStack->Return(inst, pStk);
+                return pStack->Return(result, pStk);
             }
             pStk->SetError(CBotErrBadType2, &inst->m_token);
         }
@@ -326,72 +341,24 @@ static bool IsNan(CBotVar* left, CBotVar* right, CBotError* err = nullptr)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool CBotTwoOpExpr::Execute(CBotStack* &pStack)
+// performs the operation with the CBotVar methods, for any type of operands
+static CBotVar* ExecuteOperation(int op, CBotVar* left, CBotVar* right, CBotError& err)
 {
-    CBotStack* pStk1 = pStack->AddStack(this);  // adds an item to the stack
-                                                // or return in case of recovery
-//  if ( pStk1 == EOX ) return true;
-
-    // according to recovery, it may be in one of two states
-
-    if ( pStk1->GetState() == 0 )                   // first state, evaluates the left operand
-    {
-        if (!m_leftop->Execute(pStk1) ) return false;   // interrupted here?
-
-        // for OR and AND logic does not evaluate the second expression if not necessary
-        if ( (GetTokenType() == ID_LOG_AND || GetTokenType() == ID_TXT_AND ) && pStk1->GetVal() == false )
-        {
-            CBotVar*    res = CBotVar::Create("", CBotTypBoolean);
-            res->SetValInt(false);
-            pStk1->SetVar(res);
-            return pStack->Return(pStk1);               // transmits the result
-        }
-        if ( (GetTokenType() == ID_LOG_OR||GetTokenType() == ID_TXT_OR) && pStk1->GetVal() == true )
-        {
-            CBotVar*    res = CBotVar::Create("", CBotTypBoolean);
-            res->SetValInt(true);
-            pStk1->SetVar(res);
-            return pStack->Return(pStk1);               // transmits the result
-        }
-
-        // passes to the next step
-        pStk1->SetState(1);         // ready for further
-    }
-
-
-    // requires a little more stack to avoid touching the result
-    // of which is left on the stack, precisely
-
-    CBotStack* pStk2 = pStk1->AddStack();               // adds an item to the stack
-                                                        // or return in case of recovery
-    if (pStk2->StackOver()) return pStack->Return(pStk2);
-
-    // 2nd state, evalute right operand
-    if ( pStk2->GetState() == 0 )
-    {
-        if ( !m_rightop->Execute(pStk2) ) return false;     // interrupted here?
-        pStk2->IncState();
-    }
-
-    assert(pStk1->GetVar() != nullptr && pStk2->GetVar() != nullptr);
-    CBotTypResult       type1 = pStk1->GetVar()->GetTypResult();      // what kind of results?
-    CBotTypResult       type2 = pStk2->GetVar()->GetTypResult();
-
-    CBotStack* pStk3 = pStk2->AddStack(this);               // adds an item to the stack
-    if ( pStk3->IfStep() ) return false;                    // shows the operation if step by step
+    CBotTypResult       type1 = left->GetTypResult();      // what kind of results?
+    CBotTypResult       type2 = right->GetTypResult();
 
     // creates a temporary variable to put the result
     // what kind of result?
     int TypeRes = std::max(type1.GetType(), type2.GetType());
 
     // see "any type convertible chain" in compile method
-    if ( GetTokenType() == ID_ADD &&
+    if ( op == ID_ADD &&
         (type1.Eq(CBotTypString) || type2.Eq(CBotTypString)) )
     {
         TypeRes = CBotTypString;
     }
 
-    switch ( GetTokenType() )
+    switch ( op )
     {
     case ID_LOG_OR:
     case ID_LOG_AND:
@@ -415,10 +382,6 @@ bool CBotTwoOpExpr::Execute(CBotStack* &pStack)
     // creates a variable for the result
     CBotVar*    result = CBotVar::Create("", TypeRes);
 
-    // get left and right operands
-    CBotVar*    left  = pStk1->GetVar();
-    CBotVar*    right = pStk2->GetVar();
-
     // creates a variable to perform the calculation in the appropriate type
     if ( TypeRes != CBotTypString )                                     // keep string conversion
     {
@@ -430,7 +393,7 @@ bool CBotTwoOpExpr::Execute(CBotStack* &pStack)
         right->Update(nullptr);
     }
 
-    if ( GetTokenType() == ID_ADD && type1.Eq(CBotTypString) )
+    if ( op == ID_ADD && type1.Eq(CBotTypString) )
     {
         TypeRes = CBotTypString;
     }
@@ -441,10 +404,9 @@ bool CBotTwoOpExpr::Execute(CBotStack* &pStack)
     if ( TypeRes == CBotTypClass ) temp = CBotVar::Create("", CBotTypResult(CBotTypIntrinsic, type1.GetClass() ) );
     else                           temp = CBotVar::Create("", TypeRes );
 
-    CBotError err = CBotNoErr;
     // is a operation according to request
 
-    switch (GetTokenType())
+    switch (op)
     {
     case ID_ADD:
         if ( !IsNan(left, right, &err) )    result->Add(left , right);      // addition
@@ -519,6 +481,237 @@ bool CBotTwoOpExpr::Execute(CBotStack* &pStack)
     }
     delete temp;
 
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// operation on two int, without the temporary variables of ExecuteOperation()
+static CBotVar* ExecuteInt(int op, int left, int right, CBotError& err)
+{
+    CBotVar* result = CBotVar::Create("", CBotTypInt);
+    switch (op)
+    {
+    case ID_ADD:    result->SetValInt(left + right); break;
+    case ID_SUB:    result->SetValInt(left - right); break;
+    case ID_MUL:    result->SetValInt(left * right); break;
+    case ID_POWER:  result->SetValInt(static_cast<int>(pow(left, right))); break;
+    case ID_DIV:
+        if (right == 0) err = CBotErrZeroDiv;
+        else            result->SetValInt(left / right);
+        break;
+    case ID_MODULO:
+        if (right == 0) err = CBotErrZeroDiv;
+        else            result->SetValInt(left % right);
+        break;
+    case ID_AND:    result->SetValInt(left & right); break;
+    case ID_OR:     result->SetValInt(left | right); break;
+    case ID_XOR:    result->SetValInt(left ^ right); break;
+    case ID_SL:     result->SetValInt(left << right); break;
+    case ID_ASR:    result->SetValInt(left >> right); break;
+    case ID_SR:     result->SetValInt(static_cast<unsigned>(left) >> right); break;
+    default:
+        delete result;
+        result = CBotVar::Create("", CBotTypBoolean);
+        switch (op)
+        {
+        case ID_LO: result->SetValInt(left <  right); break;
+        case ID_HI: result->SetValInt(left >  right); break;
+        case ID_LS: result->SetValInt(left <= right); break;
+        case ID_HS: result->SetValInt(left >= right); break;
+        case ID_EQ: result->SetValInt(left == right); break;
+        case ID_NE: result->SetValInt(left != right); break;
+        default:
+            delete result;
+            return nullptr;
+        }
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// operation on two float, without the temporary variables of ExecuteOperation()
+static CBotVar* ExecuteFloat(int op, float left, float right, CBotError& err)
+{
+    bool nan = std::isnan(left) || std::isnan(right);
+    CBotVar* result = nullptr;
+    switch (op)
+    {
+    case ID_ADD:
+    case ID_SUB:
+    case ID_MUL:
+    case ID_POWER:
+    case ID_DIV:
+    case ID_MODULO:
+        result = CBotVar::Create("", CBotTypFloat);
+        if (nan)
+        {
+            err = CBotErrNan;
+            break;
+        }
+        switch (op)
+        {
+        case ID_ADD:    result->SetValFloat(left + right); break;
+        case ID_SUB:    result->SetValFloat(left - right); break;
+        case ID_MUL:    result->SetValFloat(left * right); break;
+        case ID_POWER:  result->SetValFloat(pow(left, right)); break;
+        case ID_DIV:
+            if (right == 0) err = CBotErrZeroDiv;
+            else            result->SetValFloat(left / right);
+            break;
+        case ID_MODULO:
+            if (right == 0) err = CBotErrZeroDiv;
+            else            result->SetValFloat(fmod(left, right));
+            break;
+        }
+        break;
+    case ID_EQ:
+    case ID_NE:
+        result = CBotVar::Create("", CBotTypBoolean);
+        if (nan) result->SetValInt((std::isnan(left) == std::isnan(right)) == (op == ID_EQ));
+        else     result->SetValInt((left == right) == (op == ID_EQ));
+        break;
+    case ID_LO:
+    case ID_HI:
+    case ID_LS:
+    case ID_HS:
+        result = CBotVar::Create("", CBotTypBoolean);
+        if (nan)
+        {
+            err = CBotErrNan;
+            break;
+        }
+        switch (op)
+        {
+        case ID_LO: result->SetValInt(left <  right); break;
+        case ID_HI: result->SetValInt(left >  right); break;
+        case ID_LS: result->SetValInt(left <= right); break;
+        case ID_HS: result->SetValInt(left >= right); break;
+        }
+        break;
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// operation on two bool, without the temporary variables of ExecuteOperation()
+static CBotVar* ExecuteBool(int op, bool left, bool right)
+{
+    CBotVar* result = CBotVar::Create("", CBotTypBoolean);
+    switch (op)
+    {
+    case ID_TXT_AND:
+    case ID_LOG_AND:
+    case ID_AND:    result->SetValInt(left && right); break;
+    case ID_TXT_OR:
+    case ID_LOG_OR:
+    case ID_OR:     result->SetValInt(left || right); break;
+    case ID_XOR:    result->SetValInt(left != right); break;
+    case ID_EQ:     result->SetValInt(left == right); break;
+    case ID_NE:     result->SetValInt(left != right); break;
+    default:
+        delete result;
+        return nullptr;
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotInstr* CBotTwoOpExpr::FoldConstants(CBotTwoOpExpr* inst)
+{
+    std::unique_ptr<CBotVar> left(inst->m_leftop->GetConstantValue());
+    if (left == nullptr) return inst;
+    std::unique_ptr<CBotVar> right(inst->m_rightop->GetConstantValue());
+    if (right == nullptr) return inst;
+
+    CBotError err = CBotNoErr;
+    std::unique_ptr<CBotVar> result(ExecuteOperation(inst->GetTokenType(), left.get(), right.get(), err));
+    if (err != CBotNoErr) return inst;                  // the error is reported during execution
+
+    CBotInstr* literal = CreateLiteral(result.get(), &inst->m_token);
+    if (literal == nullptr) return inst;
+
+    delete inst;
+    return literal;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotTwoOpExpr::Execute(CBotStack* &pStack)
+{
+    CBotStack* pStk1 = pStack->AddStack(this);  // adds an item to the stack
+                                                // or return in case of recovery
+//  if ( pStk1 == EOX ) return true;
+
+    // according to recovery, it may be in one of two states
+
+    if ( pStk1->GetState() == 0 )                   // first state, evaluates the left operand
+    {
+        if (!m_leftop->Execute(pStk1) ) return false;   // interrupted here?
+
+        // for OR and AND logic does not evaluate the second expression if not necessary
+        if ( (GetTokenType() == ID_LOG_AND || GetTokenType() == ID_TXT_AND ) && pStk1->GetVal() == false )
+        {
+            CBotVar*    res = CBotVar::Create("", CBotTypBoolean);
+            res->SetValInt(false);
+            pStk1->SetVar(res);
+            return pStack->Return(pStk1);               // transmits the result
+        }
+        if ( (GetTokenType() == ID_LOG_OR||GetTokenType() == ID_TXT_OR) && pStk1->GetVal() == true )
+        {
+            CBotVar*    res = CBotVar::Create("", CBotTypBoolean);
+            res->SetValInt(true);
+            pStk1->SetVar(res);
+            return pStack->Return(pStk1);               // transmits the result
+        }
+
+        // passes to the next step
+        pStk1->SetState(1);         // ready for further
+    }
+
+
+    // requires a little more stack to avoid touching the result
+    // of which is left on the stack, precisely
+
+    CBotStack* pStk2 = pStk1->AddStack();               // adds an item to the stack
+                                                        // or return in case of recovery
+    if (pStk2->StackOver()) return pStack->Return(pStk2);
+
+    // 2nd state, evalute right operand
+    if ( pStk2->GetState() == 0 )
+    {
+        if ( !m_rightop->Execute(pStk2) ) return false;     // interrupted here?
+        pStk2->IncState();
+    }
+
+    assert(pStk1->GetVar() != nullptr && pStk2->GetVar() != nullptr);
+
+    CBotStack* pStk3 = pStk2->AddStack(this);               // adds an item to the stack
+    if ( pStk3->IfStep() ) return false;                    // shows the operation if step by step
+
+    // get left and right operands
+    CBotVar*    left  = pStk1->GetVar();
+    CBotVar*    right = pStk2->GetVar();
+
+    CBotError err = CBotNoErr;
+    CBotVar*    result = nullptr;
+
+    // operands of a type known during compilation can be computed directly
+    if ( m_typeOp != CBotTypVoid && left->GetType() == m_typeOp && right->GetType() == m_typeOp )
+    {
+        switch ( m_typeOp )
+        {
+        case CBotTypInt:
+            result = ExecuteInt(GetTokenType(), left->GetValInt(), right->GetValInt(), err);
+            break;
+        case CBotTypFloat:
+            result = ExecuteFloat(GetTokenType(), left->GetValFloat(), right->GetValFloat(), err);
+            break;
+        default:
+            result = ExecuteBool(GetTokenType(), left->GetValInt() != 0, right->GetValInt() != 0);
+            break;
+        }
+    }
+    if ( result == nullptr ) result = ExecuteOperation(GetTokenType(), left, right, err);
+
     pStk2->SetVar(result);                      // puts the result on the stack
     if ( err ) pStk2->SetError(err, &m_token);  // and the possible error (division by zero)
 
@@ -551,6 +744,54 @@ void CBotTwoOpExpr::RestoreState(CBotStack* &pStack, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotTwoOpExpr::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    int left, right;
+    int type = GetTokenType();
+
+    if (type == ID_LOG_AND || type == ID_TXT_AND || type == ID_LOG_OR || type == ID_TXT_OR)
+    {
+        // the second operand is evaluated only if necessary
+        if (!builder.CompileValue(m_leftop, left) || builder.GetType(left) != CBotTypBoolean) return false;
+        reg = builder.AddTemp(CBotTypBoolean);
+        builder.Emit(CBotOpcode::Mov, reg, left);
+        int end = builder.NewLabel();
+        bool isAnd = type == ID_LOG_AND || type == ID_TXT_AND;
+        builder.EmitJump(isAnd ? CBotOpcode::JumpIfFalse : CBotOpcode::JumpIfTrue, end, reg);
+        builder.AddTicks(2);
+        if (!builder.CompileValue(m_rightop, right) || builder.GetType(right) != CBotTypBoolean) return false;
+        builder.Emit(CBotOpcode::Mov, reg, right);
+        builder.SetLabel(end);
+        return true;
+    }
+
+    if (!builder.CompileValue(m_leftop, left)) return false;
+    if (!builder.CompileRight(left, m_rightop, right)) return false;
+
+    CBotType type1 = builder.GetType(left);
+    CBotType type2 = builder.GetType(right);
+    if ((type1 == CBotTypBoolean) != (type2 == CBotTypBoolean)) return false;
+
+    // the operation is done in the larger type of both operands
+    CBotType typeOp = std::max(type1, type2);
+    left = builder.Convert(left, typeOp);
+    right = builder.Convert(right, typeOp);
+
+    CBotOpcode code;
+    if (!builder.GetOperation(type, typeOp, code)) return false;
+
+    int token = builder.AddToken(&m_token);
+    builder.AddTicks(2);
+    if (typeOp == CBotTypFloat && type != ID_EQ && type != ID_NE)
+        builder.Emit(CBotOpcode::CheckNan, 0, left, right, token);
+
+    bool isCompare = type == ID_LO || type == ID_HI || type == ID_LS || type == ID_HS || type == ID_EQ || type == ID_NE;
+    reg = builder.AddTemp(isCompare ? CBotTypBoolean : typeOp);
+    builder.Emit(code, reg, left, right, token);
+    return true;
+}
+
 std::string CBotTwoOpExpr::GetDebugData()
 {
     return m_token.GetString();
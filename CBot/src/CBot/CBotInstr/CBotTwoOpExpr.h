@@ -81,16 +81,33 @@ public:
      */
     void RestoreState(CBotStack* &pj, bool bMain) override;
 
+    /*!
+     * \brief CompileBytecode
+     * \param builder
+     * \param reg
+     * \return
+     */
+    bool CompileBytecode(CBotBytecodeBuilder& builder, int& reg) override;
+
 protected:
     virtual const std::string GetDebugName() override { return "CBotTwoOpExpr"; }
     virtual std::string GetDebugData() override;
     virtual std::map<std::string, CBotInstr*> GetDebugLinks() override;
 
 private:
+    /*!
+     * \brief Replaces an operation on two constants by a literal with its result
+     * \param inst Operation, deleted if it is replaced
+     * \return The literal, or inst if the result can't be computed during compilation
+     */
+    static CBotInstr* FoldConstants(CBotTwoOpExpr* inst);
+
     //! Left element
     CBotInstr* m_leftop;
     //! Right element
     CBotInstr* m_rightop;
+    //! Type of both operands if they are int, float or bool, CBotTypVoid otherwise
+    CBotType m_typeOp = CBotTypVoid;
 };
 
 } // namespace CBot
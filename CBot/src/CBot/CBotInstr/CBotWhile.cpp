@@ -19,6 +19,7 @@
 
 #include "CBot/CBotInstr/CBotWhile.h"
 #include "CBot/CBotInstr/CBotBlock.h"
+#include "CBot/CBotInstr/CBotBytecode.h"
 #include "CBot/CBotInstr/CBotCondition.h"
 
 #include "CBot/CBotStack.h"
@@ -148,6 +149,30 @@ void CBotWhile::RestoreState(CBotStack* &pj, bool bMain)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool CBotWhile::CompileBytecode(CBotBytecodeBuilder& builder, int& reg)
+{
+    if (!m_label.empty()) return false;
+
+    int labelTest = builder.NewLabel();
+    int labelContinue = builder.NewLabel();
+    int labelEnd = builder.NewLabel();
+
+    builder.SetLabel(labelTest);
+    if (!builder.CompileCondition(m_condition, labelEnd)) return false;
+    builder.AddTicks(1);
+
+    builder.EnterLoop(labelEnd, labelContinue);
+    if (m_block != nullptr && !builder.CompileStatement(m_block)) return false;
+    builder.LeaveLoop();
+
+    builder.AddTicks(1);                                // not taken by continue, like in Execute()
+    builder.SetLabel(labelContinue);
+    builder.EmitLoop(labelTest);
+    builder.SetLabel(labelEnd);
+    return true;
+}
+
 std::string CBotWhile::GetDebugData()
 {
     return !m_label.empty() ? "m_label = "+m_label : "";
@@ -0,0 +1,288 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotNumberConversion.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+namespace CBot
+{
+
+namespace
+{
+
+// white space in the classic locale
+bool IsSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+std::string_view SkipSpaces(std::string_view str)
+{
+    std::size_t i = 0;
+    while (i < str.size() && IsSpace(str[i])) i++;
+    return str.substr(i);
+}
+
+template<typename T>
+std::string IntegerToString(T value)
+{
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, result.ptr);
+}
+
+template<typename T>
+std::string FloatToString(T value)
+{
+    char buffer[32];
+#if defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    return std::string(buffer, result.ptr);
+#else
+    // floating point std::to_chars() isn't available in all standard libraries yet
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", static_cast<double>(value));
+    return std::string(buffer, length);
+#endif
+}
+
+// optional sign and decimal digits, like std::num_get
+template<typename T>
+T ReadInteger(std::string_view str)
+{
+    str = SkipSpaces(str);
+
+    bool negative = false;
+    if (!str.empty() && (str[0] == '+' || str[0] == '-'))
+    {
+        negative = str[0] == '-';
+        str.remove_prefix(1);
+    }
+
+    unsigned long long magnitude = 0;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), magnitude);
+    if (result.ptr == str.data()) return 0;
+
+    const unsigned long long max = std::numeric_limits<T>::max();
+    bool overflow = result.ec == std::errc::result_out_of_range;
+
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (negative)
+        {
+            if (overflow || magnitude > max) return std::numeric_limits<T>::min();
+            return -static_cast<T>(magnitude);
+        }
+    }
+
+    if (overflow || magnitude > max) return std::numeric_limits<T>::max();
+    if (negative) return static_cast<T>(0 - static_cast<T>(magnitude)); // unsigned, wraps around like strtoul()
+    return static_cast<T>(magnitude);
+}
+
+// characters std::num_get takes for a floating point number: sign, digits with a decimal point, exponent
+std::string_view FloatToken(std::string_view str)
+{
+    std::size_t i = 0;
+    if (i < str.size() && (str[i] == '+' || str[i] == '-')) i++;
+
+    bool mantissa = false;
+    bool point = false;
+    for (; i < str.size(); i++)
+    {
+        if (IsDigit(str[i])) mantissa = true;
+        else if (str[i] == '.' && !point) point = true;
+        else break;
+    }
+
+    if (mantissa && i < str.size() && (str[i] == 'e' || str[i] == 'E'))
+    {
+        i++;
+        if (i < str.size() && (str[i] == '+' || str[i] == '-')) i++;
+        while (i < str.size() && IsDigit(str[i])) i++;
+    }
+    return str.substr(0, i);
+}
+
+// for a number out of range, tells if it is too large (true) or too close to zero (false)
+bool IsLarge(std::string_view token)
+{
+    // position of the first significant digit relative to the decimal point
+    long long position = 0;
+    bool significant = false;
+    bool point = false;
+    std::size_t i = 0;
+    for (; i < token.size() && token[i] != 'e' && token[i] != 'E'; i++)
+    {
+        if (token[i] == '.') point = true;
+        else if (IsDigit(token[i]))
+        {
+            if (token[i] != '0') significant = true;
+            if (!point && significant) position++;
+            if (point && !significant) position--;
+        }
+    }
+
+    long long exponent = 0;
+    if (i < token.size())
+    {
+        std::string_view digits = token.substr(i + 1);
+        bool negative = !digits.empty() && digits[0] == '-';
+        if (!digits.empty() && (digits[0] == '-' || digits[0] == '+')) digits.remove_prefix(1);
+        if (std::from_chars(digits.data(), digits.data() + digits.size(), exponent).ec == std::errc::result_out_of_range)
+            return !negative;
+        if (negative) exponent = -exponent;
+    }
+    return position + exponent > 0;
+}
+
+template<typename T>
+T ReadFloat(std::string_view str)
+{
+    std::string_view token = FloatToken(SkipSpaces(str));
+    if (!token.empty() && token[0] == '+') token.remove_prefix(1);
+    if (token.empty()) return 0;
+
+    bool negative = token[0] == '-';
+    const T max = std::numeric_limits<T>::max();
+
+#if defined(__cpp_lib_to_chars)
+    T value = 0;
+    auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ptr != token.data() + token.size()) return 0;
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        if (IsLarge(token)) return negative ? -max : max;
+        if constexpr (std::is_same_v<T, float>)
+        {
+            // the closest float may still be a denormal number
+            double closer = 0;
+            if (std::from_chars(token.data(), token.data() + token.size(), closer).ec == std::errc{})
+                return static_cast<float>(closer);
+        }
+        return negative ? -static_cast<T>(0) : static_cast<T>(0);
+    }
+    return value;
+#else
+    // floating point std::from_chars() isn't available in all standard libraries yet
+    std::string copy(token);
+    char* end = nullptr;
+    double value = std::strtod(copy.c_str(), &end);
+    if (end != copy.c_str() + copy.size()) return 0;
+    if (value > max) return max;
+    if (value < -max) return -max;
+    return static_cast<T>(value);
+#endif
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+std::string NumberToString(bool value)
+{
+    return value ? "true" : "false";
+}
+
+std::string NumberToString(signed char value)
+{
+    return std::string(1, static_cast<char>(value));
+}
+
+std::string NumberToString(short value)
+{
+    return IntegerToString(value);
+}
+
+std::string NumberToString(uint32_t value)
+{
+    return IntegerToString(value);
+}
+
+std::string NumberToString(int value)
+{
+    return IntegerToString(value);
+}
+
+std::string NumberToString(long value)
+{
+    return IntegerToString(value);
+}
+
+std::string NumberToString(float value)
+{
+    return FloatToString(value);
+}
+
+std::string NumberToString(double value)
+{
+    return FloatToString(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StringToNumber(std::string_view str, bool& value)
+{
+    value = ReadInteger<long>(str) != 0;
+}
+
+void StringToNumber(std::string_view str, signed char& value)
+{
+    str = SkipSpaces(str);
+    if (!str.empty()) value = static_cast<signed char>(str[0]);
+}
+
+void StringToNumber(std::string_view str, short& value)
+{
+    value = ReadInteger<short>(str);
+}
+
+void StringToNumber(std::string_view str, uint32_t& value)
+{
+    value = ReadInteger<uint32_t>(str);
+}
+
+void StringToNumber(std::string_view str, int& value)
+{
+    value = ReadInteger<int>(str);
+}
+
+void StringToNumber(std::string_view str, long& value)
+{
+    value = ReadInteger<long>(str);
+}
+
+void StringToNumber(std::string_view str, float& value)
+{
+    value = ReadFloat<float>(str);
+}
+
+void StringToNumber(std::string_view str, double& value)
+{
+    value = ReadFloat<double>(str);
+}
+
+} // namespace CBot
@@ -0,0 +1,66 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace CBot
+{
+
+/**
+ * \name Conversions between numbers and strings
+ *
+ * Used for the values of variables (see CBotVar::GetValString() and CBotVar::SetValString()).
+ * The results are the same as writing or reading the value with a stream in the classic locale,
+ * which was used before, without creating a stream for each conversion:
+ * - floating point numbers are written like printf("%g"), with 6 significant digits,
+ * - booleans are written as "true" or "false" but read as integers (0 is false, everything else is true),
+ * - byte values are written and read as a single character,
+ * - reading skips leading white space and stops at the first character which can't be part of the number,
+ *   a string which doesn't start with a number gives 0,
+ * - numbers out of range are clamped to the limits of the type, except for negative numbers read
+ *   into unsigned types which wrap around.
+ */
+//@{
+
+std::string NumberToString(bool value);
+std::string NumberToString(signed char value);
+std::string NumberToString(short value);
+std::string NumberToString(uint32_t value);
+std::string NumberToString(int value);
+std::string NumberToString(long value);
+std::string NumberToString(float value);
+std::string NumberToString(double value);
+
+void StringToNumber(std::string_view str, bool& value);
+//! \note value is unchanged if str has no character other than white space
+void StringToNumber(std::string_view str, signed char& value);
+void StringToNumber(std::string_view str, short& value);
+void StringToNumber(std::string_view str, uint32_t& value);
+void StringToNumber(std::string_view str, int& value);
+void StringToNumber(std::string_view str, long& value);
+void StringToNumber(std::string_view str, float& value);
+void StringToNumber(std::string_view str, double& value);
+
+//@}
+
+} // namespace CBot
@@ -0,0 +1,257 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "CBot/CBotProfiler.h"
+
+#include "CBot/CBotStack.h"
+#include "CBot/CBotToken.h"
+
+#include "CBot/CBotInstr/CBotFunction.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace CBot
+{
+
+namespace
+{
+
+std::vector<CBotProfileEntry> SortEntries(std::vector<CBotProfileEntry> entries, bool byTime)
+{
+    std::stable_sort(entries.begin(), entries.end(), [byTime](const CBotProfileEntry& a, const CBotProfileEntry& b)
+    {
+        if (byTime) return a.seconds > b.seconds;
+        if (a.ticks != b.ticks) return a.ticks > b.ticks;
+        return a.seconds > b.seconds;
+    });
+    return entries;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+CBotProfiler::CBotProfiler(int interval)
+{
+    SetInterval(interval);
+    m_last = Clock::now();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotProfiler::~CBotProfiler()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotProfiler::SetInterval(int interval)
+{
+    m_interval = std::max(interval, 1);
+}
+
+int CBotProfiler::GetInterval()
+{
+    return m_interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotProfiler::Clear()
+{
+    m_ticks = 0;
+    m_seconds = 0.0;
+    m_functions.clear();
+    m_ranges.clear();
+    m_externalCalls.clear();
+    m_stacks.clear();
+    m_excluded = 0.0;
+}
+
+long CBotProfiler::GetTicks()
+{
+    return m_ticks;
+}
+
+double CBotProfiler::GetSeconds()
+{
+    return m_seconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<CBotProfileEntry> CBotProfiler::GetFunctions()
+{
+    std::vector<CBotProfileEntry> entries;
+    for (const auto& it : m_functions)
+    {
+        CBotProfileEntry entry;
+        entry.name = it.first;
+        entry.ticks = it.second.ticks;
+        entry.seconds = it.second.seconds;
+        entry.count = it.second.count;
+        entries.push_back(entry);
+    }
+    return SortEntries(std::move(entries), false);
+}
+
+std::vector<CBotProfileEntry> CBotProfiler::GetRanges()
+{
+    std::vector<CBotProfileEntry> entries;
+    for (const auto& it : m_ranges)
+    {
+        CBotProfileEntry entry;
+        entry.name = it.second.function;
+        entry.program = std::get<0>(it.first);
+        entry.start = std::get<1>(it.first);
+        entry.end = std::get<2>(it.first);
+        entry.ticks = it.second.counter.ticks;
+        entry.seconds = it.second.counter.seconds;
+        entry.count = it.second.counter.count;
+        entries.push_back(entry);
+    }
+    return SortEntries(std::move(entries), false);
+}
+
+std::vector<CBotProfileEntry> CBotProfiler::GetExternalCalls()
+{
+    std::vector<CBotProfileEntry> entries;
+    for (const auto& it : m_externalCalls)
+    {
+        CBotProfileEntry entry;
+        entry.name = it.first;
+        entry.ticks = it.second.ticks;
+        entry.seconds = it.second.seconds;
+        entry.count = it.second.count;
+        entries.push_back(entry);
+    }
+    return SortEntries(std::move(entries), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CBotProfiler::WriteCollapsed(std::ostream& ostr, bool wallTime)
+{
+    for (const auto& it : m_stacks)
+    {
+        long long weight = wallTime ? std::llround(it.second.seconds * 1e6) : it.second.ticks;
+        if (weight <= 0) continue;
+        ostr << it.first << ' ' << weight << '\n';
+    }
+    return ostr.good();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotProfiler::Begin()
+{
+    m_last = Clock::now();
+    m_excluded = 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotProfiler::Sample(CBotStack* pile, int ticks)
+{
+    Clock::time_point now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - m_last).count() - m_excluded;
+    if (seconds < 0.0) seconds = 0.0;
+    m_last = now;
+    m_excluded = 0.0;
+
+    m_ticks += ticks;
+    m_seconds += seconds;
+
+    CBotStack* running = ReadStack(pile);
+    if (m_frames.empty()) return;
+
+    Counter& stack = m_stacks[m_stackName];
+    stack.ticks += ticks;
+    stack.seconds += seconds;
+    stack.count++;
+
+    std::string function = GetFunctionName(m_frames.front());
+    Counter& self = m_functions[function];
+    self.ticks += ticks;
+    self.seconds += seconds;
+    self.count++;
+
+    if (running == nullptr) return;
+    CBotToken* token = running->m_instr->GetToken();
+    if (token == nullptr) return;
+
+    Range& range = m_ranges[std::make_tuple(running->m_prog, token->GetStart(), token->GetEnd())];
+    if (range.function.empty()) range.function = function;
+    range.counter.ticks += ticks;
+    range.counter.seconds += seconds;
+    range.counter.count++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotProfiler::AddExternalCall(const std::string& name, CBotStack* pile, Clock::time_point start, bool finished)
+{
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    m_excluded += seconds;
+    m_seconds += seconds;
+
+    Counter& call = m_externalCalls[name];
+    call.seconds += seconds;
+    if (finished) call.count++;
+
+    ReadStack(pile);
+    if (!m_stackName.empty()) m_stackName += ';';
+    m_stackName += name;
+    m_stackName += " [extern]";
+    m_stacks[m_stackName].seconds += seconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotStack* CBotProfiler::ReadStack(CBotStack* pile)
+{
+    CBotStack* running = nullptr;
+    bool previousIsFunction = false;
+
+    m_frames.clear();
+    for (CBotStack* p = pile; p != nullptr; p = p->m_prev)
+    {
+        if (p->m_instr == nullptr) continue;
+        if (running == nullptr) running = p;
+
+        if (p->m_func != CBotStack::IsFunction::YES)
+        {
+            previousIsFunction = false;
+            continue;
+        }
+
+        // a call uses two levels of the stack for the same function, separated only by levels without instruction
+        CBotFunction* function = static_cast<CBotFunction*>(p->m_instr);
+        if (!previousIsFunction || m_frames.back() != function) m_frames.push_back(function);
+        previousIsFunction = true;
+    }
+
+    m_stackName.clear();
+    for (auto it = m_frames.rbegin(); it != m_frames.rend(); ++it)
+    {
+        if (!m_stackName.empty()) m_stackName += ';';
+        m_stackName += GetFunctionName(*it);
+    }
+    return running;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string CBotProfiler::GetFunctionName(CBotFunction* function)
+{
+    if (function->GetClassName().empty()) return function->GetName();
+    return function->GetClassName() + "::" + function->GetName();
+}
+
+} // namespace CBot
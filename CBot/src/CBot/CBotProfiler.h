@@ -0,0 +1,182 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace CBot
+{
+
+class CBotFunction;
+class CBotProgram;
+class CBotStack;
+
+/**
+ * \brief Result of the profiler for one function, source range or external call
+ * \see CBotProfiler
+ */
+struct CBotProfileEntry
+{
+    //! Name of the function ("Class::method" for methods)
+    std::string name;
+    //! Program containing the source range, nullptr for functions and external calls
+    const CBotProgram* program = nullptr;
+    //! Start of the source range in the code of the program
+    int start = 0;
+    //! End of the source range in the code of the program
+    int end = 0;
+    //! Timer ticks spent here
+    long ticks = 0;
+    //! Wall time spent here, in seconds
+    double seconds = 0.0;
+    //! Number of samples taken here, or number of finished calls for external calls
+    long count = 0;
+};
+
+/**
+ * \brief Sampling profiler of a running program, see CBotProgram::SetProfiler()
+ *
+ * Every GetInterval() timer ticks, the stack of the running program is sampled and the ticks
+ * and the wall time elapsed since the previous sample are attributed to the instruction being
+ * executed, to the function containing it and to the whole chain of calls. Time spent in
+ * external calls (the functions registered with CBotProgram::AddFunction() or
+ * CBotClass::AddFunction()) is measured separately around each call and is not included in
+ * the time of the instructions.
+ *
+ * Functions run as bytecode (see CBotProgram::SetBytecode()) are attributed as a whole
+ * to the body of the function.
+ *
+ * The results are kept until Clear() is called, so several runs can be accumulated.
+ */
+class CBotProfiler
+{
+public:
+    //! Default number of timer ticks between two samples
+    static const int DEFAULT_INTERVAL = 16;
+
+    /**
+     * \brief Constructor
+     * \param interval Number of timer ticks between two samples
+     */
+    CBotProfiler(int interval = DEFAULT_INTERVAL);
+    ~CBotProfiler();
+
+    /**
+     * \brief Changes the number of timer ticks between two samples, takes effect on the next CBotProgram::Run()
+     */
+    void SetInterval(int interval);
+    int GetInterval();
+
+    /**
+     * \brief Removes all the results
+     */
+    void Clear();
+
+    //! Total number of timer ticks sampled
+    long GetTicks();
+    //! Total wall time spent in the program, including external calls
+    double GetSeconds();
+
+    /**
+     * \brief Returns the time spent in each function, excluding the functions it calls, sorted by decreasing ticks
+     */
+    std::vector<CBotProfileEntry> GetFunctions();
+
+    /**
+     * \brief Returns the time spent in each source range (instruction), sorted by decreasing ticks
+     */
+    std::vector<CBotProfileEntry> GetRanges();
+
+    /**
+     * \brief Returns the time spent in each external call, sorted by decreasing time
+     */
+    std::vector<CBotProfileEntry> GetExternalCalls();
+
+    /**
+     * \brief Writes the sampled call stacks in the "collapsed" format of flame graph tools
+     *
+     * Each line holds the names of the functions of a call stack separated by ';', from the
+     * entry point to the innermost one, followed by a space and its weight. External calls
+     * appear as the last function of their stack with the suffix " [extern]".
+     *
+     * \param ostr Output stream
+     * \param wallTime true to weight the stacks by the wall time in microseconds, false to weight them by timer ticks
+     * \return false on write error
+     */
+    bool WriteCollapsed(std::ostream& ostr, bool wallTime = false);
+
+private:
+    friend class CBotStack;
+    friend class CBotExternalCallDefault;
+    friend class CBotExternalCallClass;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Counter
+    {
+        long ticks = 0;
+        double seconds = 0.0;
+        long count = 0;
+    };
+
+    struct Range
+    {
+        std::string function;
+        Counter counter;
+    };
+
+    //! Starts measuring the wall time, at the beginning of CBotProgram::Run()
+    void Begin();
+    //! Attributes the ticks and the wall time since the previous sample to the running instruction of the stack
+    void Sample(CBotStack* pile, int ticks);
+    //! Attributes the time of an external call to its name and to the calling stack
+    void AddExternalCall(const std::string& name, CBotStack* pile, Clock::time_point start, bool finished);
+
+    //! Collects the functions on the stack into m_frames and m_stackName, returns the innermost running instruction
+    CBotStack* ReadStack(CBotStack* pile);
+
+    static std::string GetFunctionName(CBotFunction* function);
+
+    int m_interval;
+    long m_ticks = 0;
+    double m_seconds = 0.0;
+
+    std::map<std::string, Counter> m_functions;
+    std::map<std::tuple<const CBotProgram*, int, int>, Range> m_ranges;
+    std::map<std::string, Counter> m_externalCalls;
+    //! Call stacks as "main;function;function", see WriteCollapsed()
+    std::map<std::string, Counter> m_stacks;
+
+    //! Time of the previous sample
+    Clock::time_point m_last;
+    //! Time spent in external calls since the previous sample
+    double m_excluded = 0.0;
+
+    //! Buffers reused by ReadStack()
+    std::vector<CBotFunction*> m_frames;
+    std::string m_stackName;
+};
+
+} // namespace CBot
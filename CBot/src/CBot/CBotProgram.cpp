@@ -19,7 +19,10 @@
 
 #include "CBot/CBotVar/CBotVar.h"
 
+#include "CBot/CBotContext.h"
 #include "CBot/CBotExternalCall.h"
+#include "CBot/CBotInstanceHeap.h"
+#include "CBot/CBotProfiler.h"
 #include "CBot/CBotStack.h"
 #include "CBot/CBotCStack.h"
 #include "CBot/CBotClass.h"
@@ -30,23 +33,33 @@
 #include "CBot/stdlib/stdlib.h"
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace CBot
 {
 
-std::unique_ptr<CBotExternalCallList> CBotProgram::m_externalCalls;
-
 CBotProgram::CBotProgram()
+: m_context(CBotContext::GetCurrent()), m_heap(std::make_unique<CBotInstanceHeap>(m_context))
 {
 }
 
 CBotProgram::CBotProgram(CBotVar* thisVar)
-: m_thisVar(thisVar)
+: m_thisVar(thisVar), m_context(CBotContext::GetCurrent()), m_heap(std::make_unique<CBotInstanceHeap>(m_context))
+{
+}
+
+CBotProgram::CBotProgram(CBotContext* context, CBotVar* thisVar)
+: m_thisVar(thisVar), m_context(context != nullptr ? context : CBotContext::GetCurrent()),
+  m_heap(std::make_unique<CBotInstanceHeap>(m_context))
 {
 }
 
 CBotProgram::~CBotProgram()
 {
+    CBotContext::Scope contextScope(m_context);
+
 //  delete  m_classes;
     for (CBotClass* c : m_classes)
         c->Purge();
@@ -60,9 +73,263 @@ CBotProgram::~CBotProgram()
 
 bool CBotProgram::Compile(const std::string& program, std::vector<std::string>& externFunctions, void* pUser)
 {
+    CBotContext::Scope contextScope(m_context);
+
     // Cleanup the previously compiled program
+    Clear(externFunctions);
+
+    // Step 1. Process the code into tokens
+    auto tokens = CBotToken::CompileTokens(program);
+    if (tokens == nullptr) return false;
+
+    // Step 2. Find all function and class definitions
+    if (!CompileDeclarations(tokens.get(), pUser)) return false;
+
+    // Step 3. Real compilation
+    return CompileDefinitions(tokens.get(), externFunctions, pUser, true);
+}
+
+struct CBotProgram::BatchBody
+{
+    //! Program of the function and pointer passed to the compile functions
+    CBotProgram*  program  = nullptr;
+    void*         user     = nullptr;
+    //! Function whose declaration was compiled by CompileHeaders()
+    CBotFunction* function = nullptr;
+    //! First token of the function and opening brace of the body, nullptr if the declaration has an error
+    CBotToken*    first    = nullptr;
+    CBotToken*    body     = nullptr;
+    //! Unique identifiers used by the body start after this value, last value used after compiling
+    long          uniqNum  = 0;
+    //! Result of the compilation of the body
+    CBotError     error    = CBotNoErr;
+    int           errorStart = 0;
+    int           errorEnd = 0;
+};
+
+namespace
+{
+
+//! Calls \a work with each index lower than \a count, on up to \a threads threads
+template<typename Work>
+void RunParallel(std::size_t count, int threads, const Work& work)
+{
+    std::atomic<std::size_t> next{0};
+    auto run = [count, &work, &next]()
+    {
+        for (std::size_t i = next++; i < count; i = next++) work(i);
+    };
+
+    threads = std::min(threads, static_cast<int>(count));
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) workers.emplace_back(run);
+    run();
+    for (std::thread& worker : workers) worker.join();
+}
+
+} // namespace
+
+void CBotProgram::CompileBatch(std::vector<BatchItem>& items, int threads)
+{
+    for (BatchItem& item : items)
+    {
+        CBotContext::Scope contextScope(item.program->m_context);
+        item.program->Clear(item.externFunctions);
+        item.ok = false;
+    }
+
+    if (threads <= 0) threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    // Step 1. The tokens only depend on the code and the constants
+    std::vector<std::unique_ptr<CBotToken>> tokens(items.size());
+    RunParallel(items.size(), threads, [&items, &tokens](std::size_t i)
+    {
+        CBotContext::Scope contextScope(items[i].program->m_context);
+        tokens[i] = CBotToken::CompileTokens(items[i].code);
+    });
+
+    // Step 2. Declarations of all the programs, then all the public functions at once, so
+    // a program can call the public functions of the programs following it
+    std::vector<bool> declared(items.size(), false);
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        if (tokens[i] == nullptr) continue;
+        CBotContext::Scope contextScope(items[i].program->m_context);
+        declared[i] = items[i].program->CompileDeclarations(tokens[i].get(), items[i].user);
+    }
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        if (!declared[i]) continue;
+        CBotContext::Scope contextScope(items[i].program->m_context);
+        for (CBotFunction* f : items[i].program->m_functions)
+        {
+            if (f->IsPublic()) CBotFunction::AddPublic(f);
+        }
+    }
+
+    // Step 3. Classes and declarations of the functions, in the order of the programs, as the
+    // bodies read them
+    std::vector<std::vector<BatchBody>> bodies(items.size());
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        if (!declared[i]) continue;
+        CBotContext::Scope contextScope(items[i].program->m_context);
+        items[i].program->CompileHeaders(tokens[i].get(), items[i].user, bodies[i]);
+    }
+
+    // Step 4. Bodies of the functions, each one only changes its own function
+    std::vector<BatchBody*> pending;
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        for (BatchBody& body : bodies[i])
+        {
+            if (body.body == nullptr) continue;
+            body.uniqNum = items[i].program->m_context->m_identcpt;
+            body.program->m_context->m_parallel = true;
+            pending.push_back(&body);
+        }
+    }
+
+    std::mutex heapMutex;
+    RunParallel(pending.size(), threads, [&pending, &heapMutex](std::size_t i)
+    {
+        BatchBody& body = *pending[i];
+        CBotContext::Scope contextScope(body.program->m_context);
+        CBotVar::UniqNumScope uniqNumScope(body.uniqNum);
+
+        // the instances created while compiling are registered in a heap of this thread
+        std::unique_ptr<CBotInstanceHeap> heap;
+        {
+            std::lock_guard<std::mutex> lock(heapMutex);
+            heap = std::make_unique<CBotInstanceHeap>(body.program->m_context);
+        }
+        {
+            CBotInstanceHeap::Scope heapScope(heap.get());
+
+            auto pStack = std::unique_ptr<CBotCStack>(new CBotCStack(nullptr));
+            pStack->SetProgram(body.program);
+            pStack->SetUserPtr(body.user);
+
+            CBotCStack* pStk = pStack->TokenStack(body.first, true);
+            CBotFunction::AddBodyVars(pStk, body.function);
+            CBotToken* p = body.body;
+            CBotFunction::CompileBody(p, pStk, body.function);
+            pStack->ReturnFunc(nullptr, pStk);
+
+            body.error = pStack->GetError(body.errorStart, body.errorEnd);
+        }
+        std::lock_guard<std::mutex> lock(heapMutex);
+        heap.reset();
+    });
+
+    for (BatchBody* body : pending)
+    {
+        CBotContext* context = body->program->m_context;
+        context->m_parallel = false;
+        context->m_identcpt = std::max(context->m_identcpt, body->uniqNum);
+    }
+
+    // Step 5. Errors and bodies are taken in the order of the programs
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        if (!declared[i]) continue;
+        CBotContext::Scope contextScope(items[i].program->m_context);
+        items[i].ok = items[i].program->LinkBodies(bodies[i], items[i].externFunctions);
+    }
+}
+
+void CBotProgram::CompileHeaders(CBotToken* tokens, void* pUser, std::vector<BatchBody>& bodies)
+{
+    auto pStack = std::unique_ptr<CBotCStack>(new CBotCStack(nullptr));
+    pStack->SetProgram(this);
+    pStack->SetUserPtr(pUser);
+
+    std::list<CBotFunction*>::iterator next = m_functions.begin();
+    CBotToken* p = tokens->GetNext();                       // returns to the beginning
+    while ( pStack->IsOk() && p != nullptr && p->GetType() != 0 )
+    {
+        if ( IsOfType(p, ID_SEP) ) continue;                // semicolons lurking
+
+        if ( p->GetType() == ID_CLASS ||
+            ( p->GetType() == ID_PUBLIC && p->GetNext()->GetType() == ID_CLASS ))
+        {
+            CBotClass::Compile(p, pStack.get());                  // completes the definition of the class
+            continue;
+        }
+
+        BatchBody body;
+        body.program = this;
+        body.user = pUser;
+        body.function = *next;
+        body.first = p;
+
+        CBotCStack* pStk = pStack->TokenStack(p, true);
+        if (CBotFunction::CompileHeader(p, pStk, *next)) body.body = p;
+        pStack->ReturnFunc(nullptr, pStk);
+        bodies.push_back(body);
+        if (body.body == nullptr) break;
+        ++next;
+
+        // skips the body, already delimited by CompileDeclarations()
+        if (!IsOfType(p, ID_OPBLK)) break;
+        int level = 1;
+        do
+        {
+            int type = p->GetType();
+            p = p->GetNext();
+            if (type == ID_OPBLK) level++;
+            if (type == ID_CLBLK) level--;
+        }
+        while (level > 0 && p != nullptr);
+    }
+
+    if ( !pStack->IsOk() )
+    {
+        m_error = pStack->GetError(m_errorStart, m_errorEnd);
+    }
+}
+
+bool CBotProgram::LinkBodies(const std::vector<BatchBody>& bodies, std::vector<std::string>& externFunctions)
+{
+    // the first error in the code wins, as Compile() stops there
+    for (const BatchBody& body : bodies)
+    {
+        if (body.function->IsExtern()) externFunctions.push_back(body.function->GetName());
+        if (body.body == nullptr) break;                    // error already set by CompileHeaders()
+        if (body.error == CBotNoErr) continue;
+
+        m_error = body.error;
+        m_errorStart = body.errorStart;
+        m_errorEnd = body.errorEnd;
+        break;
+    }
+
+    if (m_error != CBotNoErr)
+    {
+        for (CBotFunction* f : m_functions) delete f;
+        m_functions.clear();
+        return false;
+    }
+
+    for (CBotFunction* f : m_functions)
+    {
+        f->m_pProg = this;                                  // keeps pointers to the module
+    }
+
+    if (m_bytecode)
+    {
+        for (CBotFunction* f : m_functions) f->TranslateToBytecode();
+    }
+
+    return !m_functions.empty();
+}
+
+void CBotProgram::Clear(std::vector<std::string>& externFunctions)
+{
     Stop();
 
+    if (m_profiler != nullptr) m_profiler->Clear();
+
     for (CBotClass* c : m_classes)
         c->Purge();      // purge the old definitions of classes
                          // but without destroying the object
@@ -73,18 +340,16 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
 
     externFunctions.clear();
     m_error = CBotNoErr;
+}
 
-    // Step 1. Process the code into tokens
-    auto tokens = CBotToken::CompileTokens(program);
-    if (tokens == nullptr) return false;
-
+bool CBotProgram::CompileDeclarations(CBotToken* tokens, void* pUser)
+{
     auto pStack = std::unique_ptr<CBotCStack>(new CBotCStack(nullptr));
-    CBotToken* p = tokens.get()->GetNext();                 // skips the first token (separator)
+    CBotToken* p = tokens->GetNext();                       // skips the first token (separator)
 
     pStack->SetProgram(this);                               // defined used routines
-    m_externalCalls->SetUserPtr(pUser);
+    pStack->SetUserPtr(pUser);
 
-    // Step 2. Find all function and class definitions
     while ( pStack->IsOk() && p != nullptr && p->GetType() != 0)
     {
         if ( IsOfType(p, ID_SEP) ) continue;                // semicolons lurking
@@ -114,10 +379,17 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
         m_functions.clear();
         return false;
     }
+    return true;
+}
+
+bool CBotProgram::CompileDefinitions(CBotToken* tokens, std::vector<std::string>& externFunctions, void* pUser, bool addPublic)
+{
+    auto pStack = std::unique_ptr<CBotCStack>(new CBotCStack(nullptr));
+    pStack->SetProgram(this);
+    pStack->SetUserPtr(pUser);
 
-    // Step 3. Real compilation
     std::list<CBotFunction*>::iterator next = m_functions.begin();
-    p  = tokens.get()->GetNext();                             // returns to the beginning
+    CBotToken* p = tokens->GetNext();                       // returns to the beginning
     while ( pStack->IsOk() && p != nullptr && p->GetType() != 0 )
     {
         if ( IsOfType(p, ID_SEP) ) continue;                // semicolons lurking
@@ -131,7 +403,7 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
         {
             CBotFunction::Compile(p, pStack.get(), *next);
             if ((*next)->IsExtern()) externFunctions.push_back((*next)->GetName()/* + next->GetParams()*/);
-            if ((*next)->IsPublic()) CBotFunction::AddPublic(*next);
+            if (addPublic && (*next)->IsPublic()) CBotFunction::AddPublic(*next);
             (*next)->m_pProg = this;                           // keeps pointers to the module
             ++next;
         }
@@ -143,12 +415,28 @@ bool CBotProgram::Compile(const std::string& program, std::vector<std::string>&
         for (CBotFunction* f : m_functions) delete f;
         m_functions.clear();
     }
+    else if (m_bytecode)
+    {
+        for (CBotFunction* f : m_functions) f->TranslateToBytecode();
+    }
 
     return !m_functions.empty();
 }
 
+void CBotProgram::SetBytecode(bool bytecode)
+{
+    m_bytecode = bytecode;
+}
+
+bool CBotProgram::GetBytecode()
+{
+    return m_bytecode;
+}
+
 bool CBotProgram::Start(const std::string& name)
 {
+    CBotContext::Scope contextScope(m_context);
+
     Stop();
 
     auto it = std::find_if(m_functions.begin(), m_functions.end(), [&name](CBotFunction* x) { return x->GetName() == name; });
@@ -158,6 +446,8 @@ bool CBotProgram::Start(const std::string& name)
         return false;
     }
     m_entryPoint = *it;
+    m_ticks = 0;
+    m_peakStackSize = 0;
 
     m_stack = CBotStack::AllocateStack();
     m_stack->SetProgram(this);
@@ -184,7 +474,11 @@ bool CBotProgram::Run(void* pUser, int timer)
 
     m_error = CBotNoErr;
 
+    CBotContext::Scope contextScope(m_context);
+    CBotInstanceHeap::Scope heapScope(m_heap.get());
+
     m_stack->SetUserPtr(pUser);
+    m_stack->SetProfiler(m_profiler.get());
     if ( timer >= 0 ) m_stack->SetTimer(timer); // TODO: Check if changing order here fixed ipf()
     m_stack->Reset();                         // reset the possible previous error, and resets the timer
 
@@ -197,6 +491,9 @@ bool CBotProgram::Run(void* pUser, int timer)
         // returns to normal execution
         ok = m_entryPoint->Execute(nullptr, m_stack, m_thisVar);
     }
+    m_ticks += m_stack->GetTimerUsed();
+    m_peakStackSize = std::max(m_peakStackSize, m_stack->GetPeakSize());
+    m_stack->FlushProfiler();
 
     // completed on a mistake?
     if (ok || !m_stack->IsOk())
@@ -206,14 +503,56 @@ bool CBotProgram::Run(void* pUser, int timer)
         m_stack = nullptr;
         CBotClass::FreeLock(this);
         m_entryPoint = nullptr;
+        m_heap->Collect(false);
         return true;                                // execution is finished!
     }
 
+    m_heap->Collect(false);                        // no instruction is running, the cycles can be destroyed
     return ok;
 }
 
+long CBotProgram::GetTicks()
+{
+    return m_ticks;
+}
+
+std::size_t CBotProgram::GetPeakStackSize()
+{
+    return m_peakStackSize;
+}
+
+void CBotProgram::SetProfiler(bool profile)
+{
+    if (!profile)
+    {
+        m_profiler.reset();
+    }
+    else if (m_profiler == nullptr)
+    {
+        m_profiler = std::make_unique<CBotProfiler>();
+    }
+    if (m_stack != nullptr) m_stack->SetProfiler(m_profiler.get());
+}
+
+CBotProfiler* CBotProgram::GetProfiler()
+{
+    return m_profiler.get();
+}
+
+CBotInstanceHeap* CBotProgram::GetHeap()
+{
+    return m_heap.get();
+}
+
+CBotContext* CBotProgram::GetContext()
+{
+    return m_context;
+}
+
 void CBotProgram::Stop()
 {
+    CBotContext::Scope contextScope(m_context);
+
     if (m_stack != nullptr)
     {
         m_stack->Delete();
@@ -314,7 +653,7 @@ bool CBotProgram::AddFunction(const std::string& name,
                               bool rExec(CBotVar* pVar, CBotVar* pResult, int& Exception, void* pUser),
                               CBotTypResult rCompile(CBotVar*& pVar, void* pUser))
 {
-    return m_externalCalls->AddFunction(name, std::unique_ptr<CBotExternalCall>(new CBotExternalCallDefault(rExec, rCompile)));
+    return GetExternalCalls()->AddFunction(name, std::unique_ptr<CBotExternalCall>(new CBotExternalCallDefault(rExec, rCompile)));
 }
 
 bool CBotProgram::DefineNum(const std::string& name, long val)
@@ -361,6 +700,9 @@ bool CBotProgram::RestoreState(std::istream &istr)
 
     if (!ReadString(istr, s)) return false;
     if (!Start(s)) return false; // point de reprise
+
+    CBotContext::Scope contextScope(m_context);
+    CBotInstanceHeap::Scope heapScope(m_heap.get());
     // Start() already created the new stack
     // and called m_stack->SetProgram(this);
 
@@ -388,7 +730,7 @@ int CBotProgram::GetVersion()
 
 void CBotProgram::Init()
 {
-    m_externalCalls.reset(new CBotExternalCallList);
+    CBotContext::GetCurrent()->m_externalCalls.reset(new CBotExternalCallList);
 
     CBotProgram::DefineNum("CBotErrZeroDiv",    CBotErrZeroDiv);     // division by zero
     CBotProgram::DefineNum("CBotErrNotInit",    CBotErrNotInit);     // uninitialized variable
@@ -412,15 +754,17 @@ void CBotProgram::Init()
 
 void CBotProgram::Free()
 {
+    std::unique_ptr<CBotExternalCallList>& externalCalls = CBotContext::GetCurrent()->m_externalCalls;
+
     CBotToken::ClearDefineNum();
-    m_externalCalls->Clear();
+    if (externalCalls != nullptr) externalCalls->Clear();
     CBotClass::ClearPublic();
-    m_externalCalls.reset();
+    externalCalls.reset();
 }
 
 const std::unique_ptr<CBotExternalCallList>& CBotProgram::GetExternalCalls()
 {
-    return m_externalCalls;
+    return CBotContext::GetCurrent()->m_externalCalls;
 }
 
 } // namespace CBot
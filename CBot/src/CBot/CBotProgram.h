@@ -21,6 +21,7 @@
 
 #include "CBot/CBotEnums.h"
 
+#include <cstddef>
 #include <list>
 #include <memory>
 #include <string>
@@ -31,7 +32,11 @@ namespace CBot
 
 class CBotFunction;
 class CBotClass;
+class CBotContext;
+class CBotInstanceHeap;
+class CBotProfiler;
 class CBotStack;
+class CBotToken;
 class CBotTypResult;
 class CBotVar;
 class CBotExternalCallList;
@@ -55,6 +60,10 @@ class CBotExternalCallList;
  *
  * After you are finished, free the memory used by the CBot engine by calling CBotProgram::Free().
  *
+ * The functions, constants and classes are registered in the current CBotContext, the default
+ * context unless another one was made current with CBotContext::Scope. Programs created with
+ * different contexts are independent and can run on different threads.
+ *
  * \section Example Example usage
  * \code
  * // Initialize the engine
@@ -97,6 +106,13 @@ public:
      */
     CBotProgram(CBotVar* thisVar);
 
+    /**
+     * \brief Constructor
+     * \param context Context of the program, nullptr for the current context
+     * \param thisVar Variable to pass to the program as "this"
+     */
+    CBotProgram(CBotContext* context, CBotVar* thisVar);
+
     /**
      * \brief Destructor
      */
@@ -104,11 +120,13 @@ public:
 
     /**
      * \brief Initializes the module, should be done once (and only once) at the beginning
+     *
+     * Initializes the current context, see CBotContext::Init().
      */
     static void Init();
 
     /**
-     * \brief Frees the static memory areas
+     * \brief Frees the static memory areas, the classes and the functions of the current context
      */
     static void Free();
 
@@ -134,6 +152,62 @@ public:
      */
     bool Compile(const std::string& program, std::vector<std::string>& externFunctions, void* pUser = nullptr);
 
+    /**
+     * \brief A program to compile with CompileBatch()
+     */
+    struct BatchItem
+    {
+        //! Program to compile
+        CBotProgram* program = nullptr;
+        //! Code to compile
+        std::string code;
+        //! Pointer passed to the compile functions, see Compile()
+        void* user = nullptr;
+        //! [out] Names of the functions declared as extern
+        std::vector<std::string> externFunctions;
+        //! [out] Result of the compilation, same as the result of Compile()
+        bool ok = false;
+    };
+
+    /**
+     * \brief Compiles the programs of a scene together
+     *
+     * Same as calling Compile() on each program, except that:
+     * * the code of the programs is converted into tokens in parallel,
+     * * the public functions of all the programs are declared before the definitions are
+     *   compiled, so a program can call a public function of any program of the batch,
+     *   regardless of the order of the programs,
+     * * the bodies of the functions are compiled in parallel, see CBotFunction::CompileBody().
+     *
+     * The declarations of the functions and the classes, with the bodies of their methods, are
+     * compiled on the calling thread in the order of \a items. The compiled bodies are then
+     * linked to their programs in the same order, and each body numbers its variables from the
+     * same value (see CBotVar::UniqNumScope), so the results and the errors reported by each
+     * program (see GetError()) don't depend on the number of threads.
+     *
+     * The compile functions of the external calls (see AddFunction()) are called from
+     * several threads and must not change any state.
+     *
+     * \param items Programs to compile, with their code
+     * \param threads Number of threads, 0 for the number of cores
+     */
+    static void CompileBatch(std::vector<BatchItem>& items, int threads = 0);
+
+    /**
+     * \brief Enables translating the functions to register bytecode during the next Compile()
+     *
+     * Functions using only int, float and bool variables and simple statements are then
+     * run by CBotBytecode instead of the instruction tree, see CBotBytecode for details.
+     * \param bytecode true to enable, disabled by default
+     */
+    void SetBytecode(bool bytecode);
+
+    /**
+     * \brief Checks if translation to bytecode is enabled
+     * \see SetBytecode()
+     */
+    bool GetBytecode();
+
     /**
      * \brief Returns the last error
      * \return Error code
@@ -180,6 +254,41 @@ public:
      */
     bool Run(void* pUser = nullptr, int timer = -1);
 
+    /**
+     * \brief Returns the number of "timer ticks" (parts of instructions) executed since the last call to Start() or RestoreState()
+     * \see CBotStack::SetTimer()
+     */
+    long GetTicks();
+
+    /**
+     * \brief Returns the highest memory used by the execution stack since the last call to Start() or RestoreState(), in bytes
+     * \see CBotStack::GetPeakSize()
+     */
+    std::size_t GetPeakStackSize();
+
+    /**
+     * \brief Enables or disables the sampling profiler for the next calls to Run()
+     *
+     * The results are kept across runs and cleared by Compile(), see CBotProfiler.
+     * \param profile true to enable, disabled by default
+     */
+    void SetProfiler(bool profile);
+
+    /**
+     * \brief Returns the profiler of this program
+     * \return The profiler, nullptr if it isn't enabled
+     * \see SetProfiler()
+     */
+    CBotProfiler* GetProfiler();
+
+    /**
+     * \brief Returns the heap of the class instances and arrays created by this program
+     *
+     * Use it to limit the memory available to the program, see CBotInstanceHeap::SetLimit().
+     * The cycles of unreachable instances are collected automatically at the end of Run().
+     */
+    CBotInstanceHeap* GetHeap();
+
     /**
      * \brief Gives the current position in the executing program
      * \param[out] functionName Name of the currently executed function
@@ -327,13 +436,30 @@ public:
     bool ClassExists(std::string name);
 
     /**
-     * \brief Returns static list of all registered external calls
+     * \brief Returns the list of all external calls registered in the current context
      */
     static const std::unique_ptr<CBotExternalCallList>& GetExternalCalls();
 
+    /**
+     * \brief Returns the context of this program, see CBotContext
+     */
+    CBotContext* GetContext();
+
 private:
-    //! All external calls
-    static std::unique_ptr<CBotExternalCallList> m_externalCalls;
+    //! Deletes the previously compiled program, first step of Compile()
+    void Clear(std::vector<std::string>& externFunctions);
+    //! Finds all function and class definitions, second step of Compile()
+    bool CompileDeclarations(CBotToken* tokens, void* pUser);
+    //! Compiles the functions and the classes, last step of Compile()
+    bool CompileDefinitions(CBotToken* tokens, std::vector<std::string>& externFunctions, void* pUser, bool addPublic);
+
+    //! Body of a function to compile in CompileBatch()
+    struct BatchBody;
+    //! Compiles the classes and the declarations of the functions, collects the bodies, see CompileBatch()
+    void CompileHeaders(CBotToken* tokens, void* pUser, std::vector<BatchBody>& bodies);
+    //! Takes the compiled bodies or the first error, last step of CompileBatch()
+    bool LinkBodies(const std::vector<BatchBody>& bodies, std::vector<std::string>& externFunctions);
+
     //! All user-defined functions
     std::list<CBotFunction*> m_functions{};
     //! The entry point function
@@ -344,9 +470,25 @@ private:
     CBotStack* m_stack = nullptr;
     //! "this" variable
     CBotVar* m_thisVar = nullptr;
+    //! Context of the program, current in all the calls modifying the program
+    CBotContext* m_context;
     friend class CBotFunction;
     friend class CBotDebug;
 
+    //! Translate the functions to bytecode, see SetBytecode()
+    bool m_bytecode = false;
+
+    //! Timer ticks executed since Start(), see GetTicks()
+    long m_ticks = 0;
+    //! Stack high-water mark since Start(), see GetPeakStackSize()
+    std::size_t m_peakStackSize = 0;
+
+    //! Sampling profiler, see SetProfiler()
+    std::unique_ptr<CBotProfiler> m_profiler;
+
+    //! Instances created by this program, see GetHeap()
+    std::unique_ptr<CBotInstanceHeap> m_heap;
+
     CBotError m_error = CBotNoErr;
     int m_errorStart = 0;
     int m_errorEnd = 0;
@@ -28,8 +28,10 @@
 
 #include "CBot/CBotUtils.h"
 #include "CBot/CBotExternalCall.h"
+#include "CBot/CBotProfiler.h"
 
 #include <cassert>
+#include <climits>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -56,6 +58,14 @@ struct CBotStack::Data
     void*        pUser      = nullptr;
 
     std::unique_ptr<CBotVar> retvar;
+
+    CBotProfiler* profiler  = nullptr;
+    //! Highest number of levels used at once, see GetPeakSize()
+    int          peakLevels = 0;
+    //! Value of the timer at which the next sample is taken, see CBotProfiler
+    int          nextSample = INT_MIN;
+    //! Value of the timer at the previous sample
+    int          lastSample = 0;
 };
 
 CBotStack* CBotStack::AllocateStack()
@@ -135,6 +145,7 @@ CBotStack* CBotStack::AddStack(CBotInstr* instr, BlockVisibilityType bBlock)
 
     m_next = p;                                    // chain an element
     p->m_data   = m_data;
+    p->UpdatePeak();
     p->m_block  = bBlock;
     p->m_instr  = instr;
     p->m_prog   = m_prog;
@@ -179,6 +190,7 @@ CBotStack* CBotStack::AddStack2(BlockVisibilityType bBlock)
 
     m_next2 = p;                                // chain an element
     p->m_data = m_data;
+    p->UpdatePeak();
     p->m_prev = this;
     p->m_block = bBlock;
     p->m_prog = m_prog;
@@ -259,6 +271,17 @@ void CBotStack::Reset()
     m_data->timer = m_data->initimer; // resets the timer
     m_data->error = CBotNoErr;
     m_data->labelBreak.clear();
+
+    m_data->lastSample = m_data->timer;
+    if (m_data->profiler != nullptr)
+    {
+        m_data->nextSample = m_data->timer - m_data->profiler->GetInterval();
+        m_data->profiler->Begin();
+    }
+    else
+    {
+        m_data->nextSample = INT_MIN;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -437,6 +460,7 @@ bool CBotStack::SetState(int n, int limite)
     m_state = n;
 
     m_data->timer--;                              // decrement the timer
+    if (m_data->timer <= m_data->nextSample) Sample();
     return (m_data->timer > limite);                // interrupted if timer pass
 }
 
@@ -446,9 +470,19 @@ bool CBotStack::IncState(int limite)
     m_state++;
 
     m_data->timer--;                              // decrement the timer
+    if (m_data->timer <= m_data->nextSample) Sample();
     return (m_data->timer > limite);                // interrupted if timer pass
 }
 
+bool CBotStack::SetStateTicks(int n, int ticks, int limite)
+{
+    m_state = n;
+
+    m_data->timer -= ticks;
+    if (m_data->timer <= m_data->nextSample) Sample();
+    return (m_data->timer > limite);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void CBotStack::SetError(CBotError n, CBotToken* token)
 {
@@ -487,6 +521,55 @@ int CBotStack::GetTimer()
     return m_data->initimer;
 }
 
+int CBotStack::GetTimerUsed()
+{
+    return m_data->initimer - m_data->timer;
+}
+
+std::size_t CBotStack::GetPeakSize()
+{
+    return static_cast<std::size_t>(m_data->peakLevels) * sizeof(CBotStack);
+}
+
+void CBotStack::UpdatePeak()
+{
+    int levels = static_cast<int>(this - m_data->topStack) + 1;
+    if (levels > m_data->peakLevels) m_data->peakLevels = levels;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotStack::SetProfiler(CBotProfiler* profiler)
+{
+    m_data->profiler = profiler;
+}
+
+CBotProfiler* CBotStack::GetProfiler()
+{
+    return m_data->profiler;
+}
+
+void CBotStack::Sample()
+{
+    m_data->profiler->Sample(this, m_data->lastSample - m_data->timer);
+    m_data->lastSample = m_data->timer;
+    m_data->nextSample = m_data->timer - m_data->profiler->GetInterval();
+}
+
+void CBotStack::FlushProfiler()
+{
+    if (m_data->profiler == nullptr || m_data->timer >= m_data->lastSample) return;
+
+    // the ticks since the last sample go to the instruction on top of the stack
+    CBotStack* p = this;
+    while (p->m_next != nullptr)
+    {
+        if (p->m_next2 && p->m_next2->m_state != 0) p = p->m_next2;
+        else                                        p = p->m_next;
+    }
+    m_data->profiler->Sample(p, m_data->lastSample - m_data->timer);
+    m_data->lastSample = m_data->timer;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotStack::Execute()
 {
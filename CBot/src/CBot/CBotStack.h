@@ -24,6 +24,7 @@
 #include "CBot/CBotEnums.h"
 #include "CBot/CBotVar/CBotVar.h"
 
+#include <cstddef>
 #include <cstdio>
 #include <string>
 
@@ -33,6 +34,7 @@ namespace CBot
 class CBotInstr;
 class CBotExternalCall;
 class CBotVar;
+class CBotProfiler;
 class CBotProgram;
 class CBotToken;
 
@@ -193,6 +195,12 @@ public:
      */
     CBotVar*        CopyVar(CBotToken& pToken, bool bUpdate = false);
 
+    /**
+     * \brief Returns the variables declared at this level of the stack
+     * \return First variable, process using CBotVar::GetNext(), nullptr if there are none
+     */
+    CBotVar*        GetVarList() { return m_listVar; }
+
     //@}
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -312,6 +320,17 @@ public:
      * \return false if timer requests interruption (timer <= limit)
      */
     bool            IncState(int lim = -10);
+    /**
+     * \brief Set execution state, consuming several ticks at once
+     *
+     * Used by CBotBytecode, which checks the timer once per statement instead of once per instruction
+     *
+     * \param n New state
+     * \param ticks Number of ticks to consume
+     * \param lim Required amount of "ticks" on the timer required to allow to continue execution
+     * \return false if timer requests interruption (timer <= limit)
+     */
+    bool            SetStateTicks(int n, int ticks, int lim = -10);
 
     /**
      * \brief Check if we are in step by step execution mode
@@ -383,7 +402,7 @@ public:
     /**
      * \brief Set user pointer for external calls
      *
-     * Execution calls only - see CBotExternalCallList::SetUserPtr() for compilation calls
+     * Execution calls only - see CBotCStack::SetUserPtr() for compilation calls
      *
      * \param user User pointer to set
      */
@@ -445,6 +464,36 @@ public:
      * \brief Get the current configured maximum number of "timer ticks" (parts of instructions) to execute
      */
     int             GetTimer();
+    /**
+     * \brief Get the number of "timer ticks" used since the last call to Reset()
+     */
+    int             GetTimerUsed();
+    /**
+     * \brief Get the highest memory used by the levels of this stack at once, in bytes
+     *
+     * Levels are taken from a block allocated by AllocateStack(), see MAXSTACK.
+     * Variables on the levels are allocated separately and not counted.
+     */
+    std::size_t     GetPeakSize();
+
+    /**
+     * \brief Set the profiler which samples this execution, nullptr to disable sampling
+     *
+     * This setting gets applied on next call to Reset()
+     *
+     * \see CBotProfiler
+     */
+    void            SetProfiler(CBotProfiler* profiler);
+    /**
+     * \brief Get the profiler set with SetProfiler()
+     */
+    CBotProfiler*   GetProfiler();
+    /**
+     * \brief Attribute the ticks used since the last sample to the instruction on top of the stack
+     *
+     * Called at the end of each execution cycle, before the stack is released
+     */
+    void            FlushProfiler();
 
     /**
      * \brief Get current position in the program
@@ -464,6 +513,13 @@ public:
     bool            IsCallFinished();
 
 private:
+    friend class CBotProfiler;
+
+    //! Take a sample for the profiler, see SetProfiler()
+    void            Sample();
+    //! Record the depth of this level, see GetPeakSize()
+    void            UpdatePeak();
+
     CBotStack*        m_next;
     CBotStack*        m_next2;
     CBotStack*        m_prev;
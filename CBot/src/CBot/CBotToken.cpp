@@ -19,6 +19,8 @@
 
 #include "CBot/CBotToken.h"
 
+#include "CBot/CBotContext.h"
+
 #include <cstdarg>
 #include <cassert>
 #include <map>
@@ -134,8 +136,6 @@ const std::string& UndefinedTokenString()
     return TX_UNDEF_VALUE;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-std::map<std::string, long> CBotToken::m_defineNum;
 ////////////////////////////////////////////////////////////////////////////////
 CBotToken::CBotToken()
 {
@@ -172,7 +172,7 @@ CBotToken::~CBotToken()
 ////////////////////////////////////////////////////////////////////////////////
 void CBotToken::ClearDefineNum()
 {
-    m_defineNum.clear();
+    CBotContext::GetCurrent()->m_defineNum.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -500,25 +500,28 @@ int CBotToken::GetKeyWord(const std::string& w)
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotToken::GetDefineNum(const std::string& name, CBotToken* token)
 {
-    if (m_defineNum.count(name) == 0)
+    const std::map<std::string, long>& defineNum = CBotContext::GetCurrent()->m_defineNum;
+    auto it = defineNum.find(name);
+    if (it == defineNum.end())
         return false;
 
     token->m_type = TokenTypDef;
-    token->m_keywordId = m_defineNum[name];
+    token->m_keywordId = it->second;
     return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool CBotToken::DefineNum(const std::string& name, long val)
 {
-    if (m_defineNum.count(name) > 0)
+    std::map<std::string, long>& defineNum = CBotContext::GetCurrent()->m_defineNum;
+    if (defineNum.count(name) > 0)
     {
         // TODO: No access to the logger from CBot library :(
         printf("CBOT WARNING: %s redefined\n", name.c_str());
         return false;
     }
 
-    m_defineNum[name] = val;
+    defineNum[name] = val;
     return true;
 }
 
@@ -164,7 +164,7 @@ public:
     static std::unique_ptr<CBotToken> CompileTokens(const std::string& prog);
 
     /**
-     * \brief Define a new constant
+     * \brief Define a new constant in the current context, see CBotContext
      * \param name Name of the constant
      * \param val Value of the constant
      * \return true on success, false if already defined
@@ -205,9 +205,6 @@ private:
     //! The end position of the token in the CBotProgram
     int m_end = 0;
 
-    //! Map of all defined constants (see DefineNum())
-    static std::map<std::string, long> m_defineNum;
-
     /**
      * \brief Check if the word is a keyword
      * \param w The word to check
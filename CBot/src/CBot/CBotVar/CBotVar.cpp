@@ -37,6 +37,7 @@
 #include "CBot/CBotVar/CBotVarString.h"
 
 #include "CBot/CBotClass.h"
+#include "CBot/CBotContext.h"
 #include "CBot/CBotToken.h"
 
 #include "CBot/CBotEnums.h"
@@ -50,9 +51,6 @@
 namespace CBot
 {
 
-////////////////////////////////////////////////////////////////////////////////
-long CBotVar::m_identcpt = 0;
-
 ////////////////////////////////////////////////////////////////////////////////
 CBotVar::CBotVar( ) : m_token(nullptr)
 {
@@ -119,11 +117,31 @@ void CBotVar::SetUniqNum(long n)
     if ( n == 0 ) assert(0);
 }
 
+namespace
+{
+
+//! Counter set by CBotVar::UniqNumScope, the one of the current context if nullptr
+thread_local long* g_uniqNumCounter = nullptr;
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 long CBotVar::NextUniqNum()
 {
-    if (++m_identcpt < 10000) m_identcpt = 10000;
-    return m_identcpt;
+    long& identcpt = g_uniqNumCounter != nullptr ? *g_uniqNumCounter : CBotContext::GetCurrent()->m_identcpt;
+    if (++identcpt < 10000) identcpt = 10000;
+    return identcpt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotVar::UniqNumScope::UniqNumScope(long& counter) : m_previous(g_uniqNumCounter)
+{
+    g_uniqNumCounter = &counter;
+}
+
+CBotVar::UniqNumScope::~UniqNumScope()
+{
+    g_uniqNumCounter = m_previous;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -517,7 +535,10 @@ void CBotVar::SetVal(CBotVar* var)
         SetValDouble(var->GetValDouble());
         break;
     case CBotTypString:
-        SetValString(var->GetValString());
+        if (GetType() == CBotTypString)
+            static_cast<CBotVarString*>(this)->SetValue(CBotVarString::FromVar(var)); // shares the characters
+        else
+            SetValString(var->GetValString());
         break;
     case CBotTypPointer:
     case CBotTypNullPointer:
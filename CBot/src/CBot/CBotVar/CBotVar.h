@@ -384,10 +384,26 @@ public:
     /**
      * \brief Generate next unique identifier
      *
-     * Used by both variables (CBotVar) and functions (CBotFunction)
+     * Used by both variables (CBotVar) and functions (CBotFunction), unique in the current context (see CBotContext)
      */
     static long NextUniqNum();
 
+    /**
+     * \brief Makes NextUniqNum() use another counter on the calling thread, for the lifetime of this object
+     *
+     * Used by CBotProgram::CompileBatch(), so the identifiers of a function don't depend on
+     * the functions compiled at the same time on other threads.
+     */
+    class UniqNumScope
+    {
+    public:
+        UniqNumScope(long& counter);
+        ~UniqNumScope();
+
+    private:
+        long* m_previous;
+    };
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     //! \name Class / array member access
     //@{
@@ -703,9 +719,6 @@ protected:
      */
     long m_ident;
 
-    //! TODO: ?
-    static long m_identcpt;
-
     friend class CBotStack;
     friend class CBotCStack;
     friend class CBotInstrCall;
@@ -22,6 +22,7 @@
 #include "CBot/CBotClass.h"
 #include "CBot/CBotStack.h"
 #include "CBot/CBotDefines.h"
+#include "CBot/CBotInstanceHeap.h"
 
 #include "CBot/CBotInstr/CBotInstr.h"
 
@@ -30,9 +31,6 @@
 namespace CBot
 {
 
-////////////////////////////////////////////////////////////////////////////////
-std::set<CBotVarClass*> CBotVarClass::m_instances{};
-
 ////////////////////////////////////////////////////////////////////////////////
 CBotVarClass::CBotVarClass(const CBotToken& name, const CBotTypResult& type) : CBotVar(name)
 {
@@ -61,8 +59,8 @@ CBotVarClass::CBotVarClass(const CBotToken& name, const CBotTypResult& type) : C
     m_CptUse    = 0;
     m_ItemIdent = type.Eq(CBotTypIntrinsic) ? 0 : CBotVar::NextUniqNum();
 
-    // add to the list
-    if (m_ItemIdent != 0) m_instances.insert(this);
+    // add to the heap
+    if (m_ItemIdent != 0) CBotInstanceHeap::Register(this);
 
     CBotClass* pClass = type.GetClass();
 
@@ -76,12 +74,23 @@ CBotVarClass::~CBotVarClass( )
     if ( m_CptUse != 0 )
         assert(0);
 
-    // removes the class list
-    if (m_ItemIdent != 0) m_instances.erase(this);
+    // removes from the heap
+    CBotInstanceHeap::Unregister(this);
 
     delete    m_pVar;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void* CBotVarClass::operator new(std::size_t size)
+{
+    return CBotInstanceHeap::Allocate(size);
+}
+
+void CBotVarClass::operator delete(void* p, std::size_t size)
+{
+    CBotInstanceHeap::Release(p, size);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void CBotVarClass::ConstructorSet()
 {
@@ -412,12 +421,13 @@ CBotVarClass* CBotVarClass::GetPointer()
 ////////////////////////////////////////////////////////////////////////////////
 CBotVarClass* CBotVarClass::Find(long id)
 {
-    for (CBotVarClass* p : m_instances)
-    {
-        if (p->m_ItemIdent == id) return p;
-    }
+    return CBotInstanceHeap::Find(id);
+}
 
-    return nullptr;
+////////////////////////////////////////////////////////////////////////////////
+CBotInstanceHeap* CBotVarClass::GetHeap()
+{
+    return m_heap;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
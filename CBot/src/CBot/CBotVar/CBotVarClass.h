@@ -21,11 +21,13 @@
 
 #include "CBot/CBotVar/CBotVar.h"
 
-#include <set>
+#include <cstddef>
 
 namespace CBot
 {
 
+class CBotInstanceHeap;
+
 /**
  * \brief CBotVar subclass for managing classes (::CBotTypClass, ::CBotTypIntrinsic)
  *
@@ -43,6 +45,10 @@ public:
      */
     ~CBotVarClass();
 
+    //! Allocation from the free list of CBotInstanceHeap
+    static void* operator new(std::size_t size);
+    static void operator delete(void* p, std::size_t size);
+
     void Copy(CBotVar* pSrc, bool bName = true) override;
 
     void SetClass(CBotClass* pClass) override;
@@ -84,6 +90,7 @@ public:
      * \brief Finds a class instance by unique identifier
      * \param id Identifier to find
      * \return Found class instance
+     * \see CBotInstanceHeap::Find()
      */
     static CBotVarClass* Find(long id);
 
@@ -94,9 +101,12 @@ public:
 
     void ConstructorSet() override;
 
+    /**
+     * \brief Returns the heap containing this instance, nullptr for intrinsic objects
+     */
+    CBotInstanceHeap* GetHeap();
+
 private:
-    //! List of all class instances - first
-    static std::set<CBotVarClass*> m_instances;
     //! Class definition
     CBotClass* m_pClass;
     //! Class members
@@ -108,8 +118,17 @@ private:
     //! Set after constructor is called, allows destructor to be called
     bool m_bConstructor;
 
+    //! Heap containing this instance
+    CBotInstanceHeap* m_heap = nullptr;
+    //! Previous and next instances of the heap
+    CBotVarClass* m_heapPrev = nullptr;
+    CBotVarClass* m_heapNext = nullptr;
+    //! Used by CBotInstanceHeap::Collect()
+    int m_gcRefs = 0;
+
     friend class CBotVar;
     friend class CBotVarPointer;
+    friend class CBotInstanceHeap;
 };
 
 } // namespace CBot
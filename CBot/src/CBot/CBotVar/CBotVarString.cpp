@@ -19,27 +19,112 @@
 
 #include "CBot/CBotVar/CBotVarString.h"
 
+#include "CBot/CBotFileUtils.h"
+
+#include <algorithm>
+
 namespace CBot
 {
 
+////////////////////////////////////////////////////////////////////////////////
+CBotStringValue::CBotStringValue(std::string_view str)
+{
+    if (str.empty()) return;
+    m_buffer = std::make_shared<std::string>(str);
+    m_length = str.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotStringValue CBotStringValue::Substring(std::size_t start, std::size_t length) const
+{
+    start = std::min(start, m_length);
+    length = std::min(length, m_length - start);
+    if (length == 0) return CBotStringValue();
+
+    if (length < m_buffer->size() / 4) return CBotStringValue(GetView().substr(start, length));
+
+    CBotStringValue result = *this;
+    result.m_start += start;
+    result.m_length = length;
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotStringValue::Append(std::string_view str)
+{
+    if (str.empty()) return;
+
+    if (m_buffer != nullptr && m_start + m_length == m_buffer->size())
+    {
+        // other values in this buffer end before, they don't see the new characters
+        m_buffer->append(str);
+        m_length += str.size();
+        return;
+    }
+
+    auto buffer = std::make_shared<std::string>();
+    buffer->reserve(m_length + str.size());
+    buffer->append(GetView());
+    buffer->append(str);
+    m_buffer = buffer;
+    m_start = 0;
+    m_length = m_buffer->size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CBotVarString::Copy(CBotVar* pSrc, bool bName)
+{
+    CBotVar::Copy(pSrc, bName);
+
+    CBotVarString* p = static_cast<CBotVarString*>(pSrc);
+    m_val = p->m_val;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string CBotVarString::GetValString() const
+{
+    if (m_binit == CBotVar::InitType::UNDEF)
+        return UndefinedTokenString();
+
+    return m_val.ToString();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CBotStringValue CBotVarString::FromVar(CBotVar* var)
+{
+    if (var->GetType() == CBotTypString && var->GetInit() != CBotVar::InitType::UNDEF)
+        return static_cast<CBotVarString*>(var)->m_val;
+
+    return CBotStringValue(var->GetValString());
+}
+
+////////////////////////////////////////////////////////////////////////////////
 void CBotVarString::Add(CBotVar* left, CBotVar* right)
 {
-    SetValString(left->GetValString() + right->GetValString());
+    CBotStringValue value = FromVar(left);
+    if (right->GetType() == CBotTypString && right->GetInit() != CBotVar::InitType::UNDEF)
+        value.Append(static_cast<CBotVarString*>(right)->m_val.GetView());
+    else
+        value.Append(right->GetValString());
+    SetValue(value);
 }
 
+////////////////////////////////////////////////////////////////////////////////
 bool CBotVarString::Eq(CBotVar* left, CBotVar* right)
 {
-    return left->GetValString() == right->GetValString();
+    return FromVar(left).GetView() == FromVar(right).GetView();
 }
 
+////////////////////////////////////////////////////////////////////////////////
 bool CBotVarString::Ne(CBotVar* left, CBotVar* right)
 {
-    return left->GetValString() != right->GetValString();
+    return FromVar(left).GetView() != FromVar(right).GetView();
 }
 
+////////////////////////////////////////////////////////////////////////////////
 bool CBotVarString::Save1State(std::ostream &ostr)
 {
-    return WriteString(ostr, m_val);
+    return WriteString(ostr, m_val.ToString());
 }
 
 } // namespace CBot
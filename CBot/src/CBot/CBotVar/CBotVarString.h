@@ -19,45 +19,131 @@
 
 #pragma once
 
-#include "CBot/CBotVar/CBotVarValue.h"
+#include "CBot/CBotVar/CBotVar.h"
+
+#include "CBot/CBotNumberConversion.h"
+#include "CBot/CBotToken.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
 
 namespace CBot
 {
 
+/**
+ * \brief Value of a string variable
+ *
+ * The characters are stored in a buffer shared by all copies of the value, so assignments,
+ * parameters and values on the stack don't copy the string. A value is a part of its buffer
+ * (start and length). Characters already in a buffer are never modified, the buffer can only grow
+ * at its end, which allows:
+ * - taking a substring without copying, see Substring(),
+ * - appending to a value which ends at the end of its buffer without copying the value, see Append().
+ *   Building a string with s = s + x or s += x is then linear instead of quadratic.
+ */
+class CBotStringValue
+{
+public:
+    CBotStringValue() = default;
+    CBotStringValue(std::string_view str);
+
+    //! Returns the characters, valid until the buffer is modified by Append()
+    std::string_view GetView() const
+    {
+        if (m_buffer == nullptr) return std::string_view();
+        return std::string_view(*m_buffer).substr(m_start, m_length);
+    }
+
+    //! Returns a copy of the characters
+    std::string ToString() const
+    {
+        return std::string(GetView());
+    }
+
+    std::size_t GetLength() const
+    {
+        return m_length;
+    }
+
+    /**
+     * \brief Returns a part of the value
+     *
+     * Large parts share the buffer, small parts are copied so they don't keep a large buffer alive.
+     */
+    CBotStringValue Substring(std::size_t start, std::size_t length = std::string_view::npos) const;
+
+    //! Adds characters at the end of the value
+    void Append(std::string_view str);
+
+private:
+    std::shared_ptr<std::string> m_buffer;
+    std::size_t m_start = 0;
+    std::size_t m_length = 0;
+};
+
 /**
  * \brief CBotVar subclass for managing string values (::CBotTypString)
  */
-class CBotVarString : public CBotVarValue<std::string, CBotTypString>
+class CBotVarString : public CBotVar
 {
 public:
-    CBotVarString(const CBotToken &name) : CBotVarValue(name) {}
+    CBotVarString(const CBotToken &name) : CBotVar(name)
+    {
+        m_type = CBotTypString;
+    }
+
+    void Copy(CBotVar* pSrc, bool bName = true) override;
 
     void SetValString(const std::string& val) override
     {
-        m_val = val;
-        m_binit = CBotVar::InitType::DEF;
+        SetValue(CBotStringValue(val));
     }
 
+    std::string GetValString() const override;
+
     void SetValInt(int val, const std::string& s = "") override
     {
-        SetValString(ToString(val));
+        SetValString(NumberToString(val));
     }
 
     void SetValFloat(float val) override
     {
-        SetValString(ToString(val));
+        SetValString(NumberToString(val));
     }
 
     int GetValInt() const override
     {
-        return FromString<int>(GetValString());
+        int value = 0;
+        StringToNumber(GetValString(), value);
+        return value;
     }
 
     float GetValFloat() const override
     {
-        return FromString<float>(GetValString());
+        float value = 0;
+        StringToNumber(GetValString(), value);
+        return value;
     }
 
+    //! Sets the value, sharing the characters with val
+    void SetValue(const CBotStringValue& val)
+    {
+        m_val = val;
+        m_binit = CBotVar::InitType::DEF;
+    }
+
+    //! Returns the value without copying the characters
+    const CBotStringValue& GetValue() const
+    {
+        return m_val;
+    }
+
+    /**
+     * \brief Returns the value of a variable of type ::CBotTypString, or its conversion to string for other types
+     */
+    static CBotStringValue FromVar(CBotVar* var);
+
     void Add(CBotVar* left, CBotVar* right) override;
 
     bool Eq(CBotVar* left, CBotVar* right) override;
@@ -66,22 +152,8 @@ public:
     bool Save1State(std::ostream &ostr) override;
 
 private:
-    template<typename T>
-    static std::string ToString(T val)
-    {
-        std::ostringstream ss;
-        ss << val;
-        return ss.str();
-    }
-
-    template<typename T>
-    static T FromString(std::string val)
-    {
-        std::istringstream ss(val);
-        T v;
-        ss >> v;
-        return v;
-    }
+    //! The value
+    CBotStringValue m_val;
 };
 
 } // namespace CBot
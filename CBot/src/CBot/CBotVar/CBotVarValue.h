@@ -22,9 +22,9 @@
 #include "CBot/CBotVar/CBotVar.h"
 
 #include "CBot/CBotEnums.h"
+#include "CBot/CBotNumberConversion.h"
 #include "CBot/CBotToken.h"
 
-#include <sstream>
 #include <cmath>
 
 
@@ -57,8 +57,7 @@ public:
 
     void SetValString(const std::string& val) override
     {
-        std::istringstream s(val);
-        s >> m_val;
+        StringToNumber(val, m_val);
         m_binit = CBotVar::InitType::DEF;
     }
 
@@ -67,9 +66,7 @@ public:
         if (m_binit == CBotVar::InitType::UNDEF)
             return UndefinedTokenString();
 
-        std::ostringstream s;
-        s << std::boolalpha << m_val;
-        return s.str();
+        return NumberToString(m_val);
     }
 
 protected:
@@ -22,7 +22,6 @@
 #include "CBot/CBot.h"
 
 #include <memory>
-#include <unordered_map>
 #include <cassert>
 
 namespace CBot
@@ -31,8 +30,16 @@ namespace CBot
 namespace
 {
 std::unique_ptr<CBotFileAccessHandler> g_fileHandler;
-std::unordered_map<int, std::unique_ptr<CBotFile>> g_files;
-int g_nextFileId = 1;
+
+CBotFile* GetFile(int fileHandle)
+{
+    return CBotContext::GetCurrent()->GetFile(fileHandle);
+}
+
+void CloseFile(int fileHandle)
+{
+    CBotContext::GetCurrent()->CloseFile(fileHandle);
+}
 
 bool FileClassOpenFile(CBotVar* pThis, CBotVar* pVar, CBotVar* pResult, int& Exception)
 {
@@ -74,8 +81,8 @@ bool FileClassOpenFile(CBotVar* pThis, CBotVar* pVar, CBotVar* pResult, int& Exc
 
     if (!file->Opened()) { Exception = CBotErrFileOpen; return false; }
 
-    int fileHandle = g_nextFileId++;
-    g_files[fileHandle] = std::move(file);
+    // the handle is valid in the context of the program only
+    int fileHandle = CBotContext::GetCurrent()->AddFile(std::move(file));
 
     // save the file handle
     pVar = pThis->GetItem("handle");
@@ -131,7 +138,7 @@ bool rfdestruct (CBotVar* pThis, CBotVar* pVar, CBotVar* pResult, int& Exception
     pVar = pThis->GetItem("handle");
 
     if (!pVar->IsDefined()) return true; // file not opened
-    g_files.erase(pVar->GetValInt());
+    CloseFile(pVar->GetValInt());
 
     pVar->SetInit(CBotVar::InitType::UNDEF);
     return true;
@@ -194,14 +201,13 @@ bool rfclose (CBotVar* pThis, CBotVar* pVar, CBotVar* pResult, int& Exception, v
 
     int fileHandle = pVar->GetValInt();
 
-    const auto handleIter = g_files.find(fileHandle);
-    if (handleIter == g_files.end())
+    if (GetFile(fileHandle) == nullptr)
     {
         Exception = CBotErrNotOpen;
         return false;
     }
 
-    g_files.erase(handleIter);
+    CloseFile(fileHandle);
 
     pVar->SetInit(CBotVar::InitType::UNDEF);
     return true;
@@ -237,17 +243,17 @@ bool rfwrite (CBotVar* pThis, CBotVar* pVar, CBotVar* pResult, int& Exception, v
 
     int fileHandle = pVar->GetValInt();
 
-    const auto handleIter = g_files.find(fileHandle);
-    if (handleIter == g_files.end())
+    CBotFile* file = GetFile(fileHandle);
+    if (file == nullptr)
     {
         Exception = CBotErrNotOpen;
         return false;
     }
 
-    handleIter->second->Write(param + "\n");
+    file->Write(param + "\n");
 
     // if an error occurs generate an exception
-    if ( handleIter->second->Errored() ) { Exception = CBotErrWrite; return false; }
+    if ( file->Errored() ) { Exception = CBotErrWrite; return false; }
 
     return true;
 }
@@ -283,17 +289,17 @@ bool rfread(CBotVar* pThis, CBotVar* pVar, CBotVar* pResult, int& Exception, voi
 
     int fileHandle = pVar->GetValInt();
 
-    const auto handleIter = g_files.find(fileHandle);
-    if (handleIter == g_files.end())
+    CBotFile* file = GetFile(fileHandle);
+    if (file == nullptr)
     {
         Exception = CBotErrNotOpen;
         return false;
     }
 
-    std::string line = handleIter->second->ReadLine();
+    std::string line = file->ReadLine();
 
     // if an error occurs generate an exception
-    if ( handleIter->second->Errored() ) { Exception = CBotErrRead; return false; }
+    if ( file->Errored() ) { Exception = CBotErrRead; return false; }
 
     pResult->SetValString( line.c_str() );
 
@@ -325,14 +331,14 @@ bool rfeof (CBotVar* pThis, CBotVar* pVar, CBotVar* pResult, int& Exception, voi
 
     int fileHandle = pVar->GetValInt();
 
-    const auto handleIter = g_files.find(fileHandle);
-    if (handleIter == g_files.end())
+    CBotFile* file = GetFile(fileHandle);
+    if (file == nullptr)
     {
         Exception = CBotErrNotOpen;
         return false;
     }
 
-    pResult->SetValInt( handleIter->second->IsEOF() );
+    pResult->SetValInt( file->IsEOF() );
 
     return true;
 }
@@ -23,6 +23,8 @@
 
 #include "CBot/CBotUtils.h"
 
+#include "CBot/CBotVar/CBotVarString.h"
+
 #include <common/stringutils.h>
 
 namespace CBot
@@ -42,11 +44,8 @@ bool rStrLen( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     // no second parameter
     if ( pVar->GetNext() != nullptr ) { ex = CBotErrOverParam ; return true; }
 
-    // get the contents of the string
-    std::string  s = pVar->GetValString();
-
     // puts the length of the stack
-    pResult->SetValInt( s.length() );
+    pResult->SetValInt( CBotVarString::FromVar(pVar).GetLength() );
     return true;
 }
 
@@ -60,7 +59,7 @@ bool rStrLeft( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     if ( pVar->GetType() != CBotTypString ) { ex = CBotErrBadString ; return true; }
 
     // get the contents of the string
-    std::string  s = pVar->GetValString();
+    CBotStringValue s = CBotVarString::FromVar(pVar);
 
     // it takes a second parameter
     pVar = pVar->GetNext();
@@ -72,17 +71,17 @@ bool rStrLeft( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     // retrieves this number
     int n = pVar->GetValInt();
 
-    if (n > static_cast<int>(s.length())) n = s.length();
+    if (n > static_cast<int>(s.GetLength())) n = s.GetLength();
     if (n < 0) n = 0;
 
     // no third parameter
     if ( pVar->GetNext() != nullptr ) { ex = CBotErrOverParam ; return true; }
 
     // takes the interesting part
-    s = s.substr(0, n);
+    s = s.Substring(0, n);
 
     // puts on the stack
-    pResult->SetValString( s );
+    static_cast<CBotVarString*>(pResult)->SetValue( s );
     return true;
 }
 
@@ -96,7 +95,7 @@ bool rStrRight( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     if ( pVar->GetType() != CBotTypString ) { ex = CBotErrBadString ; return true; }
 
     // get the contents of the string
-    std::string  s = pVar->GetValString();
+    CBotStringValue s = CBotVarString::FromVar(pVar);
 
     // it takes a second parameter
     pVar = pVar->GetNext();
@@ -108,17 +107,17 @@ bool rStrRight( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     // retrieves this number
     int n = pVar->GetValInt();
 
-    if (n > static_cast<int>(s.length())) n = s.length();
+    if (n > static_cast<int>(s.GetLength())) n = s.GetLength();
     if (n < 0) n = 0;
 
     // no third parameter
     if ( pVar->GetNext() != nullptr ) { ex = CBotErrOverParam ; return true; }
 
     // takes the interesting part
-    s = s.substr(s.length()-n, std::string::npos);
+    s = s.Substring(s.GetLength()-n);
 
     // puts on the stack
-    pResult->SetValString( s );
+    static_cast<CBotVarString*>(pResult)->SetValue( s );
     return true;
 }
 
@@ -132,7 +131,7 @@ bool rStrMid( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     if ( pVar->GetType() != CBotTypString ) { ex = CBotErrBadString ; return true; }
 
     // get the contents of the string
-    std::string  s = pVar->GetValString();
+    CBotStringValue s = CBotVarString::FromVar(pVar);
 
     // it takes a second parameter
     pVar = pVar->GetNext();
@@ -144,7 +143,7 @@ bool rStrMid( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     // retrieves this number
     int n = pVar->GetValInt();
 
-    if (n > static_cast<int>(s.length())) n = s.length();
+    if (n > static_cast<int>(s.GetLength())) n = s.GetLength();
     if (n < 0) n = 0;
 
     // third parameter optional
@@ -158,23 +157,23 @@ bool rStrMid( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
         // retrieves this number
         int l = pVar->GetValInt();
 
-        if (l > static_cast<int>(s.length())) l = s.length();
+        if (l > static_cast<int>(s.GetLength())) l = s.GetLength();
         if (l < 0) l = 0;
 
         // but no fourth parameter
         if ( pVar->GetNext() != nullptr ){ ex = CBotErrOverParam ; return true; }
 
         // takes the interesting part
-        s = s.substr(n, l);
+        s = s.Substring(n, l);
     }
     else
     {
         // takes the interesting part
-        s = s.substr(n);
+        s = s.Substring(n);
     }
 
     // puts on the stack
-    pResult->SetValString( s );
+    static_cast<CBotVarString*>(pResult)->SetValue( s );
     return true;
 }
 
@@ -210,7 +209,7 @@ bool rStrFind( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     if ( pVar->GetType() != CBotTypString ) { ex = CBotErrBadString ; return true; }
 
     // get the contents of the string
-    std::string  s = pVar->GetValString();
+    CBotStringValue s = CBotVarString::FromVar(pVar);
 
     // it takes a second parameter
     pVar = pVar->GetNext();
@@ -220,14 +219,14 @@ bool rStrFind( CBotVar* pVar, CBotVar* pResult, int& ex, void* pUser )
     if ( pVar->GetType() != CBotTypString ) { ex = CBotErrBadString ; return true; }
 
     // retrieves this number
-    std::string s2 = pVar->GetValString();
+    CBotStringValue s2 = CBotVarString::FromVar(pVar);
 
     // no third parameter
     if ( pVar->GetNext() != nullptr ) { ex = CBotErrOverParam ; return true; }
 
     // puts the result on the stack
-    std::size_t res = s.find(s2);
-    if (res != std::string::npos)
+    std::size_t res = s.GetView().find(s2.GetView());
+    if (res != std::string_view::npos)
     {
         pResult->SetValInt(res);
     }
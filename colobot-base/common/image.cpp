@@ -20,6 +20,8 @@
 
 #include "common/image.h"
 
+#include "common/ioutils.h"
+
 #include "common/resources/outputstream.h"
 #include "common/resources/resourcemanager.h"
 
@@ -441,6 +443,93 @@ bool CImage::SavePNG(const std::string& fileName)
     return true;
 }
 
+bool CImage::SaveRaw(std::ostream& stream)
+{
+    if (IsEmpty())
+    {
+        m_error = "Empty image!";
+        return false;
+    }
+
+    SDL_Surface* surface = m_data->surface;
+    if (surface->format->palette != nullptr)
+    {
+        m_error = "Palette images are not supported";
+        return false;
+    }
+
+    IOUtils::WriteBinary<4, int>(surface->w, stream);
+    IOUtils::WriteBinary<4, int>(surface->h, stream);
+    IOUtils::WriteBinary<1, int>(surface->format->BitsPerPixel, stream);
+    IOUtils::WriteBinary<4, Uint32>(surface->format->Rmask, stream);
+    IOUtils::WriteBinary<4, Uint32>(surface->format->Gmask, stream);
+    IOUtils::WriteBinary<4, Uint32>(surface->format->Bmask, stream);
+    IOUtils::WriteBinary<4, Uint32>(surface->format->Amask, stream);
+
+    int lineSize = surface->w * surface->format->BytesPerPixel;
+
+    SDL_LockSurface(surface);
+    const char* pixels = static_cast<const char*>(surface->pixels);
+    for (int line = 0; line < surface->h; ++line)
+        stream.write(&pixels[line * surface->pitch], lineSize);
+    SDL_UnlockSurface(surface);
+
+    if (!stream)
+    {
+        m_error = "Error writing image data";
+        return false;
+    }
+
+    return true;
+}
+
+bool CImage::LoadRaw(std::istream& stream)
+{
+    if (! IsEmpty() )
+        Free();
+
+    m_error = "";
+
+    int width = IOUtils::ReadBinary<4, int>(stream);
+    int height = IOUtils::ReadBinary<4, int>(stream);
+    int bitsPerPixel = IOUtils::ReadBinary<1, int>(stream);
+    Uint32 rMask = IOUtils::ReadBinary<4, Uint32>(stream);
+    Uint32 gMask = IOUtils::ReadBinary<4, Uint32>(stream);
+    Uint32 bMask = IOUtils::ReadBinary<4, Uint32>(stream);
+    Uint32 aMask = IOUtils::ReadBinary<4, Uint32>(stream);
+
+    if (!stream || width <= 0 || height <= 0 || bitsPerPixel % 8 != 0 || bitsPerPixel < 8 || bitsPerPixel > 32)
+    {
+        m_error = "Invalid image header";
+        return false;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurface(0, width, height, bitsPerPixel, rMask, gMask, bMask, aMask);
+    if (surface == nullptr)
+    {
+        m_error = std::string(SDL_GetError());
+        return false;
+    }
+
+    int lineSize = width * surface->format->BytesPerPixel;
+
+    char* pixels = static_cast<char*>(surface->pixels);
+    for (int line = 0; line < height; ++line)
+        stream.read(&pixels[line * surface->pitch], lineSize);
+
+    if (!stream)
+    {
+        SDL_FreeSurface(surface);
+        m_error = "Unexpected end of image data";
+        return false;
+    }
+
+    m_data = std::make_unique<ImageData>();
+    m_data->surface = surface;
+
+    return true;
+}
+
 void CImage::SetDataPixels(void *pixels)
 {
     Uint8* srcPixels = static_cast<Uint8*> (pixels);
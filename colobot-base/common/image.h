@@ -28,6 +28,7 @@
 
 #include <glm/glm.hpp>
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 
@@ -103,6 +104,11 @@ public:
     //! Saves the image to the specified file in PNG format
     bool SavePNG(const std::string &fileName);
 
+    //! Writes the raw pixels together with their pixel format to \a stream
+    bool SaveRaw(std::ostream &stream);
+    //! Reads an image written by SaveRaw() from \a stream
+    bool LoadRaw(std::istream &stream);
+
     //! Returns the last error
     std::string GetError();
 
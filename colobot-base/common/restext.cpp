@@ -120,6 +120,7 @@ void InitializeRestext()
     stringsText[RT_STUDIO_COMPOK]    = TR("Compilation ok (0 errors)");
     stringsText[RT_STUDIO_PROGSTOP]  = TR("Program finished");
     stringsText[RT_STUDIO_CLONED]    = TR("Program cloned");
+    stringsText[RT_STUDIO_PROFILE]   = TR("Profile written to %s");
 
     stringsText[RT_PROGRAM_READONLY] = TR("This program is read-only, clone it to edit");
     stringsText[RT_PROGRAM_EXAMPLE]  = TR("This is example code that cannot be run directly");
@@ -503,6 +504,7 @@ void InitializeRestext()
     stringsEvent[EVENT_STUDIO_RUN]          = TR("Execute/stop");
     stringsEvent[EVENT_STUDIO_REALTIME]     = TR("Pause/continue");
     stringsEvent[EVENT_STUDIO_STEP]         = TR("One step");
+    stringsEvent[EVENT_STUDIO_PROFILE]      = TR("Profile the program");
 
 
 
@@ -810,6 +812,7 @@ void InitializeRestext()
     stringsCbot[CBot::CBotErrNotOpen]       = TR("File not open");
     stringsCbot[CBot::CBotErrRead]          = TR("Read error");
     stringsCbot[CBot::CBotErrWrite]         = TR("Write error");
+    stringsCbot[CBot::CBotErrOutOfMemory]   = TR("Not enough memory");
 }
 
 
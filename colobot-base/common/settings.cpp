@@ -28,9 +28,12 @@
 #include "graphics/core/device.h"
 #include "graphics/engine/camera.h"
 #include "graphics/engine/engine.h"
+#include "graphics/engine/pyro_manager.h"
 
 #include "level/robotmain.h"
 
+#include "script/scheduler.h"
+
 #include "sound/sound.h"
 
 CSettings::CSettings()
@@ -85,11 +88,13 @@ void CSettings::SaveSettings()
     GetConfigFile().SetBoolProperty("Setup", "Autosave", main->GetAutosave());
     GetConfigFile().SetIntProperty("Setup", "AutosaveInterval", main->GetAutosaveInterval());
     GetConfigFile().SetIntProperty("Setup", "AutosaveSlots", main->GetAutosaveSlots());
+    GetConfigFile().SetFloatProperty("Setup", "CBotFrameBudget", main->GetScriptScheduler()->GetBudget()*1000.0f);
     GetConfigFile().SetBoolProperty("Setup", "ObjectDirty", engine->GetDirty());
     GetConfigFile().SetBoolProperty("Setup", "FogMode", engine->GetFog());
     GetConfigFile().SetBoolProperty("Setup", "LightMode", engine->GetLightMode());
     GetConfigFile().SetIntProperty("Setup", "JoystickIndex", app->GetJoystickEnabled() ? app->GetJoystick().index : -1);
     GetConfigFile().SetFloatProperty("Setup", "ParticleDensity", engine->GetParticleDensity());
+    GetConfigFile().SetIntProperty("Setup", "PyroFrameBudget", engine->GetPyroManager()->GetSpawnBudget());
     GetConfigFile().SetFloatProperty("Setup", "ClippingDistance", engine->GetClippingDistance());
     GetConfigFile().SetBoolProperty("Setup", "EditIndentMode", engine->GetEditIndentMode());
     GetConfigFile().SetIntProperty("Setup", "EditIndentValue", engine->GetEditIndentValue());
@@ -192,6 +197,9 @@ void CSettings::LoadSettings()
     if (GetConfigFile().GetIntProperty("Setup", "AutosaveSlots", iValue))
         main->SetAutosaveSlots(iValue);
 
+    if (GetConfigFile().GetFloatProperty("Setup", "CBotFrameBudget", fValue))
+        main->GetScriptScheduler()->SetBudget(fValue/1000.0f);
+
     if (GetConfigFile().GetBoolProperty("Setup", "ObjectDirty", bValue))
         engine->SetDirty(bValue);
 
@@ -227,6 +235,9 @@ void CSettings::LoadSettings()
     if (GetConfigFile().GetFloatProperty("Setup", "ParticleDensity", fValue))
         engine->SetParticleDensity(fValue);
 
+    if (GetConfigFile().GetIntProperty("Setup", "PyroFrameBudget", iValue))
+        engine->GetPyroManager()->SetSpawnBudget(iValue);
+
     if (GetConfigFile().GetFloatProperty("Setup", "ClippingDistance", fValue))
         engine->SetClippingDistance(fValue);
 
@@ -0,0 +1,120 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * \class CWorkerPool
+ * \brief Fixed set of threads that run queued functions in parallel
+ *
+ * Unlike CWorkerThread, functions are run without holding the queue lock,
+ * so any number of them can execute at the same time. Wait() blocks until
+ * the queue is drained and all started functions have returned.
+ */
+class CWorkerPool
+{
+public:
+    using ThreadFunctionPtr = std::function<void()>;
+
+public:
+    //! Creates the pool; \a threadCount of 0 uses the number of hardware threads
+    explicit CWorkerPool(unsigned int threadCount = 0)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        m_threads.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; ++i)
+            m_threads.emplace_back(&CWorkerPool::Run, this);
+    }
+
+    ~CWorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_running = false;
+            m_cond.notify_all();
+        }
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    //! Queues a function to be run on one of the pool threads
+    void Start(ThreadFunctionPtr&& func)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_queue.push(std::move(func));
+        m_cond.notify_one();
+    }
+
+    //! Blocks until all queued functions have finished
+    void Wait()
+    {
+        auto lock = std::unique_lock<std::mutex>(m_mutex);
+        m_idleCond.wait(lock, [&]() { return m_queue.empty() && m_active == 0; });
+    }
+
+    //! Returns the number of threads in the pool
+    std::size_t GetThreadCount() const
+    {
+        return m_threads.size();
+    }
+
+    CWorkerPool(const CWorkerPool&) = delete;
+    CWorkerPool& operator=(const CWorkerPool&) = delete;
+
+private:
+    void Run()
+    {
+        auto lock = std::unique_lock<std::mutex>(m_mutex);
+        while (true)
+        {
+            m_cond.wait(lock, [&]() { return !m_running || !m_queue.empty(); });
+            if (!m_running) break;
+
+            ThreadFunctionPtr func = std::move(m_queue.front());
+            m_queue.pop();
+            m_active++;
+
+            lock.unlock();
+            func();
+            lock.lock();
+
+            m_active--;
+            if (m_queue.empty() && m_active == 0)
+                m_idleCond.notify_all();
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::condition_variable m_idleCond;
+    bool m_running = true;
+    int m_active = 0;
+    std::queue<ThreadFunctionPtr> m_queue;
+};
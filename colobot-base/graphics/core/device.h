@@ -170,6 +170,21 @@ public:
     virtual void* GetPixelsData() = 0;
 };
 
+/**
+ * \class CFrameBufferReadback
+ * \brief Pixels of the screen being copied by the GPU, without stalling the rendering
+ */
+class CFrameBufferReadback
+{
+public:
+    virtual ~CFrameBufferReadback() {}
+
+    //! Returns true when the copy is finished and the pixels can be taken without waiting
+    virtual bool IsReady() = 0;
+    //! Returns the pixels, waits for the copy if it is not finished yet
+    virtual std::unique_ptr<CFrameBufferPixels> GetPixels() = 0;
+};
+
 class CVertexBuffer
 {
 protected:
@@ -323,6 +338,8 @@ public:
 
     //! Creates a texture from image; the image can be safely removed after that
     virtual Texture CreateTexture(CImage *image, const TextureCreateParams &params) = 0;
+    //! Creates a texture from image with mipmap levels computed beforehand, uploaded instead of generating them
+    virtual Texture CreateTexture(CImage *image, const TextureCreateParams &params, const std::vector<TextureMipmap> &mipmaps) = 0;
     //! Creates a texture from raw image data; image data can be freed after that
     virtual Texture CreateTexture(ImageData *data, const TextureCreateParams &params) = 0;
     //! Creates a depth texture with specific dimensions and depth
@@ -363,6 +380,12 @@ public:
     //! Returns the pixels of the entire screen
     virtual std::unique_ptr<CFrameBufferPixels> GetFrameBufferPixels() const = 0;
 
+    //! Starts copying the pixels of the entire screen, they are ready a few frames later
+    virtual std::unique_ptr<CFrameBufferReadback> ReadFrameBufferPixels() = 0;
+
+    //! Creates a texture from the entire screen, reduced to a quarter of its size and blurred
+    virtual Texture CreateBlurredScreenTexture() = 0;
+
     //! Returns framebuffer with given name or nullptr if it doesn't exist
     virtual CFramebuffer* GetFramebuffer(std::string name) = 0;
 
@@ -36,6 +36,9 @@
 namespace Gfx
 {
 
+//! Maximum number of dynamic lights affecting one draw call, see CLightManager::GetObjectLights()
+const int MAX_DRAW_LIGHTS = 4;
+
 /**
  * \enum LightType
  * \brief Type of light in 3D scene
@@ -77,6 +80,8 @@ struct Light
     float           spotAngle = Math::PI/2.0f;
     //! Intensity of spotlight (0 = uniform; 128 = most intense)
     float           spotIntensity = 0.0f;
+    //! Distance beyond which the light is culled, 0 to derive it from the attenuation
+    float           range = 0.0f;
 
     //! Loads default values
     void LoadDefault()
@@ -34,6 +34,7 @@ class CVertexBuffer;
 enum class CullFace : unsigned char;
 enum class TransparencyMode : unsigned char;
 struct Color;
+struct Light;
 struct Texture;
 struct Vertex2D;
 struct Vertex3D;
@@ -61,6 +62,20 @@ struct ShadowParam
     glm::vec2 uv_scale;
 };
 
+/**
+ * \struct ObjectInstance
+ * \brief Per-instance parameters for instanced object rendering
+ */
+struct ObjectInstance
+{
+    //! Model matrix
+    glm::mat4 modelMatrix;
+    //! Albedo color, replaces the color set with SetAlbedoColor()
+    glm::vec4 albedoColor;
+    //! Recolor target (RGB), replaces the target color set with SetRecolor()
+    glm::vec3 recolorTo;
+};
+
 /**
  * \class CRenderer
  * \brief Common abstract interface for renderers
@@ -138,6 +153,8 @@ public:
     virtual void SetSky(const Color& color, float intensity) = 0;
     //! Sets shadow parameters
     virtual void SetShadowParams(int count, const ShadowParam* params) = 0;
+    //! Sets point and spot lights of the next draws, at most MAX_DRAW_LIGHTS
+    virtual void SetDynamicLights(int count, const Light* lights) = 0;
 
     //! Sets fog parameters
     virtual void SetFog(float min, float max, const glm::vec3& color) = 0;
@@ -192,6 +209,8 @@ public:
     virtual void SetSky(const Color& color, float intensity) = 0;
     //! Sets shadow parameters
     virtual void SetShadowParams(int count, const ShadowParam* params) = 0;
+    //! Sets point and spot lights of the next draws, at most MAX_DRAW_LIGHTS
+    virtual void SetDynamicLights(int count, const Light* lights) = 0;
 
     //! Sets fog parameters
     virtual void SetFog(float min, float max, const glm::vec3& color) = 0;
@@ -218,8 +237,15 @@ public:
     //! Sets triplanar scale
     virtual void SetTriplanarScale(float scale) = 0;
 
+    //! Sets wave animation of the vertices and normals, used by water surfaces
+    virtual void SetWaves(bool enabled, float time = {}, float height = {}, float glint = {}) = 0;
+    //! Lowers the vertices by factor times their squared horizontal distance from center
+    virtual void SetCurvature(const glm::vec3& center, float factor) = 0;
+
     //! Draws an object
     virtual void DrawObject(const CVertexBuffer* buffer) = 0;
+    //! Draws many copies of an object in one call, each with its own transform and colors
+    virtual void DrawObjectInstanced(const CVertexBuffer* buffer, int count, const ObjectInstance* instances) = 0;
     //! Draws a primitive
     virtual void DrawPrimitive(PrimitiveType type, int count, const Vertex3D* vertices) = 0;
     //! Draws a set of primitives
@@ -285,9 +311,15 @@ public:
     virtual void SetShadowMap(const Texture& texture) = 0;
     //! Sets shadow region
     virtual void SetShadowRegion(const glm::vec2& offset, const glm::vec2& scale) = 0;
+    //! Clears the depth in the current shadow region
+    virtual void ClearShadowRegion() = 0;
+    //! Copies the depth of the current shadow region from a rectangle of the same size in another shadow map
+    virtual void CopyShadowRegion(const Texture& source, const glm::ivec2& sourcePosition) = 0;
 
     //! Draws terrain object
     virtual void DrawObject(const CVertexBuffer* buffer, bool transparent) = 0;
+    //! Draws many copies of an object in one call, each with its own model matrix
+    virtual void DrawObjectInstanced(const CVertexBuffer* buffer, bool transparent, int count, const glm::mat4* matrices) = 0;
 };
 
 } // namespace Gfx
@@ -26,6 +26,8 @@
 
 #include <glm/glm.hpp>
 
+#include <vector>
+
 
 // Graphics module namespace
 namespace Gfx
@@ -99,6 +101,18 @@ struct TextureCreateParams
     bool padToNearestPowerOfTwo = false;
 };
 
+/**
+ * \struct TextureMipmap
+ * \brief Precomputed mipmap level of a texture
+ */
+struct TextureMipmap
+{
+    //! Size of the level
+    glm::ivec2 size = { 0, 0 };
+    //! 8-bit RGBA pixels, rows without padding
+    std::vector<unsigned char> pixels;
+};
+
 /**
  * \struct Texture
  * \brief Info about a texture
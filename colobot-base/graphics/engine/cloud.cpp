@@ -20,6 +20,7 @@
 
 #include "graphics/engine/cloud.h"
 
+#include "graphics/core/device.h"
 #include "graphics/core/material.h"
 #include "graphics/core/renderers.h"
 #include "graphics/core/transparency.h"
@@ -29,8 +30,6 @@
 
 #include "level/robotmain.h"
 
-#include "math/geometry.h"
-
 
 // Graphics module namespace
 namespace Gfx
@@ -53,6 +52,7 @@ CCloud::CCloud(CEngine* engine)
 
 CCloud::~CCloud()
 {
+    DestroyBuffer();
 }
 
 bool CCloud::EventProcess(const Event &event)
@@ -78,29 +78,15 @@ bool CCloud::EventFrame(const Event &event)
     return true;
 }
 
-void CCloud::AdjustLevel(glm::vec3& pos, glm::vec3& eye, float deep,
-                         glm::vec2& uv1, glm::vec2& uv2)
-{
-    uv1.x = (pos.x+20000.0f)/1280.0f;
-    uv1.y = (pos.z+20000.0f)/1280.0f;
-    uv1.x -= m_time*(m_wind.x/100.0f);
-    uv1.y -= m_time*(m_wind.z/100.0f);
-
-    uv2.x = 0.0f;
-    uv2.y = 0.0f;
-
-    float dist = Math::DistanceProjected(pos, eye);
-    float factor = powf(dist/deep, 2.0f);
-    pos.y -= m_level*factor*10.0f;
-}
-
 void CCloud::Draw()
 {
     if (! m_enabled) return;
     if (m_level == 0.0f) return;
-    if (m_lines.empty()) return;
+    if (m_buffer == nullptr) return;
 
-    std::vector<Vertex3D> vertices((m_brickCount+2)*2, Vertex3D());
+    // Still being decoded when the clouds were created
+    if (! m_texture.Valid())
+        LoadTexture();
 
     float iDeep = m_engine->GetDeepView();
     float deep = (m_brickCount*m_brickSize)/2.0f;
@@ -120,8 +106,7 @@ void CCloud::Draw()
     renderer->SetProjectionMatrix(m_engine->GetMatProj());
     renderer->SetViewMatrix(m_engine->GetMatView());
 
-    auto texture = m_engine->LoadTexture(m_fileName);
-    renderer->SetAlbedoTexture(texture);
+    renderer->SetAlbedoTexture(m_texture);
 
     renderer->SetTransparency(TransparencyMode::BLACK);
     renderer->SetDepthMask(false);
@@ -129,57 +114,13 @@ void CCloud::Draw()
     glm::mat4 matrix = glm::mat4(1.0f);
     renderer->SetModelMatrix(matrix);
 
-    float size = m_brickSize/2.0f;
-    glm::vec3 eye = m_engine->GetEyePt();
-    glm::vec3 n = glm::vec3(0.0f, -1.0f, 0.0f);
-
-    // Draws all the lines
-    for (int i = 0; i < static_cast<int>( m_lines.size() ); i++)
-    {
-        glm::vec3 pos{};
-        pos.y = m_level;
-        pos.z = m_lines[i].pz;
-        pos.x = m_lines[i].px1;
-
-        int vertexIndex = 0;
-
-        glm::vec3 p{};
-        glm::vec2 uv1, uv2;
+    // The wind moves the texture, the layer goes down away from the eye
+    glm::vec2 offset = { -m_time*(m_wind.x/100.0f), -m_time*(m_wind.z/100.0f) };
+    renderer->SetUVTransform(offset, { 1.0f, 1.0f });
+    renderer->SetCurvature(m_engine->GetEyePt(), m_level*10.0f/(deep*deep));
 
-        glm::u8vec4 white(255);
-
-        p.x = pos.x-size;
-        p.z = pos.z+size;
-        p.y = pos.y;
-        AdjustLevel(p, eye, deep, uv1, uv2);
-        vertices[vertexIndex++] = Vertex3D{ p, white, uv1, uv2, n };
-
-        p.x = pos.x-size;
-        p.z = pos.z-size;
-        p.y = pos.y;
-        AdjustLevel(p, eye, deep, uv1, uv2);
-        vertices[vertexIndex++] = Vertex3D{ p, white, uv1, uv2, n };
-
-        for (int j = 0; j < m_lines[i].len; j++)
-        {
-            p.x = pos.x+size;
-            p.z = pos.z+size;
-            p.y = pos.y;
-            AdjustLevel(p, eye, deep, uv1, uv2);
-            vertices[vertexIndex++] = Vertex3D{ p, white, uv1, uv2, n };
-
-            p.x = pos.x+size;
-            p.z = pos.z-size;
-            p.y = pos.y;
-            AdjustLevel(p, eye, deep, uv1, uv2);
-            vertices[vertexIndex++] = Vertex3D{ p, white, uv1, uv2, n };
-
-            pos.x += size*2.0f;
-        }
-
-        renderer->DrawPrimitive(PrimitiveType::TRIANGLE_STRIP, vertexIndex, vertices.data());
-        m_engine->AddStatisticTriangle(vertexIndex - 2);
-    }
+    renderer->DrawObject(m_buffer);
+    m_engine->AddStatisticTriangle(static_cast<int>(m_buffer->Size() / 3));
 
     renderer->End();
 
@@ -187,6 +128,19 @@ void CCloud::Draw()
     m_engine->SetFocus(m_engine->GetFocus());
 }
 
+void CCloud::LoadTexture()
+{
+    if (! m_fileName.empty())
+        m_texture = m_engine->LoadTexture(m_fileName);
+    else
+        m_texture.SetInvalid();
+}
+
+const Texture& CCloud::GetTexture() const
+{
+    return m_texture;
+}
+
 void CCloud::CreateLine(int x, int y, int len)
 {
     CloudLine line;
@@ -204,6 +158,54 @@ void CCloud::CreateLine(int x, int y, int len)
     m_lines.push_back(line);
 }
 
+void CCloud::CreateBuffer()
+{
+    DestroyBuffer();
+
+    if (m_lines.empty()) return;
+
+    float size = m_brickSize/2.0f;
+    glm::u8vec4 white(255);
+    glm::vec3 n = glm::vec3(0.0f, -1.0f, 0.0f);
+
+    std::vector<Vertex3D> vertices;
+    vertices.reserve(m_lines.size()*m_brickCount*6);
+
+    for (const auto& line : m_lines)
+    {
+        for (int j = 0; j < line.len; j++)
+        {
+            float x1 = line.px1 - size + size*2.0f*j;
+            float x2 = x1 + size*2.0f;
+
+            glm::vec3 p[4] =
+            {
+                { x1, m_level, line.pz+size },
+                { x1, m_level, line.pz-size },
+                { x2, m_level, line.pz+size },
+                { x2, m_level, line.pz-size },
+            };
+
+            for (int k : { 0, 1, 2, 2, 1, 3 })
+            {
+                glm::vec2 uv = { (p[k].x+20000.0f)/1280.0f, (p[k].z+20000.0f)/1280.0f };
+                vertices.push_back({ p[k], white, uv, {}, n });
+            }
+        }
+    }
+
+    m_buffer = m_engine->GetDevice()->CreateVertexBuffer(PrimitiveType::TRIANGLES,
+                                                         vertices.data(), vertices.size());
+}
+
+void CCloud::DestroyBuffer()
+{
+    if (m_buffer != nullptr)
+        m_engine->GetDevice()->DestroyVertexBuffer(m_buffer);
+
+    m_buffer = nullptr;
+}
+
 void CCloud::Create(const std::string& fileName,
                     const Color& diffuse, const Color& ambient,
                     float level)
@@ -215,8 +217,8 @@ void CCloud::Create(const std::string& fileName,
     m_lastTest = 0.0f;
     m_fileName = fileName;
 
-    if (! m_fileName.empty())
-        m_engine->LoadTexture(m_fileName);
+    DestroyBuffer();
+    LoadTexture();
 
     if (m_terrain == nullptr)
         m_terrain = CRobotMain::GetInstancePointer()->GetTerrain();
@@ -235,11 +237,15 @@ void CCloud::Create(const std::string& fileName,
     m_lines.clear();
     for (int y = 0; y < m_brickCount; y++)
         CreateLine(0, y, m_brickCount);
+
+    CreateBuffer();
 }
 
 void CCloud::Flush()
 {
     m_level = 0.0f;
+
+    DestroyBuffer();
 }
 
 void CCloud::SetLevel(float level)
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "graphics/core/color.h"
+#include "graphics/core/texture.h"
 
 #include <glm/glm.hpp>
 
@@ -40,6 +41,7 @@ namespace Gfx
 
 class CEngine;
 class CTerrain;
+class CVertexBuffer;
 
 /**
  * \class CCloud
@@ -49,6 +51,10 @@ class CTerrain;
  * - it occurs only at specified level of terrain. Cloud map is created
  * the same way water is created. CloudLine structs are used to specify
  * lines in X direction in XY terrain coordinates.
+ *
+ * The lines are built once into a vertex buffer when the layer is created.
+ * The wind moves the texture and the layer bends down away from the eye,
+ * see CObjectRenderer::SetCurvature().
  */
 class CCloud
 {
@@ -65,6 +71,11 @@ public:
     //! Draw the clouds
     void        Draw();
 
+    //! Loads the texture of the clouds, after the textures were reloaded
+    void        LoadTexture();
+    //! Returns the texture of the clouds
+    const Texture& GetTexture() const;
+
     //! Management of cloud level
     //@{
     void        SetLevel(float level);
@@ -80,11 +91,12 @@ public:
 protected:
     //! Makes the clouds evolve
     bool        EventFrame(const Event &event);
-    //! Adjusts the position to normal, to imitate the clouds at movement
-    void        AdjustLevel(glm::vec3& pos, glm::vec3& eye, float deep,
-                            glm::vec2& uv1, glm::vec2& uv2);
     //! Updates the positions, relative to the ground
     void        CreateLine(int x, int y, int len);
+    //! Builds the vertex buffer of the layer from the lines
+    void        CreateBuffer();
+    //! Destroys the vertex buffer of the layer
+    void        DestroyBuffer();
 
 protected:
     CEngine*        m_engine = nullptr;
@@ -95,6 +107,7 @@ protected:
     float           m_level = 0.0f;
     //! Texture
     std::string     m_fileName;
+    Texture         m_texture;
     //! Feedrate (wind)
     glm::vec2       m_speed;
     //! Diffuse color
@@ -128,6 +141,7 @@ protected:
         float       px1 = 0, px2 = 0, pz = 0;
     };
     std::vector<CloudLine> m_lines;
+    CVertexBuffer*  m_buffer = nullptr;
 };
 
 
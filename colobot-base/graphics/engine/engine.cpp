@@ -31,6 +31,8 @@
 
 #include "common/system/system.h"
 
+#include "common/thread/worker_pool.h"
+
 #include "graphics/core/device.h"
 #include "graphics/core/framebuffer.h"
 #include "graphics/core/material.h"
@@ -47,6 +49,7 @@
 #include "graphics/engine/pyro_manager.h"
 #include "graphics/engine/terrain.h"
 #include "graphics/engine/text.h"
+#include "graphics/engine/texture_cache.h"
 #include "graphics/engine/water.h"
 
 #include "graphics/model/model_mesh.h"
@@ -61,8 +64,9 @@
 
 #include "ui/controls/interface.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
-#include <SDL_surface.h>
 #include <SDL_thread.h>
 #include <thread>
 
@@ -72,6 +76,31 @@ using TimeUtils::TimeUnit;
 namespace Gfx
 {
 
+namespace
+{
+
+//! Size of the window of static shadows around each shadow region, in regions
+const int STATIC_SHADOW_WINDOW = 2;
+
+//! Extracts the frustum planes of an orthographic projection, as (normal, distance)
+void GetShadowPlanes(const glm::mat4& projectionViewMatrix, glm::vec4 planes[6])
+{
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++)
+        rows[i] = glm::vec4(projectionViewMatrix[0][i], projectionViewMatrix[1][i],
+                            projectionViewMatrix[2][i], projectionViewMatrix[3][i]);
+
+    for (int i = 0; i < 3; i++)
+    {
+        planes[2 * i]     = rows[3] + rows[i];
+        planes[2 * i + 1] = rows[3] - rows[i];
+    }
+    for (int i = 0; i < 6; i++)
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
+} // anonymous namespace
+
 /**
  * \struct EngineBaseObjDataTier
  * \brief Tier 3 of object tree (data)
@@ -95,6 +124,21 @@ struct EngineBaseObjDataTier
     glm::vec2               uvScale = { 1.0f, 1.0f };
 };
 
+/**
+ * \struct EnginePickNode
+ * \brief Node of the bounding volume hierarchy used to pick the triangles of a base object
+ */
+struct EnginePickNode
+{
+    //! Bounding box of the triangles of the node
+    glm::vec3           bboxMin{ 0, 0, 0 };
+    glm::vec3           bboxMax{ 0, 0, 0 };
+    //! First triangle of a leaf, or rank of the second child of a node (the first one follows the node)
+    int                 first = 0;
+    //! Number of triangles of a leaf, 0 for a node
+    int                 count = 0;
+};
+
 /**
  * \struct BaseEngineObject
  * \brief Base (template) object - geometry for engine objects
@@ -115,6 +159,10 @@ struct EngineBaseObject
     Math::Sphere           boundingSphere;
     //! Next tier
     std::vector<EngineBaseObjDataTier> next;
+    //! Hierarchy of the triangles for picking, built by the first DetectObject() needing it
+    std::vector<EnginePickNode> pickNodes;
+    //! Vertices of the triangles of pickNodes, 3 per triangle
+    std::vector<glm::vec3> pickVertices;
 
     inline void LoadDefault()
     {
@@ -157,6 +205,12 @@ struct EngineMouse
 };
 
 constexpr glm::ivec2 MOUSE_SIZE(32, 32);
+//! Triangles nearer to the eye than this depth are not picked
+constexpr float PICK_NEAR_DISTANCE = 2.0f;
+//! Maximum number of triangles in a leaf of the picking hierarchy
+constexpr int PICK_LEAF_TRIANGLES = 4;
+//! Frames after which a screenshot waits for its pixels instead of polling them
+constexpr int SCREENSHOT_MAX_FRAMES = 4;
 const std::map<EngineMouseType, EngineMouse> MOUSE_TYPES = {
     {{ENG_MOUSE_NORM},    {EngineMouse( 0,  1, 32, TransparencyMode::WHITE, TransparencyMode::BLACK, glm::ivec2( 1,  1))}},
     {{ENG_MOUSE_WAIT},    {EngineMouse( 2,  3, 33, TransparencyMode::WHITE, TransparencyMode::BLACK, glm::ivec2( 8, 12))}},
@@ -432,6 +486,8 @@ bool CEngine::Create()
 
 void CEngine::Destroy()
 {
+    UpdateScreenShots(true);
+
     m_text->Destroy();
 
     if (m_shadowMap.id != 0)
@@ -444,6 +500,8 @@ void CEngine::Destroy()
         m_shadowMap = Texture();
     }
 
+    DeleteStaticShadowMap();
+
     m_lightMan.reset();
     m_text.reset();
     m_particle.reset();
@@ -554,27 +612,50 @@ void CEngine::FrameUpdate()
 
 void CEngine::WriteScreenShot(const std::string& fileName)
 {
-    auto data = std::make_unique<WriteScreenShotData>();
-    data->img = std::make_unique<CImage>(glm::ivec2(m_size.x, m_size.y));
+    PendingScreenShot screenShot;
+    screenShot.readback = m_device->ReadFrameBufferPixels();
+    screenShot.size = m_size;
+    screenShot.fileName = fileName;
+
+    m_pendingScreenShots.push_back(std::move(screenShot));
+}
+
+void CEngine::UpdateScreenShots(bool wait)
+{
+    for (auto it = m_pendingScreenShots.begin(); it != m_pendingScreenShots.end(); )
+    {
+        it->frames++;
+
+        if (!wait && it->frames < SCREENSHOT_MAX_FRAMES && !it->readback->IsReady())
+        {
+            ++it;
+            continue;
+        }
 
-    auto pixels = m_device->GetFrameBufferPixels();
-    data->img->SetDataPixels(pixels->GetPixelsData());
-    data->img->FlipVertically();
+        auto data = std::make_unique<WriteScreenShotData>();
+        data->pixels = it->readback->GetPixels();
+        data->size = it->size;
+        data->fileName = it->fileName;
 
-    data->fileName = fileName;
+        std::thread{&CEngine::WriteScreenShotThread, std::move(data)}.detach();
 
-    std::thread{&CEngine::WriteScreenShotThread, std::move(data)}.detach();
+        it = m_pendingScreenShots.erase(it);
+    }
 }
 
 void CEngine::WriteScreenShotThread(std::unique_ptr<WriteScreenShotData> data)
 {
-    if ( data->img->SavePNG(data->fileName.c_str()) )
+    CImage img(data->size);
+    img.SetDataPixels(data->pixels->GetPixelsData());
+    img.FlipVertically();
+
+    if ( img.SavePNG(data->fileName.c_str()) )
     {
        GetLogger()->Debug("Save screenshot saved successfully\n");
     }
     else
     {
-       GetLogger()->Error("%s!\n", data->img->GetError().c_str());
+       GetLogger()->Error("%s!\n", img.GetError().c_str());
     }
 
     CApplication::GetInstancePointer()->GetEventQueue()->AddEvent(Event(EVENT_WRITE_SCENE_FINISHED));
@@ -732,7 +813,11 @@ void CEngine::DeleteBaseObject(int baseObjRank)
     }
 
     p1.next.clear();
+    p1.pickNodes.clear();
+    p1.pickVertices.clear();
     p1.used = false;
+
+    InvalidateStaticShadows();
 }
 
 void CEngine::DeleteAllBaseObjects()
@@ -750,6 +835,8 @@ void CEngine::DeleteAllBaseObjects()
     }
 
     m_baseObjects.clear();
+
+    InvalidateStaticShadows();
 }
 
 void CEngine::CopyBaseObject(int sourceBaseObjRank, int destBaseObjRank)
@@ -803,6 +890,9 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<Vertex3D>&
     p1.boundingSphere = Math::BoundingSphereForBox(p1.bboxMin, p1.bboxMax);
 
     p1.totalTriangles += vertices.size() / 3;
+
+    p1.pickNodes.clear();
+    p1.pickVertices.clear();
 }
 
 void CEngine::DebugObject(int objRank)
@@ -910,6 +1000,16 @@ void CEngine::DeleteAllObjects()
     m_objects.clear();
     m_shadowSpots.clear();
 
+    InvalidateStaticShadows();
+
+    if (m_staticShadowHits + m_staticShadowRedraws > 0)
+    {
+        GetLogger()->Debug("Static shadow regions: %d reused, %d redrawn\n",
+                           m_staticShadowHits, m_staticShadowRedraws);
+    }
+    m_staticShadowHits = 0;
+    m_staticShadowRedraws = 0;
+
     DeleteAllGroundSpots();
 }
 
@@ -917,6 +1017,9 @@ void CEngine::DeleteObject(int objRank)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
+    if (IsStaticShadowCaster(m_objects[objRank]))
+        InvalidateStaticShadows();
+
     // Mark object as deleted
     m_objects[objRank].used = false;
 
@@ -929,6 +1032,20 @@ void CEngine::SetObjectBaseRank(int objRank, int baseObjRank)
     assert(objRank == -1 || (objRank >= 0 && objRank < static_cast<int>( m_objects.size() )));
 
     m_objects[objRank].baseObjRank = baseObjRank;
+
+    if (IsStaticShadowCaster(m_objects[objRank]))
+        InvalidateStaticShadows();
+}
+
+void CEngine::SetObjectLodBaseRank(int objRank, int baseObjRank)
+{
+    assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
+
+    m_objects[objRank].baseObjRank = baseObjRank;
+
+    // the other resolution casts other shadows, only around the object
+    if (IsStaticShadowCaster(m_objects[objRank]))
+        InvalidateStaticShadows(objRank);
 }
 
 int CEngine::GetObjectBaseRank(int objRank)
@@ -942,7 +1059,13 @@ void CEngine::SetObjectType(int objRank, EngineObjectType type)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
+    if (IsStaticShadowCaster(m_objects[objRank]))
+        InvalidateStaticShadows();
+
     m_objects[objRank].type = type;
+
+    if (IsStaticShadowCaster(m_objects[objRank]))
+        InvalidateStaticShadows();
 }
 
 EngineObjectType CEngine::GetObjectType(int objRank)
@@ -957,7 +1080,18 @@ void CEngine::SetObjectTransform(int objRank, const glm::mat4& transform)
 {
     assert(objRank >= 0 && objRank < static_cast<int>( m_objects.size() ));
 
-    m_objects[objRank].transform = transform;
+    EngineObject& object = m_objects[objRank];
+
+    if (IsStaticShadowCaster(object) && object.transform != transform)
+    {
+        // placing a new object is fine, an object moving later is drawn on each frame
+        if (object.shadowSeen)
+            object.shadowDynamic = true;
+
+        InvalidateStaticShadows();
+    }
+
+    object.transform = transform;
 }
 
 void CEngine::GetObjectTransform(int objRank, glm::mat4& transform)
@@ -1112,7 +1246,7 @@ void CEngine::ChangeSecondTexture(int objRank, const std::string& tex2Name)
 
         data.material.detailTexture = tex2Name;
 
-        data.detailTexture = LoadTexture("textures/" + tex2Name);
+        data.detailTexture = LoadObjectTexture(baseObjRank, "textures/" + tex2Name, m_defaultTexParams);
     }
 }
 
@@ -1514,6 +1648,8 @@ void CEngine::UpdateStaticBuffer(EngineBaseObjDataTier& p4)
     }
 
     p4.updateStaticBuffer = false;
+
+    InvalidateStaticShadows();
 }
 
 void CEngine::UpdateStaticBuffers()
@@ -1543,176 +1679,245 @@ void CEngine::Update()
     UpdateStaticBuffers();
 }
 
-bool CEngine::DetectBBox(int objRank, const glm::vec2& mouse)
+//! Adds the node of the picking hierarchy holding the triangles order[first] to order[first+count-1]
+static void BuildPickNode(std::vector<EnginePickNode>& nodes, const std::vector<glm::vec3>& vertices,
+                          const std::vector<glm::vec3>& centers, std::vector<int>& order, int first, int count)
 {
-    assert(objRank >= 0 && objRank < static_cast<int>(m_objects.size()));
-
-    int baseObjRank = m_objects[objRank].baseObjRank;
-    if (baseObjRank == -1)
-        return false;
-
-    assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
+    int nodeRank = static_cast<int>(nodes.size());
+    nodes.push_back(EnginePickNode());
 
-    EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+    glm::vec3 bboxMin(  1000000.0f ), bboxMax( -1000000.0f );
+    glm::vec3 centerMin(  1000000.0f ), centerMax( -1000000.0f );
+    for (int i = first; i < first + count; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            bboxMin = glm::min(bboxMin, vertices[order[i]*3+j]);
+            bboxMax = glm::max(bboxMax, vertices[order[i]*3+j]);
+        }
+        centerMin = glm::min(centerMin, centers[order[i]]);
+        centerMax = glm::max(centerMax, centers[order[i]]);
+    }
 
-    glm::vec2 min, max;
-    min.x =  1000000.0f;
-    min.y =  1000000.0f;
-    max.x = -1000000.0f;
-    max.y = -1000000.0f;
+    nodes[nodeRank].bboxMin = bboxMin;
+    nodes[nodeRank].bboxMax = bboxMax;
 
-    for (int i = 0; i < 8; i++)
+    if (count <= PICK_LEAF_TRIANGLES)
     {
-        glm::vec3 p{ 0, 0, 0 };
+        nodes[nodeRank].first = first;
+        nodes[nodeRank].count = count;
+        return;
+    }
 
-        if ( i & (1<<0) )  p.x = p1.bboxMin.x;
-        else               p.x = p1.bboxMax.x;
-        if ( i & (1<<1) )  p.y = p1.bboxMin.y;
-        else               p.y = p1.bboxMax.y;
-        if ( i & (1<<2) )  p.z = p1.bboxMin.z;
-        else               p.z = p1.bboxMax.z;
+    // splits the triangles in halves along the longest axis
+    glm::vec3 size = centerMax - centerMin;
+    int axis = 0;
+    if (size.y > size[axis]) axis = 1;
+    if (size.z > size[axis]) axis = 2;
 
-        glm::vec3 pp{ 0, 0, 0 };
-        if ( TransformPoint(pp, objRank, p) )
-        {
-            if (pp.x < min.x) min.x = pp.x;
-            if (pp.x > max.x) max.x = pp.x;
-            if (pp.y < min.y) min.y = pp.y;
-            if (pp.y > max.y) max.y = pp.y;
-        }
-    }
+    int half = count / 2;
+    std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+                     [&centers, axis](int a, int b) { return centers[a][axis] < centers[b][axis]; });
 
-    return ( mouse.x >= min.x &&
-             mouse.x <= max.x &&
-             mouse.y >= min.y &&
-             mouse.y <= max.y );
+    BuildPickNode(nodes, vertices, centers, order, first, half);
+    nodes[nodeRank].first = static_cast<int>(nodes.size());
+    BuildPickNode(nodes, vertices, centers, order, first + half, count - half);
 }
 
 int CEngine::DetectObject(const glm::vec2& mouse, glm::vec3& targetPos, bool terrain)
 {
+    // ray through the mouse, its length along the view axis is 1 so that
+    // the distances along the ray are depths in the view
+    glm::mat4 matViewInverse = glm::inverse(m_matView);
+    glm::vec3 origin = Math::Transform(matViewInverse, glm::vec3(0.0f, 0.0f, 0.0f));
+    glm::vec3 dir = Math::Transform(matViewInverse, glm::vec3(
+        (mouse.x*2.0f-1.0f) / m_matProj[0][0],
+        (mouse.y*2.0f-1.0f) / m_matProj[1][1],
+        1.0f)) - origin;
+
     float min = 1000000.0f;
     int nearest = -1;
-    glm::vec3 pos{ 0, 0, 0 };
 
-    for (int objRank = 0; objRank < static_cast<int>( m_objects.size() ); objRank++)
+    if (terrain && m_terrain != nullptr)
     {
-        if (! m_objects[objRank].used)
-            continue;
+        float dist = 0.0f;
+        if (m_terrain->IntersectRay(origin, dir, PICK_NEAR_DISTANCE, m_deepView[0] * m_clippingDistance, dist))
+        {
+            glm::vec3 pos = origin + dir * dist;
+            int objRank = m_terrain->GetObjectRank(pos);
+            if (objRank != -1)
+            {
+                min = dist;
+                nearest = objRank;
+                targetPos = pos;
+            }
+        }
+    }
 
-        if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN && !terrain)
+    // bounding spheres of the objects crossed by the ray, nearest first
+    m_pickCandidates.clear();
+    for (int objRank = 0; objRank < static_cast<int>( m_objects.size() ); objRank++)
+    {
+        const EngineObject& object = m_objects[objRank];
+        if (! object.used)
             continue;
 
-        if (! DetectBBox(objRank, mouse))
+        if (object.type == ENG_OBJTYPE_TERRAIN)
             continue;
 
-        int baseObjRank = m_objects[objRank].baseObjRank;
+        int baseObjRank = object.baseObjRank;
         if (baseObjRank == -1)
             continue;
 
         assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
 
-        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-        if (! p1.used)
+        const EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+        if (! p1.used || p1.totalTriangles == 0)
             continue;
 
-        for (int l2 = 0; l2 < static_cast<int>( p1.next.size() ); l2++)
-        {
-            EngineBaseObjDataTier& data = p1.next[l2];
+        float scale = Math::Max(glm::length(glm::vec3(object.transform[0])),
+                                glm::length(glm::vec3(object.transform[1])),
+                                glm::length(glm::vec3(object.transform[2])));
+        float radius = p1.boundingSphere.radius * scale;
+        glm::vec3 center = Math::Transform(object.transform, p1.boundingSphere.pos);
+
+        glm::vec3 oc = center - origin;
+        float a = glm::dot(dir, dir);
+        float b = glm::dot(oc, dir);
+        float d = b*b - a*(glm::dot(oc, oc) - radius*radius);
+        if (d < 0.0f)
+            continue;
 
-            if (data.type == EngineTriangleType::TRIANGLES)
-            {
-                for (int i = 0; i < static_cast<int>(data.vertices.size()); i += 3)
-                {
-                    float dist = 0.0f;
-                    if (DetectTriangle(mouse, &data.vertices[i], objRank, dist, pos) && dist < min)
-                    {
-                        min = dist;
-                        nearest = objRank;
-                        targetPos = pos;
-                    }
-                }
-            }
-            else if (data.type == EngineTriangleType::SURFACE)
-            {
-                for (int i = 0; i < static_cast<int>(data.vertices.size()) - 2; i += 1)
-                {
-                    float dist = 0.0f;
-                    if (DetectTriangle(mouse, &data.vertices[i], objRank, dist, pos) && dist < min)
-                    {
-                        min = dist;
-                        nearest = objRank;
-                        targetPos = pos;
-                    }
-                }
-            }
+        d = sqrtf(d);
+        if ((b + d) / a < PICK_NEAR_DISTANCE)
+            continue;  // behind?
+
+        float dist = Math::Max((b - d) / a, PICK_NEAR_DISTANCE);
+        m_pickCandidates.push_back({ dist, objRank });
+    }
+
+    std::sort(m_pickCandidates.begin(), m_pickCandidates.end());
+
+    for (const auto& [entry, objRank] : m_pickCandidates)
+    {
+        if (entry >= min)
+            break;  // no nearer triangle
+
+        EngineBaseObject& p1 = m_baseObjects[m_objects[objRank].baseObjRank];
+
+        // the distances along the ray are the same in the coordinates of the object
+        glm::mat4 inverse = glm::inverse(m_objects[objRank].transform);
+        glm::vec3 objOrigin = Math::Transform(inverse, origin);
+        glm::vec3 objDir = glm::vec3(inverse * glm::vec4(dir, 0.0f));
+
+        float dist = min;
+        if (DetectPickTree(p1, objOrigin, objDir, dist))
+        {
+            min = dist;
+            nearest = objRank;
+            targetPos = origin + dir * dist;
         }
     }
 
     return nearest;
 }
 
-bool CEngine::DetectTriangle(const glm::vec2& mouse, Vertex3D* triangle, int objRank, float& dist, glm::vec3& pos)
+bool CEngine::DetectPickTree(EngineBaseObject& p1, const glm::vec3& origin, const glm::vec3& dir, float& dist)
 {
-    assert(objRank >= 0 && objRank < static_cast<int>(m_objects.size()));
+    if (p1.pickNodes.empty())
+        BuildPickTree(p1);
+
+    if (p1.pickNodes.empty())
+        return false;
 
-    glm::vec3 p2D[3], p3D{ 0, 0, 0 };
+    bool found = false;
 
-    for (int i = 0; i < 3; i++)
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
     {
-        p3D.x = triangle[i].position.x;
-        p3D.y = triangle[i].position.y;
-        p3D.z = triangle[i].position.z;
+        const EnginePickNode& node = p1.pickNodes[stack[--stackSize]];
 
-        if (! TransformPoint(p2D[i], objRank, p3D))
-            return false;
-    }
+        float tNear = PICK_NEAR_DISTANCE;
+        float tFar = dist;
+        if (! Math::IntersectRayBox(node.bboxMin, node.bboxMax, origin, dir, tNear, tFar))
+            continue;
 
-    if (mouse.x < p2D[0].x &&
-        mouse.x < p2D[1].x &&
-        mouse.x < p2D[2].x)
-        return false;
+        if (node.count == 0)
+        {
+            int nodeRank = static_cast<int>(&node - p1.pickNodes.data());
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = nodeRank + 1;
+            continue;
+        }
 
-    if (mouse.x > p2D[0].x &&
-        mouse.x > p2D[1].x &&
-        mouse.x > p2D[2].x)
-        return false;
+        for (int i = node.first; i < node.first + node.count; i++)
+        {
+            float t = 0.0f;
+            if (! Math::IntersectRay(p1.pickVertices[i*3+0], p1.pickVertices[i*3+1], p1.pickVertices[i*3+2],
+                                     origin, dir, t))
+                continue;
 
-    if (mouse.y < p2D[0].y &&
-        mouse.y < p2D[1].y &&
-        mouse.y < p2D[2].y)
-        return false;
+            if (t >= PICK_NEAR_DISTANCE && t < dist)
+            {
+                dist = t;
+                found = true;
+            }
+        }
+    }
 
-    if (mouse.y > p2D[0].y &&
-        mouse.y > p2D[1].y &&
-        mouse.y > p2D[2].y)
-        return false;
+    return found;
+}
 
-    glm::vec2 a, b, c;
-    a.x = p2D[0].x;
-    a.y = p2D[0].y;
-    b.x = p2D[1].x;
-    b.y = p2D[1].y;
-    c.x = p2D[2].x;
-    c.y = p2D[2].y;
+void CEngine::BuildPickTree(EngineBaseObject& p1)
+{
+    p1.pickNodes.clear();
+    p1.pickVertices.clear();
 
-    if (! Math::IsInsideTriangle(a, b, c, mouse))
-        return false;
+    std::vector<glm::vec3> vertices;
+    for (const auto& data : p1.next)
+    {
+        if (data.type == EngineTriangleType::TRIANGLES)
+        {
+            for (int i = 0; i + 2 < static_cast<int>(data.vertices.size()); i += 3)
+            {
+                for (int j = 0; j < 3; j++)
+                    vertices.push_back(data.vertices[i+j].position);
+            }
+        }
+        else if (data.type == EngineTriangleType::SURFACE)
+        {
+            for (int i = 0; i + 2 < static_cast<int>(data.vertices.size()); i += 1)
+            {
+                for (int j = 0; j < 3; j++)
+                    vertices.push_back(data.vertices[i+j].position);
+            }
+        }
+    }
+
+    int count = static_cast<int>(vertices.size() / 3);
+    if (count == 0)
+        return;
 
-    auto matViewInverse = glm::inverse(m_matView);
-    auto matProjInverse = glm::inverse(m_matProj);
+    std::vector<glm::vec3> centers(count);
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++)
+    {
+        centers[i] = (vertices[i*3+0] + vertices[i*3+1] + vertices[i*3+2]) / 3.0f;
+        order[i] = i;
+    }
 
-    glm::vec3 a2 = Math::Transform(m_objects[objRank].transform, triangle[0].position);
-    glm::vec3 b2 = Math::Transform(m_objects[objRank].transform, triangle[1].position);
-    glm::vec3 c2 = Math::Transform(m_objects[objRank].transform, triangle[2].position);
-    glm::vec3 e  = Math::Transform(matViewInverse, glm::vec3(0.0f, 0.0f, -1.0f));
-    glm::vec3 f  = Math::Transform(matViewInverse, glm::vec3(
-        (mouse.x*2.0f-1.0f) * matProjInverse[0][0],
-        (mouse.y*2.0f-1.0f) * matProjInverse[1][1],
-        0.0f));
-    Math::Intersect(a2, b2, c2, e, f, pos);
+    BuildPickNode(p1.pickNodes, vertices, centers, order, 0, count);
 
-    dist = (p2D[0].z + p2D[1].z + p2D[2].z) / 3.0f;
-    return true;
+    // the triangles of each leaf follow each other
+    p1.pickVertices.reserve(vertices.size());
+    for (int triangle : order)
+    {
+        for (int j = 0; j < 3; j++)
+            p1.pickVertices.push_back(vertices[triangle*3+j]);
+    }
 }
 
 //! Use only after world transform already set
@@ -1861,7 +2066,8 @@ void CEngine::SetViewParams(const glm::vec3 &eyePt, const glm::vec3 &lookatPt, c
         m_sound->SetListener(eyePt, lookatPt);
 }
 
-Texture CEngine::CreateTexture(const std::string& texName, const TextureCreateParams& params, CImage* image)
+Texture CEngine::CreateTexture(const std::string& texName, const TextureCreateParams& params, CImage* image,
+                               const std::vector<TextureMipmap>& mipmaps)
 {
     if (texName.empty())
         return Texture(); // invalid texture
@@ -1871,10 +2077,14 @@ Texture CEngine::CreateTexture(const std::string& texName, const TextureCreatePa
 
     Texture tex;
     CImage img;
+    std::vector<TextureMipmap> loadedMipmaps;
+    const std::vector<TextureMipmap>* imageMipmaps = &mipmaps;
+
+    bool fromFile = image == nullptr;
 
     if (image == nullptr)
     {
-        if (!img.Load(texName))
+        if (!LoadCachedTextureImage(texName, img, loadedMipmaps))
         {
             std::string error = img.GetError();
             GetLogger()->Error("Couldn't load texture '%s': %s, blacklisting\n", texName.c_str(), error.c_str());
@@ -1883,9 +2093,10 @@ Texture CEngine::CreateTexture(const std::string& texName, const TextureCreatePa
         }
 
         image = &img;
+        imageMipmaps = &loadedMipmaps;
     }
 
-    tex = m_device->CreateTexture(image, params);
+    tex = m_device->CreateTexture(image, params, *imageMipmaps);
 
     if (! tex.Valid())
     {
@@ -1897,6 +2108,12 @@ Texture CEngine::CreateTexture(const std::string& texName, const TextureCreatePa
     m_texNameMap[texName] = tex;
     m_revTexNameMap[tex] = texName;
 
+    // Only textures loaded from files can be evicted, generated ones couldn't be restored
+    if (fromFile)
+        m_texLastUse[texName] = m_texFrame;
+    else
+        m_texLastUse.erase(texName);
+
     return tex;
 }
 
@@ -1918,7 +2135,17 @@ Texture CEngine::LoadTexture(const std::string& name, const TextureCreateParams&
 
     std::map<std::string, Texture>::iterator it = m_texNameMap.find(name);
     if (it != m_texNameMap.end())
+    {
+        auto lastUse = m_texLastUse.find(name);
+        if (lastUse != m_texLastUse.end())
+            lastUse->second = m_texFrame;
+
         return (*it).second;
+    }
+
+    // Still being decoded, the caller gets a placeholder until it's ready
+    if (m_texStreamRequests.count(name) > 0)
+        return Texture();
 
     return CreateTexture(name, params);
 }
@@ -1956,7 +2183,38 @@ bool CEngine::LoadAllTextures()
         m_foregroundTex.SetInvalid();
 
     m_planet->LoadTexture();
+    m_water->LoadTexture();
+    m_cloud->LoadTexture();
+
+    // Decode textures of engine objects on worker threads, they are bound once ready
+    for (const auto& object : m_objects)
+    {
+        if (!object.used || object.baseObjRank == -1)
+            continue;
+
+        const EngineBaseObject& p1 = m_baseObjects[object.baseObjRank];
+        if (!p1.used)
+            continue;
+
+        const TextureCreateParams& params = object.type == ENG_OBJTYPE_TERRAIN ? m_terrainTexParams : m_defaultTexParams;
+        for (const auto& data : p1.next)
+        {
+            if (!data.material.albedoTexture.empty())
+                RequestTexture("textures/" + data.material.albedoTexture, params);
+            if (!data.material.detailTexture.empty())
+                RequestTexture("textures/" + data.material.detailTexture, params);
+            if (!data.material.materialTexture.empty())
+                RequestTexture("textures/" + data.material.materialTexture, params);
+            if (!data.material.emissiveTexture.empty())
+                RequestTexture("textures/" + data.material.emissiveTexture, params);
+        }
+    }
+
+    return UpdateObjectTextures();
+}
 
+bool CEngine::UpdateObjectTextures()
+{
     bool ok = true;
 
     for (int objRank = 0; objRank < static_cast<int>( m_objects.size() ); objRank++)
@@ -1964,9 +2222,7 @@ bool CEngine::LoadAllTextures()
         if (! m_objects[objRank].used)
             continue;
 
-        bool terrain = false;
-        if (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN)
-            terrain = true;
+        const TextureCreateParams& params = m_objects[objRank].type == ENG_OBJTYPE_TERRAIN ? m_terrainTexParams : m_defaultTexParams;
 
         int baseObjRank = m_objects[objRank].baseObjRank;
         if (baseObjRank == -1)
@@ -1982,45 +2238,33 @@ bool CEngine::LoadAllTextures()
         {
             if (!data.material.albedoTexture.empty())
             {
-                if (terrain)
-                    data.albedoTexture = LoadTexture("textures/" + data.material.albedoTexture, m_terrainTexParams);
-                else
-                    data.albedoTexture = LoadTexture("textures/" + data.material.albedoTexture);
+                data.albedoTexture = LoadObjectTexture(baseObjRank, "textures/" + data.material.albedoTexture, params);
 
-                if (!data.albedoTexture.Valid())
+                if (!data.albedoTexture.Valid() && !IsTextureStreaming("textures/" + data.material.albedoTexture))
                     ok = false;
             }
 
             if (!data.material.detailTexture.empty())
             {
-                if (terrain)
-                    data.detailTexture = LoadTexture("textures/" + data.material.detailTexture, m_terrainTexParams);
-                else
-                    data.detailTexture = LoadTexture("textures/" + data.material.detailTexture);
+                data.detailTexture = LoadObjectTexture(baseObjRank, "textures/" + data.material.detailTexture, params);
 
-                if (!data.detailTexture.Valid())
+                if (!data.detailTexture.Valid() && !IsTextureStreaming("textures/" + data.material.detailTexture))
                     ok = false;
             }
 
             if (!data.material.materialTexture.empty())
             {
-                if (terrain)
-                    data.materialTexture = LoadTexture("textures/" + data.material.materialTexture, m_terrainTexParams);
-                else
-                    data.materialTexture = LoadTexture("textures/" + data.material.materialTexture);
+                data.materialTexture = LoadObjectTexture(baseObjRank, "textures/" + data.material.materialTexture, params);
 
-                if (!data.materialTexture.Valid())
+                if (!data.materialTexture.Valid() && !IsTextureStreaming("textures/" + data.material.materialTexture))
                     ok = false;
             }
 
             if (!data.material.emissiveTexture.empty())
             {
-                if (terrain)
-                    data.emissiveTexture = LoadTexture("textures/" + data.material.emissiveTexture, m_terrainTexParams);
-                else
-                    data.emissiveTexture = LoadTexture("textures/" + data.material.emissiveTexture);
+                data.emissiveTexture = LoadObjectTexture(baseObjRank, "textures/" + data.material.emissiveTexture, params);
 
-                if (!data.emissiveTexture.Valid())
+                if (!data.emissiveTexture.Valid() && !IsTextureStreaming("textures/" + data.material.emissiveTexture))
                     ok = false;
             }
         }
@@ -2029,78 +2273,302 @@ bool CEngine::LoadAllTextures()
     return ok;
 }
 
-static bool IsExcludeColor(glm::vec2* exclude, int x, int y)
+Texture CEngine::LoadObjectTexture(int baseObjRank, const std::string& name, const TextureCreateParams& params)
 {
-    int i = 0;
-    while ( exclude[i+0].x != 0.0f || exclude[i+0].y != 0.0f ||
-            exclude[i+1].y != 0.0f || exclude[i+1].y != 0.0f )
-    {
-        if ( x >= static_cast<int>(exclude[i+0].x*256.0f) &&
-             x <  static_cast<int>(exclude[i+1].x*256.0f) &&
-             y >= static_cast<int>(exclude[i+0].y*256.0f) &&
-             y <  static_cast<int>(exclude[i+1].y*256.0f) )
-            return true;  // exclude
+    Texture tex = LoadTexture(name, params);
 
-        i += 2;
+    // Bound by BindStreamedTexture() once ready, without going through all objects again
+    if (!tex.Valid() && IsTextureStreaming(name))
+    {
+        auto& users = m_texStreamUsers[name];
+        if (std::find(users.begin(), users.end(), baseObjRank) == users.end())
+            users.push_back(baseObjRank);
     }
 
-    return false;  // point to include
+    return tex;
 }
 
-void CEngine::DeleteTexture(const std::string& texName)
+void CEngine::BindStreamedTexture(const std::string& name, const Texture& tex)
 {
-    auto it = m_texNameMap.find(texName);
-    if (it == m_texNameMap.end())
+    auto it = m_texStreamUsers.find(name);
+    if (it == m_texStreamUsers.end())
         return;
 
-    auto revIt = m_revTexNameMap.find((*it).second);
+    for (int baseObjRank : it->second)
+    {
+        if (baseObjRank < 0 || baseObjRank >= static_cast<int>( m_baseObjects.size() ))
+            continue;
 
-    m_device->DestroyTexture((*it).second);
+        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+        if (! p1.used)
+            continue;
 
-    m_revTexNameMap.erase(revIt);
-    m_texNameMap.erase(it);
+        // The base object may have been replaced meanwhile, so the names are checked again
+        for (auto& data : p1.next)
+        {
+            if (!data.material.albedoTexture.empty() && "textures/" + data.material.albedoTexture == name)
+                data.albedoTexture = tex;
+            if (!data.material.detailTexture.empty() && "textures/" + data.material.detailTexture == name)
+                data.detailTexture = tex;
+            if (!data.material.materialTexture.empty() && "textures/" + data.material.materialTexture == name)
+                data.materialTexture = tex;
+            if (!data.material.emissiveTexture.empty() && "textures/" + data.material.emissiveTexture == name)
+                data.emissiveTexture = tex;
+        }
+    }
+
+    m_texStreamUsers.erase(it);
 }
 
-void CEngine::DeleteTexture(const Texture& tex)
+void CEngine::RequestTexture(const std::string& name, const TextureCreateParams& params)
 {
-    if (! tex.Valid())
+    if (name.empty())
         return;
 
-    auto revIt = m_revTexNameMap.find(tex);
-    if (revIt == m_revTexNameMap.end())
+    if (m_texNameMap.count(name) > 0 || m_texBlacklist.count(name) > 0 || m_texStreamRequests.count(name) > 0)
         return;
 
-    m_device->DestroyTexture(tex);
+    if (m_texLoaderPool == nullptr)
+        m_texLoaderPool = std::make_unique<CWorkerPool>();
 
-    auto it = m_texNameMap.find((*revIt).second);
+    m_texStreamRequests[name] = params;
 
-    m_revTexNameMap.erase(revIt);
-    m_texNameMap.erase(it);
+    // Decoding only touches the image, device calls stay on the main thread
+    m_texLoaderPool->Start([this, name]()
+    {
+        StreamedTexture texture;
+        texture.name = name;
+        texture.image = std::make_unique<CImage>();
+
+        if (!LoadCachedTextureImage(name, *texture.image, texture.mipmaps))
+        {
+            texture.error = texture.image->GetError();
+            texture.image.reset();
+        }
+
+        std::lock_guard<std::mutex> lock{m_texStreamMutex};
+        m_texStreamDone.push_back(std::move(texture));
+    });
 }
 
-void CEngine::CreateOrUpdateTexture(const std::string& texName, CImage* img)
+bool CEngine::IsTextureStreaming(const std::string& name) const
 {
-    auto it = m_texNameMap.find(texName);
-    if (it == m_texNameMap.end())
-    {
-        LoadTexture(texName, img);
-    }
-    else
-    {
-        m_device->UpdateTexture((*it).second, { 0, 0 }, img->GetData(), m_defaultTexParams.format);
-    }
+    return m_texStreamRequests.count(name) > 0;
 }
 
-void CEngine::FlushTextureCache()
+void CEngine::UpdateTextureStreaming(bool wait)
 {
-    m_device->DestroyAllTextures();
+    if (m_texStreamRequests.empty())
+        return;
 
-    m_backgroundTex.SetInvalid();
+    if (wait)
+        m_texLoaderPool->Wait();
+
+    std::vector<StreamedTexture> done;
+    {
+        std::lock_guard<std::mutex> lock{m_texStreamMutex};
+        done.swap(m_texStreamDone);
+    }
+
+    if (done.empty())
+        return;
+
+    for (auto& texture : done)
+    {
+        auto it = m_texStreamRequests.find(texture.name);
+        if (it == m_texStreamRequests.end())
+            continue;
+
+        TextureCreateParams params = it->second;
+        m_texStreamRequests.erase(it);
+
+        // Created in the meantime, e.g. recolored by CreateOrUpdateTexture()
+        auto existing = m_texNameMap.find(texture.name);
+        if (existing != m_texNameMap.end())
+        {
+            BindStreamedTexture(texture.name, existing->second);
+            continue;
+        }
+
+        if (texture.image == nullptr)
+        {
+            GetLogger()->Error("Couldn't load texture '%s': %s, blacklisting\n", texture.name.c_str(), texture.error.c_str());
+            m_texBlacklist.insert(texture.name);
+            m_texStreamUsers.erase(texture.name);
+            continue;
+        }
+
+        Texture tex = CreateTexture(texture.name, params, texture.image.get(), texture.mipmaps);
+        if (tex.Valid())
+            m_texLastUse[texture.name] = m_texFrame;
+
+        // Replace placeholders in the engine objects waiting for this texture
+        BindStreamedTexture(texture.name, tex);
+    }
+}
+
+void CEngine::SetTextureMemoryBudget(std::size_t budget)
+{
+    m_texMemoryBudget = budget;
+}
+
+std::size_t CEngine::GetTextureMemoryBudget() const
+{
+    return m_texMemoryBudget;
+}
+
+void CEngine::TrimTextureCache()
+{
+    // No texture is being decoded at this point, so the files on disk can be trimmed too
+    if (m_texStreamRequests.empty())
+        TrimTextureCacheFiles(TEXTURE_CACHE_MAX_DISK_SIZE);
+
+    if (m_texMemoryBudget == 0)
+        return;
+
+    // Estimate: RGBA with full mipmap chain
+    auto textureMemory = [](const Texture& tex)
+    {
+        return static_cast<std::size_t>(tex.size.x) * tex.size.y * 4 * 4 / 3;
+    };
+
+    std::size_t total = 0;
+    for (const auto& [name, tex] : m_texNameMap)
+        total += textureMemory(tex);
+
+    if (total <= m_texMemoryBudget)
+        return;
+
+    // Textures referenced by engine objects must stay
+    std::set<Texture> referenced = { m_backgroundTex, m_foregroundTex, m_miceTexture,
+                                     m_water->GetTexture(), m_cloud->GetTexture() };
+    for (const auto& object : m_objects)
+    {
+        if (!object.used || object.baseObjRank == -1)
+            continue;
+
+        const EngineBaseObject& p1 = m_baseObjects[object.baseObjRank];
+        if (!p1.used)
+            continue;
+
+        for (const auto& data : p1.next)
+        {
+            referenced.insert(data.albedoTexture);
+            referenced.insert(data.detailTexture);
+            referenced.insert(data.materialTexture);
+            referenced.insert(data.emissiveTexture);
+        }
+    }
+
+    std::vector<std::pair<unsigned long long, std::string>> candidates;
+    for (const auto& [name, lastUse] : m_texLastUse)
+    {
+        auto it = m_texNameMap.find(name);
+        if (it != m_texNameMap.end() && referenced.count(it->second) == 0)
+            candidates.emplace_back(lastUse, name);
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    int evicted = 0;
+    for (const auto& [lastUse, name] : candidates)
+    {
+        if (total <= m_texMemoryBudget)
+            break;
+
+        total -= textureMemory(m_texNameMap[name]);
+        DeleteTexture(name);
+        evicted++;
+    }
+
+    GetLogger()->Debug("Evicted %d textures, %zu KiB of textures remain loaded\n", evicted, total / 1024);
+}
+
+static bool IsExcludeColor(glm::vec2* exclude, int x, int y)
+{
+    int i = 0;
+    while ( exclude[i+0].x != 0.0f || exclude[i+0].y != 0.0f ||
+            exclude[i+1].y != 0.0f || exclude[i+1].y != 0.0f )
+    {
+        if ( x >= static_cast<int>(exclude[i+0].x*256.0f) &&
+             x <  static_cast<int>(exclude[i+1].x*256.0f) &&
+             y >= static_cast<int>(exclude[i+0].y*256.0f) &&
+             y <  static_cast<int>(exclude[i+1].y*256.0f) )
+            return true;  // exclude
+
+        i += 2;
+    }
+
+    return false;  // point to include
+}
+
+void CEngine::DeleteTexture(const std::string& texName)
+{
+    auto it = m_texNameMap.find(texName);
+    if (it == m_texNameMap.end())
+        return;
+
+    auto revIt = m_revTexNameMap.find((*it).second);
+
+    m_device->DestroyTexture((*it).second);
+
+    m_revTexNameMap.erase(revIt);
+    m_texLastUse.erase(texName);
+    m_texNameMap.erase(it);
+}
+
+void CEngine::DeleteTexture(const Texture& tex)
+{
+    if (! tex.Valid())
+        return;
+
+    auto revIt = m_revTexNameMap.find(tex);
+    if (revIt == m_revTexNameMap.end())
+        return;
+
+    m_device->DestroyTexture(tex);
+
+    auto it = m_texNameMap.find((*revIt).second);
+
+    m_texLastUse.erase((*revIt).second);
+    m_revTexNameMap.erase(revIt);
+    m_texNameMap.erase(it);
+}
+
+void CEngine::CreateOrUpdateTexture(const std::string& texName, CImage* img)
+{
+    auto it = m_texNameMap.find(texName);
+    if (it == m_texNameMap.end())
+    {
+        LoadTexture(texName, img);
+    }
+    else
+    {
+        m_device->UpdateTexture((*it).second, { 0, 0 }, img->GetData(), m_defaultTexParams.format);
+        m_texLastUse.erase(texName);
+    }
+}
+
+void CEngine::FlushTextureCache()
+{
+    if (m_texLoaderPool != nullptr)
+        m_texLoaderPool->Wait();
+
+    m_texStreamRequests.clear();
+    {
+        std::lock_guard<std::mutex> lock{m_texStreamMutex};
+        m_texStreamDone.clear();
+    }
+
+    m_device->DestroyAllTextures();
+
+    m_backgroundTex.SetInvalid();
     m_foregroundTex.SetInvalid();
 
     m_texNameMap.clear();
     m_revTexNameMap.clear();
     m_texBlacklist.clear();
+    m_texLastUse.clear();
 
     m_firstGroundSpot = true;
 }
@@ -2467,6 +2935,7 @@ void CEngine::SetShadowMapping(bool value)
         m_device->DeleteFramebuffer("shadow");
         m_device->DestroyTexture(m_shadowMap);
         m_shadowMap.id = 0;
+        DeleteStaticShadowMap();
     }
 }
 
@@ -2490,6 +2959,7 @@ void CEngine::SetShadowMappingOffscreen(bool value)
         m_device->DeleteFramebuffer("shadow");
         m_shadowMap.id = 0;
     }
+    DeleteStaticShadowMap();
 }
 
 bool CEngine::GetShadowMappingOffscreen()
@@ -2504,6 +2974,7 @@ void CEngine::SetShadowMappingOffscreenResolution(int resolution)
     m_offscreenShadowRenderingResolution = resolution;
     m_device->DeleteFramebuffer("shadow");
     m_shadowMap.id = 0;
+    DeleteStaticShadowMap();
 }
 
 int CEngine::GetShadowMappingOffscreenResolution()
@@ -2519,6 +2990,7 @@ bool CEngine::IsShadowMappingQualitySupported()
 void CEngine::SetShadowMappingQuality(bool value)
 {
     if(!IsShadowMappingQualitySupported()) value = false;
+    if(value != m_qualityShadows) InvalidateStaticShadows();
     m_qualityShadows = value;
 }
 
@@ -2529,6 +3001,9 @@ bool CEngine::GetShadowMappingQuality()
 
 void CEngine::SetTerrainShadows(bool value)
 {
+    if (value != m_terrainShadows)
+        InvalidateStaticShadows();
+
     m_terrainShadows = value;
 }
 
@@ -2732,13 +3207,21 @@ void CEngine::Render()
         m_fpsCounter = 0;
     }
 
+    UpdateScreenShots();
+
     if (! m_render)
         return;
 
+    m_texFrame++;
+    UpdateTextureStreaming();
+
     m_statisticTriangle = 0;
 
     m_lightMan->UpdateLights();
 
+    if (m_terrain != nullptr && m_drawWorld)
+        m_terrain->UpdateLod(m_eyePt);
+
     Color color;
     if (m_cloud->GetLevel() != 0.0f)  // clouds?
         color = m_backgroundCloudDown;
@@ -2824,8 +3307,6 @@ void CEngine::Draw3DScene()
 
     // Draw terrain
 
-    //m_lightMan->UpdateDeviceLights(ENG_OBJTYPE_TERRAIN);
-
     Gfx::ShadowParam shadowParams[4];
     for (int i = 0; i < m_shadowRegions; i++)
     {
@@ -2883,6 +3364,12 @@ void CEngine::Draw3DScene()
         if (! p1.used)
             continue;
 
+        int lightRanks[MAX_DRAW_LIGHTS];
+        Light lights[MAX_DRAW_LIGHTS];
+        int lightCount = GetObjectLights(objRank, lightRanks);
+        GetDynamicLights(lightCount, lightRanks, lights);
+        terrainRenderer->SetDynamicLights(lightCount, lights);
+
         for (auto& data : p1.next)
         {
             terrainRenderer->SetAlbedoColor(data.material.albedoColor);
@@ -2935,6 +3422,8 @@ void CEngine::Draw3DScene()
 
     bool transparent = false;
 
+    ClearInstanceBatches();
+
     for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
     {
         if (! m_objects[objRank].used)
@@ -2961,65 +3450,112 @@ void CEngine::Draw3DScene()
         if (! p1.used)
             continue;
 
-        objectRenderer->SetModelMatrix(m_objects[objRank].transform);
+        if (m_objects[objRank].ghost)  // transparent ?
+        {
+            // like the per-tier check it replaces, only a base object with data tiers needs the pass
+            if (! p1.next.empty())
+                transparent = true;
+            continue;
+        }
 
-        //m_lightMan->UpdateDeviceLights(m_objects[objRank].type);
+        AddToInstanceBatch(objRank, baseObjRank);
+    }
 
-        for (auto& data : p1.next)
+    // Objects sharing a base object are drawn with one instanced call per data tier
+    for (int baseObjRank : m_instanceBatchRanks)
+    {
+        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+
+        // Only the objects lit by the same dynamic lights can share a call
+        m_batchLights.clear();
+        for (int objRank : m_instanceBatches[baseObjRank])
         {
-            if (m_objects[objRank].ghost)  // transparent ?
-            {
-                transparent = true;
-                continue;
-            }
+            std::array<int, MAX_DRAW_LIGHTS> lightRanks;
+            lightRanks.fill(-1);
+            GetObjectLights(objRank, lightRanks.data());
+            m_batchLights.emplace_back(lightRanks, objRank);
+        }
 
-            if (data.material.alphaMode != AlphaMode::NONE)
-            {
-                objectRenderer->SetAlphaScissor(data.material.alphaThreshold);
-            }
-            else
-            {
-                objectRenderer->SetAlphaScissor(0.0f);
-            }
+        std::sort(m_batchLights.begin(), m_batchLights.end());
 
-            Color color = data.material.albedoColor;
+        for (std::size_t first = 0; first < m_batchLights.size(); )
+        {
+            const auto& lightRanks = m_batchLights[first].first;
 
-            if (!data.material.tag.empty())
-            {
-                Color c = GetObjectColor(objRank, data.material.tag);
+            m_batchRun.clear();
+            std::size_t last = first;
+            for (; last < m_batchLights.size() && m_batchLights[last].first == lightRanks; last++)
+                m_batchRun.push_back(m_batchLights[last].second);
 
-                if (c != Color(1.0, 1.0, 1.0, 1.0))
+            int lightCount = 0;
+            while (lightCount < MAX_DRAW_LIGHTS && lightRanks[lightCount] != -1)
+                lightCount++;
+
+            Light lights[MAX_DRAW_LIGHTS];
+            GetDynamicLights(lightCount, lightRanks.data(), lights);
+            objectRenderer->SetDynamicLights(lightCount, lights);
+
+            const auto& batch = m_batchRun;
+            bool instanced = batch.size() > 1;
+
+            if (! instanced)
+                objectRenderer->SetModelMatrix(m_objects[batch.front()].transform);
+
+            for (auto& data : p1.next)
+            {
+                if (data.material.alphaMode != AlphaMode::NONE)
                 {
-                    color = c;
+                    objectRenderer->SetAlphaScissor(data.material.alphaThreshold);
+                }
+                else
+                {
+                    objectRenderer->SetAlphaScissor(0.0f);
                 }
-            }
 
-            if (data.material.recolor.empty())
-            {
-                objectRenderer->SetRecolor(false);
-            }
-            else
-            {
                 Color recolorFrom = data.material.recolorReference;
-                Color recolorTo = GetObjectColor(objRank, data.material.recolor);
                 float recolorThreshold = 0.1;
 
-                objectRenderer->SetRecolor(true, recolorFrom, recolorTo, recolorThreshold);
-            }
+                if (instanced)
+                {
+                    m_objectInstances.clear();
+
+                    for (int objRank : batch)
+                        m_objectInstances.push_back(GetObjectInstance(objRank, data.material));
+
+                    objectRenderer->SetRecolor(!data.material.recolor.empty(), recolorFrom, {}, recolorThreshold);
+                }
+                else
+                {
+                    ObjectInstance instance = GetObjectInstance(batch.front(), data.material);
 
-            objectRenderer->SetAlbedoColor(color);
-            objectRenderer->SetAlbedoTexture(data.albedoTexture);
-            objectRenderer->SetDetailTexture(data.detailTexture);
+                    objectRenderer->SetAlbedoColor(Color(instance.albedoColor.r, instance.albedoColor.g,
+                                                         instance.albedoColor.b, instance.albedoColor.a));
 
-            objectRenderer->SetEmissiveColor(data.material.emissiveColor);
-            objectRenderer->SetEmissiveTexture(data.emissiveTexture);
+                    if (data.material.recolor.empty())
+                        objectRenderer->SetRecolor(false);
+                    else
+                        objectRenderer->SetRecolor(true, recolorFrom, instance.recolorTo, recolorThreshold);
+                }
+
+                objectRenderer->SetAlbedoTexture(data.albedoTexture);
+                objectRenderer->SetDetailTexture(data.detailTexture);
 
-            objectRenderer->SetMaterialParams(data.material.roughness, data.material.metalness, data.material.aoStrength);
-            objectRenderer->SetMaterialTexture(data.materialTexture);
+                objectRenderer->SetEmissiveColor(data.material.emissiveColor);
+                objectRenderer->SetEmissiveTexture(data.emissiveTexture);
+
+                objectRenderer->SetMaterialParams(data.material.roughness, data.material.metalness, data.material.aoStrength);
+                objectRenderer->SetMaterialTexture(data.materialTexture);
+
+                objectRenderer->SetCullFace(data.material.cullFace);
+                objectRenderer->SetUVTransform(data.uvOffset, data.uvScale);
+
+                if (instanced)
+                    objectRenderer->DrawObjectInstanced(data.buffer, static_cast<int>(m_objectInstances.size()), m_objectInstances.data());
+                else
+                    objectRenderer->DrawObject(data.buffer);
+            }
 
-            objectRenderer->SetCullFace(data.material.cullFace);
-            objectRenderer->SetUVTransform(data.uvOffset, data.uvScale);
-            objectRenderer->DrawObject(data.buffer);
+            first = last;
         }
     }
 
@@ -3156,103 +3692,8 @@ void CEngine::Capture3DScene()
         m_capturedWorldTexture = Texture();
     }
 
-    // obtain pixels from screen
-    int width = m_size.x;
-    int height = m_size.y;
-
-    auto pixels = m_device->GetFrameBufferPixels();
-    unsigned char* data = reinterpret_cast<unsigned char*>(pixels->GetPixelsData());
-
-    // calculate 2nd mipmap
-    int newWidth = width / 4;
-    int newHeight = height / 4;
-    std::unique_ptr<unsigned char[]> mipmap = std::make_unique<unsigned char[]>(4 * newWidth * newHeight);
-
-    for (int x = 0; x < newWidth; x++)
-    {
-        for (int y = 0; y < newHeight; y++)
-        {
-            float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-
-            for (int i = 0; i < 4; i++)
-            {
-                for (int j = 0; j < 4; j++)
-                {
-                    int index = 4 * ((4 * x + i) + width * (4 * y + j));
-
-                    for (int k = 0; k < 4; k++)
-                        color[k] += data[index + k];
-                }
-            }
-
-            int index = 4 * (x + newWidth * y);
-
-            for (int k = 0; k < 4; k++)
-            {
-                mipmap[index + k] = static_cast<unsigned char>(color[k] * (1.0f / 16.0f));
-            }
-        }
-    }
-
-    // calculate Gaussian blur
-    std::unique_ptr<unsigned char[]> blured = std::make_unique<unsigned char[]>(4 * newWidth * newHeight);
-
-    float matrix[7][7] =
-        {
-            { 0.00000067f, 0.00002292f, 0.00019117f, 0.00038771f, 0.00019117f, 0.00002292f, 0.00000067f },
-            { 0.00002292f, 0.00078634f, 0.00655965f, 0.01330373f, 0.00655965f, 0.00078633f, 0.00002292f },
-            { 0.00019117f, 0.00655965f, 0.05472157f, 0.11098164f, 0.05472157f, 0.00655965f, 0.00019117f },
-            { 0.00038771f, 0.01330373f, 0.11098164f, 0.22508352f, 0.11098164f, 0.01330373f, 0.00038771f },
-            { 0.00019117f, 0.00655965f, 0.05472157f, 0.11098164f, 0.05472157f, 0.00655965f, 0.00019117f },
-            { 0.00002292f, 0.00078633f, 0.00655965f, 0.01330373f, 0.00655965f, 0.00078633f, 0.00002292f },
-            { 0.00000067f, 0.00002292f, 0.00019117f, 0.00038771f, 0.00019117f, 0.00002292f, 0.00000067f }
-        };
-
-    for (int x = 0; x < newWidth; x++)
-    {
-        for (int y = 0; y < newHeight; y++)
-        {
-            float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-
-            for (int i = -3; i <= 3; i++)
-            {
-                for (int j = -3; j <= 3; j++)
-                {
-                    int xp = glm::clamp(x + i, 0, newWidth - 1);
-                    int yp = glm::clamp(y + j, 0, newHeight - 1);
-
-                    float weight = matrix[i + 3][j + 3];
-
-                    int index = 4 * (newWidth * yp + xp);
-
-                    for (int k = 0; k < 4; k++)
-                        color[k] += weight * mipmap[index + k];
-                }
-            }
-
-            int index = 4 * (newWidth * y + x);
-
-            for (int k = 0; k < 4; k++)
-            {
-                float value = glm::clamp(color[k], 0.0f, 255.0f);
-                blured[index + k] = static_cast<unsigned char>(value);
-            }
-        }
-    }
-
-    // create SDL surface and final texture
-    ImageData image;
-    image.surface = SDL_CreateRGBSurfaceFrom(blured.get(), newWidth, newHeight,
-        32, 4 * newWidth, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
-
-    TextureCreateParams params;
-    params.filter = TextureFilter::BILINEAR;
-    params.format = TextureFormat::RGBA;
-    params.mipmap = false;
-
-    m_capturedWorldTexture = m_device->CreateTexture(&image, params);
-
-    SDL_FreeSurface(image.surface);
+    // downsampled and blurred on the GPU, the pixels never come back to the CPU
+    m_capturedWorldTexture = m_device->CreateBlurredScreenTexture();
 
     m_captureWorld = false;
     m_worldCaptured = true;
@@ -3448,18 +3889,29 @@ void CEngine::RenderShadowMap()
             m_shadowMap.size.x, m_shadowMap.size.y, 32);
     }
 
-    auto renderer = m_device->GetShadowRenderer();
-    renderer->Begin();
-    renderer->SetShadowMap(m_shadowMap);
-    renderer->SetShadowRegion({ 0.0, 0.0 }, { 1.0, 1.0 });
+    // The shadows of the terrain and fixed objects are kept in a second map,
+    // whose regions cover a larger window when the device allows a texture this large
+    if (m_staticShadowMap.id == 0)
+    {
+        m_staticShadowWindow = STATIC_SHADOW_WINDOW;
+        if (m_shadowMap.size.x * m_staticShadowWindow > m_device->GetMaxTextureSize())
+            m_staticShadowWindow = 1;
 
-    m_device->Clear();
+        m_staticShadowMap = m_device->CreateDepthTexture(
+            m_shadowMap.size.x * m_staticShadowWindow,
+            m_shadowMap.size.y * m_staticShadowWindow,
+            32);
+
+        InvalidateStaticShadows();
+    }
+
+    // Frustum planes of each region and of its window of static shadows, as (normal, distance)
+    glm::vec4 planes[4][6];
+    glm::vec4 staticPlanes[4][6];
 
     for (int region = 0; region < m_shadowRegions; region++)
     {
-        renderer->SetShadowRegion(
-            m_shadowParams[region].offset,
-            m_shadowParams[region].scale);
+        ShadowParam& param = m_shadowParams[region];
 
         // recompute matrices
         glm::vec3 worldUp(0.0f, 1.0f, 0.0f);
@@ -3481,24 +3933,39 @@ void CEngine::RenderShadowMap()
 
         glm::vec3 pos = m_lookatPt + 0.25f * dist * dir;
 
+        // To prevent 'shadow shimmering', we ensure that the position only moves in texel-sized
+        // increments. To do this we transform the position to a space where the light's forward/right/up
+        // axes are aligned with the x/y/z axes (not necessarily in that order, and +/- signs don't matter).
+        glm::mat4 lightRotation;
+        Math::LoadViewMatrix(lightRotation, glm::vec3{0, 0, 0}, lightDir, worldUp);
+        pos = Math::Transform(lightRotation, pos);
+        // ...then we round to the nearest texel of the region:
+        const float worldUnitsPerTexel = (dist * 2.0f) / (m_shadowMap.size.x * param.scale.x);
+        pos = glm::round(pos / worldUnitsPerTexel) * worldUnitsPerTexel;
+
+        // The static shadows are drawn in a window m_staticShadowWindow times larger, centered on a coarse
+        // grid of the same space, and are reused until the region leaves the window or a caster changes
+        float staticDist = dist * m_staticShadowWindow;
+        float margin = staticDist - dist;
+        glm::vec3 offset = pos - param.staticAnchor;
+        if (!param.staticValid || std::abs(offset.x) > margin || std::abs(offset.y) > margin ||
+            std::abs(offset.z) > margin)
         {
-            // To prevent 'shadow shimmering', we ensure that the position only moves in texel-sized
-            // increments. To do this we transform the position to a space where the light's forward/right/up
-            // axes are aligned with the x/y/z axes (not necessarily in that order, and +/- signs don't matter).
-            glm::mat4 lightRotation;
-            Math::LoadViewMatrix(lightRotation, glm::vec3{0, 0, 0}, lightDir, worldUp);
-            pos = Math::Transform(lightRotation, pos);
-            // ...then we round to the nearest worldUnitsPerTexel:
-            const float worldUnitsPerTexel = (dist * 2.0f) / m_shadowMap.size.x;
-            pos /= worldUnitsPerTexel;
-            pos.x = round(pos.x);
-            pos.y = round(pos.y);
-            pos.z = round(pos.z);
-            pos *= worldUnitsPerTexel;
-            // ...and convert back to world space.
-            pos = Math::Transform(glm::inverse(lightRotation), pos);
+            float step = std::max(margin, worldUnitsPerTexel);
+            param.staticAnchor = glm::round(pos / step) * step;
+            param.staticValid = false;
         }
 
+        // Both share the depth origin, so that the static depth can be copied as is, and the depth range
+        // covers the region wherever it is in the window
+        pos.z = param.staticAnchor.z;
+        depth += margin;
+
+        // ...and convert back to world space.
+        glm::mat4 lightToWorld = glm::inverse(lightRotation);
+        glm::vec3 staticPos = Math::Transform(lightToWorld, param.staticAnchor);
+        pos = Math::Transform(lightToWorld, pos);
+
         glm::vec3 lookAt = pos - lightDir;
 
         Math::LoadOrthoProjectionMatrix(m_shadowProjMat, -dist, dist, -dist, dist, -depth, depth);
@@ -3515,47 +3982,129 @@ void CEngine::RenderShadowMap()
 
         auto projectionViewMatrix = m_shadowProjMat * m_shadowViewMat;
 
-        m_shadowParams[region].transform = m_shadowTextureMat;
+        param.transform = m_shadowTextureMat;
+        param.projection = m_shadowProjMat;
+        param.view = m_shadowViewMat;
 
-        renderer->SetProjectionMatrix(m_shadowProjMat);
-        renderer->SetViewMatrix(m_shadowViewMat);
+        GetShadowPlanes(projectionViewMatrix, planes[region]);
 
-        // render objects into shadow map
-        for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
-        {
-            if (!m_objects[objRank].used)
-                continue;
+        Math::LoadOrthoProjectionMatrix(param.staticProjection, -staticDist, staticDist, -staticDist, staticDist,
+                                        -depth, depth);
+        Math::LoadViewMatrix(param.staticView, staticPos, staticPos - lightDir, worldUp);
 
-            bool terrain = (m_objects[objRank].type == ENG_OBJTYPE_TERRAIN);
+        auto staticProjectionView = param.staticProjection * param.staticView;
+        GetShadowPlanes(staticProjectionView, staticPlanes[region]);
 
-            if (terrain && !m_terrainShadows) continue;
+        // The texels of the region lie on the texels of the window, offset by a whole number
+        glm::vec2 regionSize = glm::vec2(m_shadowMap.size) * param.scale;
+        glm::vec2 staticSize = glm::vec2(m_staticShadowMap.size) * param.scale;
+        glm::vec4 center = staticProjectionView * glm::vec4(pos, 1.0f);
+        glm::vec2 corner = glm::vec2(m_staticShadowMap.size) * param.offset +
+                           (glm::vec2(center) * 0.5f + 0.5f) * staticSize - regionSize * 0.5f;
+        param.staticSource = glm::ivec2(glm::round(corner));
 
-            auto combinedMatrix = projectionViewMatrix * m_objects[objRank].transform;
+        param.staticCasters.clear();
+        param.dynamicCasters.clear();
+    }
 
-            if (!IsVisible(combinedMatrix, objRank))
-                continue;
+    // Finds the objects of all the regions in a single pass
+    for (int objRank = 0; objRank < static_cast<int>(m_objects.size()); objRank++)
+    {
+        EngineObject& object = m_objects[objRank];
+        if (!object.used)
+            continue;
 
-            int baseObjRank = m_objects[objRank].baseObjRank;
-            if (baseObjRank == -1)
-                continue;
+        object.shadowSeen = true;
 
-            assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
+        if (object.type == ENG_OBJTYPE_TERRAIN && !m_terrainShadows)
+            continue;
 
-            EngineBaseObject& p1 = m_baseObjects[baseObjRank];
-            if (!p1.used)
-                continue;
+        int baseObjRank = object.baseObjRank;
+        if (baseObjRank == -1)
+            continue;
 
-            renderer->SetModelMatrix(m_objects[objRank].transform);
+        assert(baseObjRank >= 0 && baseObjRank < static_cast<int>(m_baseObjects.size()));
 
-            for (auto& data : p1.next)
-            {
-                renderer->SetTexture(data.albedoTexture);
+        const EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+        if (!p1.used)
+            continue;
 
-                renderer->DrawObject(data.buffer, true);
+        bool isStatic = IsStaticShadowCaster(object);
+
+        glm::vec3 center = glm::vec3(object.transform * glm::vec4(p1.boundingSphere.pos, 1.0f));
+        float scale = std::max({ glm::dot(glm::vec3(object.transform[0]), glm::vec3(object.transform[0])),
+                                 glm::dot(glm::vec3(object.transform[1]), glm::vec3(object.transform[1])),
+                                 glm::dot(glm::vec3(object.transform[2]), glm::vec3(object.transform[2])) });
+        float radius = p1.boundingSphere.radius * std::sqrt(scale);
+
+        for (int region = 0; region < m_shadowRegions; region++)
+        {
+            ShadowParam& param = m_shadowParams[region];
+            if (isStatic && param.staticValid)
+                continue;
+
+            bool inside = true;
+            for (const auto& plane : isStatic ? staticPlanes[region] : planes[region])
+            {
+                if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                {
+                    inside = false;
+                    break;
+                }
             }
+            if (!inside)
+                continue;
+
+            if (isStatic)
+                param.staticCasters.push_back(objRank);
+            else
+                param.dynamicCasters.push_back(objRank);
         }
     }
 
+    auto renderer = m_device->GetShadowRenderer();
+    renderer->Begin();
+
+    // Redraws the static shadows of the regions which left their window or whose objects changed
+    renderer->SetShadowMap(m_staticShadowMap);
+
+    for (int region = 0; region < m_shadowRegions; region++)
+    {
+        ShadowParam& param = m_shadowParams[region];
+        if (param.staticValid)
+        {
+            m_staticShadowHits++;
+            continue;
+        }
+
+        renderer->SetShadowRegion(param.offset, param.scale);
+        renderer->ClearShadowRegion();
+
+        renderer->SetProjectionMatrix(param.staticProjection);
+        renderer->SetViewMatrix(param.staticView);
+
+        DrawShadowCasters(param.staticCasters);
+
+        param.staticValid = true;
+        m_staticShadowRedraws++;
+    }
+
+    // Each region of the shadow map starts from its static shadows, the regions cover the whole map
+    renderer->SetShadowMap(m_shadowMap);
+
+    for (int region = 0; region < m_shadowRegions; region++)
+    {
+        const ShadowParam& param = m_shadowParams[region];
+
+        renderer->SetShadowRegion(param.offset, param.scale);
+        renderer->CopyShadowRegion(m_staticShadowMap, param.staticSource);
+
+        renderer->SetProjectionMatrix(param.projection);
+        renderer->SetViewMatrix(param.view);
+
+        DrawShadowCasters(param.dynamicCasters);
+    }
+
     renderer->End();
 
     // restore default state
@@ -3569,6 +4118,185 @@ void CEngine::RenderShadowMap()
     m_device->SetDepthTest(false);
 }
 
+void CEngine::ClearInstanceBatches()
+{
+    for (int baseObjRank : m_instanceBatchRanks)
+        m_instanceBatches[baseObjRank].clear();
+
+    m_instanceBatchRanks.clear();
+}
+
+void CEngine::AddToInstanceBatch(int objRank, int baseObjRank)
+{
+    if (baseObjRank >= static_cast<int>(m_instanceBatches.size()))
+        m_instanceBatches.resize(m_baseObjects.size());
+
+    auto& batch = m_instanceBatches[baseObjRank];
+
+    if (batch.empty())
+        m_instanceBatchRanks.push_back(baseObjRank);
+
+    batch.push_back(objRank);
+}
+
+bool CEngine::IsStaticShadowCaster(const EngineObject& object)
+{
+    if (!object.used || object.shadowDynamic)
+        return false;
+
+    return object.type == ENG_OBJTYPE_TERRAIN ||
+           object.type == ENG_OBJTYPE_FIX     ||
+           object.type == ENG_OBJTYPE_QUARTZ  ||
+           object.type == ENG_OBJTYPE_METAL;
+}
+
+void CEngine::InvalidateStaticShadows()
+{
+    for (auto& param : m_shadowParams)
+        param.staticValid = false;
+}
+
+void CEngine::InvalidateStaticShadows(int objRank)
+{
+    const EngineObject& object = m_objects[objRank];
+    if (object.baseObjRank == -1)
+        return;
+
+    const auto& sphere = m_baseObjects[object.baseObjRank].boundingSphere;
+
+    glm::vec3 center = glm::vec3(object.transform * glm::vec4(sphere.pos, 1.0f));
+    float scale = std::max({ glm::length(glm::vec3(object.transform[0])),
+                             glm::length(glm::vec3(object.transform[1])),
+                             glm::length(glm::vec3(object.transform[2])) });
+    float radius = sphere.radius * scale;
+
+    for (int region = 0; region < m_shadowRegions; region++)
+    {
+        ShadowParam& param = m_shadowParams[region];
+        if (!param.staticValid)
+            continue;
+
+        glm::vec4 planes[6];
+        GetShadowPlanes(param.staticProjection * param.staticView, planes);
+
+        bool inside = true;
+        for (const auto& plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            {
+                inside = false;
+                break;
+            }
+        }
+
+        if (inside)
+            param.staticValid = false;
+    }
+}
+
+void CEngine::DeleteStaticShadowMap()
+{
+    if (m_staticShadowMap.id != 0)
+        m_device->DestroyTexture(m_staticShadowMap);
+
+    m_staticShadowMap = Texture();
+    InvalidateStaticShadows();
+}
+
+void CEngine::DrawShadowCasters(const std::vector<int>& objRanks)
+{
+    auto renderer = m_device->GetShadowRenderer();
+
+    ClearInstanceBatches();
+
+    for (int objRank : objRanks)
+        AddToInstanceBatch(objRank, m_objects[objRank].baseObjRank);
+
+    for (int baseObjRank : m_instanceBatchRanks)
+    {
+        const auto& batch = m_instanceBatches[baseObjRank];
+        EngineBaseObject& p1 = m_baseObjects[baseObjRank];
+
+        if (batch.size() == 1)
+        {
+            renderer->SetModelMatrix(m_objects[batch.front()].transform);
+
+            for (auto& data : p1.next)
+            {
+                renderer->SetTexture(data.albedoTexture);
+
+                renderer->DrawObject(data.buffer, true);
+            }
+
+            continue;
+        }
+
+        m_instanceMatrices.clear();
+
+        for (int objRank : batch)
+            m_instanceMatrices.push_back(m_objects[objRank].transform);
+
+        for (auto& data : p1.next)
+        {
+            renderer->SetTexture(data.albedoTexture);
+
+            renderer->DrawObjectInstanced(data.buffer, true,
+                static_cast<int>(m_instanceMatrices.size()), m_instanceMatrices.data());
+        }
+    }
+}
+
+int CEngine::GetObjectLights(int objRank, int ranks[MAX_DRAW_LIGHTS])
+{
+    const EngineObject& object = m_objects[objRank];
+    const auto& sphere = m_baseObjects[object.baseObjRank].boundingSphere;
+
+    glm::vec3 center = glm::vec3(object.transform * glm::vec4(sphere.pos, 1.0f));
+    float scale = std::max({ glm::length(glm::vec3(object.transform[0])),
+                             glm::length(glm::vec3(object.transform[1])),
+                             glm::length(glm::vec3(object.transform[2])) });
+
+    return m_lightMan->GetObjectLights(objRank, object.type, center, sphere.radius * scale, ranks);
+}
+
+void CEngine::GetDynamicLights(int count, const int* ranks, Light* lights)
+{
+    for (int i = 0; i < count; i++)
+        m_lightMan->GetLight(ranks[i], lights[i]);
+}
+
+ObjectInstance CEngine::GetObjectInstance(int objRank, const Material& material)
+{
+    ObjectInstance instance;
+    instance.modelMatrix = m_objects[objRank].transform;
+
+    Color color = material.albedoColor;
+
+    if (!material.tag.empty())
+    {
+        Color c = GetObjectColor(objRank, material.tag);
+
+        if (c != Color(1.0, 1.0, 1.0, 1.0))
+        {
+            color = c;
+        }
+    }
+
+    instance.albedoColor = color;
+
+    if (!material.recolor.empty())
+    {
+        Color recolorTo = GetObjectColor(objRank, material.recolor);
+        instance.recolorTo = { recolorTo.r, recolorTo.g, recolorTo.b };
+    }
+    else
+    {
+        instance.recolorTo = { 0.0f, 0.0f, 0.0f };
+    }
+
+    return instance;
+}
+
 void CEngine::UseMSAA(bool enable)
 {
     m_multisample = Math::Min(m_device->GetMaxSamples(), m_multisample);
@@ -4644,7 +5372,7 @@ void CEngine::DrawStats()
 
     float height = m_text->GetAscent(FONT_COMMON, 13.0f);
     float width = 0.4f;
-    const int TOTAL_LINES = 22;
+    const int TOTAL_LINES = 23;
 
     glm::vec2 pos(0.05f * m_size.x/m_size.y, 0.05f + TOTAL_LINES * height);
 
@@ -4732,6 +5460,8 @@ void CEngine::DrawStats()
     drawStatsCounter("Swap buffers & VSync",  PCNT_SWAP_BUFFERS);
     drawStatsLine(   "", "", "");
     drawStatsLine(   "Triangles",         StrUtils::ToString<int>(m_statisticTriangle), "");
+    drawStatsLine(   "Static shadows",    StrUtils::Format("%d reused", m_staticShadowHits),
+                                          StrUtils::Format("%d redrawn", m_staticShadowRedraws));
     drawStatsLine(   "FPS",               StrUtils::Format("%.3f", m_fps), "");
     drawStatsLine(   "", "", "");
     std::stringstream str;
@@ -4792,6 +5522,9 @@ void CEngine::AddBaseObjTriangles(int baseObjRank, const std::vector<Gfx::ModelT
         p1.totalTriangles += vertices.size() / 3;
     }
 
+    p1.pickNodes.clear();
+    p1.pickVertices.clear();
+
     m_updateStaticBuffers = true;
 }
 
@@ -28,6 +28,7 @@
 #include "common/system/system.h"
 
 #include "graphics/core/color.h"
+#include "graphics/core/light.h"
 #include "graphics/core/texture.h"
 #include "graphics/core/renderers.h"
 #include "graphics/core/vertex.h"
@@ -36,11 +37,13 @@
 
 #include <glm/glm.hpp>
 
+#include <array>
 #include <string>
 #include <vector>
 #include <map>
 #include <set>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 
@@ -48,6 +51,7 @@ class CApplication;
 class CSoundInterface;
 class CImage;
 class CSystemUtils;
+class CWorkerPool;
 struct Event;
 
 
@@ -56,6 +60,8 @@ namespace Gfx
 {
 
 class CDevice;
+class CFrameBufferPixels;
+class CFrameBufferReadback;
 class CUIRenderer;
 class CObjectRenderer;
 class COldModelManager;
@@ -140,6 +146,10 @@ struct EngineObject
     bool                   ghost = false;
     //! Team
     int                    team = 0;
+    //! If true, the object existed during the last shadow pass
+    bool                   shadowSeen = false;
+    //! If true, the object moved since it was created and is not kept in the cache of static shadows
+    bool                   shadowDynamic = false;
 };
 
 /**
@@ -398,6 +408,11 @@ enum EngineMouseType : unsigned char
  * Shadows are drawn as circular spots on the ground, except for shadows for worms, which have
  * special mode for them.
  *
+ * With shadow mapping, the shadows of the terrain and of the fixed objects are drawn in a separate
+ * shadow map, which is copied into the shadow map of each frame and redrawn only when a region
+ * moves or those objects change. A fixed object which moves after its creation is drawn with
+ * the vehicles on each frame from then on.
+ *
  * \section Textures Textures
  *
  * Textures are loaded from a texture subdir in data directory. In the old code, textures were identified
@@ -463,7 +478,10 @@ public:
 
 
     //! Writes a screenshot containing the current frame
+    /** The pixels are copied without waiting for the GPU and written by UpdateScreenShots() a few frames later. */
     void            WriteScreenShot(const std::string& fileName);
+    //! Starts writing the screenshots whose pixels are ready; if \a wait is true, waits for all of them
+    void            UpdateScreenShots(bool wait = false);
 
 
     //@{
@@ -583,6 +601,9 @@ public:
     int             GetObjectBaseRank(int objRank);
     //@}
 
+    //! Switches the object to another resolution of the same geometry, redrawing only the static shadows around it
+    void            SetObjectLodBaseRank(int objRank, int baseObjRank);
+
     //@{
     //! Management of engine object type
     void            SetObjectType(int objRank, EngineObjectType type);
@@ -690,6 +711,22 @@ public:
     //! Loads all necessary textures
     bool            LoadAllTextures();
 
+    //! Starts decoding texture on a worker thread, it is created by UpdateTextureStreaming() once ready
+    /** Until then, LoadTexture() returns an invalid texture as placeholder. */
+    void            RequestTexture(const std::string& name, const TextureCreateParams& params);
+    //! Returns whether texture was requested and is not created yet
+    bool            IsTextureStreaming(const std::string& name) const;
+    //! Creates textures that finished decoding; if \a wait is true, waits for all requests first
+    void            UpdateTextureStreaming(bool wait = false);
+
+    //! Sets the memory budget for textures loaded from files, in bytes (0 = unlimited)
+    void            SetTextureMemoryBudget(std::size_t budget);
+    //! Returns the memory budget for textures loaded from files
+    std::size_t     GetTextureMemoryBudget() const;
+    //! Evicts least recently used textures that are not used by engine objects until they fit in the budget
+    /** Also trims the texture cache files on disk, see TrimTextureCacheFiles(). */
+    void            TrimTextureCache();
+
     //! Deletes the given texture, unloading it and removing from cache
     void            DeleteTexture(const std::string& texName);
     //! Deletes the given texture, unloading it and removing from cache
@@ -1034,21 +1071,50 @@ protected:
     EngineBaseObjDataTier& AddLevel(EngineBaseObject& p3, EngineTriangleType type, const Material& material);
 
     //! Create texture and add it to cache
-    Texture CreateTexture(const std::string &texName, const TextureCreateParams &params, CImage* image = nullptr);
+    Texture CreateTexture(const std::string &texName, const TextureCreateParams &params, CImage* image = nullptr,
+                          const std::vector<TextureMipmap>& mipmaps = {});
+    //! Binds textures of engine objects, returns false if some couldn't be loaded
+    bool    UpdateObjectTextures();
+    //! Loads texture of a data tier of the base object, remembering the base object if the texture is still streaming
+    Texture LoadObjectTexture(int baseObjRank, const std::string& name, const TextureCreateParams& params);
+    //! Binds a texture that finished streaming to the data tiers waiting for it
+    void    BindStreamedTexture(const std::string& name, const Texture& tex);
 
     //! Tests whether the given object is visible
     bool        IsVisible(const glm::mat4& matrix, int objRank);
 
-    bool        InPlane(glm::vec3 normal, float originPlane, glm::vec3 center, float radius);
+    //! Tests whether the object is drawn in the cache of static shadows
+    bool        IsStaticShadowCaster(const EngineObject& object);
+    //! Redraws the cache of static shadows on the next frame
+    void        InvalidateStaticShadows();
+    //! Redraws the static shadows of the regions whose window contains the object
+    void        InvalidateStaticShadows(int objRank);
+    //! Destroys the cache of static shadows
+    void        DeleteStaticShadowMap();
+    //! Draws the given objects in the current shadow region
+    void        DrawShadowCasters(const std::vector<int>& objRanks);
+
+    //! Clears batches of objects collected for instanced rendering
+    void        ClearInstanceBatches();
+    //! Adds object to the batch of visible objects sharing its base object
+    void        AddToInstanceBatch(int objRank, int baseObjRank);
+    //! Returns per-instance parameters of object drawn with given material
+    ObjectInstance GetObjectInstance(int objRank, const Material& material);
+    //! Finds the point and spot lights affecting the object, see CLightManager::GetObjectLights()
+    int         GetObjectLights(int objRank, int ranks[MAX_DRAW_LIGHTS]);
+    //! Copies the current configuration of the given dynamic lights
+    void        GetDynamicLights(int count, const int* ranks, Light* lights);
 
-    //! Detects whether an object is affected by the mouse
-    bool        DetectBBox(int objRank, const glm::vec2& mouse);
+    bool        InPlane(glm::vec3 normal, float originPlane, glm::vec3 center, float radius);
 
     //! Compute and return the 2D box on screen of any object
     bool        GetBBox2D(int objRank, glm::vec2& min, glm::vec2& max);
 
-    //! Detects whether the mouse is in a triangle.
-    bool        DetectTriangle(const glm::vec2& mouse, Vertex3D* triangle, int objRank, float& dist, glm::vec3& pos);
+    //! Finds the nearest triangle of a base object hit by a ray in the coordinates of the object
+    /** \a dist gives the maximum distance along the ray and receives the distance to the triangle. */
+    bool        DetectPickTree(EngineBaseObject& p1, const glm::vec3& origin, const glm::vec3& dir, float& dist);
+    //! Builds the hierarchy of the triangles of a base object used by DetectPickTree()
+    void        BuildPickTree(EngineBaseObject& p1);
 
     //! Transforms a 3D point (x, y, z) in 2D space (x, y, -) of the window
     /** The coordinated p2D.z gives the distance. */
@@ -1068,7 +1134,8 @@ protected:
 
     struct WriteScreenShotData
     {
-        std::unique_ptr<CImage> img;
+        std::unique_ptr<CFrameBufferPixels> pixels;
+        glm::ivec2 size;
         std::string fileName;
     };
     static void WriteScreenShotThread(std::unique_ptr<WriteScreenShotData> data);
@@ -1142,6 +1209,20 @@ protected:
     std::vector<EngineBaseObject> m_baseObjects;
     //! Object parameters
     std::vector<EngineObject>     m_objects;
+    //! Visible objects grouped by base object rank, for instanced rendering
+    std::vector<std::vector<int>> m_instanceBatches;
+    //! Base object ranks of non-empty instance batches, in order of appearance
+    std::vector<int>              m_instanceBatchRanks;
+    //! Objects of the currently drawn batch with the ranks of their dynamic lights
+    std::vector<std::pair<std::array<int, MAX_DRAW_LIGHTS>, int>> m_batchLights;
+    //! Objects of the currently drawn batch lit by the same dynamic lights
+    std::vector<int>              m_batchRun;
+    //! Per-instance data of the currently drawn batch
+    std::vector<ObjectInstance>   m_objectInstances;
+    //! Per-instance model matrices of the currently drawn shadow batch
+    std::vector<glm::mat4>        m_instanceMatrices;
+    //! Objects whose bounding sphere is crossed by the ray of DetectObject(), with the distance to the sphere
+    std::vector<std::pair<float, int>> m_pickCandidates;
     //! Shadow list
     std::vector<EngineShadow>     m_shadowSpots;
     //! Ground spot list
@@ -1206,11 +1287,35 @@ protected:
         glm::vec2 offset;
         glm::vec2 scale;
         float range;
+        //! Matrices of the shadow renderer for this region
+        glm::mat4 projection;
+        glm::mat4 view;
+
+        //! Center of the window of static shadows drawn in this region of m_staticShadowMap, in light space
+        glm::vec3 staticAnchor{ 0, 0, 0 };
+        //! Matrices of the shadow renderer for the window of static shadows
+        glm::mat4 staticProjection;
+        glm::mat4 staticView;
+        //! Lower left corner of this region in m_staticShadowMap, in texels
+        glm::ivec2 staticSource{ 0, 0 };
+        //! If true, the static shadows of the region are up to date
+        bool staticValid = false;
+
+        //! Objects found in the region by the last shadow pass
+        std::vector<int> staticCasters;
+        std::vector<int> dynamicCasters;
     };
 
     int             m_shadowRegions = 4;
     ShadowParam     m_shadowParams[4];
     Texture         m_shadowMap;
+    //! Shadows of the terrain and the objects which don't move, see RenderShadowMap()
+    Texture         m_staticShadowMap;
+    //! Size of the regions of m_staticShadowMap, in regions of m_shadowMap
+    int             m_staticShadowWindow = 1;
+    //! Regions drawn from the static shadows as they were and regions redrawn, since the scene was loaded
+    int             m_staticShadowHits = 0;
+    int             m_staticShadowRedraws = 0;
 
     struct PendingDebugDraw
     {
@@ -1264,6 +1369,31 @@ protected:
     /** Textures on this list were not successful in first loading,
      *  so are disabled for subsequent load calls. */
     std::set<std::string> m_texBlacklist;
+    //! Last frame in which each texture loaded from file was used
+    std::unordered_map<std::string, unsigned long long> m_texLastUse;
+    //! Frame counter for m_texLastUse
+    unsigned long long m_texFrame = 0;
+    //! Memory budget for textures loaded from files
+    std::size_t m_texMemoryBudget = 512 * 1024 * 1024;
+
+    //! Texture image decoded on worker thread
+    struct StreamedTexture
+    {
+        std::string name;
+        std::unique_ptr<CImage> image;
+        std::vector<TextureMipmap> mipmaps;
+        std::string error;
+    };
+    //! Textures requested for streaming, by name
+    std::map<std::string, TextureCreateParams> m_texStreamRequests;
+    //! Base objects with data tiers waiting for each streamed texture, see LoadObjectTexture()
+    std::unordered_map<std::string, std::vector<int>> m_texStreamUsers;
+    //! Protects m_texStreamDone
+    std::mutex m_texStreamMutex;
+    //! Decoded textures waiting to be created on the main thread
+    std::vector<StreamedTexture> m_texStreamDone;
+    //! Threads used to decode texture images; declared last so it stops before the state above is destroyed
+    std::unique_ptr<CWorkerPool> m_texLoaderPool;
 
     //! Texture with mouse cursors
     Texture         m_miceTexture;
@@ -1295,6 +1425,18 @@ protected:
     bool            m_captureWorld = false;
     //! Texture with captured 3D world
     Texture         m_capturedWorldTexture;
+
+    //! Screenshot waiting for its pixels
+    struct PendingScreenShot
+    {
+        std::unique_ptr<CFrameBufferReadback> readback;
+        glm::ivec2 size;
+        std::string fileName;
+        //! Frames rendered since the copy started
+        int frames = 0;
+    };
+    //! Screenshots waiting for their pixels, see UpdateScreenShots()
+    std::vector<PendingScreenShot> m_pendingScreenShots;
 };
 
 
@@ -37,6 +37,28 @@
 namespace Gfx
 {
 
+namespace
+{
+
+//! Size of the cells of the light clusters
+const float LIGHT_CLUSTER_SIZE = 32.0f;
+//! Maximum number of cells in each direction, larger lights or objects use all the cells
+const int LIGHT_CLUSTER_MAX_CELLS = 16;
+//! Attenuation beyond which a light is negligible
+const float LIGHT_MAX_ATTENUATION = 64.0f;
+
+int ClusterCell(float coord)
+{
+    return static_cast<int>(std::floor(coord / LIGHT_CLUSTER_SIZE));
+}
+
+long long ClusterKey(int x, int z)
+{
+    return (static_cast<long long>(x) << 32) ^ static_cast<unsigned int>(z);
+}
+
+} // namespace
+
 
 void LightProgression::Init(float value)
 {
@@ -141,6 +163,7 @@ void CLightManager::DebugDumpLights()
         l->Debug("   attenuation2 = %f\n", light.attenuation2);
         l->Debug("   spotAngle = %f\n", light.spotAngle);
         l->Debug("   spotIntensity = %f\n", light.spotIntensity);
+        l->Debug("   range = %f\n", light.range);
 
         l->Debug(" intensity: %f\n", dynLight.intensity.current);
         l->Debug(" color: %f %f %f\n", dynLight.colorRed.current, dynLight.colorGreen.current, dynLight.colorBlue.current);
@@ -152,6 +175,10 @@ void CLightManager::DebugDumpLights()
 void CLightManager::FlushLights()
 {
     m_dynLights.clear();
+
+    // Forgets the cells of the old scene, every cached object becomes invalid instead
+    m_cellVersions.clear();
+    m_globalVersion = ++m_clusterVersion;
 }
 
 /** Returns the index of light created. */
@@ -442,6 +469,8 @@ void CLightManager::UpdateLights()
             m_dynLights[i].light.diffuse.b = 0.0f;
         }
     }
+
+    UpdateClusters();
 }
 
 void CLightManager::UpdateDeviceLights(EngineObjectType type)
@@ -449,36 +478,20 @@ void CLightManager::UpdateDeviceLights(EngineObjectType type)
     for (int i = 0; i < static_cast<int>( m_lightMap.size() ); ++i)
         m_lightMap[i] = -1;
 
-    std::vector<DynamicLight> sortedLights = m_dynLights;
-    CLightsComparator lightsComparator(m_engine->GetEyePt(), type);
-    std::sort(sortedLights.begin(), sortedLights.end(), lightsComparator);
+    glm::vec3 eye = m_engine->GetEyePt();
 
-    int lightMapIndex = 0;
-    for (int i = 0; i < static_cast<int>( sortedLights.size() ); i++)
+    m_candidates.clear();
+    for (int i = 0; i < static_cast<int>( m_activeLights.size() ); i++)
     {
-        if (! sortedLights[i].used)
-            continue;
-        if (! sortedLights[i].enabled)
-            continue;
-        if (sortedLights[i].intensity.current == 0.0f)
-            continue;
+        if (IsLightIncluded(m_activeLights[i], type))
+            m_candidates.emplace_back(GetLightWeight(m_activeLights[i], eye), i);
+    }
 
-        bool enabled = true;
-        if (sortedLights[i].includeType != ENG_OBJTYPE_NULL)
-            enabled = (sortedLights[i].includeType == type);
+    int count = static_cast<int>( std::min(m_candidates.size(), m_lightMap.size()) );
+    std::partial_sort(m_candidates.begin(), m_candidates.begin() + count, m_candidates.end());
 
-        if (sortedLights[i].excludeType != ENG_OBJTYPE_NULL)
-            enabled = (sortedLights[i].excludeType != type);
-
-        if (enabled)
-        {
-            m_lightMap[lightMapIndex] = sortedLights[i].rank;
-            ++lightMapIndex;
-        }
-
-        if (lightMapIndex >= static_cast<int>( m_lightMap.size() ))
-            break;
-    }
+    for (int i = 0; i < count; i++)
+        m_lightMap[i] = m_activeLights[m_candidates[i].second].rank;
 
     for (int i = 0; i < static_cast<int>( m_lightMap.size() ); ++i)
     {
@@ -496,37 +509,302 @@ void CLightManager::UpdateDeviceLights(EngineObjectType type)
     }
 }
 
-// -----------
+int CLightManager::GetObjectLights(int objRank, EngineObjectType type, const glm::vec3& center, float radius,
+                                   int ranks[MAX_DRAW_LIGHTS])
+{
+    if (objRank >= static_cast<int>( m_objectLights.size() ))
+        m_objectLights.resize(objRank + 1);
+
+    ObjectLights& cache = m_objectLights[objRank];
+    if (cache.type == type && cache.center == center && cache.radius == radius && IsObjectCacheValid(cache))
+    {
+        std::copy(cache.ranks, cache.ranks + cache.count, ranks);
+        return cache.count;
+    }
+
+    m_candidates.clear();
+
+    auto addCandidate = [&](int index)
+    {
+        const ActiveLight& light = m_activeLights[index];
+        if (! IsLightIncluded(light, type))
+            return;
+        if (light.range > 0.0f && glm::distance(light.position, center) > light.range + radius)
+            return;
+
+        m_candidates.emplace_back(GetLightWeight(light, center), index);
+    };
+
+    for (int index : m_globalLights)
+        addCandidate(index);
+
+    int x1 = ClusterCell(center.x - radius), x2 = ClusterCell(center.x + radius);
+    int z1 = ClusterCell(center.z - radius), z2 = ClusterCell(center.z + radius);
+    if (x2 - x1 >= LIGHT_CLUSTER_MAX_CELLS || z2 - z1 >= LIGHT_CLUSTER_MAX_CELLS)
+    {
+        for (const auto& [key, cell] : m_clusterCells)
+        {
+            for (int index : cell)
+                addCandidate(index);
+        }
+    }
+    else
+    {
+        for (int x = x1; x <= x2; x++)
+        {
+            for (int z = z1; z <= z2; z++)
+            {
+                auto it = m_clusterCells.find(ClusterKey(x, z));
+                if (it == m_clusterCells.end())
+                    continue;
+
+                for (int index : it->second)
+                    addCandidate(index);
+            }
+        }
+    }
+
+    // A light covering several cells touched by the object is found several times
+    std::sort(m_candidates.begin(), m_candidates.end());
+    m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()), m_candidates.end());
+
+    int count = std::min(static_cast<int>( m_candidates.size() ), MAX_DRAW_LIGHTS);
+    for (int i = 0; i < count; i++)
+        ranks[i] = m_activeLights[m_candidates[i].second].rank;
+
+    // Objects lit by the same lights get the same list
+    std::sort(ranks, ranks + count);
+
+    cache.version = m_clusterVersion;
+    cache.type = type;
+    cache.center = center;
+    cache.radius = radius;
+    cache.count = count;
+    std::copy(ranks, ranks + count, cache.ranks);
+
+    return count;
+}
+
+void CLightManager::UpdateClusters()
+{
+    std::swap(m_activeLights, m_previousLights);
+    m_activeLights.clear();
+
+    for (const auto& dynLight : m_dynLights)
+    {
+        if (! dynLight.used || ! dynLight.enabled)
+            continue;
+        if (Math::IsZero(dynLight.intensity.current))
+            continue;
+
+        ActiveLight light;
+        light.rank = dynLight.rank;
+        light.type = dynLight.light.type;
+        light.position = dynLight.light.position;
+        light.range = GetLightRange(dynLight.light);
+        light.priority = dynLight.priority;
+        light.includeType = dynLight.includeType;
+        light.excludeType = dynLight.excludeType;
+        m_activeLights.push_back(light);
+    }
+
+    if (m_activeLights == m_previousLights)
+        return;
+
+    m_clusterVersion++;
+
+    // Both lists are sorted by rank, only the cells of the lights which differ lose their cached objects
+    auto previous = m_previousLights.begin();
+    auto active = m_activeLights.begin();
+    while (previous != m_previousLights.end() || active != m_activeLights.end())
+    {
+        if (active == m_activeLights.end() || (previous != m_previousLights.end() && previous->rank < active->rank))
+        {
+            InvalidateLightCells(*previous++);
+        }
+        else if (previous == m_previousLights.end() || active->rank < previous->rank)
+        {
+            InvalidateLightCells(*active++);
+        }
+        else
+        {
+            if (! (*previous == *active))
+            {
+                InvalidateLightCells(*previous);
+                InvalidateLightCells(*active);
+            }
+            ++previous;
+            ++active;
+        }
+    }
+
+    m_clusterCells.clear();
+    m_globalLights.clear();
+
+    for (int i = 0; i < static_cast<int>( m_activeLights.size() ); i++)
+    {
+        const ActiveLight& light = m_activeLights[i];
+
+        // Directional lights are replaced by the sun of the renderers
+        if (light.type == LIGHT_DIRECTIONAL)
+            continue;
+
+        int x1 = 0, x2 = 0, z1 = 0, z2 = 0;
+        if (! GetLightCells(light, x1, x2, z1, z2))
+        {
+            m_globalLights.push_back(i);
+            continue;
+        }
+
+        for (int x = x1; x <= x2; x++)
+        {
+            for (int z = z1; z <= z2; z++)
+            {
+                m_clusterCells[ClusterKey(x, z)].push_back(i);
+            }
+        }
+    }
+}
+
+void CLightManager::InvalidateLightCells(const ActiveLight& light)
+{
+    if (light.type == LIGHT_DIRECTIONAL)
+        return;
+
+    int x1 = 0, x2 = 0, z1 = 0, z2 = 0;
+    if (! GetLightCells(light, x1, x2, z1, z2))
+    {
+        m_globalVersion = m_clusterVersion;
+        return;
+    }
+
+    for (int x = x1; x <= x2; x++)
+    {
+        for (int z = z1; z <= z2; z++)
+        {
+            m_cellVersions[ClusterKey(x, z)] = m_clusterVersion;
+        }
+    }
+}
+
+bool CLightManager::IsObjectCacheValid(const ObjectLights& cache) const
+{
+    if (cache.version < m_globalVersion)
+        return false;
+
+    // Nothing changed since the lights were chosen
+    if (cache.version == m_clusterVersion)
+        return true;
+
+    int x1 = ClusterCell(cache.center.x - cache.radius), x2 = ClusterCell(cache.center.x + cache.radius);
+    int z1 = ClusterCell(cache.center.z - cache.radius), z2 = ClusterCell(cache.center.z + cache.radius);
+    if (x2 - x1 >= LIGHT_CLUSTER_MAX_CELLS || z2 - z1 >= LIGHT_CLUSTER_MAX_CELLS)
+        return false;
+
+    for (int x = x1; x <= x2; x++)
+    {
+        for (int z = z1; z <= z2; z++)
+        {
+            auto it = m_cellVersions.find(ClusterKey(x, z));
+            if (it != m_cellVersions.end() && it->second > cache.version)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool CLightManager::GetLightCells(const ActiveLight& light, int& x1, int& x2, int& z1, int& z2)
+{
+    if (light.range == 0.0f)
+        return false;
+
+    x1 = ClusterCell(light.position.x - light.range);
+    x2 = ClusterCell(light.position.x + light.range);
+    z1 = ClusterCell(light.position.z - light.range);
+    z2 = ClusterCell(light.position.z + light.range);
 
-CLightManager::CLightsComparator::CLightsComparator(glm::vec3 eyePos, EngineObjectType objectType)
+    return x2 - x1 < LIGHT_CLUSTER_MAX_CELLS && z2 - z1 < LIGHT_CLUSTER_MAX_CELLS;
+}
+
+bool CLightManager::IsLightIncluded(const ActiveLight& light, EngineObjectType type)
 {
-    m_eyePos = eyePos;
-    m_objectType = objectType;
+    bool enabled = true;
+    if (light.includeType != ENG_OBJTYPE_NULL)
+        enabled = (light.includeType == type);
+
+    if (light.excludeType != ENG_OBJTYPE_NULL)
+        enabled = (light.excludeType != type);
+
+    return enabled;
 }
 
-float CLightManager::CLightsComparator::GetLightWeight(const DynamicLight& dynLight)
+float CLightManager::GetLightWeight(const ActiveLight& light, const glm::vec3& pos)
 {
-    if (dynLight.priority == LIGHT_PRI_HIGHEST)
+    if (light.priority == LIGHT_PRI_HIGHEST)
         return -1.0f;
 
-    bool enabled = true;
-    if (!dynLight.used || !dynLight.enabled || dynLight.intensity.current == 0.0f)
-        enabled = false;
-    else if (dynLight.includeType != ENG_OBJTYPE_NULL)
-        enabled = dynLight.includeType == m_objectType;
-    else if (dynLight.excludeType != ENG_OBJTYPE_NULL)
-        enabled = dynLight.excludeType != m_objectType;
+    return glm::length(light.position - pos) * light.priority;
+}
 
-    return enabled ? ( glm::length(dynLight.light.position - m_eyePos) * dynLight.priority ) : 10000.0f;
+float CLightManager::GetLightRange(const Light& light)
+{
+    if (light.type == LIGHT_DIRECTIONAL)
+        return 0.0f;
+
+    if (light.range > 0.0f)
+        return light.range;
+
+    // Constant attenuation, the light reaches everything
+    if (light.attenuation1 <= 0.0f && light.attenuation2 <= 0.0f)
+        return 0.0f;
+
+    // Negligible everywhere
+    if (light.attenuation0 >= LIGHT_MAX_ATTENUATION)
+        return Math::TOLERANCE;
+
+    // Solves attenuation0 + attenuation1*d + attenuation2*d^2 = LIGHT_MAX_ATTENUATION
+    float a = light.attenuation2;
+    float b = light.attenuation1;
+    float c = light.attenuation0 - LIGHT_MAX_ATTENUATION;
+
+    if (a > 0.0f)
+        return (-b + sqrtf(b*b - 4.0f*a*c)) / (2.0f*a);
+
+    return -c / b;
 }
 
-bool CLightManager::CLightsComparator::operator()(const DynamicLight& left, const DynamicLight& right)
+float CLightManager::GetSpotRange(const Light& light, float height)
 {
-    float leftWeight = GetLightWeight(left);
-    float rightWeight = GetLightWeight(right);
+    if (light.type != LIGHT_SPOT || height <= 0.0f)
+        return 0.0f;
+
+    // Negligible everywhere
+    if (light.attenuation0 >= LIGHT_MAX_ATTENUATION)
+        return Math::TOLERANCE;
 
-    return leftWeight < rightWeight;
+    // Angle from the axis where pow(cos(angle), spotIntensity) / attenuation0 falls to 1 / LIGHT_MAX_ATTENUATION
+    float angle = light.spotAngle;
+    if (light.spotIntensity > 0.0f)
+    {
+        float cosine = powf(light.attenuation0 / LIGHT_MAX_ATTENUATION, 1.0f / light.spotIntensity);
+        angle = std::min(angle, acosf(cosine));
+    }
+
+    // The far edge of the lit area, with the tilt of the axis from the vertical
+    float tilt = acosf(glm::clamp(-glm::normalize(light.direction).y, -1.0f, 1.0f));
+    float edge = tilt + angle;
+    if (edge >= Math::PI / 2.0f - 0.01f)
+        return 0.0f;
+
+    return height / cosf(edge);
 }
 
-} // namespace Gfx
+bool CLightManager::ActiveLight::operator==(const ActiveLight& other) const
+{
+    return rank == other.rank && type == other.type && position == other.position &&
+           range == other.range && priority == other.priority &&
+           includeType == other.includeType && excludeType == other.excludeType;
+}
 
+} // namespace Gfx
@@ -26,6 +26,7 @@
 
 #include "graphics/core/light.h"
 
+#include <unordered_map>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -147,6 +148,12 @@ struct DynamicLight
  * updating the models with new values, while only one function, UpdateDeviceLights(), performs the actual
  * synchronization to the device. It allocates device's light slots as necessary, with two priority levels
  * for lights.
+ *
+ * The renderers get the point and spot lights affecting each draw item from GetObjectLights().
+ * The lights which are turned on are gathered once per frame by UpdateLights() into clusters,
+ * the cells of a horizontal grid covering their range; the lights without a limited range
+ * affect every cell. The lights chosen for an object are kept until the object moves or a light
+ * touching one of its cells changes.
  */
 class CLightManager
 {
@@ -216,21 +223,74 @@ public:
     //! Enables or disables dynamic lights affecting the given object type
     void            UpdateDeviceLights(EngineObjectType type);
 
+    /**
+     * \brief Finds the point and spot lights affecting an engine object
+     *
+     * Chooses at most MAX_DRAW_LIGHTS lights among the lights gathered by the last call
+     * to UpdateLights(), the highest priority and the nearest lights first.
+     * \param objRank Rank of the engine object, the result is cached for it
+     * \param type Type of the engine object
+     * \param center Center of the bounding sphere of the object, in world coordinates
+     * \param radius Radius of the bounding sphere of the object
+     * \param ranks Ranks of the lights, sorted by rank
+     * \return Number of lights
+     */
+    int             GetObjectLights(int objRank, EngineObjectType type, const glm::vec3& center, float radius,
+                                    int ranks[MAX_DRAW_LIGHTS]);
+
+    /**
+     * \brief Returns the cull range of a spot light with constant attenuation shining on the ground
+     *
+     * The lit area is limited by the spot cone and by the angle where the spot exponent makes
+     * the light negligible; the range is the distance from the light to the far edge of that area.
+     * \param light Spot light
+     * \param height Height of the light above the ground
+     * \return Range to set in Light::range, 0 if the lit area isn't limited
+     */
+    static float    GetSpotRange(const Light& light, float height);
+
 protected:
-    class CLightsComparator
+    //! Light turned on, gathered by UpdateLights()
+    struct ActiveLight
     {
-        public:
-            CLightsComparator(glm::vec3 eyePos, EngineObjectType objectType);
-
-            bool operator()(const DynamicLight& left, const DynamicLight& right);
-
-        private:
-            float GetLightWeight(const DynamicLight& dynLight);
+        int       rank;
+        LightType type;
+        glm::vec3 position;
+        //! Distance beyond which the light is negligible, 0 if it isn't limited
+        float     range;
+        LightPriority priority;
+        EngineObjectType includeType;
+        EngineObjectType excludeType;
+
+        bool operator==(const ActiveLight& other) const;
+    };
 
-            glm::vec3 m_eyePos = { 0, 0, 0 };
-            EngineObjectType m_objectType;
+    //! Lights chosen for an engine object
+    struct ObjectLights
+    {
+        unsigned int version = 0;
+        EngineObjectType type{};
+        glm::vec3 center{ 0, 0, 0 };
+        float     radius = 0.0f;
+        int       count = 0;
+        int       ranks[MAX_DRAW_LIGHTS] = {};
     };
 
+    //! Checks if the light affects the given object type
+    static bool     IsLightIncluded(const ActiveLight& light, EngineObjectType type);
+    //! Weight of the light for an object at given position, the lowest weights are chosen first
+    static float    GetLightWeight(const ActiveLight& light, const glm::vec3& pos);
+    //! Distance beyond which the light is negligible, 0 if it isn't limited
+    static float    GetLightRange(const Light& light);
+    //! Cells covered by the light, false if it affects all the cells
+    static bool     GetLightCells(const ActiveLight& light, int& x1, int& x2, int& z1, int& z2);
+    //! Gathers the lights turned on and rebuilds the clusters if they changed since the previous frame
+    void            UpdateClusters();
+    //! Marks the cells covered by a light which appeared, disappeared or changed
+    void            InvalidateLightCells(const ActiveLight& light);
+    //! Checks if the lights chosen for an object are still valid
+    bool            IsObjectCacheValid(const ObjectLights& cache) const;
+
 protected:
     CEngine*          m_engine;
     CDevice*          m_device;
@@ -241,6 +301,26 @@ protected:
     std::vector<DynamicLight> m_dynLights;
     //! Map of current light allocation: graphics light -> dynamic light
     std::vector<int>  m_lightMap;
+
+    //! Lights turned on during the current frame
+    std::vector<ActiveLight> m_activeLights;
+    //! Lights of the previous frame, to detect changes
+    std::vector<ActiveLight> m_previousLights;
+    //! Point and spot lights in each horizontal cell, indexes in m_activeLights
+    std::unordered_map<long long, std::vector<int>> m_clusterCells;
+    //! Point and spot lights affecting all the cells
+    std::vector<int>  m_globalLights;
+    //! Incremented each time the clusters change
+    unsigned int      m_clusterVersion = 1;
+    //! Value of m_clusterVersion when a light affecting all the cells last changed
+    unsigned int      m_globalVersion = 1;
+    //! Value of m_clusterVersion when a light in the cell last changed
+    std::unordered_map<long long, unsigned int> m_cellVersions;
+
+    //! Cache of chosen lights, indexed by engine object rank
+    std::vector<ObjectLights> m_objectLights;
+    //! Candidates while choosing lights
+    std::vector<std::pair<float, int>> m_candidates;
 };
 
 } // namespace Gfx
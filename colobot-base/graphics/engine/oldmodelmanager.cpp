@@ -25,14 +25,20 @@
 #include "common/stringutils.h"
 
 #include "common/resources/inputstream.h"
+#include "common/resources/outputstream.h"
 #include "common/resources/resourcemanager.h"
 
+#include "common/thread/worker_pool.h"
+
 #include "graphics/engine/engine.h"
 
-#include "graphics/model/model_input.h"
+#include "graphics/model/model.h"
+#include "graphics/model/model_bin.h"
 #include "graphics/model/model_io_exception.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <filesystem>
 
 namespace Gfx
 {
@@ -46,7 +52,11 @@ COldModelManager::~COldModelManager()
 {
 }
 
-bool COldModelManager::LoadModel(const std::string& name, bool mirrored, int team)
+namespace
+{
+
+//! Reads the model of the given name, nullptr if there is none
+std::unique_ptr<CModel> ReadModel(const std::string& name)
 {
     std::unique_ptr<CModel> model;
     try
@@ -57,12 +67,12 @@ bool COldModelManager::LoadModel(const std::string& name, bool mirrored, int tea
         {
             GetLogger()->Debug("Loading model '%s'\n", name.c_str());
 
-            model = ModelInput::Read("models/" + name);
+            model = ModelIO::ReadCachedModel("models/" + name);
 
             if (model->GetMeshCount() == 0)
-                return false;
+                return nullptr;
 
-            goto skip;
+            return model;
         }
 
         auto gltf_path = "models/" + name + ".gltf";
@@ -71,10 +81,10 @@ bool COldModelManager::LoadModel(const std::string& name, bool mirrored, int tea
         {
             GetLogger()->Debug("Loading model '%s'\n", (name + ".gltf").c_str());
 
-            model = ModelInput::Read(gltf_path);
+            model = ModelIO::ReadCachedModel(gltf_path);
 
             if (model->GetMeshCount() > 0)
-                goto skip;
+                return model;
         }
 
         auto mod_path = "models/" + name + ".mod";
@@ -83,21 +93,43 @@ bool COldModelManager::LoadModel(const std::string& name, bool mirrored, int tea
         {
             GetLogger()->Debug("Loading model '%s'\n", (name + ".mod").c_str());
 
-            model = ModelInput::Read(mod_path);
+            model = ModelIO::ReadCachedModel(mod_path);
 
             if (model->GetMeshCount() > 0)
-                goto skip;
+                return model;
         }
 
-        return false;
+        return nullptr;
     }
     catch (const CModelIOException& e)
     {
         GetLogger()->Error("Loading model '%s' failed: %s\n", name.c_str(), e.what());
-        return false;
+        return nullptr;
     }
+}
+
+} // anonymous namespace
+
+bool COldModelManager::LoadModel(const std::string& name, bool mirrored, int team)
+{
+    // a preloaded model is kept until ClearPreloadedModels(), the mirrored and team variants share it
+    std::unique_ptr<CModel> loaded;
+    CModel* model = nullptr;
+
+    auto preloaded = m_preloadedModels.find(name);
+    if (preloaded != m_preloadedModels.end() && preloaded->second != nullptr)
+    {
+        model = preloaded->second.get();
+    }
+    else
+    {
+        loaded = ReadModel(name);
+        model = loaded.get();
+    }
+
+    if (model == nullptr)
+        return false;
 
-skip:
     CModelMesh* mesh = model->GetMesh();
     assert(mesh != nullptr);
 
@@ -197,6 +229,63 @@ void COldModelManager::UnloadAllModels()
     m_models.clear();
 }
 
+void COldModelManager::PreloadModels(const std::string& listFile, CWorkerPool& pool)
+{
+    m_preloadedModels.clear();
+
+    if (!CResourceManager::Exists(listFile))
+        return;
+
+    std::vector<std::string> loaded = GetLoadedModelNames();
+
+    CInputStream stream;
+    stream.open(listFile);
+
+    // Every task fills its own entry, the map itself is not changed until they are done
+    std::string fileName;
+    while (std::getline(stream, fileName))
+    {
+        if (!fileName.empty() && std::find(loaded.begin(), loaded.end(), fileName) == loaded.end())
+            m_preloadedModels.emplace(fileName, nullptr);
+    }
+
+    for (auto& [name, model] : m_preloadedModels)
+    {
+        pool.Start([&name = name, &model = model]()
+        {
+            model = ReadModel(name);
+        });
+    }
+}
+
+void COldModelManager::ClearPreloadedModels()
+{
+    m_preloadedModels.clear();
+}
+
+void COldModelManager::WriteModelList(const std::string& listFile)
+{
+    CResourceManager::CreateNewDirectory(std::filesystem::path(listFile).parent_path().string());
+
+    COutputStream stream(listFile);
+    if (!stream.is_open())
+        return;
+
+    for (const auto& fileName : GetLoadedModelNames())
+        stream << fileName << "\n";
+}
+
+std::vector<std::string> COldModelManager::GetLoadedModelNames()
+{
+    std::vector<std::string> fileNames;
+    for (const auto& [fileInfo, modelInfo] : m_models)
+    {
+        if (fileNames.empty() || fileNames.back() != fileInfo.fileName)
+            fileNames.push_back(fileInfo.fileName);
+    }
+    return fileNames;
+}
+
 void COldModelManager::Mirror(std::vector<ModelTriangle>& triangles)
 {
     for (int i = 0; i < static_cast<int>( triangles.size() ); i++)
@@ -23,14 +23,18 @@
 
 #include "graphics/model/model_triangle.h"
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
-#include <map>
+
+class CWorkerPool;
 
 namespace Gfx
 {
 
 class CEngine;
+class CModel;
 
 /**
  * \class COldModelManager
@@ -80,9 +84,18 @@ public:
     //! Unloads all models
     void UnloadAllModels();
 
+    //! Reads the models listed by WriteModelList() on \a pool, LoadModel() then uses them until ClearPreloadedModels()
+    void PreloadModels(const std::string& listFile, CWorkerPool& pool);
+    //! Frees the models read by PreloadModels()
+    void ClearPreloadedModels();
+    //! Writes the names of the loaded models, for PreloadModels() on the next load of the level
+    void WriteModelList(const std::string& listFile);
+
 protected:
     //! Mirrors the model along the Z axis
     void Mirror(std::vector<ModelTriangle>& triangles);
+    //! Returns the file names of the loaded models, each one once
+    std::vector<std::string> GetLoadedModelNames();
 
 private:
     struct ModelInfo
@@ -120,6 +133,8 @@ private:
     };
     std::map<FileInfo, ModelInfo> m_models;
     std::vector<int> m_copiesBaseRanks;
+    //! Models read by PreloadModels(), nullptr for the ones that failed
+    std::map<std::string, std::unique_ptr<CModel>> m_preloadedModels;
     CEngine* m_engine;
 };
 
@@ -46,7 +46,9 @@
 
 #include "sound/sound.h"
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 
 
 // Graphics module namespace
@@ -74,9 +76,17 @@ static bool IsAlien(ObjectType type)
 }
 
 CParticle::CParticle(CEngine* engine)
-    : m_engine(engine), m_triangle(MAXPARTICULE)
+    : m_engine(engine)
 {
     std::fill_n(m_frameUpdate, SH_MAX, true);
+
+    int capacity = MAXPARTICULE*MAXPARTITYPE;
+    m_particle.reserve(capacity);
+    m_pos.reserve(capacity);
+    m_speed.reserve(capacity);
+    m_moveStep.reserve(capacity);
+    m_windStep.reserve(capacity);
+    m_gravityStep.reserve(capacity);
 }
 
 CParticle::~CParticle()
@@ -91,8 +101,11 @@ void CParticle::SetDevice(CDevice* device)
 
 void CParticle::FlushParticle()
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
-        m_particle[i].used = false;
+    for (int i = 0; i < static_cast<int>(m_particle.size()); i++)
+    {
+        if (m_particle[i].used)
+            ReleaseRank(i);
+    }
 
     for (int i = 0; i < MAXPARTITYPE; i++)
     {
@@ -117,12 +130,12 @@ void CParticle::FlushParticle()
 
 void CParticle::FlushParticle(int sheet)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    for (int i = 0; i < static_cast<int>(m_particle.size()); i++)
     {
         if (!m_particle[i].used) continue;
         if (m_particle[i].sheet != sheet) continue;
 
-        m_particle[i].used = false;
+        ReleaseRank(i);
     }
 
     for (int i = 0; i < MAXPARTITYPE; i++)
@@ -290,71 +303,62 @@ int CParticle::CreateParticle(glm::vec3 pos, glm::vec3 speed, const glm::vec2& d
     if (t >= MAXPARTITYPE) return -1;
     if (t == -1) return -1;
 
-    for (int j = 0; j < MAXPARTICULE; j++)
-    {
-        int i = MAXPARTICULE*t+j;
-
-        if (! m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = false;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = mass;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
-            m_particle[i].windSensitivity = windSensitivity;
-            m_particle[i].dim       = dim;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].objLink   = nullptr;
-            m_particle[i].objFather = nullptr;
-            m_particle[i].trackRank = -1;
-
-            m_totalInterface[t][sheet] ++;
-
-            if ( type == PARTIEXPLOT ||
-                 type == PARTIEXPLOO )
-            {
-                m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
-            }
-
-            if ( type == PARTIGUN1 ||
-                 type == PARTIGUN4 )
-            {
-                m_particle[i].testTime = 1.0f;  // impact immediately
-            }
+    int i = AllocateRank(t);
+    if (i == -1)  return -1;
+
+    m_particle[i].ray       = false;
+    m_particle[i].uniqueStamp = m_uniqueStamp++;
+    m_particle[i].sheet     = sheet;
+    m_particle[i].mass      = mass;
+    m_particle[i].duration  = duration;
+    m_pos[i]                = pos;
+    m_particle[i].goal      = pos;
+    m_speed[i]              = speed;
+    m_particle[i].windSensitivity = windSensitivity;
+    m_particle[i].dim       = dim;
+    m_particle[i].zoom      = 1.0f;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].intensity = 1.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].time      = 0.0f;
+    m_particle[i].phaseTime = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].objLink   = nullptr;
+    m_particle[i].objFather = nullptr;
+    m_particle[i].trackRank = -1;
+
+    m_totalInterface[t][sheet] ++;
+
+    if ( type == PARTIEXPLOT ||
+         type == PARTIEXPLOO )
+    {
+        m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
+    }
 
-            if ( type == PARTIVIRUS )
-            {
-                m_particle[i].text = RandomLetter();
-            }
+    if ( type == PARTIGUN1 ||
+         type == PARTIGUN4 )
+    {
+        m_particle[i].testTime = 1.0f;  // impact immediately
+    }
 
-            if ( type >= PARTIFOG0 &&
-                 type <= PARTIFOG7 )
-            {
-                if (m_fogTotal < MAXPARTIFOG)
-                m_fog[m_fogTotal++] = i;
-            }
+    if ( type == PARTIVIRUS )
+    {
+        m_particle[i].text = RandomLetter();
+    }
 
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
+    if ( type >= PARTIFOG0 &&
+         type <= PARTIFOG7 )
+    {
+        if (m_fogTotal < MAXPARTIFOG)
+        m_fog[m_fogTotal++] = i;
     }
 
-    return -1;
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 /** Returns the channel of the particle created or -1 on error */
@@ -365,100 +369,91 @@ int CParticle::CreateFrag(glm::vec3 pos, glm::vec3 speed,
                           float windSensitivity, int sheet)
 {
     int t = 0;
-    for (int j = 0; j < MAXPARTICULE; j++)
-    {
-        int i = MAXPARTICULE*t+j;
-
-        if (!m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = false;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = mass;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
-            m_particle[i].windSensitivity = windSensitivity;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].objLink   = nullptr;
-            m_particle[i].objFather = nullptr;
-            m_particle[i].trackRank = -1;
-            m_triangle[i] = *triangle;
-
-            m_totalInterface[t][sheet] ++;
+    int i = AllocateRank(t);
+    if (i == -1)  return -1;
+
+    m_particle[i].ray       = false;
+    m_particle[i].uniqueStamp = m_uniqueStamp++;
+    m_particle[i].sheet     = sheet;
+    m_particle[i].mass      = mass;
+    m_particle[i].duration  = duration;
+    m_pos[i]                = pos;
+    m_particle[i].goal      = pos;
+    m_speed[i]              = speed;
+    m_particle[i].windSensitivity = windSensitivity;
+    m_particle[i].zoom      = 1.0f;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].intensity = 1.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].time      = 0.0f;
+    m_particle[i].phaseTime = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].objLink   = nullptr;
+    m_particle[i].objFather = nullptr;
+    m_particle[i].trackRank = -1;
+    m_triangle[i] = *triangle;
+
+    m_totalInterface[t][sheet] ++;
+
+    glm::vec3    p1;
+    p1.x = m_triangle[i].triangle[0].position.x;
+    p1.y = m_triangle[i].triangle[0].position.y;
+    p1.z = m_triangle[i].triangle[0].position.z;
+
+    glm::vec3 p2;
+    p2.x = m_triangle[i].triangle[1].position.x;
+    p2.y = m_triangle[i].triangle[1].position.y;
+    p2.z = m_triangle[i].triangle[1].position.z;
+
+    glm::vec3 p3;
+    p3.x = m_triangle[i].triangle[2].position.x;
+    p3.y = m_triangle[i].triangle[2].position.y;
+    p3.z = m_triangle[i].triangle[2].position.z;
+
+    float l1 = glm::distance(p1, p2);
+    float l2 = glm::distance(p2, p3);
+    float l3 = glm::distance(p3, p1);
+    float dx = fabs(Math::Min(l1, l2, l3))*0.5f;
+    float dy = fabs(Math::Max(l1, l2, l3))*0.5f;
+    p1 = glm::vec3(-dx,  dy, 0.0f);
+    p2 = glm::vec3( dx,  dy, 0.0f);
+    p3 = glm::vec3(-dx, -dy, 0.0f);
+
+    m_triangle[i].triangle[0].position.x = p1.x;
+    m_triangle[i].triangle[0].position.y = p1.y;
+    m_triangle[i].triangle[0].position.z = p1.z;
+
+    m_triangle[i].triangle[1].position.x = p2.x;
+    m_triangle[i].triangle[1].position.y = p2.y;
+    m_triangle[i].triangle[1].position.z = p2.z;
+
+    m_triangle[i].triangle[2].position.x = p3.x;
+    m_triangle[i].triangle[2].position.y = p3.y;
+    m_triangle[i].triangle[2].position.z = p3.z;
 
-            glm::vec3    p1;
-            p1.x = m_triangle[i].triangle[0].position.x;
-            p1.y = m_triangle[i].triangle[0].position.y;
-            p1.z = m_triangle[i].triangle[0].position.z;
-
-            glm::vec3 p2;
-            p2.x = m_triangle[i].triangle[1].position.x;
-            p2.y = m_triangle[i].triangle[1].position.y;
-            p2.z = m_triangle[i].triangle[1].position.z;
-
-            glm::vec3 p3;
-            p3.x = m_triangle[i].triangle[2].position.x;
-            p3.y = m_triangle[i].triangle[2].position.y;
-            p3.z = m_triangle[i].triangle[2].position.z;
-
-            float l1 = glm::distance(p1, p2);
-            float l2 = glm::distance(p2, p3);
-            float l3 = glm::distance(p3, p1);
-            float dx = fabs(Math::Min(l1, l2, l3))*0.5f;
-            float dy = fabs(Math::Max(l1, l2, l3))*0.5f;
-            p1 = glm::vec3(-dx,  dy, 0.0f);
-            p2 = glm::vec3( dx,  dy, 0.0f);
-            p3 = glm::vec3(-dx, -dy, 0.0f);
-
-            m_triangle[i].triangle[0].position.x = p1.x;
-            m_triangle[i].triangle[0].position.y = p1.y;
-            m_triangle[i].triangle[0].position.z = p1.z;
-
-            m_triangle[i].triangle[1].position.x = p2.x;
-            m_triangle[i].triangle[1].position.y = p2.y;
-            m_triangle[i].triangle[1].position.z = p2.z;
-
-            m_triangle[i].triangle[2].position.x = p3.x;
-            m_triangle[i].triangle[2].position.y = p3.y;
-            m_triangle[i].triangle[2].position.z = p3.z;
-
-            glm::vec3 n(0.0f, 0.0f, -1.0f);
-
-            m_triangle[i].triangle[0].normal.x = n.x;
-            m_triangle[i].triangle[0].normal.y = n.y;
-            m_triangle[i].triangle[0].normal.z = n.z;
+    glm::vec3 n(0.0f, 0.0f, -1.0f);
 
-            m_triangle[i].triangle[1].normal.x = n.x;
-            m_triangle[i].triangle[1].normal.y = n.y;
-            m_triangle[i].triangle[1].normal.z = n.z;
+    m_triangle[i].triangle[0].normal.x = n.x;
+    m_triangle[i].triangle[0].normal.y = n.y;
+    m_triangle[i].triangle[0].normal.z = n.z;
 
-            m_triangle[i].triangle[2].normal.x = n.x;
-            m_triangle[i].triangle[2].normal.y = n.y;
-            m_triangle[i].triangle[2].normal.z = n.z;
+    m_triangle[i].triangle[1].normal.x = n.x;
+    m_triangle[i].triangle[1].normal.y = n.y;
+    m_triangle[i].triangle[1].normal.z = n.z;
 
-            if (type == PARTIFRAG)
-                m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
+    m_triangle[i].triangle[2].normal.x = n.x;
+    m_triangle[i].triangle[2].normal.y = n.y;
+    m_triangle[i].triangle[2].normal.z = n.z;
 
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
-    }
+    if (type == PARTIFRAG)
+        m_particle[i].angle = Math::Rand()*Math::PI*2.0f;
 
-    return -1;
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 
@@ -469,45 +464,36 @@ int CParticle::CreatePart(glm::vec3 pos, glm::vec3 speed,
                           float windSensitivity, int sheet)
 {
     int t = 0;
-    for (int j = 0; j < MAXPARTICULE; j++)
-    {
-        int i = MAXPARTICULE*t+j;
-
-        if (!m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = false;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = mass;
-            m_particle[i].weight    = weight;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = pos;
-            m_particle[i].speed     = speed;
-            m_particle[i].windSensitivity = windSensitivity;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].trackRank = -1;
-
-            m_totalInterface[t][sheet] ++;
-
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
-    }
-
-    return -1;
+    int i = AllocateRank(t);
+    if (i == -1)  return -1;
+
+    m_particle[i].ray       = false;
+    m_particle[i].uniqueStamp = m_uniqueStamp++;
+    m_particle[i].sheet     = sheet;
+    m_particle[i].mass      = mass;
+    m_particle[i].weight    = weight;
+    m_particle[i].duration  = duration;
+    m_pos[i]                = pos;
+    m_particle[i].goal      = pos;
+    m_speed[i]              = speed;
+    m_particle[i].windSensitivity = windSensitivity;
+    m_particle[i].zoom      = 1.0f;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].intensity = 1.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].time      = 0.0f;
+    m_particle[i].phaseTime = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].trackRank = -1;
+
+    m_totalInterface[t][sheet] ++;
+
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 /** Returns the channel of the particle created or -1 on error */
@@ -525,47 +511,38 @@ int CParticle::CreateRay(glm::vec3 pos, glm::vec3 goal,
     if (t >= MAXPARTITYPE) return -1;
     if (t == -1) return -1;
 
-    for (int j = 0; j < MAXPARTICULE; j++)
-    {
-        int i = MAXPARTICULE*t+j;
-
-        if (!m_particle[i].used)
-        {
-            m_particle[i] = Particle();
-            m_particle[i].used      = true;
-            m_particle[i].ray       = true;
-            m_particle[i].uniqueStamp = m_uniqueStamp++;
-            m_particle[i].sheet     = sheet;
-            m_particle[i].mass      = 0.0f;
-            m_particle[i].duration  = duration;
-            m_particle[i].pos       = pos;
-            m_particle[i].goal      = goal;
-            m_particle[i].speed     = glm::vec3(0.0f, 0.0f, 0.0f);
-            m_particle[i].windSensitivity = 0.0f;
-            m_particle[i].dim       = dim;
-            m_particle[i].zoom      = 1.0f;
-            m_particle[i].angle     = 0.0f;
-            m_particle[i].intensity = 1.0f;
-            m_particle[i].type      = type;
-            m_particle[i].phase     = PARPHSTART;
-            m_particle[i].texSup.x  = 0.0f;
-            m_particle[i].texSup.y  = 0.0f;
-            m_particle[i].texInf.x  = 0.0f;
-            m_particle[i].texInf.y  = 0.0f;
-            m_particle[i].time      = 0.0f;
-            m_particle[i].phaseTime = 0.0f;
-            m_particle[i].testTime  = 0.0f;
-            m_particle[i].objLink   = nullptr;
-            m_particle[i].objFather = nullptr;
-            m_particle[i].trackRank = -1;
-
-            m_totalInterface[t][sheet] ++;
-
-            return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
-        }
-    }
-
-    return -1;
+    int i = AllocateRank(t);
+    if (i == -1)  return -1;
+
+    m_particle[i].ray       = true;
+    m_particle[i].uniqueStamp = m_uniqueStamp++;
+    m_particle[i].sheet     = sheet;
+    m_particle[i].mass      = 0.0f;
+    m_particle[i].duration  = duration;
+    m_pos[i]                = pos;
+    m_particle[i].goal      = goal;
+    m_speed[i]              = glm::vec3(0.0f, 0.0f, 0.0f);
+    m_particle[i].windSensitivity = 0.0f;
+    m_particle[i].dim       = dim;
+    m_particle[i].zoom      = 1.0f;
+    m_particle[i].angle     = 0.0f;
+    m_particle[i].intensity = 1.0f;
+    m_particle[i].type      = type;
+    m_particle[i].phase     = PARPHSTART;
+    m_particle[i].texSup.x  = 0.0f;
+    m_particle[i].texSup.y  = 0.0f;
+    m_particle[i].texInf.x  = 0.0f;
+    m_particle[i].texInf.y  = 0.0f;
+    m_particle[i].time      = 0.0f;
+    m_particle[i].phaseTime = 0.0f;
+    m_particle[i].testTime  = 0.0f;
+    m_particle[i].objLink   = nullptr;
+    m_particle[i].objFather = nullptr;
+    m_particle[i].trackRank = -1;
+
+    m_totalInterface[t][sheet] ++;
+
+    return i | ((m_particle[i].uniqueStamp&0xffff)<<16);
 }
 
 /** "length" is the length of the tail of drag (in seconds)! */
@@ -645,7 +622,7 @@ bool CParticle::CheckChannel(int &channel)
     channel &= 0xffff;
 
     if (channel < 0)  return false;
-    if (channel >= MAXPARTICULE*MAXPARTITYPE) return false;
+    if (channel >= static_cast<int>(m_particle.size())) return false;
 
     if (!m_particle[channel].used)
     {
@@ -662,21 +639,96 @@ bool CParticle::CheckChannel(int &channel)
     return true;
 }
 
+int CParticle::AllocateRank(int t)
+{
+    int rank = -1;
+    if (!m_freeRank[t].empty())
+    {
+        std::pop_heap(m_freeRank[t].begin(), m_freeRank[t].end(), std::greater<int>());
+        rank = m_freeRank[t].back();
+        m_freeRank[t].pop_back();
+    }
+    else
+    {
+        rank = static_cast<int>(m_particle.size());
+        if (rank >= MAXPARTICULETOTAL)  // no more channels?
+        {
+            GetLogger()->Trace("Particle limit reached, particle of type %d dropped\n", t);
+            return -1;
+        }
+
+        m_particle.emplace_back();
+        m_pos.emplace_back(0.0f, 0.0f, 0.0f);
+        m_speed.emplace_back(0.0f, 0.0f, 0.0f);
+        m_moveStep.push_back(0.0f);
+        m_windStep.push_back(0.0f);
+        m_gravityStep.push_back(0.0f);
+        if (t == 0)  // triangle?
+            m_triangle.resize(rank+1);
+    }
+
+    m_particle[rank] = Particle();
+    m_particle[rank].used      = true;
+    m_particle[rank].drawType  = t;
+
+    if (!m_liveRank[t].empty() && rank < m_liveRank[t].back())
+        m_liveSorted[t] = false;
+    m_liveRank[t].push_back(rank);
+
+    m_pos[rank]   = glm::vec3(0.0f, 0.0f, 0.0f);
+    m_speed[rank] = glm::vec3(0.0f, 0.0f, 0.0f);
+    return rank;
+}
+
+void CParticle::ReleaseRank(int rank)
+{
+    int t = m_particle[rank].drawType;
+
+    // stays in the live ranks until SortLiveRanks()
+    m_liveSorted[t] = false;
+
+    m_particle[rank].used   = false;
+    m_particle[rank].update = false;
+    m_moveStep[rank]    = 0.0f;
+    m_windStep[rank]    = 0.0f;
+    m_gravityStep[rank] = 0.0f;
+    m_freeRank[t].push_back(rank);
+    std::push_heap(m_freeRank[t].begin(), m_freeRank[t].end(), std::greater<int>());
+}
+
+/**
+ * The particles of a type are updated and drawn by increasing rank. As the lowest free rank
+ * is taken first, this is the order of the fixed slots the particles had before, so the
+ * draw order and the sequence of Math::Rand() calls are kept.
+ */
+void CParticle::SortLiveRanks(int t)
+{
+    if (m_liveSorted[t])  return;
+
+    auto& live = m_liveRank[t];
+    live.erase(std::remove_if(live.begin(), live.end(), [this](int rank) { return !m_particle[rank].used; }), live.end());
+    std::sort(live.begin(), live.end());
+    live.erase(std::unique(live.begin(), live.end()), live.end());
+
+    m_liveSorted[t] = true;
+}
+
 void CParticle::DeleteRank(int rank)
 {
-    if (m_totalInterface[rank/MAXPARTICULE][m_particle[rank].sheet] > 0)
-        m_totalInterface[rank/MAXPARTICULE][m_particle[rank].sheet]--;
+    int t = m_particle[rank].drawType;
+    if (m_totalInterface[t][m_particle[rank].sheet] > 0)
+        m_totalInterface[t][m_particle[rank].sheet]--;
 
     int i = m_particle[rank].trackRank;
     if (i != -1)  // drag associated?
         m_track[i].used = false;  // frees the drag
 
-    m_particle[rank].used = false;
+    ReleaseRank(rank);
 }
 
 void CParticle::DeleteParticle(ParticleType type)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    for (int i = 0; i < static_cast<int>(m_particle.size()); i++)
     {
         if (!m_particle[i].used) continue;
         if (m_particle[i].type != type) continue;
@@ -689,14 +741,7 @@ void CParticle::DeleteParticle(int channel)
 {
     if (!CheckChannel(channel)) return;
 
-    if (m_totalInterface[channel/MAXPARTICULE][m_particle[channel].sheet] > 0 )
-        m_totalInterface[channel/MAXPARTICULE][m_particle[channel].sheet]--;
-
-    int i = m_particle[channel].trackRank;
-    if (i != -1)  // drag associated?
-        m_track[i].used = false;  // frees the drag
-
-    m_particle[channel].used = false;
+    DeleteRank(channel);
 }
 
 void CParticle::SetObjectLink(int channel, CObject *object)
@@ -714,7 +759,7 @@ void CParticle::SetObjectFather(int channel, CObject *object)
 void CParticle::SetPosition(int channel, glm::vec3 pos)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].pos = pos;
+    m_pos[channel] = pos;
 }
 
 void CParticle::SetDimension(int channel, const glm::vec2& dim)
@@ -745,7 +790,7 @@ void CParticle::SetParam(int channel, glm::vec3 pos, const glm::vec2& dim, float
                           float angle, float intensity)
 {
     if (!CheckChannel(channel))  return;
-    m_particle[channel].pos       = pos;
+    m_pos[channel]                = pos;
     m_particle[channel].dim       = dim;
     m_particle[channel].zoom      = zoom;
     m_particle[channel].angle     = angle;
@@ -763,7 +808,7 @@ void CParticle::SetPhase(int channel, ParticlePhase phase, float duration)
 bool CParticle::GetPosition(int channel, glm::vec3 &pos)
 {
     if (!CheckChannel(channel))  return false;
-    pos = m_particle[channel].pos;
+    pos = m_pos[channel];
     return true;
 }
 
@@ -772,6 +817,24 @@ void CParticle::SetFrameUpdate(int sheet, bool update)
     m_frameUpdate[sheet] = update;
 }
 
+void CParticle::IntegrateParticles(const glm::vec3& wind)
+{
+    // Plain loops over contiguous arrays, without branches, so the compiler can vectorize them;
+    // the steps are 0 for the particles not updated in this frame.
+    int total = static_cast<int>(m_particle.size());
+    glm::vec3* pos = m_pos.data();
+    glm::vec3* speed = m_speed.data();
+    const float* moveStep = m_moveStep.data();
+    const float* windStep = m_windStep.data();
+    const float* gravityStep = m_gravityStep.data();
+
+    for (int i = 0; i < total; i++)
+        pos[i] += speed[i]*moveStep[i] + wind*windStep[i];
+
+    for (int i = 0; i < total; i++)
+        speed[i].y -= gravityStep[i];
+}
+
 void CParticle::FrameParticle(float rTime)
 {
     if (m_main == nullptr)
@@ -791,15 +854,34 @@ void CParticle::FrameParticle(float rTime)
         m_absTime += rTime;
     }
 
+    m_searchIndexUpdated = false;
+
     glm::vec3 wind = m_terrain->GetWind();
     glm::vec3 eye = m_engine->GetEyePt();
 
     glm::vec2 ts, ti;
     glm::vec3 pos = { 0, 0, 0 };
 
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    // Selects the particles to update, the particles created
+    // during this frame are updated from the next one.
+    int total = static_cast<int>(m_particle.size());
+    for (int i = 0; i < total; i++)
+    {
+        m_particle[i].update = false;
+        m_moveStep[i]    = 0.0f;
+        m_windStep[i]    = 0.0f;
+        m_gravityStep[i] = 0.0f;
+    }
+
+    m_frameOrder.clear();
+    for (int t = 0; t < MAXPARTITYPE; t++)
+    {
+        SortLiveRanks(t);
+        m_frameOrder.insert(m_frameOrder.end(), m_liveRank[t].begin(), m_liveRank[t].end());
+    }
+
+    for (int i : m_frameOrder)
     {
-        if (!m_particle[i].used) continue;
         if (!m_frameUpdate[m_particle[i].sheet]) continue;
 
         if (m_particle[i].type != PARTISHOW)
@@ -807,31 +889,38 @@ void CParticle::FrameParticle(float rTime)
             if (pause && m_particle[i].sheet != SH_INTERFACE) continue;
         }
 
-        if (m_particle[i].type != PARTIQUARTZ)
-            m_particle[i].pos += m_particle[i].speed*rTime;
+        m_particle[i].update = true;
 
-        if (m_particle[i].sheet == SH_WORLD)
+        if (m_particle[i].type != PARTIQUARTZ)
         {
-            float h = rTime*m_particle[i].windSensitivity*Math::Rand()*2.0f;
-            m_particle[i].pos += wind*h;
+            m_moveStep[i] = rTime;
+            m_gravityStep[i] = m_particle[i].mass*rTime;
         }
 
+        if (m_particle[i].sheet == SH_WORLD)
+            m_windStep[i] = rTime*m_particle[i].windSensitivity*Math::Rand()*2.0f;
+    }
+
+    IntegrateParticles(wind);
+
+    for (int i : m_frameOrder)
+    {
+        if (!m_particle[i].update) continue;
+
         float progress = (m_particle[i].time-m_particle[i].phaseTime)/m_particle[i].duration;
 
         // Manages the particles with mass that bounce.
         if ( m_particle[i].mass != 0.0f        &&
              m_particle[i].type != PARTIQUARTZ )
         {
-            m_particle[i].speed.y -= m_particle[i].mass*rTime;
-
             float h;
             if (m_particle[i].sheet == SH_INTERFACE)
                 h = 0.0f;
             else
-                h = m_terrain->GetFloorLevel(m_particle[i].pos, true);
+                h = m_terrain->GetFloorLevel(m_pos[i], true);
 
             h += m_particle[i].dim.y*0.75f;
-            if (m_particle[i].pos.y < h)  // impact with the ground?
+            if (m_pos[i].y < h)  // impact with the ground?
             {
                 if ( m_particle[i].type == PARTIPART &&
                      m_particle[i].weight > 3.0f &&  // heavy enough?
@@ -842,21 +931,21 @@ void CParticle::FrameParticle(float rTime)
                     if (amplitude > 1.0f)  amplitude = 1.0f;
                     if (amplitude > 0.0f)
                     {
-                        Play(SOUND_BOUM, m_particle[i].pos, amplitude);
+                        Play(SOUND_BOUM, m_pos[i], amplitude);
                     }
                 }
 
                 if (m_particle[i].bounce < 3)
                 {
-                    m_particle[i].pos.y = h;
-                    m_particle[i].speed.y *= -0.4f;
-                    m_particle[i].speed.x *=  0.4f;
-                    m_particle[i].speed.z *=  0.4f;
+                    m_pos[i].y = h;
+                    m_speed[i].y *= -0.4f;
+                    m_speed[i].x *=  0.4f;
+                    m_speed[i].z *=  0.4f;
                     m_particle[i].bounce ++;  // more impact
                 }
                 else    // disappears after 3 bounces?
                 {
-                    if ( m_particle[i].pos.y < h-10.0f ||
+                    if ( m_pos[i].y < h-10.0f ||
                          m_particle[i].time >= 20.0f   )
                     {
                         DeleteRank(i);
@@ -870,7 +959,7 @@ void CParticle::FrameParticle(float rTime)
         int r = m_particle[i].trackRank;
         if (r != -1)  // drag exists?
         {
-            if (TrackMove(r, m_particle[i].pos, progress))
+            if (TrackMove(r, m_pos[i], progress))
             {
                 DeleteRank(i);
                 continue;
@@ -952,8 +1041,8 @@ void CParticle::FrameParticle(float rTime)
 
         if (m_particle[i].type == PARTITRACK11)  // phazer shot?
         {
-            CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-            m_particle[i].goal = m_particle[i].pos;
+            CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+            m_particle[i].goal = m_pos[i];
             if (object != nullptr && object->Implements(ObjectInterfaceType::Damageable))
             {
                 dynamic_cast<CDamageableObject&>(*object).DamageObject(DamageType::Phazer, 0.002f, m_particle[i].objFather);
@@ -1112,7 +1201,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                if (m_terrain->GetHeightToFloor(m_particle[i].pos, true) < -2.0f)
+                if (m_terrain->GetHeightToFloor(m_pos[i], true) < -2.0f)
                 {
                     m_exploGunCounter++;
 
@@ -1153,8 +1242,8 @@ void CParticle::FrameParticle(float rTime)
                     continue;
                 }
 
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     if (object->Implements(ObjectInterfaceType::Damageable))
@@ -1166,7 +1255,7 @@ void CParticle::FrameParticle(float rTime)
 
                     if (m_exploGunCounter % 2 == 0)
                     {
-                        pos = m_particle[i].pos;
+                        pos = m_pos[i];
                         glm::vec3 speed;
                         speed.x = 0.0f;
                         speed.z = 0.0f;
@@ -1221,17 +1310,17 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.1f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     if (object->GetType() == OBJECT_MOBILErs && dynamic_cast<CShielder&>(*object).GetActiveShieldRadius() > 0.0f)  // protected by shield?
                     {
-                        CreateParticle(m_particle[i].pos, glm::vec3(0.0f, 0.0f, 0.0f), { 6.0f, 6.0f }, PARTIGUNDEL, 2.0f);
+                        CreateParticle(m_pos[i], glm::vec3(0.0f, 0.0f, 0.0f), { 6.0f, 6.0f }, PARTIGUNDEL, 2.0f);
                         if (m_lastTimeGunDel > 0.2f)
                         {
                             m_lastTimeGunDel = 0.0f;
-                            Play(SOUND_GUNDEL, m_particle[i].pos, 1.0f);
+                            Play(SOUND_GUNDEL, m_pos[i], 1.0f);
                         }
                         DeleteRank(i);
                         continue;
@@ -1239,7 +1328,7 @@ void CParticle::FrameParticle(float rTime)
                     else
                     {
                         if (object->GetType() != OBJECT_HUMAN)
-                            Play(SOUND_TOUCH, m_particle[i].pos, 1.0f);
+                            Play(SOUND_TOUCH, m_pos[i], 1.0f);
 
                         if (object->Implements(ObjectInterfaceType::Damageable))
                         {
@@ -1269,17 +1358,17 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.1f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     if (object->GetType() == OBJECT_MOBILErs && dynamic_cast<CShielder&>(*object).GetActiveShieldRadius() > 0.0f)
                     {
-                        CreateParticle(m_particle[i].pos, glm::vec3(0.0f, 0.0f, 0.0f), { 6.0f, 6.0f }, PARTIGUNDEL, 2.0f);
+                        CreateParticle(m_pos[i], glm::vec3(0.0f, 0.0f, 0.0f), { 6.0f, 6.0f }, PARTIGUNDEL, 2.0f);
                         if (m_lastTimeGunDel > 0.2f)
                         {
                             m_lastTimeGunDel = 0.0f;
-                            Play(SOUND_GUNDEL, m_particle[i].pos, 1.0f);
+                            Play(SOUND_GUNDEL, m_pos[i], 1.0f);
                         }
                         DeleteRank(i);
                         continue;
@@ -1312,7 +1401,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                if (m_terrain->GetHeightToFloor(m_particle[i].pos, true) < -2.0f)
+                if (m_terrain->GetHeightToFloor(m_pos[i], true) < -2.0f)
                 {
                     m_exploGunCounter ++;
 
@@ -1338,8 +1427,8 @@ void CParticle::FrameParticle(float rTime)
                     continue;
                 }
 
-                CObject* object = SearchObjectGun(m_particle[i].goal, m_particle[i].pos, m_particle[i].type, m_particle[i].objFather);
-                m_particle[i].goal = m_particle[i].pos;
+                CObject* object = SearchObjectGun(m_particle[i].goal, m_pos[i], m_particle[i].type, m_particle[i].objFather);
+                m_particle[i].goal = m_pos[i];
                 if (object != nullptr)
                 {
                     if (object->Implements(ObjectInterfaceType::Damageable))
@@ -1351,7 +1440,7 @@ void CParticle::FrameParticle(float rTime)
 
                     if (m_exploGunCounter % 2 == 0)
                     {
-                        pos = m_particle[i].pos;
+                        pos = m_pos[i];
                         glm::vec3 speed = { 0, 0, 0 };
                         glm::vec2 dim;
                         dim.x = Math::Rand()*4.0f+2.0f;
@@ -1597,15 +1686,15 @@ void CParticle::FrameParticle(float rTime)
         {
             float h = 10.0f;
 
-            if ( m_particle[i].pos.y >= eye.y   &&
-                 m_particle[i].pos.y <  eye.y+h )
+            if ( m_pos[i].y >= eye.y   &&
+                 m_pos[i].y <  eye.y+h )
             {
-                m_particle[i].intensity *= (m_particle[i].pos.y-eye.y)/h;
+                m_particle[i].intensity *= (m_pos[i].y-eye.y)/h;
             }
-            if ( m_particle[i].pos.y >  eye.y-h &&
-                 m_particle[i].pos.y <  eye.y   )
+            if ( m_pos[i].y >  eye.y-h &&
+                 m_pos[i].y <  eye.y   )
             {
-                m_particle[i].intensity *= (eye.y-m_particle[i].pos.y)/h;
+                m_particle[i].intensity *= (eye.y-m_pos[i].y)/h;
             }
         }
 
@@ -1686,7 +1775,7 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIBUBBLE)
         {
             if ( progress >= 1.0f ||
-                 m_particle[i].pos.y >= m_water->GetLevel() )
+                 m_pos[i].y >= m_water->GetLevel() )
             {
                 DeleteRank(i);
                 continue;
@@ -1893,7 +1982,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].testTime = 0.0f;
 
-                pos = m_particle[i].pos;
+                pos = m_pos[i];
                 glm::vec3 speed = glm::vec3(0.0f, 0.0f, 0.0f);
                 glm::vec2 dim;
                 dim.x = 1.0f*(Math::Rand()*0.8f+0.6f);
@@ -1913,7 +2002,7 @@ void CParticle::FrameParticle(float rTime)
             {
                 DeleteRank(i);
 
-                pos = m_particle[i].pos;
+                pos = m_pos[i];
                 glm::vec2 dim;
                 dim.x    = m_particle[i].dim.x/4.0f;
                 dim.y    = dim.x;
@@ -2091,9 +2180,9 @@ void CParticle::FrameParticle(float rTime)
             {
                 m_particle[i].time = 0.0f;
                 m_particle[i].duration = 0.5f+Math::Rand()*2.0f;
-                m_particle[i].pos.x = m_particle[i].speed.x + (Math::Rand()-0.5f)*m_particle[i].mass;
-                m_particle[i].pos.y = m_particle[i].speed.y + (Math::Rand()-0.5f)*m_particle[i].mass;
-                m_particle[i].pos.z = m_particle[i].speed.z + (Math::Rand()-0.5f)*m_particle[i].mass;
+                m_pos[i].x = m_speed[i].x + (Math::Rand()-0.5f)*m_particle[i].mass;
+                m_pos[i].y = m_speed[i].y + (Math::Rand()-0.5f)*m_particle[i].mass;
+                m_pos[i].z = m_speed[i].z + (Math::Rand()-0.5f)*m_particle[i].mass;
                 m_particle[i].dim.x = 0.5f+Math::Rand()*1.5f;
                 m_particle[i].dim.y = m_particle[i].dim.x;
                 progress = 0.0f;
@@ -2371,7 +2460,7 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIDROP)
         {
             if (progress >= 1.0f ||
-                m_particle[i].pos.y < m_water->GetLevel())
+                m_pos[i].y < m_water->GetLevel())
             {
                 DeleteRank(i);
                 continue;
@@ -2389,7 +2478,7 @@ void CParticle::FrameParticle(float rTime)
         if (m_particle[i].type == PARTIWATER)
         {
             if (progress >= 1.0f ||
-                m_particle[i].pos.y < m_water->GetLevel())
+                m_pos[i].y < m_water->GetLevel())
             {
                 DeleteRank(i);
                 continue;
@@ -2414,7 +2503,7 @@ void CParticle::FrameParticle(float rTime)
             if (m_particle[i].testTime >= 0.2f)
             {
                 m_particle[i].testTime = 0.0f;
-                CObject* object = SearchObjectRay(m_particle[i].pos, m_particle[i].goal,
+                CObject* object = SearchObjectRay(m_pos[i], m_particle[i].goal,
                                          m_particle[i].type, m_particle[i].objFather);
                 if (object != nullptr)
                 {
@@ -2674,7 +2763,7 @@ void CParticle::DrawParticleTriangle(int i)
     if (m_particle[i].zoom == 0.0f)  return;
 
     glm::vec3 eye = m_engine->GetEyePt();
-    glm::vec3 pos = m_particle[i].pos;
+    glm::vec3 pos = m_pos[i];
 
     CObject* object = m_particle[i].objLink;
     if (object != nullptr)
@@ -2718,7 +2807,7 @@ void CParticle::DrawParticleNorm(int i)
 
     if (m_particle[i].sheet == SH_INTERFACE)
     {
-        glm::vec3 pos = m_particle[i].pos;
+        glm::vec3 pos = m_pos[i];
 
         glm::vec3 n(0.0f, 0.0f, -1.0f);
 
@@ -2755,7 +2844,7 @@ void CParticle::DrawParticleNorm(int i)
     else
     {
         glm::vec3 eye = m_engine->GetEyePt();
-        glm::vec3 pos = m_particle[i].pos;
+        glm::vec3 pos = m_pos[i];
 
         CObject* object = m_particle[i].objLink;
         if (object != nullptr)
@@ -2812,7 +2901,7 @@ void CParticle::DrawParticleFlat(int i)
     if (m_particle[i].zoom == 0.0f) return;
     if (m_particle[i].intensity == 0.0f) return;
 
-    glm::vec3 pos = m_particle[i].pos;
+    glm::vec3 pos = m_pos[i];
 
     CObject* object = m_particle[i].objLink;
     if (object != nullptr)
@@ -2877,7 +2966,7 @@ void CParticle::DrawParticleFog(int i)
     if (!m_engine->GetFog()) return;
     if (m_particle[i].intensity == 0.0f) return;
 
-    glm::vec3 pos = m_particle[i].pos;
+    glm::vec3 pos = m_pos[i];
 
     glm::vec2 dim;
     dim.x = m_particle[i].dim.x;
@@ -2965,7 +3054,7 @@ void CParticle::DrawParticleRay(int i)
     if (m_particle[i].intensity == 0.0f)  return;
 
     glm::vec3 eye = m_engine->GetEyePt();
-    glm::vec3 pos = m_particle[i].pos;
+    glm::vec3 pos = m_pos[i];
     glm::vec3 goal = m_particle[i].goal;
 
     CObject* object = m_particle[i].objLink;
@@ -3131,9 +3220,9 @@ void CParticle::DrawParticleSphere(int i)
     mat[0][0] = zoom;
     mat[1][1] = zoom;
     mat[2][2] = zoom;
-    mat[3][0] = m_particle[i].pos.x;
-    mat[3][1] = m_particle[i].pos.y;
-    mat[3][2] = m_particle[i].pos.z;
+    mat[3][0] = m_pos[i].x;
+    mat[3][1] = m_pos[i].y;
+    mat[3][2] = m_pos[i].z;
 
     if (m_particle[i].angle != 0.0f)
     {
@@ -3242,9 +3331,9 @@ void CParticle::DrawParticleCylinder(int i)
     mat[0][0] = zoom;
     mat[1][1] = zoom;
     mat[2][2] = zoom;
-    mat[3][0] = m_particle[i].pos.x;
-    mat[3][1] = m_particle[i].pos.y;
-    mat[3][2] = m_particle[i].pos.z;
+    mat[3][0] = m_pos[i].x;
+    mat[3][1] = m_pos[i].y;
+    mat[3][2] = m_pos[i].z;
 
     m_renderer->SetModelMatrix(mat);
 
@@ -3404,9 +3493,9 @@ void CParticle::DrawParticle(int sheet)
     // Draw the basic particles of triangles.
     if (m_totalInterface[0][sheet] > 0)
     {
-        for (int i = 0; i < MAXPARTICULE; i++)
+        SortLiveRanks(0);
+        for (int i : m_liveRank[0])
         {
-            if (!m_particle[i].used)  continue;
             if (m_particle[i].sheet != sheet)  continue;
             if (m_particle[i].type == PARTIPART)  continue;
 
@@ -3448,10 +3537,9 @@ void CParticle::DrawParticle(int sheet)
         m_renderer->SetTransparency(mode);
         m_renderer->SetColor({ 1.0f, 1.0f, 1.0f, 1.0f });
 
-        for (int j = 0; j < MAXPARTICULE; j++)
+        SortLiveRanks(t);
+        for (int i : m_liveRank[t])
         {
-            int i = MAXPARTICULE*t+j;
-            if (!m_particle[i].used)  continue;
             if (m_particle[i].sheet != sheet)  continue;
 
             if (!loadTexture && t != 5)
@@ -3534,10 +3622,12 @@ CObject* CParticle::SearchObjectGun(glm::vec3 old, glm::vec3 pos,
     box2.y += min;
     box2.z += min;
 
+    SearchObjects(box1, box2);
+
     CObject* best = nullptr;
     float best_dist = std::numeric_limits<float>::infinity();
     bool shield = false;
-    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    for (CObject* obj : m_searchObjects)
     {
         if (!obj->GetDetectable()) continue;  // inactive?
         if (obj == father) continue;
@@ -3647,7 +3737,9 @@ CObject* CParticle::SearchObjectRay(glm::vec3 pos, glm::vec3 goal,
     box2.y += min;
     box2.z += min;
 
-    for (CObject* obj : CObjectManager::GetInstancePointer()->GetAllObjects())
+    SearchObjects(box1, box2);
+
+    for (CObject* obj : m_searchObjects)
     {
         if (!obj->GetDetectable()) continue;  // inactive?
         if (obj == father) continue;
@@ -3681,6 +3773,21 @@ CObject* CParticle::SearchObjectRay(glm::vec3 pos, glm::vec3 goal,
     return nullptr;
 }
 
+void CParticle::SearchObjects(const glm::vec3& box1, const glm::vec3& box2)
+{
+    CObjectManager* objectManager = CObjectManager::GetInstancePointer();
+
+    // The objects don't move while the particles are updated,
+    // the index is built once per frame by the first query.
+    if (!m_searchIndexUpdated)
+    {
+        objectManager->UpdateSpatialIndex();
+        m_searchIndexUpdated = true;
+    }
+
+    objectManager->GetObjectsInBox(box1, box2, m_searchObjects);
+}
+
 void CParticle::Play(SoundType sound, glm::vec3 pos, float amplitude)
 {
     if (m_sound == nullptr)
@@ -3701,20 +3808,20 @@ Color CParticle::GetFogColor(glm::vec3 pos)
     {
         int i = m_fog[fog];  // i = rank of the particle
 
-        if (pos.y >= m_particle[i].pos.y+FOG_HSUP)  continue;
-        if (pos.y <= m_particle[i].pos.y-FOG_HINF)  continue;
+        if (pos.y >= m_pos[i].y+FOG_HSUP)  continue;
+        if (pos.y <= m_pos[i].y-FOG_HINF)  continue;
 
-        float dist = Math::DistanceProjected(pos, m_particle[i].pos);
+        float dist = Math::DistanceProjected(pos, m_pos[i]);
         if (dist >= m_particle[i].dim.x*1.5f)  continue;
 
         // Calculates the horizontal distance.
         float factor = 1.0f-powf(dist/(m_particle[i].dim.x*1.5f), 4.0f);
 
         // Calculates the vertical distance.
-        if (pos.y > m_particle[i].pos.y)
-            factor *= 1.0f-(pos.y-m_particle[i].pos.y)/FOG_HSUP;
+        if (pos.y > m_pos[i].y)
+            factor *= 1.0f-(pos.y-m_pos[i].y)/FOG_HSUP;
         else
-            factor *= 1.0f-(m_particle[i].pos.y-pos.y)/FOG_HINF;
+            factor *= 1.0f-(m_pos[i].y-pos.y)/FOG_HINF;
 
         factor *= 0.3f;
 
@@ -3769,7 +3876,7 @@ Color CParticle::GetFogColor(glm::vec3 pos)
 
 void CParticle::CutObjectLink(CObject* obj)
 {
-    for (int i = 0; i < MAXPARTICULE*MAXPARTITYPE; i++)
+    for (int i = 0; i < static_cast<int>(m_particle.size()); i++)
     {
         if (!m_particle[i].used) continue;
 
@@ -49,8 +49,9 @@ class CWater;
 
 struct EngineTriangle;
 
-const short MAXPARTICULE = 500;
+const short MAXPARTICULE = 500;         // initial capacity of each type of texture
 const short MAXPARTITYPE = 6;
+const int MAXPARTICULETOTAL = 0xffff;   // channels keep the rank on 16 bits
 const short MAXTRACK = 100;
 const short MAXTRACKLEN = 10;
 const short MAXPARTIFOG = 100;
@@ -171,17 +172,17 @@ enum ParticlePhase
 struct Particle
 {
     bool            used = false;      // TRUE -> particle used
+    bool            update = false;    // TRUE -> updated in the current frame
     bool            ray = false;       // TRUE -> ray with goal
     unsigned short  uniqueStamp = 0;    // unique mark
     short           sheet = 0;      // sheet (0..n)
+    short           drawType = 0;   // type of texture (0..MAXPARTITYPE-1)
     ParticleType    type = {};       // type PARTI*
     ParticlePhase   phase = {};      // phase PARPH*
     float           mass = 0.0f;       // mass of the particle (in rebounding)
     float           weight = 0.0f;     // weight of the particle (for noise)
     float           duration = 0.0f;   // length of life
-    glm::vec3       pos = { 0, 0, 0 };        // absolute position (relative if object links)
     glm::vec3       goal = { 0, 0, 0 };       // goal position (if ray)
-    glm::vec3       speed = { 0, 0, 0 };      // speed of displacement
     float           windSensitivity = 0.0f;
     short           bounce = 0;     // number of rebounds
     glm::vec2       dim;        // dimensions of the rectangle
@@ -226,7 +227,11 @@ struct WheelTrace
  * \class CParticle
  * \brief Particle engine
  *
- * TODO: documentation
+ * A particle is identified by its rank, which keeps its type of texture for good. Each type of
+ * texture has a list of its live ranks, for drawing, and a list of its free ranks, for creating
+ * particles; the store grows when a type has no free rank left. The position and the speed of
+ * the particles are stored separately, in structure-of-arrays layout, and integrated by
+ * IntegrateParticles() in one pass before the update specific to each type of particle.
  */
 class CParticle
 {
@@ -303,8 +308,16 @@ public:
     void        CutObjectLink(CObject* obj);
 
 protected:
+    //! Takes a free rank of the given type of texture, returns -1 if there are too many particles
+    int         AllocateRank(int t);
+    //! Returns a rank to the free ranks of its type of texture
+    void        ReleaseRank(int rank);
+    //! Drops the released ranks from the live ranks of a type of texture and sorts them
+    void        SortLiveRanks(int t);
     //! Removes a particle of given rank
     void        DeleteRank(int rank);
+    //! Moves the particles updated in this frame by their speed, the wind and the gravity
+    void        IntegrateParticles(const glm::vec3& wind);
     /**
      * \brief Adapts the channel so it can be used as an offset in m_particle
      * \param channel Channel number to process, will be modified to be index of particle in m_particle
@@ -329,6 +342,8 @@ protected:
     void        DrawParticleText(int i);
     //! Draws a tire mark
     void        DrawParticleWheel(int i);
+    //! Finds the objects which may be in a box, for SearchObjectGun() and SearchObjectRay()
+    void        SearchObjects(const glm::vec3& box1, const glm::vec3& box2);
     //! Seeks if an object collided with a bullet
     CObject*    SearchObjectGun(glm::vec3 old, glm::vec3 pos, ParticleType type, CObject *father);
     //! Seeks if an object collided with a ray
@@ -349,7 +364,16 @@ protected:
     CSoundInterface*  m_sound = nullptr;
     CParticleRenderer* m_renderer = nullptr;
 
-    Particle       m_particle[MAXPARTICULE*MAXPARTITYPE];
+    std::vector<Particle>  m_particle;          // particles by rank
+    std::vector<glm::vec3> m_pos;               // absolute position (relative if object links)
+    std::vector<glm::vec3> m_speed;             // speed of displacement
+    std::vector<float>     m_moveStep;          // integration steps of the frame, see IntegrateParticles()
+    std::vector<float>     m_windStep;
+    std::vector<float>     m_gravityStep;
+    std::vector<int>       m_liveRank[MAXPARTITYPE];    // ranks in use, see SortLiveRanks()
+    bool                   m_liveSorted[MAXPARTITYPE] = {};
+    std::vector<int>       m_freeRank[MAXPARTITYPE];    // min-heap, the lowest free rank is taken first
+    std::vector<int>       m_frameOrder;                // ranks in the order FrameParticle() updates them
     std::vector<EngineTriangle> m_triangle;  // triangle if PartiType == 0
     Track          m_track[MAXTRACK];
     int           m_wheelTraceTotal = 0;
@@ -363,6 +387,8 @@ protected:
     int           m_exploGunCounter = 0;
     float         m_lastTimeGunDel = 0.0f;
     float         m_absTime = 0.0f;
+    bool          m_searchIndexUpdated = false;
+    std::vector<CObject*> m_searchObjects;
 };
 
 
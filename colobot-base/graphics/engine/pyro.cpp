@@ -46,11 +46,130 @@
 
 #include "sound/sound.h"
 
+#include <algorithm>
+#include <array>
+
 
 // Graphics module namespace
 namespace Gfx
 {
 
+namespace
+{
+
+//! Origin of the particles of a spawn step
+enum PyroSpawnOrigin
+{
+    PSO_OBJECT,     // center of the effect
+    PSO_POWER,      // battery, the step is skipped without one
+    PSO_FLOOR,      // battery if there is one, else the ground below the center
+};
+
+//! Condition on the effect for a spawn step
+enum PyroSpawnIf
+{
+    PSI_ALWAYS,
+    PSI_LARGE,          // larger than 10 (freight excluded)
+    PSI_LARGE_OR_POWER, // larger than 10 or with a battery
+};
+
+/**
+ * \brief One step of the spawn program of an effect: a burst of similar particles
+ *
+ * The ranges are given as { minimum, random extent }. No random number is drawn for an empty
+ * extent, so the steps use the same sequence of Math::Rand() as the code they replace.
+ */
+struct PyroSpawnStep
+{
+    PyroType        pyro;
+    ParticleType    particle;
+    float           count;          // number of particles
+    bool            density;        // count scaled by the particle density
+    PyroSpawnOrigin origin;
+    PyroSpawnIf     condition;
+    bool            father;         // particles bound to the object
+    glm::vec3       spread;         // extent of the random offset of the origin
+    float           speedXZ;        // extent of the random horizontal speed
+    float           speedY[2];
+    float           duration[2];
+    float           mass[2];
+    float           wind;           // wind sensitivity
+    float           dim[2];         // { constant, factor of the size of the effect }
+    bool            track;
+    float           trackLength[2];
+    float           trackFactor;    // added length, relative to the duration
+    float           trackWidth;
+};
+
+//! Particle bursts of the effects, in spawn order for each effect
+const PyroSpawnStep PYRO_SPAWN_STEPS[] =
+{
+    //pyro      particle        count  dens.  origin      condition           father spread                spXZ   speedY            duration        mass              wind  dim             track  length          fact. width
+    { PT_FRAGT,  PARTISPHERE0,    1.0f, false, PSO_FLOOR,  PSI_LARGE,          false, { 0.0f, 0.0f, 0.0f },  0.0f, {  0.0f,  0.0f }, { 2.0f, 0.0f }, {  0.0f,  0.0f }, 0.0f, { 0.0f, 0.4f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_FRAGT,  PARTITRACK1,    10.0f, true,  PSO_POWER,  PSI_ALWAYS,         false, { 0.0f, 0.0f, 0.0f }, 30.0f, {  0.0f, 30.0f }, { 2.0f, 3.0f }, { 15.0f, 10.0f }, 1.0f, { 1.0f, 0.0f }, true,  { 0.7f, 1.0f }, 0.0f, 1.0f },
+    { PT_FRAGT,  PARTICHOC,       1.0f, false, PSO_OBJECT, PSI_LARGE_OR_POWER, false, { 0.0f, 0.0f, 0.0f },  0.0f, {  0.0f,  0.0f }, { 2.0f, 0.0f }, {  0.0f,  0.0f }, 1.0f, { 0.0f, 1.0f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_EXPLOT, PARTISPHERE0,    1.0f, false, PSO_FLOOR,  PSI_LARGE,          false, { 0.0f, 0.0f, 0.0f },  0.0f, {  0.0f,  0.0f }, { 2.0f, 0.0f }, {  0.0f,  0.0f }, 0.0f, { 0.0f, 0.4f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_EXPLOT, PARTITRACK1,    10.0f, true,  PSO_POWER,  PSI_ALWAYS,         false, { 0.0f, 0.0f, 0.0f }, 30.0f, {  0.0f, 30.0f }, { 2.0f, 3.0f }, { 15.0f, 10.0f }, 1.0f, { 1.0f, 0.0f }, true,  { 0.7f, 1.0f }, 0.0f, 1.0f },
+    { PT_EXPLOT, PARTICHOC,       1.0f, false, PSO_OBJECT, PSI_LARGE_OR_POWER, false, { 0.0f, 0.0f, 0.0f },  0.0f, {  0.0f,  0.0f }, { 2.0f, 0.0f }, {  0.0f,  0.0f }, 1.0f, { 0.0f, 1.0f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_FRAGW,  PARTICHOC,       1.0f, false, PSO_OBJECT, PSI_LARGE_OR_POWER, false, { 0.0f, 0.0f, 0.0f },  0.0f, {  0.0f,  0.0f }, { 2.0f, 0.0f }, {  0.0f,  0.0f }, 1.0f, { 0.0f, 1.0f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_EXPLOW, PARTICHOC,       1.0f, false, PSO_OBJECT, PSI_LARGE_OR_POWER, false, { 0.0f, 0.0f, 0.0f },  0.0f, {  0.0f,  0.0f }, { 2.0f, 0.0f }, {  0.0f,  0.0f }, 1.0f, { 0.0f, 1.0f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_FRAGO,  PARTIORGANIC1,  10.0f, true,  PSO_OBJECT, PSI_ALWAYS,         false, { 0.0f, 0.0f, 0.0f }, 30.0f, {  0.0f, 50.0f }, { 0.8f, 1.0f }, { 15.0f, 10.0f }, 1.0f, { 1.0f, 0.0f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_FRAGO,  PARTITRACK4,     5.0f, true,  PSO_OBJECT, PSI_ALWAYS,         false, { 0.0f, 0.0f, 0.0f }, 30.0f, {  0.0f, 50.0f }, { 1.4f, 2.0f }, { 15.0f, 10.0f }, 1.0f, { 1.0f, 0.0f }, true,  { 0.0f, 0.0f }, 0.5f, 2.0f },
+    { PT_EXPLOO, PARTIORGANIC1,  10.0f, true,  PSO_OBJECT, PSI_ALWAYS,         false, { 0.0f, 0.0f, 0.0f }, 30.0f, {  0.0f, 50.0f }, { 0.8f, 1.0f }, { 15.0f, 10.0f }, 1.0f, { 1.0f, 0.0f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_EXPLOO, PARTITRACK4,     5.0f, true,  PSO_OBJECT, PSI_ALWAYS,         false, { 0.0f, 0.0f, 0.0f }, 30.0f, {  0.0f, 50.0f }, { 1.4f, 2.0f }, { 15.0f, 10.0f }, 1.0f, { 1.0f, 0.0f }, true,  { 0.0f, 0.0f }, 0.5f, 2.0f },
+    { PT_SPIDER, PARTIGUN3,      50.0f, false, PSO_OBJECT, PSI_ALWAYS,         true,  { 3.0f, 2.0f, 3.0f }, 24.0f, { 10.0f, 10.0f }, { 2.0f, 2.0f }, { 10.0f,  0.0f }, 1.0f, { 1.0f, 0.0f }, false, { 0.0f, 0.0f }, 0.0f, 0.0f },
+    { PT_SPIDER, PARTITRACK3,    10.0f, true,  PSO_OBJECT, PSI_ALWAYS,         false, { 3.0f, 2.0f, 3.0f }, 24.0f, {  7.0f,  7.0f }, { 2.0f, 2.0f }, { 10.0f,  0.0f }, 1.0f, { 1.0f, 0.0f }, true,  { 2.0f, 0.0f }, 0.0f, 0.6f },
+};
+
+//! Returns a value of the range, see PyroSpawnStep
+float SpawnRange(const float range[2])
+{
+    if (range[1] == 0.0f)  return range[0];
+    return range[0]+Math::Rand()*range[1];
+}
+
+//! Returns a random offset within the extent, 0 without drawing a random number for an empty extent
+float SpawnSpread(float extent)
+{
+    if (extent == 0.0f)  return 0.0f;
+    return (Math::Rand()-0.5f)*extent;
+}
+
+const int PYRO_TYPE_COUNT = PT_SQUASH + 1;
+
+//! Spawn steps grouped by effect, with the range of the steps of each effect
+struct PyroSpawnPrograms
+{
+    std::vector<PyroSpawnStep> steps;
+    std::array<std::pair<int, int>, PYRO_TYPE_COUNT> ranges;
+};
+
+//! Compiles the spawn programs on first use
+const PyroSpawnPrograms& GetSpawnPrograms()
+{
+    static const PyroSpawnPrograms programs = []
+    {
+        PyroSpawnPrograms result;
+        result.steps.assign(std::begin(PYRO_SPAWN_STEPS), std::end(PYRO_SPAWN_STEPS));
+        std::stable_sort(result.steps.begin(), result.steps.end(), [](const PyroSpawnStep& a, const PyroSpawnStep& b)
+        {
+            return a.pyro < b.pyro;
+        });
+
+        result.ranges.fill({ 0, 0 });
+        for (int i = 0; i < static_cast<int>(result.steps.size()); i++)
+        {
+            auto& range = result.ranges[result.steps[i].pyro];
+            if (range.first == range.second) range.first = i;
+            range.second = i + 1;
+        }
+        return result;
+    }();
+    return programs;
+}
+
+} // namespace
+
 
 CPyro::CPyro()
 {
@@ -67,6 +186,52 @@ CPyro::~CPyro()
 {
 }
 
+void CPyro::Reset()
+{
+    m_object = nullptr;
+
+    m_pos = { 0, 0, 0 };
+    m_posPower = { 0, 0, 0 };
+    m_power = false;
+    m_type = PT_NULL;
+    m_force = 0.0f;
+    m_size = 0.0f;
+    m_progress = 0.0f;
+    m_speed = 0.0f;
+    m_time = 0.0f;
+    m_lastParticle = 0.0f;
+    m_lastParticleSmoke = 0.0f;
+    m_soundChannel = -1;
+
+    m_lightRank = -1;
+    m_lightHeight = 0.0f;
+    m_lightOper.clear();  // keeps the memory for the next effect
+
+    m_burnType = OBJECT_NULL;
+    m_burnPartTotal = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        m_burnPart[i] = PyroBurnPart();
+        m_burnKeepPart[i] = 0;
+    }
+    m_burnFall = 0.0f;
+
+    m_fallFloor = 0.0f;
+    m_fallSpeed = 0.0f;
+    m_fallBulletTime = 0.0f;
+    m_fallEnding = false;
+
+    m_crashSpheres.clear();
+    m_resetAngle = 0.0f;
+
+    m_fragments.clear();  // keeps the memory for the next effect
+    m_fragmentNext = 0;
+    m_spawnStep = 0;
+    m_spawnEnd = 0;
+    m_spawnLeft = -1;
+    m_spawnPowerScale = 1;
+}
+
 void CPyro::DeleteObject()
 {
     if ( m_lightRank != -1 )
@@ -490,139 +655,8 @@ bool CPyro::Create(PyroType type, CObject* obj, float force)
         }
     }
 
-    if ( m_type == PT_FRAGT  ||
-         m_type == PT_EXPLOT )
-    {
-        if ( m_power )
-        {
-            int total = static_cast<int>(10.0f*m_engine->GetParticleDensity());
-            if ( oType == OBJECT_TNT  ||
-                 oType == OBJECT_BOMB )  total *= 3;
-            for (int i = 0; i < total; i++)
-            {
-                pos = m_posPower;
-                glm::vec3 speed{};
-                speed.x = (Math::Rand()-0.5f)*30.0f;
-                speed.z = (Math::Rand()-0.5f)*30.0f;
-                speed.y = Math::Rand()*30.0f;
-                glm::vec2 dim;
-                dim.x = 1.0f;
-                dim.y = dim.x;
-                float duration = Math::Rand()*3.0f+2.0f;
-                float mass = Math::Rand()*10.0f+15.0f;
-                m_particle->CreateTrack(pos, speed, dim, PARTITRACK1,
-                                         duration, mass, Math::Rand()+0.7f, 1.0f);
-            }
-        }
-
-        if (m_size > 10.0f)  // large enough (freight excluded)?
-        {
-            if (m_power)
-            {
-                pos = m_posPower;
-            }
-            else
-            {
-                pos = m_pos;
-                m_terrain->AdjustToFloor(pos);
-                pos.y += 1.0f;
-            }
-            glm::vec2 dim;
-            dim.x = m_size*0.4f;
-            dim.y = dim.x;
-            m_particle->CreateParticle(pos, glm::vec3(0.0f,0.0f,0.0f), dim, PARTISPHERE0, 2.0f, 0.0f, 0.0f);
-        }
-    }
-
-    if ( m_type == PT_FRAGO  ||
-         m_type == PT_EXPLOO )
-    {
-        int total = static_cast<int>(10.0f*m_engine->GetParticleDensity());
-        for (int i = 0; i < total; i++)
-        {
-            pos = m_pos;
-            glm::vec3 speed{};
-            speed.x = (Math::Rand()-0.5f)*30.0f;
-            speed.z = (Math::Rand()-0.5f)*30.0f;
-            speed.y = Math::Rand()*50.0f;
-            glm::vec2 dim;
-            dim.x = 1.0f;
-            dim.y = dim.x;
-            float duration = Math::Rand()*1.0f+0.8f;
-            float mass = Math::Rand()*10.0f+15.0f;
-            m_particle->CreateParticle(pos, speed, dim, PARTIORGANIC1,
-                                         duration, mass);
-        }
-        total = static_cast<int>(5.0f*m_engine->GetParticleDensity());
-        for (int i = 0; i < total; i++)
-        {
-            pos = m_pos;
-            glm::vec3 speed{};
-            speed.x = (Math::Rand()-0.5f)*30.0f;
-            speed.z = (Math::Rand()-0.5f)*30.0f;
-            speed.y = Math::Rand()*50.0f;
-            glm::vec2 dim;
-            dim.x = 1.0f;
-            dim.y = dim.x;
-            float duration = Math::Rand()*2.0f+1.4f;
-            float mass = Math::Rand()*10.0f+15.0f;
-            m_particle->CreateTrack(pos, speed, dim, PARTITRACK4,
-                                     duration, mass, duration*0.5f, dim.x*2.0f);
-        }
-    }
-
-    if ( m_type == PT_SPIDER )
-    {
-        for (int i = 0; i < 50; i++)
-        {
-            pos = m_pos;
-            pos.x += (Math::Rand()-0.5f)*3.0f;
-            pos.z += (Math::Rand()-0.5f)*3.0f;
-            pos.y += (Math::Rand()-0.5f)*2.0f;
-            glm::vec3 speed{};
-            speed.x = (Math::Rand()-0.5f)*24.0f;
-            speed.z = (Math::Rand()-0.5f)*24.0f;
-            speed.y = 10.0f+Math::Rand()*10.0f;
-            glm::vec2 dim;
-            dim.x = 1.0f;
-            dim.y = dim.x;
-            int channel = m_particle->CreateParticle(pos, speed, dim, PARTIGUN3, 2.0f+Math::Rand()*2.0f, 10.0f);
-            m_particle->SetObjectFather(channel, obj);
-        }
-        int total = static_cast<int>(10.0f*m_engine->GetParticleDensity());
-        for (int i = 0; i < total; i++)
-        {
-            pos = m_pos;
-            pos.x += (Math::Rand()-0.5f)*3.0f;
-            pos.z += (Math::Rand()-0.5f)*3.0f;
-            pos.y += (Math::Rand()-0.5f)*2.0f;
-            glm::vec3 speed{};
-            speed.x = (Math::Rand()-0.5f)*24.0f;
-            speed.z = (Math::Rand()-0.5f)*24.0f;
-            speed.y = 7.0f+Math::Rand()*7.0f;
-            glm::vec2 dim{};
-            dim.x = 1.0f;
-            dim.y = dim.x;
-            m_particle->CreateTrack(pos, speed, dim, PARTITRACK3,
-                                    2.0f+Math::Rand()*2.0f, 10.0f, 2.0f, 0.6f);
-        }
-    }
-
-    if ( type == PT_FRAGT  ||
-         type == PT_FRAGW  ||
-         type == PT_EXPLOT ||
-         type == PT_EXPLOW )
-    {
-        if (m_size > 10.0f || m_power)
-        {
-            pos = m_pos;
-            glm::vec3 speed(0.0f, 0.0f, 0.0f);
-            glm::vec2 dim;
-            dim.x = m_size;
-            dim.y = dim.x;
-            m_particle->CreateParticle(pos, speed, dim, PARTICHOC, 2.0f);
-        }
-    }
+    // The fragments and the bursts of particles are spawned by the manager, see SpawnParticles().
+    SpawnStart(oType);
 
     return true;
 }
@@ -1369,6 +1403,7 @@ void CPyro::CreateLight(glm::vec3 pos, float height)
     light.attenuation1 = 0.0f;
     light.attenuation2 = 0.0f;
     light.spotAngle = Math::PI/4.0f;
+    light.range = CLightManager::GetSpotRange(light, height);
 
     m_lightRank = m_lightMan->CreateLight();
 
@@ -1559,9 +1594,108 @@ void CPyro::CreateTriangle(CObject* obj, ObjectType oType, int part)
         if ( oType == OBJECT_STONE   )  speed *= 0.5f;
         if ( oType == OBJECT_URANIUM )  speed *= 0.4f;
         float duration = Math::Rand()*3.0f+3.0f;
-        m_particle->CreateFrag(pos, speed, &buffer[i], PARTIFRAG,
-                               duration, mass, 0.5f);
+
+        // created within the budget of particles, see SpawnParticles()
+        PyroFragment fragment;
+        fragment.triangle = buffer[i];
+        fragment.pos      = pos;
+        fragment.speed    = speed;
+        fragment.duration = duration;
+        fragment.mass     = mass;
+        m_fragments.push_back(fragment);
+    }
+}
+
+void CPyro::SpawnStart(ObjectType oType)
+{
+    const auto& range = GetSpawnPrograms().ranges[m_type];
+    m_spawnStep = range.first;
+    m_spawnEnd = range.second;
+    m_spawnLeft = -1;
+
+    m_spawnPowerScale = 1;
+    if ( oType == OBJECT_TNT  ||
+         oType == OBJECT_BOMB )  m_spawnPowerScale = 3;
+}
+
+int CPyro::SpawnParticles(int budget)
+{
+    const PyroSpawnPrograms& programs = GetSpawnPrograms();
+
+    int spawned = 0;
+    for (; m_fragmentNext < static_cast<int>(m_fragments.size()) && spawned < budget; m_fragmentNext++, spawned++)
+    {
+        PyroFragment& fragment = m_fragments[m_fragmentNext];
+        m_particle->CreateFrag(fragment.pos, fragment.speed, &fragment.triangle, PARTIFRAG,
+                               fragment.duration, fragment.mass, 0.5f);
+    }
+
+    while (m_spawnStep < m_spawnEnd && spawned < budget)
+    {
+        const PyroSpawnStep& step = programs.steps[m_spawnStep];
+
+        if (m_spawnLeft < 0)
+        {
+            bool enabled = true;
+            if (step.origin == PSO_POWER)  enabled = m_power;
+            if (step.condition == PSI_LARGE)  enabled = enabled && m_size > 10.0f;
+            if (step.condition == PSI_LARGE_OR_POWER)  enabled = enabled && (m_size > 10.0f || m_power);
+
+            m_spawnLeft = 0;
+            if (enabled)
+            {
+                float count = step.count;
+                if (step.density)  count *= m_engine->GetParticleDensity();
+                m_spawnLeft = static_cast<int>(count);
+                if (step.origin == PSO_POWER)  m_spawnLeft *= m_spawnPowerScale;
+            }
+        }
+
+        for (; m_spawnLeft > 0 && spawned < budget; m_spawnLeft--, spawned++)
+        {
+            glm::vec3 pos = m_pos;
+            if (step.origin == PSO_POWER || (step.origin == PSO_FLOOR && m_power))
+            {
+                pos = m_posPower;
+            }
+            else if (step.origin == PSO_FLOOR)
+            {
+                m_terrain->AdjustToFloor(pos);
+                pos.y += 1.0f;
+            }
+            pos.x += SpawnSpread(step.spread.x);
+            pos.z += SpawnSpread(step.spread.z);
+            pos.y += SpawnSpread(step.spread.y);
+            glm::vec3 speed{};
+            speed.x = SpawnSpread(step.speedXZ);
+            speed.z = SpawnSpread(step.speedXZ);
+            speed.y = SpawnRange(step.speedY);
+            glm::vec2 dim;
+            dim.x = step.dim[0]+step.dim[1]*m_size;
+            dim.y = dim.x;
+            float duration = SpawnRange(step.duration);
+            float mass = SpawnRange(step.mass);
+
+            if (step.track)
+            {
+                float length = SpawnRange(step.trackLength)+duration*step.trackFactor;
+                m_particle->CreateTrack(pos, speed, dim, step.particle,
+                                        duration, mass, length, step.trackWidth);
+            }
+            else
+            {
+                int channel = m_particle->CreateParticle(pos, speed, dim, step.particle, duration, mass, step.wind);
+                if (step.father)  m_particle->SetObjectFather(channel, m_object);
+            }
+        }
+
+        if (m_spawnLeft == 0)
+        {
+            m_spawnStep++;
+            m_spawnLeft = -1;
+        }
     }
+    return spawned;
 }
 
 void CPyro::ExploStart()
@@ -28,6 +28,7 @@
 #include "common/error.h"
 
 #include "graphics/core/color.h"
+#include "graphics/core/triangle.h"
 
 #include "graphics/engine/pyro_type.h"
 
@@ -64,10 +65,14 @@ class CPyro
 protected:
     friend class CPyroManager;
 
+    //! Clears the state left by a previous effect, before reusing the object
+    void        Reset();
     //! Creates pyrotechnic effect
     bool        Create(PyroType type, CObject* obj, float force);
     //! Destroys the object
     void        DeleteObject();
+    //! Spawns at most \a budget particles of the spawn program, returns the number of spawned particles
+    int         SpawnParticles(int budget);
 
 public:
     CPyro(); // should only be called by CPyroManager
@@ -92,8 +97,10 @@ protected:
     //! Removes the binding to a pyrotechnic effect
     void        DeleteObject(bool primary, bool secondary);
 
-    //! Creates an explosion with triangular form of particles
+    //! Prepares the triangular particles of an explosion, spawned by SpawnParticles()
     void        CreateTriangle(CObject* obj, ObjectType oType, int part);
+    //! Starts the spawn program of the effect, see SpawnParticles()
+    void        SpawnStart(ObjectType oType);
 
     //! Starts the explosion of a vehicle
     void        ExploStart();
@@ -183,6 +190,22 @@ protected:
 
     std::vector<Math::Sphere> m_crashSpheres;
     float           m_resetAngle = 0.0f;
+
+    struct PyroFragment
+    {
+        EngineTriangle  triangle;
+        glm::vec3       pos = { 0, 0, 0 };
+        glm::vec3       speed = { 0, 0, 0 };
+        float           duration = 0.0f;
+        float           mass = 0.0f;
+    };
+    std::vector<PyroFragment> m_fragments;  // triangles of the explosion, drawn at its start
+    int             m_fragmentNext = 0;     // first fragment not spawned yet
+
+    int             m_spawnStep = 0;        // current step of the spawn program
+    int             m_spawnEnd = 0;         // end of the spawn program
+    int             m_spawnLeft = -1;       // particles left in the current step, -1 if not started
+    int             m_spawnPowerScale = 1;  // multiplies the particles coming from the battery
 };
 
 
@@ -19,59 +19,136 @@
 
 #include "graphics/engine/pyro_manager.h"
 
+#include "common/event.h"
+
 #include "graphics/engine/pyro.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace Gfx
 {
 
+namespace
+{
 
-Gfx::CPyroManager::CPyroManager()
-{}
+//! Number of effects allocated together
+const int PYRO_BLOCK_SIZE = 32;
+//! Default number of particles spawned by the effects on each frame
+const int PYRO_SPAWN_BUDGET = 400;
+
+} // namespace
+
+
+CPyroManager::CPyroManager()
+{
+    m_spawnBudget = PYRO_SPAWN_BUDGET;
+    m_spawnLeft = m_spawnBudget;
+}
 
 CPyroManager::~CPyroManager()
 {}
 
-void Gfx::CPyroManager::Create(PyroType type, CObject* obj, float force)
+void CPyroManager::Create(PyroType type, CObject* obj, float force)
 {
-    auto pyroUPtr = std::make_unique<CPyro>();
-    pyroUPtr->Create(type, obj, force);
-    m_pyros.insert(std::move(pyroUPtr));
+    CPyro* pyro = Allocate();
+    pyro->Reset();
+    pyro->Create(type, obj, force);
+    m_pyros.push_back(pyro);
+
+    // a single effect starts with all its particles, as long as the budget allows it
+    if (m_spawnLeft > 0)
+    {
+        m_spawnLeft -= pyro->SpawnParticles(m_spawnLeft);
+    }
 }
 
 void CPyroManager::DeleteAll()
 {
-    for (auto& pyro : m_pyros)
+    for (CPyro* pyro : m_pyros)
     {
         pyro->DeleteObject();
+        m_free.push_back(pyro);
     }
 
     m_pyros.clear();
 }
 
-void Gfx::CPyroManager::CutObjectLink(CObject* obj)
+void CPyroManager::CutObjectLink(CObject* obj)
 {
-    for (auto& pyro : m_pyros)
+    for (CPyro* pyro : m_pyros)
     {
         pyro->CutObjectLink(obj);
     }
 }
 
-void Gfx::CPyroManager::EventProcess(const Event& event)
+void CPyroManager::EventProcess(const Event& event)
 {
-    auto it = m_pyros.begin();
-    while (it != m_pyros.end())
+    if (event.type == EVENT_FRAME)
+    {
+        m_spawnLeft = m_spawnBudget > 0 ? m_spawnBudget : std::numeric_limits<int>::max();
+        SpawnParticles();
+    }
+
+    // an effect may start other effects (see CPyro::FallProgress()), they are added
+    // at the end of the list and processed in the same loop
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_pyros.size(); i++)
     {
-        (*it)->EventProcess(event);
-        if ((*it)->IsEnded() == ERR_CONTINUE)
+        CPyro* pyro = m_pyros[i];
+        pyro->EventProcess(event);
+        if (pyro->IsEnded() == ERR_CONTINUE)
         {
-            ++it;
+            m_pyros[kept++] = pyro;
         }
         else
         {
-            (*it)->DeleteObject();
-            it = m_pyros.erase(it);
+            pyro->DeleteObject();
+            m_free.push_back(pyro);
         }
     }
+    m_pyros.resize(kept);
+}
+
+void CPyroManager::SetSpawnBudget(int budget)
+{
+    m_spawnBudget = std::max(budget, 0);
+}
+
+int CPyroManager::GetSpawnBudget() const
+{
+    return m_spawnBudget;
+}
+
+int CPyroManager::GetCount() const
+{
+    return static_cast<int>(m_pyros.size());
+}
+
+CPyro* CPyroManager::Allocate()
+{
+    if (m_free.empty())
+    {
+        m_blocks.push_back(std::make_unique<CPyro[]>(PYRO_BLOCK_SIZE));
+        CPyro* block = m_blocks.back().get();
+        for (int i = PYRO_BLOCK_SIZE - 1; i >= 0; i--)
+        {
+            m_free.push_back(&block[i]);
+        }
+    }
+
+    CPyro* pyro = m_free.back();
+    m_free.pop_back();
+    return pyro;
+}
+
+void CPyroManager::SpawnParticles()
+{
+    for (CPyro* pyro : m_pyros)
+    {
+        if (m_spawnLeft <= 0) break;
+        m_spawnLeft -= pyro->SpawnParticles(m_spawnLeft);
+    }
 }
 
 } // namespace Gfx
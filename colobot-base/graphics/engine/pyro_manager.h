@@ -27,7 +27,7 @@
 #include "graphics/engine/pyro_type.h"
 
 #include <memory>
-#include <set>
+#include <vector>
 
 struct Event;
 class CObject;
@@ -36,8 +36,18 @@ namespace Gfx
 {
 
 class CPyro;
-using CPyroUPtr = std::unique_ptr<CPyro>;
 
+/**
+ * \class CPyroManager
+ * \brief Owner of the running pyrotechnic effects
+ *
+ * The effects are kept in blocks allocated once and reused, an effect which ends goes back
+ * to a free list instead of being destroyed.
+ *
+ * The particles of an effect are spawned from its spawn program (see CPyro::SpawnParticles())
+ * within a budget of particles per frame. When many effects start at once, the particles
+ * which don't fit in the budget are spawned on the next frames, oldest effects first.
+ */
 class CPyroManager
 {
 public:
@@ -51,8 +61,31 @@ public:
 
     void EventProcess(const Event& event);
 
+    //! Management of the number of particles spawned by the effects on each frame, 0 for no limit
+    //@{
+    void SetSpawnBudget(int budget);
+    int GetSpawnBudget() const;
+    //@}
+
+    //! Returns the number of running effects
+    int GetCount() const;
+
 private:
-    std::set<CPyroUPtr> m_pyros;
+    //! Takes an effect from the free list, allocating a new block when it is empty
+    CPyro* Allocate();
+    //! Spawns the pending particles of the running effects, within what is left of the budget
+    void SpawnParticles();
+
+    //! Storage of the effects, a block never moves
+    std::vector<std::unique_ptr<CPyro[]>> m_blocks;
+    //! Effects which can be reused
+    std::vector<CPyro*> m_free;
+    //! Running effects, oldest first
+    std::vector<CPyro*> m_pyros;
+
+    int m_spawnBudget;
+    //! Particles which can still be spawned during the current frame
+    int m_spawnLeft;
 };
 
 } // namespace Gfx
@@ -24,6 +24,8 @@
 #include "common/image.h"
 #include "common/logger.h"
 
+#include "common/thread/worker_pool.h"
+
 #include "graphics/core/triangle.h"
 
 #include "graphics/engine/engine.h"
@@ -100,6 +102,8 @@ bool CTerrain::Generate(int mosaicCount, int brickCountPow2, float brickSize,
 
     dim = m_mosaicCount*m_mosaicCount;
     std::vector<int>(dim, -1).swap(m_objRanks);
+    std::vector<int>(dim*m_depth, -1).swap(m_lodBaseRanks);
+    std::vector<int>(dim, 0).swap(m_lodLevels);
 
     return true;
 }
@@ -212,17 +216,53 @@ Gfx::IntColor ResourceToColor(TerrainRes res)
 /**
  * The image must be 24 bits/pixel and grayscale and dx x dy in size
  * with dx = dy = (mosaic*brick)+1 */
+void CTerrain::PreloadImages(const std::vector<std::string>& fileNames, CWorkerPool& pool)
+{
+    m_preloadedImages.clear();
+
+    // Every task fills its own entry, the map itself is not changed until they are done
+    for (const auto& fileName : fileNames)
+        m_preloadedImages[fileName] = nullptr;
+
+    for (auto& [fileName, image] : m_preloadedImages)
+    {
+        pool.Start([&fileName = fileName, &image = image]()
+        {
+            auto img = std::make_unique<CImage>();
+            if (img->Load(fileName))
+                image = std::move(img);
+        });
+    }
+}
+
+std::unique_ptr<CImage> CTerrain::ReadImage(const std::string& fileName)
+{
+    auto it = m_preloadedImages.find(fileName);
+    if (it != m_preloadedImages.end() && it->second != nullptr)
+    {
+        auto img = std::move(it->second);
+        m_preloadedImages.erase(it);
+        return img;
+    }
+
+    auto img = std::make_unique<CImage>();
+    if (! img->Load(fileName))
+        return nullptr;
+
+    return img;
+}
+
 bool CTerrain::LoadResources(const std::string& fileName)
 {
-    CImage img;
+    std::unique_ptr<CImage> img = ReadImage(fileName);
 
-    if (! img.Load(fileName))
+    if (img == nullptr)
     {
         GetLogger()->Error("Cannot load resource file: '%s'\n", fileName.c_str());
         return false;
     }
 
-    ImageData *data = img.GetData();
+    ImageData *data = img->GetData();
 
     int size = (m_mosaicCount*m_brickCount)+1;
 
@@ -238,7 +278,7 @@ bool CTerrain::LoadResources(const std::string& fileName)
     {
         for (int y = 0; y < size; ++y)
         {
-            Gfx::IntColor pixel = img.GetPixelInt({ x, size - y - 1 });
+            Gfx::IntColor pixel = img->GetPixelInt({ x, size - y - 1 });
             TerrainRes res = TR_NULL;
 
             for (const auto& it : RESOURCE_PALETTE)
@@ -277,20 +317,18 @@ void CTerrain::FlushRelief()
     m_resources.clear();
     m_textures.clear();
 
-    for (int objRank : m_objRanks)
+    if (!m_objRanks.empty())
     {
-        if (objRank == -1)
-            continue;
-
-        int baseObjRank = m_engine->GetObjectBaseRank(objRank);
-
-        if (baseObjRank != -1)
-            m_engine->DeleteBaseObject(baseObjRank);
-
-        m_engine->DeleteObject(objRank);
+        for (int y = 0; y < m_mosaicCount; y++)
+        {
+            for (int x = 0; x < m_mosaicCount; x++)
+                DeleteSquare(x, y);
+        }
     }
 
     m_objRanks.clear();
+    m_lodBaseRanks.clear();
+    m_lodLevels.clear();
 }
 
 /**
@@ -301,15 +339,15 @@ bool CTerrain::LoadRelief(const std::string &fileName, float scaleRelief,
 {
     m_scaleRelief = scaleRelief;
 
-    CImage img;
+    std::unique_ptr<CImage> img = ReadImage(fileName);
 
-    if (! img.Load(fileName))
+    if (img == nullptr)
     {
         GetLogger()->Error("Could not load relief file: '%s'!\n", fileName.c_str());
         return false;
     }
 
-    ImageData *data = img.GetData();
+    ImageData *data = img->GetData();
 
     int size = (m_mosaicCount*m_brickCount)+1;
     GetLogger()->Debug("Expected relief size for current terrain configuration is %dx%d\n", size, size);
@@ -325,7 +363,7 @@ bool CTerrain::LoadRelief(const std::string &fileName, float scaleRelief,
     {
         for (int x = 0; x < size; x++)
         {
-            Gfx::IntColor color = img.GetPixelInt({ x, size - y - 1 });
+            Gfx::IntColor color = img->GetPixelInt({ x, size - y - 1 });
 
             float avg = (color.r + color.g + color.b) / 3.0f; // to be sure it is grayscale
             float level = (255.0f - avg) * scaleRelief;
@@ -585,7 +623,7 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank)
     std::string texName1;
     std::string texName2;
 
-    if ( step == 1 )
+    // every resolution has the ground spots, only one of them is drawn
     {
         int i = (ox/5) + (oy/5)*(m_mosaicCount/5);
         std::stringstream s;
@@ -695,7 +733,7 @@ bool CTerrain::CreateMosaic(int ox, int oy, int step, int objRank)
                     p1.uv2.x = (static_cast<float>(ox%5)*m_brickCount+xx+0.0f)/(m_brickCount*5);
                     p1.uv2.y = (static_cast<float>(oy%5)*m_brickCount+yy+0.0f)/(m_brickCount*5);
                     p2.uv2.x = (static_cast<float>(ox%5)*m_brickCount+xx+0.0f)/(m_brickCount*5);
-                    p2.uv2.y = (static_cast<float>(oy%5)*m_brickCount+yy+1.0f)/(m_brickCount*5);
+                    p2.uv2.y = (static_cast<float>(oy%5)*m_brickCount+yy+step)/(m_brickCount*5);
 
 // Correction for 1 pixel cover
 // There is 1 pixel cover around each of the 16 surfaces:
@@ -1251,16 +1289,80 @@ bool CTerrain::CreateSquare(int x, int y)
     int objRank = m_engine->CreateObject();
     m_engine->SetObjectType(objRank, ENG_OBJTYPE_TERRAIN);
 
-    m_objRanks[x+y*m_mosaicCount] = objRank;
+    int square = x+y*m_mosaicCount;
+    m_objRanks[square] = objRank;
 
-    for (int step = 0; step < m_depth; step++)
+    // each resolution has its own base object, UpdateLod() chooses the one drawn
+    for (int level = 0; level < m_depth; level++)
     {
-        CreateMosaic(x, y, 1 << step, objRank);
+        int baseObjRank = m_engine->CreateBaseObject();
+        m_lodBaseRanks[square*m_depth+level] = baseObjRank;
+
+        m_engine->SetObjectBaseRank(objRank, baseObjRank);
+        CreateMosaic(x, y, 1 << level, objRank);
     }
 
+    m_engine->SetObjectBaseRank(objRank, m_lodBaseRanks[square*m_depth+m_lodLevels[square]]);
+
     return true;
 }
 
+void CTerrain::DeleteSquare(int x, int y)
+{
+    int square = x+y*m_mosaicCount;
+
+    for (int level = 0; level < m_depth; level++)
+    {
+        int& baseObjRank = m_lodBaseRanks[square*m_depth+level];
+        if (baseObjRank != -1)
+            m_engine->DeleteBaseObject(baseObjRank);
+        baseObjRank = -1;
+    }
+
+    if (m_objRanks[square] != -1)
+        m_engine->DeleteObject(m_objRanks[square]);
+    m_objRanks[square] = -1;
+}
+
+void CTerrain::UpdateLod(const glm::vec3& eye)
+{
+    if (m_depth <= 1 || m_vision <= 0.0f || m_objRanks.empty())
+        return;
+
+    float size = m_brickCount*m_brickSize;
+    float dim = (m_mosaicCount*size)/2.0f;
+    float margin = m_vision*0.1f;  // keeps a mosaic from switching back and forth at a limit
+
+    for (int y = 0; y < m_mosaicCount; y++)
+    {
+        for (int x = 0; x < m_mosaicCount; x++)
+        {
+            int square = x+y*m_mosaicCount;
+            if (m_objRanks[square] == -1)
+                continue;
+
+            // horizontal distance from the eye to the nearest point of the mosaic
+            float minX = x*size-dim;
+            float minZ = y*size-dim;
+            float dx = Math::Max(minX-eye.x, eye.x-(minX+size), 0.0f);
+            float dz = Math::Max(minZ-eye.z, eye.z-(minZ+size), 0.0f);
+            float dist = sqrtf(dx*dx+dz*dz);
+
+            int level = m_lodLevels[square];
+            while (level < m_depth-1 && dist > m_vision*(level+1)+margin)
+                level++;
+            while (level > 0 && dist < m_vision*level-margin)
+                level--;
+
+            if (level == m_lodLevels[square])
+                continue;
+
+            m_lodLevels[square] = level;
+            m_engine->SetObjectLodBaseRank(m_objRanks[square], m_lodBaseRanks[square*m_depth+level]);
+        }
+    }
+}
+
 bool CTerrain::CreateObjects()
 {
     AdjustRelief();
@@ -1274,7 +1376,6 @@ bool CTerrain::CreateObjects()
     return true;
 }
 
-/** ATTENTION: ok only with m_depth = 2! */
 bool CTerrain::Terraform(const glm::vec3 &p1, const glm::vec3 &p2, float height)
 {
     float dim = (m_mosaicCount*m_brickCount*m_brickSize)/2.0f;
@@ -1300,6 +1401,7 @@ bool CTerrain::Terraform(const glm::vec3 &p1, const glm::vec3 &p2, float height)
     }
 
     int size = (m_mosaicCount*m_brickCount)+1;
+    int b = 1 << (m_depth-1);  // step of the points on the mosaic edges, see AdjustRelief()
 
     // Calculates the current average height
     float avg = 0.0f;
@@ -1321,41 +1423,41 @@ bool CTerrain::Terraform(const glm::vec3 &p1, const glm::vec3 &p2, float height)
         {
             m_relief[x+y*size] = avg+height;
 
-            if (x % m_brickCount == 0 && y % m_depth != 0)
+            // a point between the points of an edge is interpolated from them by AdjustRelief()
+            if (x % m_brickCount == 0 && y % b != 0)
             {
-                m_relief[(x+0)+(y-1)*size] = avg+height;
-                m_relief[(x+0)+(y+1)*size] = avg+height;
+                m_relief[(x+0)+(y-y%b+0)*size] = avg+height;
+                m_relief[(x+0)+(y-y%b+b)*size] = avg+height;
             }
 
-            if (y % m_brickCount == 0 && x % m_depth != 0)
+            if (y % m_brickCount == 0 && x % b != 0)
             {
-                m_relief[(x-1)+(y+0)*size] = avg+height;
-                m_relief[(x+1)+(y+0)*size] = avg+height;
+                m_relief[(x-x%b+0)+(y+0)*size] = avg+height;
+                m_relief[(x-x%b+b)+(y+0)*size] = avg+height;
             }
         }
     }
     AdjustRelief();
 
     glm::ivec2 pp1, pp2;
-    pp1.x = (tp1.x-2)/m_brickCount;
-    pp1.y = (tp1.y-2)/m_brickCount;
-    pp2.x = (tp2.x+1)/m_brickCount;
-    pp2.y = (tp2.y+1)/m_brickCount;
+    pp1.x = (tp1.x-b)/m_brickCount;
+    pp1.y = (tp1.y-b)/m_brickCount;
+    pp2.x = (tp2.x+b-1)/m_brickCount;
+    pp2.y = (tp2.y+b-1)/m_brickCount;
 
     if (pp1.x <  0            ) pp1.x = 0;
     if (pp1.x >= m_mosaicCount) pp1.x = m_mosaicCount-1;
     if (pp1.y <  0            ) pp1.y = 0;
     if (pp1.y >= m_mosaicCount) pp1.y = m_mosaicCount-1;
+    if (pp2.x >= m_mosaicCount) pp2.x = m_mosaicCount-1;
+    if (pp2.y >= m_mosaicCount) pp2.y = m_mosaicCount-1;
 
     for (int y = pp1.y; y <= pp2.y; y++)
     {
         for (int x = pp1.x; x <= pp2.x; x++)
         {
-            int objRank = m_objRanks[x+y*m_mosaicCount];
-            int baseObjRank = m_engine->GetObjectBaseRank(objRank);
-            m_engine->DeleteBaseObject(baseObjRank);
-            m_engine->DeleteObject(objRank);
-            CreateSquare(x, y);  // recreates the square
+            DeleteSquare(x, y);
+            CreateSquare(x, y);  // recreates the square, with its current resolution
         }
     }
     m_engine->Update();
@@ -1536,6 +1638,71 @@ bool CTerrain::AdjustToFloor(glm::vec3 &pos, bool brut, bool water)
     return true;
 }
 
+/**
+ * The ray is marched by steps of half a brick, then the crossing of the ground is refined by bisection.
+ * \param origin,dir  ray
+ * \param minDist,maxDist  part of the ray to test, in lengths of \a dir
+ * \param dist  distance to the ground, in lengths of \a dir
+ * \returns \c true if the ray hits the ground
+ */
+bool CTerrain::IntersectRay(const glm::vec3& origin, const glm::vec3& dir, float minDist, float maxDist, float& dist)
+{
+    if (m_relief.empty()) return false;
+
+    float dim = (m_mosaicCount*m_brickCount*m_brickSize)/2.0f;
+
+    glm::vec3 bboxMin(-dim, -Math::HUGE_NUM, -dim);
+    glm::vec3 bboxMax( dim,  Math::HUGE_NUM,  dim);
+    if (! Math::IntersectRayBox(bboxMin, bboxMax, origin, dir, minDist, maxDist))  return false;
+
+    float length = glm::length(dir);
+    if (length == 0.0f)  return false;
+    float step = m_brickSize*0.5f/length;
+
+    auto above = [&](float t)
+    {
+        glm::vec3 p = origin + dir*t;
+        return p.y > GetFloorLevel(p, true);
+    };
+
+    if (! above(minDist))  return false;  // starts under the ground
+
+    float t1 = minDist;
+    while (t1 < maxDist)
+    {
+        float t2 = Math::Min(t1+step, maxDist);
+        if (! above(t2))
+        {
+            for (int i = 0; i < 10; i++)
+            {
+                float t = (t1+t2)/2.0f;
+                if (above(t))  t1 = t;
+                else           t2 = t;
+            }
+            dist = t2;
+            return true;
+        }
+        t1 = t2;
+    }
+
+    return false;
+}
+
+int CTerrain::GetObjectRank(const glm::vec3& pos)
+{
+    float dim = (m_mosaicCount*m_brickCount*m_brickSize)/2.0f;
+
+    int x = static_cast<int>((pos.x+dim)/(m_brickCount*m_brickSize));
+    int y = static_cast<int>((pos.z+dim)/(m_brickCount*m_brickSize));
+
+    if ( pos.x < -dim || x >= m_mosaicCount ||
+         pos.z < -dim || y >= m_mosaicCount )  return -1;
+
+    if (m_objRanks.empty())  return -1;
+
+    return m_objRanks[x+y*m_mosaicCount];
+}
+
 /**
  * \param pos position to adjust
  * \returns \c false if the initial coordinate was outside terrain area; \c true otherwise
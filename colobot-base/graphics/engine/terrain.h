@@ -30,9 +30,14 @@
 
 #include <glm/glm.hpp>
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+class CImage;
+class CWorkerPool;
+
 
 // Graphics module namespace
 namespace Gfx
@@ -91,6 +96,19 @@ Gfx::IntColor ResourceToColor(TerrainRes res);
  * brickCount x brickCount bricks where brickCount is an even power of 2.
  * Each mosaic corresponds to one created engine object.
  *
+ * Each mosaic is built at depth resolutions, every one with half the bricks
+ * of the previous one, in separate base objects. On each frame UpdateLod()
+ * gives each mosaic the resolution matching its distance to the eye, the
+ * resolution changes every vision units. AdjustRelief() makes the edges of
+ * all mosaics follow the lowest resolution, so that neighbors drawn with
+ * different resolutions have no gaps between them.
+ *
+ * The number of resolutions is therefore the depth given to Generate(): a coarser
+ * resolution would need edges the relief wasn't adjusted to, and adjusting them
+ * further changes the relief the game walks on. A mosaic switches resolution at
+ * once, without geomorphing, so the switch can be seen; the limits are spaced by
+ * vision units with a margin, so a mosaic near a limit doesn't switch back and forth.
+ *
  * The whole terrain is also a square formed by mosaicCount * mosaicCount
  * of mosaics.
  *
@@ -175,8 +193,13 @@ public:
     //! Load resources from image
     bool        LoadResources(const std::string& fileName);
 
+    //! Decodes the relief and resource images on \a pool ahead of LoadRelief() and LoadResources()
+    void        PreloadImages(const std::vector<std::string>& fileNames, CWorkerPool& pool);
+
     //! Creates all objects of the terrain within the 3D engine
     bool        CreateObjects();
+    //! Chooses the resolution of each mosaic from its distance to the eye
+    void        UpdateLod(const glm::vec3& eye);
 
     //! Modifies the terrain's relief
     bool        Terraform(const glm::vec3& p1, const glm::vec3& p2, float height);
@@ -199,6 +222,10 @@ public:
     float       GetHeightToFloor(const glm::vec3& pos, bool brut=false, bool water=false);
     //! Modifies the Y coordinate of 3D position to rest on the ground floor
     bool        AdjustToFloor(glm::vec3& pos, bool brut=false, bool water=false);
+    //! Finds where a ray hits the ground
+    bool        IntersectRay(const glm::vec3& origin, const glm::vec3& dir, float minDist, float maxDist, float& dist);
+    //! Returns the engine object drawing the ground at 2D (XZ) position, -1 if none
+    int         GetObjectRank(const glm::vec3& pos);
     //! Adjusts 3D position so that it is within standard terrain boundaries
     bool        AdjustToStandardBounds(glm::vec3 &pos);
     //! Adjusts 3D position so that it is within terrain boundaries and the given margin
@@ -258,6 +285,8 @@ protected:
     bool        CreateMosaic(int ox, int oy, int step, int objRank);
     //! Creates all objects in a mesh square ground
     bool        CreateSquare(int x, int y);
+    //! Deletes the objects of a mesh square ground
+    void        DeleteSquare(int x, int y);
 
     struct TerrainMaterial;
     //! Seeks a material based on its ID
@@ -284,6 +313,9 @@ protected:
     //! Adjusts a position according to a possible rise
     void        AdjustBuildingLevel(glm::vec3 &p);
 
+    //! Returns the image decoded by PreloadImages() or loads it now, nullptr on error
+    std::unique_ptr<CImage> ReadImage(const std::string& fileName);
+
 protected:
     CEngine*        m_engine;
     CWater*         m_water;
@@ -292,10 +324,16 @@ protected:
     std::vector<float> m_relief;
     //! Resources data
     std::vector<unsigned char> m_resources;
+    //! Images decoded by PreloadImages(), not used yet
+    std::map<std::string, std::unique_ptr<CImage>> m_preloadedImages;
     //! Texture indices
     std::vector<int> m_textures;
     //! Object ranks for mosaic objects
     std::vector<int> m_objRanks;
+    //! Base objects of each mosaic, one per resolution
+    std::vector<int> m_lodBaseRanks;
+    //! Resolution drawn for each mosaic, 0 for the finest one
+    std::vector<int> m_lodLevels;
 
     //! Number of mosaics (along one dimension)
     int             m_mosaicCount;
@@ -0,0 +1,260 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/engine/texture_cache.h"
+
+#include "common/image.h"
+#include "common/ioutils.h"
+#include "common/logger.h"
+
+#include "common/resources/inputstream.h"
+#include "common/resources/outputstream.h"
+#include "common/resources/resourcemanager.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#include <SDL.h>
+
+namespace Gfx
+{
+
+namespace
+{
+
+//! Magic number at the beginning of cache file ("CTEX")
+const int TEXTURE_CACHE_MAGIC = 0x58455443;
+//! Version of cache file format, must be increased on every layout change
+const int TEXTURE_CACHE_VERSION = 2;
+
+//! Returns the cache directory in the real file system, where entries can be touched and trimmed
+std::filesystem::path GetCacheDirectory()
+{
+    return std::filesystem::u8path(CResourceManager::GetSaveLocation()) / "cache" / "textures";
+}
+
+//! Computes mipmap levels 1 and smaller of the image down to 1x1, with a box filter like glGenerateMipmap
+bool GenerateMipmaps(CImage& image, std::vector<TextureMipmap>& mipmaps)
+{
+    mipmaps.clear();
+
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(image.GetData()->surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (surface == nullptr)
+        return false;
+
+    TextureMipmap level0;
+    level0.size = { surface->w, surface->h };
+    level0.pixels.resize(static_cast<std::size_t>(surface->w) * surface->h * 4);
+
+    SDL_LockSurface(surface);
+    const unsigned char* pixels = static_cast<const unsigned char*>(surface->pixels);
+    for (int y = 0; y < surface->h; ++y)
+        std::copy_n(&pixels[y * surface->pitch], surface->w * 4, &level0.pixels[static_cast<std::size_t>(y) * surface->w * 4]);
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+
+    const TextureMipmap* source = &level0;
+    while (source->size.x > 1 || source->size.y > 1)
+    {
+        TextureMipmap level;
+        level.size = { std::max(1, source->size.x / 2), std::max(1, source->size.y / 2) };
+        level.pixels.resize(static_cast<std::size_t>(level.size.x) * level.size.y * 4);
+
+        for (int y = 0; y < level.size.y; ++y)
+        {
+            int y0 = std::min(y * 2, source->size.y - 1);
+            int y1 = std::min(y * 2 + 1, source->size.y - 1);
+
+            for (int x = 0; x < level.size.x; ++x)
+            {
+                int x0 = std::min(x * 2, source->size.x - 1);
+                int x1 = std::min(x * 2 + 1, source->size.x - 1);
+
+                for (int c = 0; c < 4; ++c)
+                {
+                    auto at = [&](int px, int py) { return source->pixels[(static_cast<std::size_t>(py) * source->size.x + px) * 4 + c]; };
+                    int sum = at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1);
+                    level.pixels[(static_cast<std::size_t>(y) * level.size.x + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+
+        mipmaps.push_back(std::move(level));
+        source = &mipmaps.back();
+    }
+
+    return true;
+}
+
+bool ReadCacheFile(const std::string& cacheFile, long long sourceSize, long long sourceTime,
+                   CImage& image, std::vector<TextureMipmap>& mipmaps)
+{
+    if (!CResourceManager::Exists(cacheFile))
+        return false;
+
+    CInputStream stream;
+    stream.open(cacheFile);
+    if (!stream.is_open())
+        return false;
+
+    if (IOUtils::ReadBinary<4, int>(stream) != TEXTURE_CACHE_MAGIC)
+        return false;
+    if (IOUtils::ReadBinary<4, int>(stream) != TEXTURE_CACHE_VERSION)
+        return false;
+    if (IOUtils::ReadBinary<4, unsigned int>(stream) != static_cast<unsigned int>(sourceSize))
+        return false;
+    if (IOUtils::ReadBinary<4, unsigned int>(stream) != static_cast<unsigned int>(sourceTime))
+        return false;
+
+    if (!image.LoadRaw(stream))
+        return false;
+
+    int count = IOUtils::ReadBinary<1, int>(stream);
+    mipmaps.resize(count);
+
+    // Each level must halve the previous one, anything else is a damaged entry
+    glm::ivec2 expected = image.GetSize();
+    for (auto& level : mipmaps)
+    {
+        level.size.x = IOUtils::ReadBinary<4, int>(stream);
+        level.size.y = IOUtils::ReadBinary<4, int>(stream);
+
+        expected = { std::max(1, expected.x / 2), std::max(1, expected.y / 2) };
+        if (!stream || level.size != expected)
+            return false;
+
+        level.pixels.resize(static_cast<std::size_t>(level.size.x) * level.size.y * 4);
+        stream.read(reinterpret_cast<char*>(level.pixels.data()), level.pixels.size());
+    }
+
+    if (!stream)
+        return false;
+
+    // Keeps the entry from being trimmed, see TrimTextureCacheFiles()
+    std::error_code error;
+    std::filesystem::last_write_time(std::filesystem::u8path(CResourceManager::GetSaveLocation()) / cacheFile,
+                                     std::filesystem::file_time_type::clock::now(), error);
+
+    return true;
+}
+
+void WriteCacheFile(const std::string& cacheFile, long long sourceSize, long long sourceTime,
+                    CImage& image, const std::vector<TextureMipmap>& mipmaps)
+{
+    CResourceManager::CreateNewDirectory(std::filesystem::path(cacheFile).parent_path().string());
+
+    COutputStream stream(cacheFile);
+    if (!stream.is_open())
+        return;
+
+    IOUtils::WriteBinary<4, int>(TEXTURE_CACHE_MAGIC, stream);
+    IOUtils::WriteBinary<4, int>(TEXTURE_CACHE_VERSION, stream);
+    IOUtils::WriteBinary<4, unsigned int>(static_cast<unsigned int>(sourceSize), stream);
+    IOUtils::WriteBinary<4, unsigned int>(static_cast<unsigned int>(sourceTime), stream);
+
+    bool ok = image.SaveRaw(stream);
+
+    IOUtils::WriteBinary<1, int>(static_cast<int>(mipmaps.size()), stream);
+    for (const auto& level : mipmaps)
+    {
+        IOUtils::WriteBinary<4, int>(level.size.x, stream);
+        IOUtils::WriteBinary<4, int>(level.size.y, stream);
+        stream.write(reinterpret_cast<const char*>(level.pixels.data()), level.pixels.size());
+    }
+
+    ok = ok && stream;
+    stream.close();
+
+    // Don't leave a half-written entry behind, it would be rejected on every load anyway
+    if (!ok)
+        CResourceManager::Remove(cacheFile);
+}
+
+} // anonymous namespace
+
+bool LoadCachedTextureImage(const std::string& name, CImage& image, std::vector<TextureMipmap>& mipmaps)
+{
+    std::string cacheFile = "cache/" + name + ".raw";
+
+    long long sourceSize = CResourceManager::GetFileSize(name);
+    long long sourceTime = CResourceManager::GetLastModificationTime(name);
+
+    if (sourceSize >= 0 && ReadCacheFile(cacheFile, sourceSize, sourceTime, image, mipmaps))
+        return true;
+
+    mipmaps.clear();
+
+    if (!image.Load(name))
+        return false;
+
+    if (!GenerateMipmaps(image, mipmaps))
+        mipmaps.clear();
+
+    if (sourceSize >= 0)
+        WriteCacheFile(cacheFile, sourceSize, sourceTime, image, mipmaps);
+
+    return true;
+}
+
+void TrimTextureCacheFiles(std::uintmax_t maxSize)
+{
+    std::error_code error;
+
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+    std::uintmax_t total = 0;
+
+    for (auto it = std::filesystem::recursive_directory_iterator(GetCacheDirectory(), error);
+         !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+        if (!it->is_regular_file(error))
+            continue;
+
+        std::uintmax_t size = it->file_size(error);
+        if (error)
+            continue;
+
+        total += size;
+        entries.emplace_back(it->last_write_time(error), it->path());
+    }
+
+    if (total <= maxSize)
+        return;
+
+    // Least recently used first, reading an entry touches it
+    std::sort(entries.begin(), entries.end());
+
+    int removed = 0;
+    for (const auto& [time, path] : entries)
+    {
+        if (total <= maxSize)
+            break;
+
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        if (std::filesystem::remove(path, error))
+        {
+            total -= size;
+            removed++;
+        }
+    }
+
+    GetLogger()->Debug("Removed %d texture cache files, %ju KiB remain\n", removed, total / 1024);
+}
+
+} // namespace Gfx
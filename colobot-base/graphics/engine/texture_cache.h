@@ -0,0 +1,57 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/engine/texture_cache.h
+ * \brief On-disk cache of decoded texture images
+ */
+
+#pragma once
+
+#include "graphics/core/texture.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CImage;
+
+namespace Gfx
+{
+
+//! Default limit of the size of texture cache files on disk, see TrimTextureCacheFiles()
+constexpr std::uintmax_t TEXTURE_CACHE_MAX_DISK_SIZE = 1024ull * 1024 * 1024;
+
+//! Loads image of texture \a name, using the decoded copy from texture cache if it is up to date
+/**
+ * Decoded images are kept in "cache/" in the save directory, keyed by the
+ * size and modification time of the source file, together with their mipmap
+ * levels so the device can upload them instead of generating them. On a cache
+ * miss the image is decoded from the source file, its mipmaps are computed
+ * and the cache entry is rewritten.
+ *
+ * Doesn't touch any engine state, so it can be called from worker threads.
+ */
+bool LoadCachedTextureImage(const std::string& name, CImage& image, std::vector<TextureMipmap>& mipmaps);
+
+//! Removes the least recently used texture cache files until they take at most \a maxSize bytes
+/** Must not run while textures are being loaded. */
+void TrimTextureCacheFiles(std::uintmax_t maxSize);
+
+} // namespace Gfx
@@ -60,6 +60,7 @@ CWater::CWater(CEngine* engine)
 
 CWater::~CWater()
 {
+    DestroyBuffers();
 }
 
 bool CWater::EventProcess(const Event &event)
@@ -237,23 +238,6 @@ void CWater::VaporFrame(int i, float rTime)
     }
 }
 
-void CWater::AdjustLevel(glm::vec3 &pos, glm::vec3 &norm,
-                         glm::vec2& uv1, glm::vec2& uv2)
-{
-    float t1 = m_time*1.5f + pos.x*0.1f * pos.z*0.2f;
-    pos.y += sinf(t1)*m_eddy.y;
-
-    t1 = m_time*1.5f;
-    uv1.x = (pos.x+10000.0f)/40.0f+sinf(t1)*m_eddy.x*0.02f;
-    uv1.y = (pos.z+10000.0f)/40.0f-cosf(t1)*m_eddy.z*0.02f;
-    uv2.x = (pos.x+10010.0f)/20.0f+cosf(-t1)*m_eddy.x*0.02f;
-    uv2.y = (pos.z+10010.0f)/20.0f-sinf(-t1)*m_eddy.z*0.02f;
-
-    t1 = m_time*0.50f + pos.x*2.1f + pos.z*1.1f;
-    float t2 = m_time*0.75f + pos.x*2.0f + pos.z*1.0f;
-    norm = glm::vec3(sinf(t1)*m_glint, 1.0f, sinf(t2)*m_glint);
-}
-
 /** This surface prevents to see the sky (background) underwater! */
 void CWater::DrawBack()
 {
@@ -324,14 +308,14 @@ void CWater::DrawSurf()
 {
     if (! m_draw) return;
     if (m_type[0] == WATER_NULL) return;
-    if (m_lines.empty()) return;
-
-    std::vector<Vertex3D> vertices((m_brickCount+2)*2);
-
-    glm::vec3 eye = m_engine->GetEyePt();
 
     int rankview = m_engine->GetRankView();
-    bool under = ( rankview == 1);
+    CVertexBuffer* buffer = m_buffers[rankview];
+    if (buffer == nullptr) return;
+
+    // Still being decoded when the water was created
+    if (! m_texture.Valid())
+        LoadTexture();
 
     CDevice* device = m_engine->GetDevice();
     auto renderer = device->GetObjectRenderer();
@@ -339,9 +323,7 @@ void CWater::DrawSurf()
     glm::mat4 matrix = glm::mat4(1.0f);
     renderer->SetModelMatrix(matrix);
 
-    auto texture = m_engine->LoadTexture(m_fileName);
-
-    renderer->SetAlbedoTexture(texture);
+    renderer->SetAlbedoTexture(m_texture);
     renderer->SetDetailTexture(Texture{});
 
     if (m_type[rankview] == WATER_TT)
@@ -365,74 +347,31 @@ void CWater::DrawSurf()
         renderer->SetAlbedoColor(Color{ 1.0f, 1.0f, 1.0f, 1.0f });
     }
 
-    float size = m_brickSize/2.0f;
-    float sizez = 0.0f;
-    if (under) sizez = -size;
-    else       sizez =  size;
+    // Swirls of the texture
+    float t = m_time*1.5f;
+    glm::vec2 offset = { sinf(t)*m_eddy.x*0.02f, -cosf(t)*m_eddy.z*0.02f };
 
-    // Draws all the lines
-    float deep = m_engine->GetDeepView(0)*1.5f;
+    renderer->SetUVTransform(offset, { 1.0f, 1.0f });
+    renderer->SetWaves(true, m_time, m_eddy.y, m_glint);
 
-    for (int i = 0; i < static_cast<int>( m_lines.size() ); i++)
-    {
-        glm::vec3 pos{};
-        pos.y = m_level;
-        pos.z = m_lines[i].pz;
-        pos.x = m_lines[i].px1;
-
-        // Visible line?
-        glm::vec3 p = pos;
-        p.x += size*(m_lines[i].len-1);
-        float radius = sqrtf(powf(size, 2.0f)+powf(size*m_lines[i].len, 2.0f));
-        if (glm::distance(p, eye) > deep + radius)
-            continue;
-
-        /// TODO: use m_engine->ComputeSphereVisibility() instead
-        //if (device->ComputeSphereVisibility(p, radius) != Gfx::FRUSTUM_PLANE_ALL)
-        //    continue;
-
-        int vertexIndex = 0;
-
-        glm::vec2 uv1, uv2;
-        glm::vec3 n{};
-        glm::u8vec4 white(255);
-
-        p.x = pos.x-size;
-        p.z = pos.z-sizez;
-        p.y = pos.y;
-        AdjustLevel(p, n, uv1, uv2);
-        if (under) n.y = -n.y;
-        vertices[vertexIndex++] = { p, white, uv1, {}, n };
-
-        p.x = pos.x-size;
-        p.z = pos.z+sizez;
-        p.y = pos.y;
-        AdjustLevel(p, n, uv1, uv2);
-        if (under)  n.y = -n.y;
-        vertices[vertexIndex++] = { p, white, uv1, {}, n };
-
-        for (int j = 0; j < m_lines[i].len; j++)
-        {
-            p.x = pos.x+size;
-            p.z = pos.z-sizez;
-            p.y = pos.y;
-            AdjustLevel(p, n, uv1, uv2);
-            if (under)  n.y = -n.y;
-            vertices[vertexIndex++] = { p, white, uv1, {}, n };
-
-            p.x = pos.x+size;
-            p.z = pos.z+sizez;
-            p.y = pos.y;
-            AdjustLevel(p, n, uv1, uv2);
-            if (under)  n.y = -n.y;
-            vertices[vertexIndex++] = { p, white, uv1, {}, n };
-
-            pos.x += size*2.0f;
-        }
+    renderer->DrawObject(buffer);
+    m_engine->AddStatisticTriangle(static_cast<int>(buffer->Size() / 3));
 
-        renderer->DrawPrimitive(PrimitiveType::TRIANGLE_STRIP, vertexIndex, vertices.data());
-        m_engine->AddStatisticTriangle(vertexIndex - 2);
-    }
+    renderer->SetWaves(false);
+    renderer->SetUVTransform({ 0.0f, 0.0f }, { 1.0f, 1.0f });
+}
+
+void CWater::LoadTexture()
+{
+    if (! m_fileName.empty())
+        m_texture = m_engine->LoadTexture(m_fileName);
+    else
+        m_texture.SetInvalid();
+}
+
+const Texture& CWater::GetTexture() const
+{
+    return m_texture;
 }
 
 bool CWater::GetWater(int x, int y)
@@ -476,6 +415,65 @@ void CWater::CreateLine(int x, int y, int len)
     m_lines.push_back(line);
 }
 
+void CWater::CreateBuffers()
+{
+    DestroyBuffers();
+
+    if (m_lines.empty()) return;
+
+    float size = m_brickSize/2.0f;
+    glm::u8vec4 white(255);
+
+    std::vector<Vertex3D> vertices;
+
+    for (int rank = 0; rank < 2; rank++)
+    {
+        // Seen from under the water, the strips turn the other way
+        bool under = (rank == 1);
+        float sizez = under ? -size : size;
+        glm::vec3 n = { 0.0f, under ? -1.0f : 1.0f, 0.0f };
+
+        vertices.clear();
+
+        for (const auto& line : m_lines)
+        {
+            for (int j = 0; j < line.len; j++)
+            {
+                float x1 = line.px1 - size + size*2.0f*j;
+                float x2 = x1 + size*2.0f;
+
+                glm::vec3 p[4] =
+                {
+                    { x1, m_level, line.pz-sizez },
+                    { x1, m_level, line.pz+sizez },
+                    { x2, m_level, line.pz-sizez },
+                    { x2, m_level, line.pz+sizez },
+                };
+
+                for (int k : { 0, 1, 2, 2, 1, 3 })
+                {
+                    glm::vec2 uv = { (p[k].x+10000.0f)/40.0f, (p[k].z+10000.0f)/40.0f };
+                    vertices.push_back({ p[k], white, uv, {}, n });
+                }
+            }
+        }
+
+        m_buffers[rank] = m_engine->GetDevice()->CreateVertexBuffer(PrimitiveType::TRIANGLES,
+                                                                     vertices.data(), vertices.size());
+    }
+}
+
+void CWater::DestroyBuffers()
+{
+    for (auto& buffer : m_buffers)
+    {
+        if (buffer != nullptr)
+            m_engine->GetDevice()->DestroyVertexBuffer(buffer);
+
+        buffer = nullptr;
+    }
+}
+
 void CWater::Create(WaterType type1, WaterType type2, const std::string& fileName,
                     Color diffuse, Color ambient,
                     float level, float glint, glm::vec3 eddy)
@@ -492,9 +490,8 @@ void CWater::Create(WaterType type1, WaterType type2, const std::string& fileNam
     m_fileName = fileName;
 
     VaporFlush();
-
-    if (! m_fileName.empty())
-        m_engine->LoadTexture(m_fileName);
+    DestroyBuffers();
+    LoadTexture();
 
     if (m_terrain == nullptr)
         m_terrain = CRobotMain::GetInstancePointer()->GetTerrain();
@@ -536,6 +533,8 @@ void CWater::Create(WaterType type1, WaterType type2, const std::string& fileNam
         if (len != 0)
             CreateLine(m_brickCount - len, y, len);
     }
+
+    CreateBuffers();
 }
 
 void CWater::Flush()
@@ -544,6 +543,8 @@ void CWater::Flush()
     m_type[1] = WATER_NULL;
     m_level = 0.0f;
     m_lava = false;
+
+    DestroyBuffers();
 }
 
 void CWater::SetLevel(float level)
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include "graphics/core/texture.h"
+
 #include "graphics/engine/particle.h"
 
 
@@ -37,6 +39,7 @@ namespace Gfx
 
 class CEngine;
 class CTerrain;
+class CVertexBuffer;
 
 /**
  * \enum WaterType
@@ -68,6 +71,10 @@ enum WaterType
  * There are two parts of drawing process: drawing the background image
  * blocking the normal sky layer and drawing the surface of water.
  * The surface is drawn with texture, so with proper texture it can be lava.
+ *
+ * The lines are built once into vertex buffers, one for each side of the surface,
+ * when the water is created or its level changes. The waves are animated by the
+ * object renderer, see CObjectRenderer::SetWaves().
  */
 class CWater
 {
@@ -86,6 +93,11 @@ public:
     //! Draws the flat surface of the water
     void        DrawSurf();
 
+    //! Loads the texture of the surface, after the textures were reloaded
+    void        LoadTexture();
+    //! Returns the texture of the surface
+    const Texture& GetTexture() const;
+
     //! Changes the level of the water
     void        SetLevel(float level);
     //! Returns the current level of water
@@ -107,12 +119,14 @@ protected:
     bool        EventFrame(const Event &event);
     //! Makes evolve the steam jets on the lava
     void        LavaFrame(float rTime);
-    //! Adjusts the position to normal, to imitate reflections on an expanse of water at rest
-    void        AdjustLevel(glm::vec3 &pos, glm::vec3 &norm, glm::vec2& uv1, glm::vec2& uv2);
     //! Indicates if there is water in a given position
     bool        GetWater(int x, int y);
     //! Updates the positions, relative to the ground
     void        CreateLine(int x, int y, int len);
+    //! Builds the vertex buffers of the surface from the lines
+    void        CreateBuffers();
+    //! Destroys the vertex buffers of the surface
+    void        DestroyBuffers();
 
     //! Removes all the steam jets
     void        VaporFlush();
@@ -130,6 +144,7 @@ protected:
 
     WaterType       m_type[2] = {};
     std::string     m_fileName;
+    Texture         m_texture;
     //! Overall level
     float           m_level = 0.0f;
     //! Amplitude of reflections
@@ -165,6 +180,8 @@ protected:
         float       px1 = 0, px2 = 0, pz = 0;
     };
     std::vector<WaterLine>  m_lines;
+    //! Surface seen from above and from under the water
+    CVertexBuffer*  m_buffers[2] = {};
 
     /**
      * \struct WaterVapor
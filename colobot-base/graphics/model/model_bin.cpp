@@ -0,0 +1,453 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2022, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/model/model_bin.h"
+
+#include "common/logger.h"
+
+#include "common/resources/inputstream.h"
+#include "common/resources/outputstream.h"
+#include "common/resources/resourcemanager.h"
+
+#include "graphics/model/model_input.h"
+#include "graphics/model/model_io_exception.h"
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Gfx::ModelIO
+{
+
+namespace
+{
+
+//! Magic bytes at the beginning of binary model file
+const std::array<char, 4> BINARY_MODEL_MAGIC = { 'C', 'B', 'M', 'D' };
+
+//! Attributes in the order they are stored in file
+const std::array<VertexAttribute, 8> BINARY_MODEL_ATTRIBUTES =
+{
+    VertexAttribute::POSITION,
+    VertexAttribute::COLOR,
+    VertexAttribute::UV1,
+    VertexAttribute::UV2,
+    VertexAttribute::NORMAL,
+    VertexAttribute::TANGENT,
+    VertexAttribute::BONE_INDICES,
+    VertexAttribute::BONE_WEIGHTS,
+};
+
+bool IsLittleEndian()
+{
+    std::uint32_t value = 1;
+    unsigned char byte = 0;
+    std::memcpy(&byte, &value, 1);
+    return byte == 1;
+}
+
+Color ToColor(const glm::vec4& value)
+{
+    return Color(value.r, value.g, value.b, value.a);
+}
+
+class CBinaryWriter
+{
+public:
+    void WriteBytes(const void* data, std::size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
+    template<typename T>
+    void Write(const T& value)
+    {
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteString(const std::string& value)
+    {
+        Write(static_cast<std::uint32_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+    void WriteMaterial(const Material& material)
+    {
+        Write<glm::vec4>(material.albedoColor);
+        WriteString(material.albedoTexture);
+        Write(material.roughness);
+        Write(material.metalness);
+        Write(material.aoStrength);
+        WriteString(material.materialTexture);
+        Write<glm::vec4>(material.emissiveColor);
+        WriteString(material.emissiveTexture);
+        WriteString(material.normalTexture);
+        Write(material.alphaMode);
+        Write(material.alphaThreshold);
+        Write(material.cullFace);
+        WriteString(material.tag);
+        WriteString(material.recolor);
+        Write<glm::vec4>(material.recolorReference);
+        Write<std::uint8_t>(material.variableDetail);
+        WriteString(material.detailTexture);
+    }
+
+    const std::vector<char>& GetData() const
+    {
+        return m_data;
+    }
+
+private:
+    std::vector<char> m_data;
+};
+
+class CBinaryReader
+{
+public:
+    explicit CBinaryReader(std::vector<char>&& data)
+        : m_data(std::move(data))
+    {}
+
+    void ReadBytes(void* data, std::size_t size)
+    {
+        if (size == 0)
+            return;
+
+        if (size > m_data.size() - m_position)
+            throw CModelIOException("Unexpected end of binary model file");
+
+        std::memcpy(data, m_data.data() + m_position, size);
+        m_position += size;
+    }
+
+    //! Throws if fewer than size bytes are left, used before allocating memory for them
+    void CheckRemaining(std::uint64_t size) const
+    {
+        if (size > m_data.size() - m_position)
+            throw CModelIOException("Unexpected end of binary model file");
+    }
+
+    template<typename T>
+    T Read()
+    {
+        T value{};
+        ReadBytes(&value, sizeof(T));
+        return value;
+    }
+
+    std::string ReadString()
+    {
+        std::uint32_t size = Read<std::uint32_t>();
+        CheckRemaining(size);
+
+        std::string value(size, '\0');
+        ReadBytes(value.data(), value.size());
+        return value;
+    }
+
+    //! Reads an enum stored as one byte, last is its greatest value
+    template<typename T>
+    T ReadEnum(T last)
+    {
+        std::uint8_t value = Read<std::uint8_t>();
+        if (value > static_cast<std::uint8_t>(last))
+            throw CModelIOException("Invalid enum value in binary model file");
+
+        return static_cast<T>(value);
+    }
+
+    Material ReadMaterial()
+    {
+        Material material;
+        material.albedoColor = ToColor(Read<glm::vec4>());
+        material.albedoTexture = ReadString();
+        material.roughness = Read<float>();
+        material.metalness = Read<float>();
+        material.aoStrength = Read<float>();
+        material.materialTexture = ReadString();
+        material.emissiveColor = ToColor(Read<glm::vec4>());
+        material.emissiveTexture = ReadString();
+        material.normalTexture = ReadString();
+        material.alphaMode = ReadEnum(AlphaMode::BLEND);
+        material.alphaThreshold = Read<float>();
+        material.cullFace = ReadEnum(CullFace::BOTH);
+        material.tag = ReadString();
+        material.recolor = ReadString();
+        material.recolorReference = ToColor(Read<glm::vec4>());
+        material.variableDetail = Read<std::uint8_t>() != 0;
+        material.detailTexture = ReadString();
+        return material;
+    }
+
+private:
+    std::vector<char> m_data;
+    std::size_t m_position = 0;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<CModel> ReadBinaryModel(const std::filesystem::path& path, const SourceStamp& source)
+{
+    if (!IsLittleEndian())
+        return nullptr;
+
+    CInputStream stream;
+    stream.open(path);
+    if (!stream.is_open())
+        return nullptr;
+
+    std::vector<char> data(stream.size());
+    stream.read(data.data(), data.size());
+    if (static_cast<std::size_t>(stream.gcount()) != data.size())
+        throw CModelIOException("Error reading binary model file");
+
+    CBinaryReader reader(std::move(data));
+
+    std::array<char, 4> magic = {};
+    reader.ReadBytes(magic.data(), magic.size());
+    if (magic != BINARY_MODEL_MAGIC)
+        throw CModelIOException("Not a binary model file");
+
+    if (reader.Read<std::uint32_t>() != BINARY_MODEL_VERSION)
+        return nullptr;
+
+    SourceStamp stamp;
+    stamp.size = reader.Read<std::int64_t>();
+    stamp.modificationTime = reader.Read<std::int64_t>();
+    if (!(stamp == source))
+        return nullptr;
+
+    auto model = std::make_unique<CModel>();
+
+    std::uint32_t crashSphereCount = reader.Read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < crashSphereCount; ++i)
+    {
+        ModelCrashSphere crashSphere;
+        crashSphere.position = reader.Read<glm::vec3>();
+        crashSphere.radius = reader.Read<float>();
+        crashSphere.sound = reader.ReadString();
+        crashSphere.hardness = reader.Read<float>();
+        model->AddCrashSphere(crashSphere);
+    }
+
+    if (reader.Read<std::uint8_t>() != 0)
+    {
+        ModelShadowSpot shadowSpot;
+        shadowSpot.radius = reader.Read<float>();
+        shadowSpot.intensity = reader.Read<float>();
+        model->SetShadowSpot(shadowSpot);
+    }
+
+    if (reader.Read<std::uint8_t>() != 0)
+    {
+        glm::vec3 position = reader.Read<glm::vec3>();
+        float radius = reader.Read<float>();
+        model->SetCameraCollisionSphere(Math::Sphere(position, radius));
+    }
+
+    std::uint32_t meshCount = reader.Read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < meshCount; ++i)
+    {
+        std::string name = reader.ReadString();
+
+        auto mesh = std::make_unique<CModelMesh>();
+        mesh->SetParent(reader.ReadString());
+        mesh->SetPosition(reader.Read<glm::vec3>());
+        mesh->SetRotation(reader.Read<glm::vec3>());
+        mesh->SetScale(reader.Read<glm::vec3>());
+
+        std::uint32_t partCount = reader.Read<std::uint32_t>();
+        for (std::uint32_t j = 0; j < partCount; ++j)
+        {
+            CModelPart* part = mesh->AddPart(reader.ReadMaterial());
+
+            std::uint32_t attributes = reader.Read<std::uint32_t>();
+            std::uint32_t vertexCount = reader.Read<std::uint32_t>();
+            std::uint32_t indexCount = reader.Read<std::uint32_t>();
+
+            // positions are always stored
+            if ((attributes & 1u) == 0 || (attributes >> BINARY_MODEL_ATTRIBUTES.size()) != 0)
+                throw CModelIOException("Invalid vertex attributes in binary model file");
+
+            std::uint64_t vertexSize = 0;
+            for (std::size_t k = 0; k < BINARY_MODEL_ATTRIBUTES.size(); ++k)
+            {
+                if ((attributes & (1u << k)) != 0)
+                    vertexSize += CModelPart::GetAttributeSize(BINARY_MODEL_ATTRIBUTES[k]);
+            }
+            reader.CheckRemaining(vertexCount * vertexSize + indexCount * std::uint64_t{sizeof(std::uint32_t)});
+
+            part->SetVertices(vertexCount);
+            for (std::size_t k = 0; k < BINARY_MODEL_ATTRIBUTES.size(); ++k)
+            {
+                if ((attributes & (1u << k)) == 0)
+                    continue;
+
+                VertexAttribute attribute = BINARY_MODEL_ATTRIBUTES[k];
+                part->Add(attribute);
+                reader.ReadBytes(part->GetAttributeData(attribute), vertexCount * CModelPart::GetAttributeSize(attribute));
+            }
+
+            part->SetIndices(indexCount);
+            reader.ReadBytes(part->GetIndexData(), indexCount * sizeof(std::uint32_t));
+        }
+
+        model->AddMesh(name, std::move(mesh));
+    }
+
+    return model;
+}
+
+void WriteBinaryModel(const CModel& model, const std::filesystem::path& path, const SourceStamp& source)
+{
+    if (!IsLittleEndian())
+        throw CModelIOException("Binary models are only supported on little-endian platforms");
+
+    CBinaryWriter writer;
+
+    writer.WriteBytes(BINARY_MODEL_MAGIC.data(), BINARY_MODEL_MAGIC.size());
+    writer.Write(BINARY_MODEL_VERSION);
+    writer.Write(source.size);
+    writer.Write(source.modificationTime);
+
+    writer.Write(static_cast<std::uint32_t>(model.GetCrashSphereCount()));
+    for (const ModelCrashSphere& crashSphere : model.GetCrashSpheres())
+    {
+        writer.Write(crashSphere.position);
+        writer.Write(crashSphere.radius);
+        writer.WriteString(crashSphere.sound);
+        writer.Write(crashSphere.hardness);
+    }
+
+    writer.Write<std::uint8_t>(model.HasShadowSpot());
+    if (model.HasShadowSpot())
+    {
+        writer.Write(model.GetShadowSpot().radius);
+        writer.Write(model.GetShadowSpot().intensity);
+    }
+
+    writer.Write<std::uint8_t>(model.HasCameraCollisionSphere());
+    if (model.HasCameraCollisionSphere())
+    {
+        writer.Write(model.GetCameraCollisionSphere().pos);
+        writer.Write(model.GetCameraCollisionSphere().radius);
+    }
+
+    std::vector<std::string> meshNames = model.GetMeshNames();
+    writer.Write(static_cast<std::uint32_t>(meshNames.size()));
+    for (const std::string& name : meshNames)
+    {
+        const CModelMesh* mesh = model.GetMesh(name);
+
+        writer.WriteString(name);
+        writer.WriteString(mesh->GetParent());
+        writer.Write(mesh->GetPosition());
+        writer.Write(mesh->GetRotation());
+        writer.Write(mesh->GetScale());
+
+        writer.Write(static_cast<std::uint32_t>(mesh->GetPartCount()));
+        for (std::size_t i = 0; i < mesh->GetPartCount(); ++i)
+        {
+            CModelPart* part = mesh->GetPart(i);
+
+            std::uint32_t attributes = 0;
+            for (std::size_t k = 0; k < BINARY_MODEL_ATTRIBUTES.size(); ++k)
+            {
+                if (part->Has(BINARY_MODEL_ATTRIBUTES[k]))
+                    attributes |= 1u << k;
+            }
+
+            writer.WriteMaterial(part->GetMaterial());
+            writer.Write(attributes);
+            writer.Write(static_cast<std::uint32_t>(part->GetVertexCount()));
+            writer.Write(static_cast<std::uint32_t>(part->GetIndexCount()));
+
+            for (VertexAttribute attribute : BINARY_MODEL_ATTRIBUTES)
+            {
+                if (part->Has(attribute))
+                    writer.WriteBytes(part->GetAttributeData(attribute), part->GetVertexCount() * CModelPart::GetAttributeSize(attribute));
+            }
+
+            writer.WriteBytes(part->GetIndices().data(), part->GetIndexCount() * sizeof(std::uint32_t));
+        }
+    }
+
+    COutputStream stream(path);
+    if (!stream.is_open())
+        throw CModelIOException("Could not open binary model file for writing: " + path.string());
+
+    const std::vector<char>& data = writer.GetData();
+    stream.write(data.data(), data.size());
+    if (!stream)
+        throw CModelIOException("Error writing binary model file: " + path.string());
+}
+
+std::unique_ptr<CModel> ReadCachedModel(const std::filesystem::path& path)
+{
+    std::filesystem::path cacheFile = "cache" / path;
+    cacheFile += ".bin";
+
+    // unlike a hash of the contents, the stamp costs no read of the source on a cache hit
+    SourceStamp source;
+    source.size = CResourceManager::GetFileSize(path.string());
+    bool cacheable = source.size >= 0;
+    if (cacheable)
+        source.modificationTime = CResourceManager::GetLastModificationTime(path.string());
+
+    std::unique_ptr<CModel> model;
+
+    if (cacheable)
+    {
+        try
+        {
+            model = ReadBinaryModel(cacheFile, source);
+        }
+        catch (const CModelIOException& e)
+        {
+            GetLogger()->Warn("Ignoring model cache %s: %s\n", cacheFile.string().c_str(), e.what());
+        }
+    }
+
+    if (model != nullptr)
+    {
+        GetLogger()->Debug("Loading cached model: %s\n", cacheFile.string().c_str());
+        return model;
+    }
+
+    model = ModelInput::Read(path);
+
+    if (cacheable)
+    {
+        try
+        {
+            CResourceManager::CreateNewDirectory(cacheFile.parent_path().string());
+            WriteBinaryModel(*model, cacheFile, source);
+        }
+        catch (const CModelIOException& e)
+        {
+            GetLogger()->Warn("Couldn't write model cache %s: %s\n", cacheFile.string().c_str(), e.what());
+        }
+    }
+
+    return model;
+}
+
+} // namespace Gfx::ModelIO
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2022, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#pragma once
+
+#include "graphics/model/model.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+/**
+ * \namespace ModelIO
+ * \brief Namespace with functions to read and write the binary model cache
+ *
+ * The binary format stores models exactly as CModel keeps them in memory:
+ * vertex attribute arrays are written as raw little-endian arrays, so
+ * reading a model is mostly a matter of copying them back.
+ */
+namespace Gfx::ModelIO
+{
+
+//! Version of binary model format, must be increased on every layout change
+constexpr std::uint32_t BINARY_MODEL_VERSION = 2;
+
+//! Identifies the version of the source file a binary model was made from
+struct SourceStamp
+{
+    //! Size of the source file in bytes
+    std::int64_t size = 0;
+    //! Last modification time of the source file
+    std::int64_t modificationTime = 0;
+
+    bool operator==(const SourceStamp& other) const
+    {
+        return size == other.size && modificationTime == other.modificationTime;
+    }
+};
+
+//! Reads a model from binary model file
+/**
+ * Returns nullptr if the file does not exist, has a different version
+ * or was generated from a source with a different \a source stamp.
+ * @throws CModelIOException if the file is damaged
+ */
+std::unique_ptr<CModel> ReadBinaryModel(const std::filesystem::path& path, const SourceStamp& source);
+
+//! Writes a model to binary model file
+/** @throws CModelIOException on write error */
+void WriteBinaryModel(const CModel& model, const std::filesystem::path& path, const SourceStamp& source);
+
+//! Reads a model file of any format through the binary cache
+/**
+ * The cache file is cache/<path>.bin in the save directory. It is used if
+ * the size and modification time of the source match, otherwise the source
+ * is parsed and the cache is written again.
+ * @throws CModelIOException on read error of the source
+ */
+std::unique_ptr<CModel> ReadCachedModel(const std::filesystem::path& path);
+
+}
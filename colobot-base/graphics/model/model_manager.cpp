@@ -21,10 +21,7 @@
 
 #include "common/logger.h"
 
-#include "common/resources/inputstream.h"
-
-#include "graphics/model/model_input.h"
-#include "graphics/model/model_io_exception.h"
+#include "graphics/model/model_bin.h"
 
 namespace Gfx
 {
@@ -39,7 +36,7 @@ CModel* CModelManager::GetModel(const std::string& modelName)
 
     GetLogger()->Debug("Loading new model: %s\n", modelFile.c_str());
 
-    m_models[modelName] = ModelInput::Read(modelFile);
+    m_models[modelName] = ModelIO::ReadCachedModel(modelFile);
 
     return m_models[modelName].get();
 }
@@ -289,6 +289,68 @@ void CModelPart::SetIndex(size_t index, unsigned int value)
     m_indices.array[index] = value;
 }
 
+const void* CModelPart::GetAttributeData(VertexAttribute attribute) const
+{
+    return const_cast<CModelPart*>(this)->GetAttributeData(attribute);
+}
+
+void* CModelPart::GetAttributeData(VertexAttribute attribute)
+{
+    if (!Has(attribute))
+        return nullptr;
+
+    switch (attribute)
+    {
+    case VertexAttribute::POSITION:
+        return m_positions.array.data();
+    case VertexAttribute::COLOR:
+        return m_colors.array.data();
+    case VertexAttribute::UV1:
+        return m_uvs1.array.data();
+    case VertexAttribute::UV2:
+        return m_uvs2.array.data();
+    case VertexAttribute::NORMAL:
+        return m_normals.array.data();
+    case VertexAttribute::TANGENT:
+        return m_tangents.array.data();
+    case VertexAttribute::BONE_INDICES:
+        return m_boneIndices.array.data();
+    case VertexAttribute::BONE_WEIGHTS:
+        return m_boneWeights.array.data();
+    default:
+        return nullptr;
+    }
+}
+
+size_t CModelPart::GetAttributeSize(VertexAttribute attribute)
+{
+    switch (attribute)
+    {
+    case VertexAttribute::POSITION:
+        return sizeof(glm::vec3);
+    case VertexAttribute::COLOR:
+        return sizeof(glm::u8vec4);
+    case VertexAttribute::UV1:
+    case VertexAttribute::UV2:
+        return sizeof(glm::vec2);
+    case VertexAttribute::NORMAL:
+        return sizeof(glm::vec3);
+    case VertexAttribute::TANGENT:
+        return sizeof(glm::vec4);
+    case VertexAttribute::BONE_INDICES:
+        return sizeof(glm::u8vec4);
+    case VertexAttribute::BONE_WEIGHTS:
+        return sizeof(glm::vec4);
+    default:
+        return 0;
+    }
+}
+
+std::uint32_t* CModelPart::GetIndexData()
+{
+    return m_indices.array.data();
+}
+
 void CModelPart::GetTriangles(std::vector<Gfx::ModelTriangle>& triangles)
 {
     size_t n = IsIndexed()
@@ -153,6 +153,15 @@ public:
     //! Set index
     void SetIndex(size_t index, unsigned int value);
 
+    //! Returns the raw data of vertex attribute array or nullptr if it is not present
+    const void* GetAttributeData(VertexAttribute attribute) const;
+    //! Returns the raw data of vertex attribute array or nullptr if it is not present
+    void* GetAttributeData(VertexAttribute attribute);
+    //! Returns the size in bytes of a single element of vertex attribute array
+    static size_t GetAttributeSize(VertexAttribute attribute);
+    //! Returns the raw index data
+    std::uint32_t* GetIndexData();
+
     //! Fills the array with converted model triangles
     void GetTriangles(std::vector<Gfx::ModelTriangle>& triangles);
 
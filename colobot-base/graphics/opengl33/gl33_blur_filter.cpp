@@ -0,0 +1,167 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2022, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/opengl33/gl33_blur_filter.h"
+
+#include "graphics/opengl33/glutil.h"
+
+#include "common/logger.h"
+
+using namespace Gfx;
+
+namespace
+{
+
+GLuint CreateBlurProgram(const char* fragmentShader)
+{
+    GLint shaders[2] = {};
+
+    shaders[0] = LoadShader(GL_VERTEX_SHADER, "shaders/gl33/blur_vs.glsl");
+    if (shaders[0] == 0)
+    {
+        GetLogger()->Error("Could not create vertex shader from file 'blur_vs.glsl'\n");
+        return 0;
+    }
+
+    shaders[1] = LoadShader(GL_FRAGMENT_SHADER, fragmentShader);
+    if (shaders[1] == 0)
+    {
+        GetLogger()->Error("Could not create fragment shader from file '%s'\n", fragmentShader);
+        glDeleteShader(shaders[0]);
+        return 0;
+    }
+
+    GLuint program = LinkProgram(2, shaders);
+
+    glDeleteShader(shaders[0]);
+    glDeleteShader(shaders[1]);
+
+    if (program == 0)
+    {
+        GetLogger()->Error("Could not link shader program for blur filter\n");
+        return 0;
+    }
+
+    glUseProgram(program);
+
+    // Set texture unit to 3rd, used for transient bindings
+    auto texture = glGetUniformLocation(program, "uni_Texture");
+    glUniform1i(texture, 3);
+
+    glUseProgram(0);
+
+    return program;
+}
+
+GLuint CreateFilterTexture(const glm::ivec2& size)
+{
+    GLuint texture = 0;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    return texture;
+}
+
+} // namespace
+
+CGL33BlurFilter::CGL33BlurFilter()
+{
+    GetLogger()->Info("Creating CGL33BlurFilter\n");
+
+    m_downsampleProgram = CreateBlurProgram("shaders/gl33/blur_downsample_fs.glsl");
+    m_blurProgram = CreateBlurProgram("shaders/gl33/blur_fs.glsl");
+
+    if (m_downsampleProgram == 0 || m_blurProgram == 0) return;
+
+    m_downsampleStep = glGetUniformLocation(m_downsampleProgram, "uni_Step");
+    m_blurStep = glGetUniformLocation(m_blurProgram, "uni_Step");
+
+    glGenVertexArrays(1, &m_vao);
+    glGenFramebuffers(1, &m_framebuffer);
+
+    GetLogger()->Info("CGL33BlurFilter created successfully\n");
+}
+
+CGL33BlurFilter::~CGL33BlurFilter()
+{
+    glDeleteProgram(m_downsampleProgram);
+    glDeleteProgram(m_blurProgram);
+
+    glDeleteVertexArrays(1, &m_vao);
+    glDeleteFramebuffers(1, &m_framebuffer);
+
+    glDeleteTextures(1, &m_screenTexture);
+    glDeleteTextures(1, &m_tempTexture);
+}
+
+void CGL33BlurFilter::Apply(const glm::ivec2& screenSize, GLuint target)
+{
+    if (m_framebuffer == 0) return;
+
+    glm::ivec2 size = screenSize / 4;
+
+    glActiveTexture(GL_TEXTURE3);
+
+    if (m_screenSize != screenSize)
+    {
+        glDeleteTextures(1, &m_screenTexture);
+        glDeleteTextures(1, &m_tempTexture);
+
+        m_screenTexture = CreateFilterTexture(screenSize);
+        m_tempTexture = CreateFilterTexture(size);
+        m_screenSize = screenSize;
+    }
+
+    // the copy stays on the GPU, nothing waits for it
+    glBindTexture(GL_TEXTURE_2D, m_screenTexture);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, screenSize.x, screenSize.y);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, size.x, size.y);
+    glBindVertexArray(m_vao);
+
+    glUseProgram(m_downsampleProgram);
+    Draw(m_screenTexture, target, m_downsampleStep, 1.0f / glm::vec2(screenSize));
+
+    glUseProgram(m_blurProgram);
+    Draw(target, m_tempTexture, m_blurStep, { 1.0f / size.x, 0.0f });
+    Draw(m_tempTexture, target, m_blurStep, { 0.0f, 1.0f / size.y });
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glUseProgram(0);
+}
+
+void CGL33BlurFilter::Draw(GLuint source, GLuint target, GLint stepLocation, const glm::vec2& step)
+{
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glUniform2f(stepLocation, step.x, step.y);
+
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
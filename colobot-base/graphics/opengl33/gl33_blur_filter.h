@@ -0,0 +1,82 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2022, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+ /**
+  * \file graphics/opengl33/gl33_blur_filter.h
+  * \brief OpenGL 3.3 blur filter of the screen
+  */
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \class CGL33BlurFilter
+ * \brief Downsamples and blurs the screen on the GPU, for the blurred background of the pause menu
+ *
+ * The screen is copied to a texture, reduced to a quarter of its size by averaging blocks
+ * of 4x4 pixels and blurred by a Gaussian kernel in two separable passes. Nothing is read
+ * back to the CPU.
+ */
+class CGL33BlurFilter
+{
+public:
+    CGL33BlurFilter();
+    ~CGL33BlurFilter();
+
+    /**
+     * \brief Draws the blurred screen into the target texture
+     *
+     * Leaves the framebuffer of the screen bound; the caller restores the viewport.
+     * \param screenSize Size of the screen
+     * \param target RGBA texture of a quarter of the size of the screen
+     */
+    void Apply(const glm::ivec2& screenSize, GLuint target);
+
+private:
+    //! Draws the source texture through the current program into the target texture
+    void Draw(GLuint source, GLuint target, GLint stepLocation, const glm::vec2& step);
+
+    // Shader programs
+    GLuint m_downsampleProgram = 0;
+    GLuint m_blurProgram = 0;
+    // Locations of the sampling steps
+    GLint m_downsampleStep = -1;
+    GLint m_blurStep = -1;
+
+    // Empty vertex array object, the vertices are made in the vertex shader
+    GLuint m_vao = 0;
+    // Framebuffer drawing into the textures
+    GLuint m_framebuffer = 0;
+
+    // Copy of the screen
+    GLuint m_screenTexture = 0;
+    // Result of the horizontal pass
+    GLuint m_tempTexture = 0;
+    // Size of the screen the textures were created for
+    glm::ivec2 m_screenSize = { 0, 0 };
+};
+
+} // namespace Gfx
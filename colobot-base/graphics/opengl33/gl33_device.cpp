@@ -19,9 +19,11 @@
 
 #include "graphics/opengl33/gl33_device.h"
 
+#include "graphics/opengl33/gl33_blur_filter.h"
 #include "graphics/opengl33/gl33_object_renderer.h"
 #include "graphics/opengl33/gl33_particle_renderer.h"
 #include "graphics/opengl33/gl33_shadow_renderer.h"
+#include "graphics/opengl33/gl33_stream_buffer.h"
 #include "graphics/opengl33/gl33_terrain_renderer.h"
 #include "graphics/opengl33/gl33_ui_renderer.h"
 #include "graphics/opengl33/glframebuffer.h"
@@ -44,6 +46,7 @@
 #include <SDL.h>
 #include <physfs.h>
 
+#include <algorithm>
 #include <cassert>
 
 #include <glm/gtc/type_ptr.hpp>
@@ -53,6 +56,9 @@
 namespace Gfx
 {
 
+//! Initial size of the buffer for immediate-mode vertices, in bytes
+constexpr GLsizeiptr STREAM_BUFFER_SIZE = 4 * 1024 * 1024;
+
 CGL33VertexBuffer::CGL33VertexBuffer(PrimitiveType type, size_t size)
     : CVertexBuffer(type, size)
 {
@@ -194,11 +200,14 @@ bool CGL33Device::Create()
     glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &m_capabilities.maxRenderbufferSize);
     GetLogger()->Info("Maximum renderbuffer size: %d\n", m_capabilities.maxRenderbufferSize);
 
+    m_streamBuffer = std::make_unique<CGL33StreamBuffer>(STREAM_BUFFER_SIZE);
+
     m_uiRenderer = std::make_unique<CGL33UIRenderer>(this);
     m_terrainRenderer = std::make_unique<CGL33TerrainRenderer>(this);
     m_objectRenderer = std::make_unique<CGL33ObjectRenderer>(this);
     m_particleRenderer = std::make_unique<CGL33ParticleRenderer>(this);
     m_shadowRenderer = std::make_unique<CGL33ShadowRenderer>(this);
+    m_blurFilter = std::make_unique<CGL33BlurFilter>();
 
     // create default framebuffer object
     FramebufferParams framebufferParams;
@@ -239,6 +248,9 @@ void CGL33Device::Destroy()
     m_objectRenderer = nullptr;
     m_particleRenderer = nullptr;
     m_shadowRenderer = nullptr;
+    m_blurFilter = nullptr;
+
+    m_streamBuffer = nullptr;
 }
 
 void CGL33Device::ConfigChanged(const DeviceConfig& newConfig)
@@ -313,10 +325,20 @@ CShadowRenderer* CGL33Device::GetShadowRenderer()
     return m_shadowRenderer.get();
 }
 
+CGL33StreamBuffer* CGL33Device::GetStreamBuffer()
+{
+    return m_streamBuffer.get();
+}
+
 /** If image is invalid, returns invalid texture.
     Otherwise, returns pointer to new Texture struct.
     This struct must not be deleted in other way than through DeleteTexture() */
 Texture CGL33Device::CreateTexture(CImage *image, const TextureCreateParams &params)
+{
+    return CreateTexture(image, params, {});
+}
+
+Texture CGL33Device::CreateTexture(CImage *image, const TextureCreateParams &params, const std::vector<TextureMipmap> &mipmaps)
 {
     ImageData *data = image->GetData();
     if (data == nullptr)
@@ -330,13 +352,19 @@ Texture CGL33Device::CreateTexture(CImage *image, const TextureCreateParams &par
     if (params.padToNearestPowerOfTwo)
         image->PadToNearestPowerOfTwo();
 
-    Texture tex = CreateTexture(data, params);
+    // A padded image no longer matches the mipmaps, CreateTextureFromData() generates them then
+    Texture tex = CreateTextureFromData(data, params, mipmaps);
     tex.originalSize = originalSize;
 
     return tex;
 }
 
 Texture CGL33Device::CreateTexture(ImageData *data, const TextureCreateParams &params)
+{
+    return CreateTextureFromData(data, params, {});
+}
+
+Texture CGL33Device::CreateTextureFromData(ImageData *data, const TextureCreateParams &params, const std::vector<TextureMipmap> &mipmaps)
 {
     Texture result;
 
@@ -419,8 +447,28 @@ Texture CGL33Device::CreateTexture(ImageData *data, const TextureCreateParams &p
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texData.actualSurface->w, texData.actualSurface->h,
                  0, texData.sourceFormat, GL_UNSIGNED_BYTE, texData.actualSurface->pixels);
 
-    if (params.mipmap)
+    // Mipmaps computed beforehand must continue the chain of this image
+    bool uploadMipmaps = !mipmaps.empty() &&
+        mipmaps.front().size == glm::ivec2(std::max(1, result.size.x / 2), std::max(1, result.size.y / 2));
+
+    if (params.mipmap && uploadMipmaps)
+    {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+        int levels = std::min(mipmapLevel - 1, static_cast<int>(mipmaps.size()));
+        for (int level = 1; level <= levels; level++)
+        {
+            const TextureMipmap& mipmap = mipmaps[level - 1];
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, mipmap.size.x, mipmap.size.y,
+                         0, GL_RGBA, GL_UNSIGNED_BYTE, mipmap.pixels.data());
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels);
+    }
+    else if (params.mipmap)
+    {
         glGenerateMipmap(GL_TEXTURE_2D);
+    }
 
     SDL_FreeSurface(texData.convertedSurface);
 
@@ -644,6 +692,47 @@ std::unique_ptr<CFrameBufferPixels> CGL33Device::GetFrameBufferPixels() const
     return GetGLFrameBufferPixels(m_config.size);
 }
 
+std::unique_ptr<CFrameBufferReadback> CGL33Device::ReadFrameBufferPixels()
+{
+    return StartGLFrameBufferReadback(m_config.size);
+}
+
+Texture CGL33Device::CreateBlurredScreenTexture()
+{
+    Texture result;
+
+    result.size = m_config.size / 4;
+    result.originalSize = result.size;
+    result.alpha = false;
+
+    if (result.size.x == 0 || result.size.y == 0) return Texture();
+
+    glGenTextures(1, &result.id);
+
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, result.id);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, result.size.x, result.size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    m_allTextures.insert(result);
+
+    SetTransparency(TransparencyMode::NONE);
+    SetDepthTest(false);
+    SetCullFace(CullFace::NONE);
+
+    m_blurFilter->Apply(m_config.size, result.id);
+
+    glViewport(0, 0, m_config.size.x, m_config.size.y);
+
+    return result;
+}
+
 CFramebuffer* CGL33Device::GetFramebuffer(std::string name)
 {
     auto it = m_framebuffers.find(name);
@@ -66,6 +66,8 @@ public:
     }
 };
 
+class CGL33BlurFilter;
+class CGL33StreamBuffer;
 class CGL33UIRenderer;
 class CGL33TerrainRenderer;
 class CGL33ObjectRenderer;
@@ -107,7 +109,11 @@ public:
     CParticleRenderer* GetParticleRenderer() override;
     CShadowRenderer* GetShadowRenderer() override;
 
+    //! Returns the buffer for the vertices of immediate-mode draws, shared by the renderers
+    CGL33StreamBuffer* GetStreamBuffer();
+
     Texture CreateTexture(CImage *image, const TextureCreateParams &params) override;
+    Texture CreateTexture(CImage *image, const TextureCreateParams &params, const std::vector<TextureMipmap> &mipmaps) override;
     Texture CreateTexture(ImageData *data, const TextureCreateParams &params) override;
     Texture CreateDepthTexture(int width, int height, int depth) override;
     void UpdateTexture(const Texture& texture, const glm::ivec2& offset, ImageData* data, TextureFormat format) override;
@@ -134,6 +140,10 @@ public:
 
     std::unique_ptr<CFrameBufferPixels> GetFrameBufferPixels() const override;
 
+    std::unique_ptr<CFrameBufferReadback> ReadFrameBufferPixels() override;
+
+    Texture CreateBlurredScreenTexture() override;
+
     CFramebuffer* GetFramebuffer(std::string name) override;
 
     CFramebuffer* CreateFramebuffer(std::string name, const FramebufferParams& params) override;
@@ -152,6 +162,9 @@ public:
     bool IsFramebufferSupported() override;
 
 private:
+    //! Creates a texture, uploading the given mipmaps if they continue the chain of the image
+    Texture CreateTextureFromData(ImageData *data, const TextureCreateParams &params, const std::vector<TextureMipmap> &mipmaps);
+
     //! Current config
     DeviceConfig m_config;
 
@@ -168,6 +181,8 @@ private:
     //! Map of framebuffers
     std::map<std::string, std::unique_ptr<CFramebuffer>> m_framebuffers;
 
+    //! Buffer for immediate-mode vertices
+    std::unique_ptr<CGL33StreamBuffer> m_streamBuffer;
     //! Interface renderer
     std::unique_ptr<CGL33UIRenderer> m_uiRenderer;
     //! Terrain renderer
@@ -178,6 +193,8 @@ private:
     std::unique_ptr<CGL33ParticleRenderer> m_particleRenderer;
     //! Shadow renderer
     std::unique_ptr<CGL33ShadowRenderer> m_shadowRenderer;
+    //! Blur filter of the screen
+    std::unique_ptr<CGL33BlurFilter> m_blurFilter;
 
     //! Depth test
     bool m_depthTest = false;
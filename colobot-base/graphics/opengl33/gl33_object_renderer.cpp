@@ -20,8 +20,10 @@
 #include "graphics/opengl33/gl33_object_renderer.h"
 
 #include "graphics/opengl33/gl33_device.h"
+#include "graphics/opengl33/gl33_stream_buffer.h"
 #include "graphics/opengl33/glutil.h"
 
+#include "graphics/core/light.h"
 #include "graphics/core/material.h"
 #include "graphics/core/transparency.h"
 #include "graphics/core/vertex.h"
@@ -33,6 +35,10 @@
 #include <glm/ext.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 using namespace Gfx;
 
 CGL33ObjectRenderer::CGL33ObjectRenderer(CGL33Device* device)
@@ -85,6 +91,12 @@ CGL33ObjectRenderer::CGL33ObjectRenderer(CGL33Device* device)
     m_skyColor = glGetUniformLocation(m_program, "uni_SkyColor");
     m_skyIntensity = glGetUniformLocation(m_program, "uni_SkyIntensity");
 
+    m_dynamicLightCount = glGetUniformLocation(m_program, "uni_DynamicLightCount");
+    m_dynamicLightPosition = glGetUniformLocation(m_program, "uni_DynamicLightPosition");
+    m_dynamicLightDirection = glGetUniformLocation(m_program, "uni_DynamicLightDirection");
+    m_dynamicLightColor = glGetUniformLocation(m_program, "uni_DynamicLightColor");
+    m_dynamicLightAttenuation = glGetUniformLocation(m_program, "uni_DynamicLightAttenuation");
+
     m_fogRange = glGetUniformLocation(m_program, "uni_FogRange");
     m_fogColor = glGetUniformLocation(m_program, "uni_FogColor");
 
@@ -106,6 +118,12 @@ CGL33ObjectRenderer::CGL33ObjectRenderer(CGL33Device* device)
     m_uvOffset = glGetUniformLocation(m_program, "uni_UVOffset");
     m_uvScale = glGetUniformLocation(m_program, "uni_UVScale");
 
+    m_instanced = glGetUniformLocation(m_program, "uni_Instanced");
+
+    m_waves = glGetUniformLocation(m_program, "uni_Waves");
+    m_waveParams = glGetUniformLocation(m_program, "uni_WaveParams");
+    m_curvature = glGetUniformLocation(m_program, "uni_Curvature");
+
     m_shadowRegions = glGetUniformLocation(m_program, "uni_ShadowRegions");
 
     std::array<GLchar, 256> name;
@@ -155,11 +173,7 @@ CGL33ObjectRenderer::CGL33ObjectRenderer(CGL33Device* device)
 
     glUseProgram(0);
 
-    // Generic buffer
-    glGenBuffers(1, &m_bufferVBO);
-    glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferVBO);
-    glBufferData(GL_COPY_WRITE_BUFFER, 8 * sizeof(Vertex3D), nullptr, GL_STREAM_DRAW);
-
+    // Generic buffer, the vertices come from the stream buffer of the device
     glGenVertexArrays(1, &m_bufferVAO);
     glBindVertexArray(m_bufferVAO);
 
@@ -169,6 +183,9 @@ CGL33ObjectRenderer::CGL33ObjectRenderer(CGL33Device* device)
     glEnableVertexAttribArray(3);
     glEnableVertexAttribArray(4);
 
+    // Instance buffer
+    glGenBuffers(1, &m_instanceVBO);
+
     GetLogger()->Info("CGL33ObjectRenderer created successfully\n");
 }
 
@@ -176,8 +193,8 @@ CGL33ObjectRenderer::~CGL33ObjectRenderer()
 {
     glDeleteProgram(m_program);
     glDeleteTextures(1, &m_whiteTexture);
-    glDeleteBuffers(1, &m_bufferVBO);
     glDeleteVertexArrays(1, &m_bufferVAO);
+    glDeleteBuffers(1, &m_instanceVBO);
 }
 
 void CGL33ObjectRenderer::CGL33ObjectRenderer::Begin()
@@ -218,6 +235,11 @@ void CGL33ObjectRenderer::CGL33ObjectRenderer::Begin()
     SetAlbedoColor({ 1, 1, 1, 1 });
     SetMaterialParams(1.0, 0.0, 0.0);
     SetRecolor(false);
+    SetWaves(false);
+    SetDynamicLights(0, nullptr);
+    SetCurvature({ 0.0f, 0.0f, 0.0f }, 0.0f);
+
+    glUniform1i(m_instanced, 0);
 }
 
 void CGL33ObjectRenderer::CGL33ObjectRenderer::End()
@@ -387,6 +409,40 @@ void CGL33ObjectRenderer::SetShadowParams(int count, const ShadowParam* params)
     }
 }
 
+void CGL33ObjectRenderer::SetDynamicLights(int count, const Light* lights)
+{
+    count = std::min(count, MAX_DRAW_LIGHTS);
+
+    std::array<glm::vec4, MAX_DRAW_LIGHTS> position;
+    std::array<glm::vec4, MAX_DRAW_LIGHTS> direction;
+    std::array<glm::vec3, MAX_DRAW_LIGHTS> color;
+    std::array<glm::vec3, MAX_DRAW_LIGHTS> attenuation;
+
+    for (int i = 0; i < count; i++)
+    {
+        const Light& light = lights[i];
+
+        // Point lights have no cone
+        float cutoff = light.type == LIGHT_SPOT ? cosf(light.spotAngle) : -1.0f;
+
+        glm::vec3 dir = glm::length(light.direction) > 0.0f ? glm::normalize(light.direction) : glm::vec3(0.0f, -1.0f, 0.0f);
+
+        position[i] = glm::vec4(light.position, cutoff);
+        direction[i] = glm::vec4(dir, light.spotIntensity);
+        color[i] = glm::vec3(light.diffuse.r, light.diffuse.g, light.diffuse.b);
+        attenuation[i] = glm::vec3(light.attenuation0, light.attenuation1, light.attenuation2);
+    }
+
+    glUniform1i(m_dynamicLightCount, count);
+
+    if (count == 0) return;
+
+    glUniform4fv(m_dynamicLightPosition, count, glm::value_ptr(position[0]));
+    glUniform4fv(m_dynamicLightDirection, count, glm::value_ptr(direction[0]));
+    glUniform3fv(m_dynamicLightColor, count, glm::value_ptr(color[0]));
+    glUniform3fv(m_dynamicLightAttenuation, count, glm::value_ptr(attenuation[0]));
+}
+
 void CGL33ObjectRenderer::SetFog(float min, float max, const glm::vec3& color)
 {
     glUniform2f(m_fogRange, min, max);
@@ -429,6 +485,19 @@ void CGL33ObjectRenderer::SetTriplanarScale(float scale)
     glUniform1f(m_triplanarScale, scale);
 }
 
+void CGL33ObjectRenderer::SetWaves(bool enabled, float time, float height, float glint)
+{
+    glUniform1i(m_waves, enabled ? 1 : 0);
+
+    if (enabled)
+        glUniform3f(m_waveParams, time, height, glint);
+}
+
+void CGL33ObjectRenderer::SetCurvature(const glm::vec3& center, float factor)
+{
+    glUniform3f(m_curvature, center.x, center.z, factor);
+}
+
 void CGL33ObjectRenderer::SetAlphaScissor(float alpha)
 {
     glUniform1f(m_alphaScissor, alpha);
@@ -460,6 +529,77 @@ void CGL33ObjectRenderer::DrawObject(const CVertexBuffer* buffer)
     glDrawArrays(TranslateGfxPrimitive(b->GetType()), 0, static_cast<GLsizei>(b->Size()));
 }
 
+void CGL33ObjectRenderer::DrawObjectInstanced(const CVertexBuffer* buffer, int count, const ObjectInstance* instances)
+{
+    auto b = dynamic_cast<const CGL33VertexBuffer*>(buffer);
+
+    if (b == nullptr || count <= 0) return;
+
+    m_instances.resize(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        const ObjectInstance& instance = instances[i];
+        InstanceData& data = m_instances[i];
+
+        data.modelMatrix = instance.modelMatrix;
+        data.normalMatrix = glm::transpose(glm::inverse(glm::mat3(instance.modelMatrix)));
+        data.albedoColor = instance.albedoColor;
+
+        // Recolor is done in HSV space in the shader
+        auto hsv = RGB2HSV(Color(instance.recolorTo.r, instance.recolorTo.g, instance.recolorTo.b, 1.0f));
+        data.recolorTo = { hsv.h, hsv.s, hsv.v };
+    }
+
+    size_t size = count * sizeof(InstanceData);
+
+    // Orphan the previous storage so that the upload doesn't wait for pending draws
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    m_instanceCapacity = std::max(m_instanceCapacity, size);
+    glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, m_instances.data());
+
+    glBindVertexArray(b->GetVAO());
+
+    // Model matrix occupies 4 consecutive attribute locations
+    for (GLuint i = 0; i < 4; i++)
+    {
+        glEnableVertexAttribArray(5 + i);
+        glVertexAttribPointer(5 + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            reinterpret_cast<void*>(offsetof(InstanceData, modelMatrix) + i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(5 + i, 1);
+    }
+
+    glEnableVertexAttribArray(9);
+    glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+        reinterpret_cast<void*>(offsetof(InstanceData, albedoColor)));
+    glVertexAttribDivisor(9, 1);
+
+    glEnableVertexAttribArray(10);
+    glVertexAttribPointer(10, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+        reinterpret_cast<void*>(offsetof(InstanceData, recolorTo)));
+    glVertexAttribDivisor(10, 1);
+
+    // Normal matrix occupies 3 consecutive attribute locations
+    for (GLuint i = 0; i < 3; i++)
+    {
+        glEnableVertexAttribArray(11 + i);
+        glVertexAttribPointer(11 + i, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            reinterpret_cast<void*>(offsetof(InstanceData, normalMatrix) + i * sizeof(glm::vec3)));
+        glVertexAttribDivisor(11 + i, 1);
+    }
+
+    glUniform1i(m_instanced, 1);
+
+    glDrawArraysInstanced(TranslateGfxPrimitive(b->GetType()), 0, static_cast<GLsizei>(b->Size()), count);
+
+    glUniform1i(m_instanced, 0);
+
+    // Leave the VAO in the state expected by DrawObject()
+    for (GLuint i = 5; i <= 13; i++)
+        glDisableVertexAttribArray(i);
+}
+
 void CGL33ObjectRenderer::DrawPrimitive(PrimitiveType type, int count, const Vertex3D* vertices)
 {
     DrawPrimitives(type, 1, &count, vertices);
@@ -467,25 +607,45 @@ void CGL33ObjectRenderer::DrawPrimitive(PrimitiveType type, int count, const Ver
 
 void CGL33ObjectRenderer::DrawPrimitives(PrimitiveType type, int drawCount, int count[], const Vertex3D* vertices)
 {
+    GLint total = 0;
+
+    for (int i = 0; i < drawCount; i++)
+        total += count[i];
+
+    size_t size = total * sizeof(Vertex3D);
+
+    // Send new vertices to GPU
+    auto buffer = m_device->GetStreamBuffer();
+    GLintptr offset = 0;
+    void* ptr = buffer->Map(size, sizeof(Vertex3D), offset);
+    std::memcpy(ptr, vertices, size);
+    buffer->Unmap();
+
+    BindStreamBuffer();
+
     m_first.resize(drawCount);
 
-    GLint offset = 0;
+    GLint first = static_cast<GLint>(offset / sizeof(Vertex3D));
 
     for (size_t i = 0; i < drawCount; i++)
     {
-        m_first[i] = offset;
-        offset += count[i];
+        m_first[i] = first;
+        first += count[i];
     }
 
+    glMultiDrawArrays(TranslateGfxPrimitive(type), m_first.data(), count, drawCount);
+}
+
+void CGL33ObjectRenderer::BindStreamBuffer()
+{
     glBindVertexArray(m_bufferVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_bufferVBO);
 
-    size_t size = offset * sizeof(Vertex3D);
+    // Vertex attributes are set up once, and again if the stream buffer was reallocated
+    GLuint vbo = m_device->GetStreamBuffer()->GetVBO();
+    if (m_bufferVBO == vbo) return;
 
-    // Send new vertices to GPU
+    m_bufferVBO = vbo;
     glBindBuffer(GL_ARRAY_BUFFER, m_bufferVBO);
-    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex3D),
         reinterpret_cast<void*>(offsetof(Vertex3D, position)));
@@ -501,6 +661,4 @@ void CGL33ObjectRenderer::DrawPrimitives(PrimitiveType type, int drawCount, int
 
     glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex3D),
         reinterpret_cast<void*>(offsetof(Vertex3D, uv2)));
-
-    glMultiDrawArrays(TranslateGfxPrimitive(type), m_first.data(), count, drawCount);
 }
@@ -80,6 +80,8 @@ public:
     virtual void SetSky(const Color& color, float intensity) override;
     //! Sets shadow parameters
     virtual void SetShadowParams(int count, const ShadowParam* params) override;
+    //! Sets dynamic lights
+    virtual void SetDynamicLights(int count, const Light* lights) override;
 
     //! Sets fog parameters
     virtual void SetFog(float min, float max, const glm::vec3& color) override;
@@ -105,14 +107,24 @@ public:
     //! Sets triplanar scale
     virtual void SetTriplanarScale(float scale) override;
 
+    //! Sets wave animation
+    virtual void SetWaves(bool enabled, float time = {}, float height = {}, float glint = {}) override;
+    //! Sets curvature
+    virtual void SetCurvature(const glm::vec3& center, float factor) override;
+
     //! Draws an object
     virtual void DrawObject(const CVertexBuffer* buffer) override;
+    //! Draws many copies of an object in one call
+    virtual void DrawObjectInstanced(const CVertexBuffer* buffer, int count, const ObjectInstance* instances) override;
     //! Draws a primitive
     virtual void DrawPrimitive(PrimitiveType type, int count, const Vertex3D* vertices) override;
     //! Draws a set of primitives
     virtual void DrawPrimitives(PrimitiveType type, int drawCount, int count[], const Vertex3D* vertices) override;
 
 private:
+    //! Binds the vertex array object, pointing to the stream buffer of the device
+    void BindStreamBuffer();
+
     CGL33Device* const m_device;
 
     // Uniform data
@@ -131,6 +143,12 @@ private:
     GLint m_skyColor = -1;
     GLint m_skyIntensity = -1;
 
+    GLint m_dynamicLightCount = -1;
+    GLint m_dynamicLightPosition = -1;
+    GLint m_dynamicLightDirection = -1;
+    GLint m_dynamicLightColor = -1;
+    GLint m_dynamicLightAttenuation = -1;
+
     GLint m_fogRange = -1;
     GLint m_fogColor = -1;
 
@@ -152,6 +170,12 @@ private:
     GLint m_uvOffset = -1;
     GLint m_uvScale = -1;
 
+    GLint m_instanced = -1;
+
+    GLint m_waves = -1;
+    GLint m_waveParams = -1;
+    GLint m_curvature = -1;
+
     struct ShadowUniforms
     {
         GLint transform;
@@ -185,12 +209,27 @@ private:
     // Currently bound shadow map
     GLuint m_shadowMap = 0;
 
-    // Vertex buffer object
+    // Stream buffer object the vertex array object points to
     GLuint m_bufferVBO = 0;
     // Vertex array object
     GLuint m_bufferVAO = 0;
     // Offsets
     std::vector<GLint> m_first;
+
+    // Instance buffer object
+    GLuint m_instanceVBO = 0;
+    // Allocated size of instance buffer in bytes
+    size_t m_instanceCapacity = 0;
+    // Per-instance attributes as uploaded, with the normal matrix computed once per instance
+    struct InstanceData
+    {
+        glm::mat4 modelMatrix;
+        glm::mat3 normalMatrix;
+        glm::vec4 albedoColor;
+        glm::vec3 recolorTo;
+    };
+    // Instance data prepared for upload
+    std::vector<InstanceData> m_instances;
 };
 
 }
@@ -20,6 +20,7 @@
 #include "graphics/opengl33/gl33_particle_renderer.h"
 
 #include "graphics/opengl33/gl33_device.h"
+#include "graphics/opengl33/gl33_stream_buffer.h"
 #include "graphics/opengl33/glutil.h"
 
 #include "graphics/core/material.h"
@@ -99,12 +100,7 @@ CGL33ParticleRenderer::CGL33ParticleRenderer(CGL33Device* device)
 
     glUseProgram(0);
 
-    // Generic buffer
-    glGenBuffers(1, &m_bufferVBO);
-    glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferVBO);
-    glBufferData(GL_COPY_WRITE_BUFFER, m_bufferCapacity * sizeof(VertexParticle), nullptr, GL_STREAM_DRAW);
-    m_bufferOffset = m_bufferCapacity;
-
+    // Generic buffer, the vertices come from the stream buffer of the device
     glGenVertexArrays(1, &m_bufferVAO);
     glBindVertexArray(m_bufferVAO);
 
@@ -119,6 +115,7 @@ CGL33ParticleRenderer::~CGL33ParticleRenderer()
 {
     glDeleteProgram(m_program);
     glDeleteTextures(1, &m_whiteTexture);
+    glDeleteVertexArrays(1, &m_bufferVAO);
 }
 
 void CGL33ParticleRenderer::Begin()
@@ -136,8 +133,7 @@ void CGL33ParticleRenderer::Begin()
 
     glUniform4f(m_color, 1.0f, 1.0f, 1.0f, 1.0f);
 
-    glBindVertexArray(m_bufferVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_bufferVBO);
+    BindStreamBuffer();
 }
 
 void CGL33ParticleRenderer::End()
@@ -197,50 +193,39 @@ void CGL33ParticleRenderer::SetTransparency(TransparencyMode mode)
 
 void CGL33ParticleRenderer::DrawParticle(PrimitiveType type, int count, const VertexParticle* vertices)
 {
-    GLuint total = m_bufferOffset + count;
+    auto buffer = m_device->GetStreamBuffer();
 
-    // Buffer full, orphan
-    if (total >= m_bufferCapacity)
-    {
-        glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(VertexParticle), nullptr, GL_STREAM_DRAW);
+    GLintptr offset = 0;
+    void* ptr = buffer->Map(count * sizeof(VertexParticle), sizeof(VertexParticle), offset);
 
-        m_bufferOffset = 0;
+    std::copy_n(vertices, count, reinterpret_cast<VertexParticle*>(ptr));
 
-        // Respecify vertex attributes
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexParticle),
-            reinterpret_cast<void*>(offsetof(VertexParticle, position)));
+    buffer->Unmap();
 
-        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(VertexParticle),
-            reinterpret_cast<void*>(offsetof(VertexParticle, color)));
+    BindStreamBuffer();
 
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexParticle),
-            reinterpret_cast<void*>(offsetof(VertexParticle, uv)));
-    }
+    glDrawArrays(TranslateGfxPrimitive(type),
+        static_cast<GLint>(offset / sizeof(VertexParticle)),
+        count);
+}
 
-    void* ptr = glMapBufferRange(GL_ARRAY_BUFFER,
-        m_bufferOffset * sizeof(VertexParticle),
-        count * sizeof(VertexParticle),
-        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+void CGL33ParticleRenderer::BindStreamBuffer()
+{
+    glBindVertexArray(m_bufferVAO);
 
-    if (ptr)
-    {
-        auto buffer = reinterpret_cast<VertexParticle*>(ptr);
+    // Vertex attributes are set up once, and again if the stream buffer was reallocated
+    GLuint vbo = m_device->GetStreamBuffer()->GetVBO();
+    if (m_bufferVBO == vbo) return;
 
-        std::copy_n(vertices, count, buffer);
+    m_bufferVBO = vbo;
+    glBindBuffer(GL_ARRAY_BUFFER, m_bufferVBO);
 
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-    }
-    else
-    {
-        glBufferSubData(GL_ARRAY_BUFFER,
-            m_bufferOffset * sizeof(VertexParticle),
-            count * sizeof(VertexParticle),
-            vertices);
-    }
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexParticle),
+        reinterpret_cast<void*>(offsetof(VertexParticle, position)));
 
-    glDrawArrays(TranslateGfxPrimitive(type),
-        m_bufferOffset,
-        count);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(VertexParticle),
+        reinterpret_cast<void*>(offsetof(VertexParticle, color)));
 
-    m_bufferOffset += count;
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexParticle),
+        reinterpret_cast<void*>(offsetof(VertexParticle, uv)));
 }
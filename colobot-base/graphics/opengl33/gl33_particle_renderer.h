@@ -66,6 +66,9 @@ public:
     virtual void DrawParticle(PrimitiveType type, int count, const VertexParticle* vertices) override;
 
 private:
+    //! Binds the vertex array object, pointing to the stream buffer of the device
+    void BindStreamBuffer();
+
     CGL33Device* const m_device;
 
     // Uniform data
@@ -85,14 +88,10 @@ private:
     // Currently bound primary texture
     GLuint m_texture = 0;
 
-    // Vertex buffer object
+    // Stream buffer object the vertex array object points to
     GLuint m_bufferVBO = 0;
     // Vertex array object
     GLuint m_bufferVAO = 0;
-    // VBO capacity
-    GLsizei m_bufferCapacity = 64 * 1024;
-    // Buffer offset
-    GLsizei m_bufferOffset = 0;
 };
 
 }
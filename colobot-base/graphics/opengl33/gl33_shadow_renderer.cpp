@@ -80,10 +80,15 @@ CGL33ShadowRenderer::CGL33ShadowRenderer(CGL33Device* device)
     m_viewMatrix = glGetUniformLocation(m_program, "uni_ViewMatrix");
     m_modelMatrix = glGetUniformLocation(m_program, "uni_ModelMatrix");
     m_alphaScissor = glGetUniformLocation(m_program, "uni_AlphaScissor");
+    m_instanced = glGetUniformLocation(m_program, "uni_Instanced");
+
+    glUniform1i(m_instanced, 0);
 
     glUseProgram(0);
 
     glGenFramebuffers(1, &m_framebuffer);
+    glGenFramebuffers(1, &m_copyFramebuffer);
+    glGenBuffers(1, &m_instanceVBO);
 
     GetLogger()->Info("CGL33ShadowRenderer created successfully\n");
 }
@@ -93,6 +98,8 @@ CGL33ShadowRenderer::~CGL33ShadowRenderer()
     glDeleteProgram(m_program);
 
     glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteFramebuffers(1, &m_copyFramebuffer);
+    glDeleteBuffers(1, &m_instanceVBO);
 }
 
 void CGL33ShadowRenderer::Begin()
@@ -170,12 +177,39 @@ void CGL33ShadowRenderer::SetShadowMap(const Texture& texture)
 
 void CGL33ShadowRenderer::SetShadowRegion(const glm::vec2& offset, const glm::vec2& scale)
 {
-    int x = static_cast<int>(m_width * offset.x);
-    int y = static_cast<int>(m_height * offset.y);
-    int width = static_cast<int>(m_width * scale.x);
-    int height = static_cast<int>(m_height * scale.y);
+    m_regionX = static_cast<int>(m_width * offset.x);
+    m_regionY = static_cast<int>(m_height * offset.y);
+    m_regionWidth = static_cast<int>(m_width * scale.x);
+    m_regionHeight = static_cast<int>(m_height * scale.y);
+
+    glViewport(m_regionX, m_regionY, m_regionWidth, m_regionHeight);
+}
 
-    glViewport(x, y, width, height);
+void CGL33ShadowRenderer::ClearShadowRegion()
+{
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(m_regionX, m_regionY, m_regionWidth, m_regionHeight);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void CGL33ShadowRenderer::CopyShadowRegion(const Texture& source, const glm::ivec2& sourcePosition)
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_copyFramebuffer);
+    glFramebufferTexture(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, source.id, 0);
+    glReadBuffer(GL_NONE);
+
+    int x1 = m_regionX + m_regionWidth;
+    int y1 = m_regionY + m_regionHeight;
+
+    // both maps have the same format, the depth is copied as is
+    glBlitFramebuffer(sourcePosition.x, sourcePosition.y,
+        sourcePosition.x + m_regionWidth, sourcePosition.y + m_regionHeight,
+        m_regionX, m_regionY, x1, y1,
+        GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    glFramebufferTexture(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, 0, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
 }
 
 void CGL33ShadowRenderer::DrawObject(const CVertexBuffer* buffer, bool transparent)
@@ -190,3 +224,37 @@ void CGL33ShadowRenderer::DrawObject(const CVertexBuffer* buffer, bool transpare
 
     glDrawArrays(TranslateGfxPrimitive(b->GetType()), 0, b->Size());
 }
+
+void CGL33ShadowRenderer::DrawObjectInstanced(const CVertexBuffer* buffer, bool transparent, int count, const glm::mat4* matrices)
+{
+    auto b = dynamic_cast<const CGL33VertexBuffer*>(buffer);
+
+    if (b == nullptr || count <= 0) return;
+
+    size_t size = count * sizeof(glm::mat4);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    m_instanceCapacity = std::max(m_instanceCapacity, size);
+    glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, matrices);
+
+    glUniform1i(m_alphaScissor, transparent ? 1 : 0);
+    glUniform1i(m_instanced, 1);
+
+    glBindVertexArray(b->GetVAO());
+
+    for (GLuint i = 0; i < 4; i++)
+    {
+        glEnableVertexAttribArray(5 + i);
+        glVertexAttribPointer(5 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+            reinterpret_cast<void*>(i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(5 + i, 1);
+    }
+
+    glDrawArraysInstanced(TranslateGfxPrimitive(b->GetType()), 0, b->Size(), count);
+
+    for (GLuint i = 0; i < 4; i++)
+        glDisableVertexAttribArray(5 + i);
+
+    glUniform1i(m_instanced, 0);
+}
@@ -61,9 +61,15 @@ public:
     virtual void SetShadowMap(const Texture& texture) override;
     //! Sets shadow region
     virtual void SetShadowRegion(const glm::vec2& offset, const glm::vec2& scale) override;
+    //! Clears the depth in the current shadow region
+    virtual void ClearShadowRegion() override;
+    //! Copies the depth of the current shadow region from a rectangle in another shadow map
+    virtual void CopyShadowRegion(const Texture& source, const glm::ivec2& sourcePosition) override;
 
     //! Draws terrain object
     virtual void DrawObject(const CVertexBuffer* buffer, bool transparent) override;
+    //! Draws many copies of an object in one call
+    virtual void DrawObjectInstanced(const CVertexBuffer* buffer, bool transparent, int count, const glm::mat4* matrices) override;
 
 private:
     CGL33Device* const m_device;
@@ -73,6 +79,7 @@ private:
     GLint m_viewMatrix = -1;
     GLint m_modelMatrix = -1;
     GLint m_alphaScissor = -1;
+    GLint m_instanced = -1;
 
     // Shader program
     GLuint m_program = 0;
@@ -81,6 +88,20 @@ private:
     GLuint m_framebuffer = 0;
     int m_width = 0;
     int m_height = 0;
+
+    // Current shadow region
+    int m_regionX = 0;
+    int m_regionY = 0;
+    int m_regionWidth = 0;
+    int m_regionHeight = 0;
+
+    // Framebuffer reading the source of CopyShadowRegion()
+    GLuint m_copyFramebuffer = 0;
+
+    // Instance buffer object
+    GLuint m_instanceVBO = 0;
+    // Allocated size of instance buffer in bytes
+    size_t m_instanceCapacity = 0;
 };
 
 } // namespace Gfx
@@ -0,0 +1,210 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "graphics/opengl33/gl33_stream_buffer.h"
+
+#include "graphics/opengl33/glutil.h"
+
+#include "common/logger.h"
+
+#include <algorithm>
+#include <cassert>
+
+// Graphics module namespace
+namespace Gfx
+{
+
+CGL33StreamBuffer::CGL33StreamBuffer(GLsizeiptr capacity)
+{
+    m_persistent = AreExtensionsSupported("GL_ARB_buffer_storage");
+
+    Create(capacity);
+
+    GetLogger()->Info("Stream buffer: %d KB, %s\n", static_cast<int>(capacity / 1024),
+        m_persistent ? "persistent mapping" : "unsynchronized mapping");
+}
+
+CGL33StreamBuffer::~CGL33StreamBuffer()
+{
+    Release();
+    glDeleteBuffers(1, &m_vbo);
+}
+
+void CGL33StreamBuffer::Create(GLsizeiptr capacity)
+{
+    m_capacity = capacity;
+    m_segmentSize = (capacity + SEGMENT_COUNT - 1) / SEGMENT_COUNT;
+    m_offset = 0;
+    m_segment = 0;
+
+    glGenBuffers(1, &m_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    if (m_persistent)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage(GL_ARRAY_BUFFER, m_capacity, nullptr, flags);
+        m_data = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, m_capacity, flags));
+
+        if (m_data != nullptr) return;
+
+        // Mapping failed, use a mutable buffer mapped for each range
+        GetLogger()->Warn("Persistent mapping of stream buffer failed\n");
+        m_persistent = false;
+        glDeleteBuffers(1, &m_vbo);
+        glGenBuffers(1, &m_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    }
+
+    glBufferData(GL_ARRAY_BUFFER, m_capacity, nullptr, GL_STREAM_DRAW);
+}
+
+void CGL33StreamBuffer::Release()
+{
+    for (auto& fence : m_fences)
+    {
+        if (fence != nullptr)
+            glDeleteSync(fence);
+
+        fence = nullptr;
+    }
+
+    if (m_data != nullptr)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        m_data = nullptr;
+    }
+}
+
+void* CGL33StreamBuffer::Map(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset)
+{
+    assert(!m_mapped);
+
+    // Range too large, grow the buffer; the draws using the old one keep it alive
+    if (size > m_capacity)
+    {
+        // Deleted after the new one is created, so that its name isn't reused
+        GLuint previous = m_vbo;
+
+        Release();
+        Create(std::max(size, 2 * m_capacity));
+
+        glDeleteBuffers(1, &previous);
+    }
+
+    GLintptr start = (m_offset + alignment - 1) / alignment * alignment;
+    bool wrap = start + size > m_capacity;
+    if (wrap) start = 0;
+
+    int first = static_cast<int>(start / m_segmentSize);
+    int last = static_cast<int>((start + std::max<GLsizeiptr>(size, 1) - 1) / m_segmentSize);
+
+    if (wrap)
+    {
+        for (int segment = m_segment; segment < SEGMENT_COUNT; segment++)
+            Fence(segment);
+
+        for (int segment = 0; segment <= last; segment++)
+            Wait(segment);
+    }
+    else
+    {
+        for (int segment = m_segment; segment < first; segment++)
+            Fence(segment);
+
+        // The segment of the previous range was already waited for
+        for (int segment = std::max(first, m_segment + 1); segment <= last; segment++)
+            Wait(segment);
+    }
+
+    m_segment = last;
+    m_offset = start + size;
+
+    m_mapOffset = start;
+    m_mapSize = size;
+    m_mapped = true;
+    offset = start;
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    if (m_persistent)
+        return m_data + start;
+
+    void* ptr = glMapBufferRange(GL_ARRAY_BUFFER, start, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+    // Mapping failed, use backup buffer
+    if (ptr == nullptr)
+    {
+        m_backup = true;
+        m_buffer.resize(size);
+
+        return m_buffer.data();
+    }
+
+    return ptr;
+}
+
+void CGL33StreamBuffer::Unmap()
+{
+    if (!m_mapped) return;
+
+    m_mapped = false;
+
+    if (m_persistent) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    if (m_backup)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, m_mapOffset, m_mapSize, m_buffer.data());
+        m_backup = false;
+    }
+    else
+    {
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+}
+
+void CGL33StreamBuffer::Fence(int segment)
+{
+    if (m_fences[segment] != nullptr)
+        glDeleteSync(m_fences[segment]);
+
+    m_fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void CGL33StreamBuffer::Wait(int segment)
+{
+    GLsync fence = m_fences[segment];
+    if (fence == nullptr) return;
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+
+    // Flush the commands on the second try so that the fence is eventually signaled
+    while (result == GL_TIMEOUT_EXPIRED)
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+    glDeleteSync(fence);
+    m_fences[segment] = nullptr;
+}
+
+} // namespace Gfx
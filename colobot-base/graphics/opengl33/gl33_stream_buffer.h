@@ -0,0 +1,121 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file graphics/opengl33/gl33_stream_buffer.h
+ * \brief OpenGL 3.3 implementation - CGL33StreamBuffer class
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <array>
+#include <vector>
+
+// Graphics module namespace
+namespace Gfx
+{
+
+/**
+ * \class CGL33StreamBuffer
+ * \brief Ring buffer for the vertices written once by the CPU and drawn right away
+ *
+ * The renderers drawing immediate-mode geometry take their vertices from ranges of
+ * this buffer instead of respecifying their own buffer on every draw. The buffer is
+ * split in segments; when the allocations leave a segment, a fence is inserted after
+ * the draws reading it and the segment is reused only once the fence is signaled.
+ *
+ * With GL_ARB_buffer_storage the buffer is mapped once for its whole lifetime,
+ * otherwise each range is mapped without synchronization, which the fences make safe.
+ *
+ * The buffer grows when a range doesn't fit; its name then changes and the vertex
+ * array objects pointing to it must be set up again, see GetVBO().
+ */
+class CGL33StreamBuffer
+{
+public:
+    //! Creates a buffer of \a capacity bytes
+    CGL33StreamBuffer(GLsizeiptr capacity);
+    ~CGL33StreamBuffer();
+
+    CGL33StreamBuffer(const CGL33StreamBuffer&) = delete;
+    CGL33StreamBuffer& operator=(const CGL33StreamBuffer&) = delete;
+
+    //! Returns the name of the buffer object
+    GLuint GetVBO() const
+    {
+        return m_vbo;
+    }
+
+    //! Reserves \a size bytes and returns where to write them
+    /**
+     * Binds the buffer to GL_ARRAY_BUFFER.
+     * \param size       number of bytes
+     * \param alignment  the offset is a multiple of this value, the size of a vertex for glDrawArrays()
+     * \param offset     receives the offset of the range in the buffer
+     */
+    void* Map(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset);
+    //! Ends writing the range returned by Map(), before drawing from it
+    void Unmap();
+
+private:
+    //! Creates the buffer object and maps it if possible
+    void Create(GLsizeiptr capacity);
+    //! Destroys the fences and the persistent mapping of the buffer object
+    void Release();
+
+    //! Inserts a fence after the draws reading a segment
+    void Fence(int segment);
+    //! Waits until the GPU is done with a segment
+    void Wait(int segment);
+
+    static constexpr int SEGMENT_COUNT = 4;
+
+    // Buffer object
+    GLuint m_vbo = 0;
+    // Size of the buffer in bytes
+    GLsizeiptr m_capacity = 0;
+    // Size of a segment in bytes
+    GLsizeiptr m_segmentSize = 0;
+    // Fences of the segments, null if the GPU is done with them
+    std::array<GLsync, SEGMENT_COUNT> m_fences = {};
+
+    // Offset of the next range
+    GLintptr m_offset = 0;
+    // Segment of the last range
+    int m_segment = 0;
+
+    // True if the buffer is mapped persistently
+    bool m_persistent = false;
+    // Persistent mapping of the buffer
+    char* m_data = nullptr;
+
+    // Current range
+    GLintptr m_mapOffset = 0;
+    GLsizeiptr m_mapSize = 0;
+    // True means currently writing
+    bool m_mapped = false;
+    // True means mapping failed, using auxiliary buffer
+    bool m_backup = false;
+    // Buffered data
+    std::vector<char> m_buffer;
+};
+
+} // namespace Gfx
@@ -22,6 +22,7 @@
 #include "graphics/opengl33/gl33_device.h"
 #include "graphics/opengl33/glutil.h"
 
+#include "graphics/core/light.h"
 #include "graphics/core/material.h"
 #include "graphics/core/transparency.h"
 #include "graphics/core/vertex.h"
@@ -34,6 +35,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 using namespace Gfx;
 
@@ -91,6 +93,12 @@ CGL33TerrainRenderer::CGL33TerrainRenderer(CGL33Device* device)
     m_skyColor = glGetUniformLocation(m_program, "uni_SkyColor");
     m_skyIntensity = glGetUniformLocation(m_program, "uni_SkyIntensity");
 
+    m_dynamicLightCount = glGetUniformLocation(m_program, "uni_DynamicLightCount");
+    m_dynamicLightPosition = glGetUniformLocation(m_program, "uni_DynamicLightPosition");
+    m_dynamicLightDirection = glGetUniformLocation(m_program, "uni_DynamicLightDirection");
+    m_dynamicLightColor = glGetUniformLocation(m_program, "uni_DynamicLightColor");
+    m_dynamicLightAttenuation = glGetUniformLocation(m_program, "uni_DynamicLightAttenuation");
+
     m_fogRange = glGetUniformLocation(m_program, "uni_FogRange");
     m_fogColor = glGetUniformLocation(m_program, "uni_FogColor");
 
@@ -194,6 +202,7 @@ void CGL33TerrainRenderer::Begin()
     m_device->SetCullFace(CullFace::BACK);
 
     SetFog(1e+6f, 1e+6, {});
+    SetDynamicLights(0, nullptr);
 }
 
 void CGL33TerrainRenderer::End()
@@ -358,6 +367,40 @@ void CGL33TerrainRenderer::SetShadowParams(int count, const ShadowParam* params)
     }
 }
 
+void CGL33TerrainRenderer::SetDynamicLights(int count, const Light* lights)
+{
+    count = std::min(count, MAX_DRAW_LIGHTS);
+
+    std::array<glm::vec4, MAX_DRAW_LIGHTS> position;
+    std::array<glm::vec4, MAX_DRAW_LIGHTS> direction;
+    std::array<glm::vec3, MAX_DRAW_LIGHTS> color;
+    std::array<glm::vec3, MAX_DRAW_LIGHTS> attenuation;
+
+    for (int i = 0; i < count; i++)
+    {
+        const Light& light = lights[i];
+
+        // Point lights have no cone
+        float cutoff = light.type == LIGHT_SPOT ? cosf(light.spotAngle) : -1.0f;
+
+        glm::vec3 dir = glm::length(light.direction) > 0.0f ? glm::normalize(light.direction) : glm::vec3(0.0f, -1.0f, 0.0f);
+
+        position[i] = glm::vec4(light.position, cutoff);
+        direction[i] = glm::vec4(dir, light.spotIntensity);
+        color[i] = glm::vec3(light.diffuse.r, light.diffuse.g, light.diffuse.b);
+        attenuation[i] = glm::vec3(light.attenuation0, light.attenuation1, light.attenuation2);
+    }
+
+    glUniform1i(m_dynamicLightCount, count);
+
+    if (count == 0) return;
+
+    glUniform4fv(m_dynamicLightPosition, count, glm::value_ptr(position[0]));
+    glUniform4fv(m_dynamicLightDirection, count, glm::value_ptr(direction[0]));
+    glUniform3fv(m_dynamicLightColor, count, glm::value_ptr(color[0]));
+    glUniform3fv(m_dynamicLightAttenuation, count, glm::value_ptr(attenuation[0]));
+}
+
 void CGL33TerrainRenderer::SetFog(float min, float max, const glm::vec3& color)
 {
     glUniform2f(m_fogRange, min, max);
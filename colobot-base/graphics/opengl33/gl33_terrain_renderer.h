@@ -80,6 +80,8 @@ public:
     virtual void SetSky(const Color& color, float intensity) override;
     //! Sets shadow parameters
     virtual void SetShadowParams(int count, const ShadowParam* params) override;
+    //! Sets dynamic lights
+    virtual void SetDynamicLights(int count, const Light* lights) override;
 
     //! Sets fog parameters
     virtual void SetFog(float min, float max, const glm::vec3& color) override;
@@ -105,6 +107,12 @@ private:
     GLint m_skyColor = -1;
     GLint m_skyIntensity = -1;
 
+    GLint m_dynamicLightCount = -1;
+    GLint m_dynamicLightPosition = -1;
+    GLint m_dynamicLightDirection = -1;
+    GLint m_dynamicLightColor = -1;
+    GLint m_dynamicLightAttenuation = -1;
+
     GLint m_fogRange = -1;
     GLint m_fogColor = -1;
 
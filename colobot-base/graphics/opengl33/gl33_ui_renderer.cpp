@@ -20,6 +20,7 @@
 #include "graphics/opengl33/gl33_ui_renderer.h"
 
 #include "graphics/opengl33/gl33_device.h"
+#include "graphics/opengl33/gl33_stream_buffer.h"
 #include "graphics/opengl33/glutil.h"
 
 #include "graphics/core/material.h"
@@ -93,15 +94,14 @@ CGL33UIRenderer::CGL33UIRenderer(CGL33Device* device)
     auto texture = glGetUniformLocation(m_program, "uni_Texture");
     glUniform1i(texture, 8);
 
-    // Generic buffer
-    glGenBuffers(1, &m_bufferVBO);
-    glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferVBO);
-    glBufferData(GL_COPY_WRITE_BUFFER, m_bufferCapacity * sizeof(Vertex2D), nullptr, GL_STREAM_DRAW);
-    m_bufferOffset = m_bufferCapacity;
-
+    // Generic buffer, the vertices come from the stream buffer of the device
     glGenVertexArrays(1, &m_bufferVAO);
     glBindVertexArray(m_bufferVAO);
 
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+
     // White texture
     glActiveTexture(GL_TEXTURE0);
     glGenTextures(1, &m_whiteTexture);
@@ -126,7 +126,6 @@ CGL33UIRenderer::~CGL33UIRenderer()
     glDeleteProgram(m_program);
     glDeleteTextures(1, &m_whiteTexture);
 
-    glDeleteBuffers(1, &m_bufferVBO);
     glDeleteVertexArrays(1, &m_bufferVAO);
 }
 
@@ -168,9 +167,6 @@ Vertex2D* CGL33UIRenderer::BeginPrimitive(PrimitiveType type, int count)
 
 Vertex2D* CGL33UIRenderer::BeginPrimitives(PrimitiveType type, int drawCount, const int* counts)
 {
-    glBindVertexArray(m_bufferVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_bufferVBO);
-
     m_currentCount = 0;
 
     for (size_t i = 0; i < drawCount; i++)
@@ -178,33 +174,13 @@ Vertex2D* CGL33UIRenderer::BeginPrimitives(PrimitiveType type, int drawCount, co
         m_currentCount += counts[i];
     }
 
-    GLuint total = m_bufferOffset + m_currentCount;
-
-    // Buffer full, orphan
-    if (total >= m_bufferCapacity)
-    {
-        glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(Vertex2D), nullptr, GL_STREAM_DRAW);
-
-        m_bufferOffset = 0;
-
-        // Respecify vertex attributes
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D),
-            reinterpret_cast<void*>(offsetof(Vertex2D, position)));
-
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D),
-            reinterpret_cast<void*>(offsetof(Vertex2D, uv)));
-
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex2D),
-            reinterpret_cast<void*>(offsetof(Vertex2D, color)));
-    }
+    GLintptr offset = 0;
+    void* ptr = m_device->GetStreamBuffer()->Map(m_currentCount * sizeof(Vertex2D), sizeof(Vertex2D), offset);
 
     m_first.resize(drawCount);
     m_count.resize(drawCount);
 
-    GLsizei currentOffset = m_bufferOffset;
+    GLsizei currentOffset = static_cast<GLsizei>(offset / sizeof(Vertex2D));
 
     for (size_t i = 0; i < drawCount; i++)
     {
@@ -214,44 +190,20 @@ Vertex2D* CGL33UIRenderer::BeginPrimitives(PrimitiveType type, int drawCount, co
         currentOffset += counts[i];
     }
 
-    auto ptr = glMapBufferRange(GL_ARRAY_BUFFER,
-        m_bufferOffset * sizeof(Vertex2D),
-        m_currentCount * sizeof(Vertex2D),
-        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
-
     m_mapped = true;
     m_type = type;
     m_drawCount = drawCount;
 
-    // Mapping failed, use backup buffer
-    if (ptr == nullptr)
-    {
-        m_backup = true;
-        m_buffer.resize(m_currentCount);
-
-        return m_buffer.data();
-    }
-    else
-    {
-        return reinterpret_cast<Vertex2D*>(ptr);
-    }
+    return reinterpret_cast<Vertex2D*>(ptr);
 }
 
 bool CGL33UIRenderer::EndPrimitive()
 {
     if (!m_mapped) return false;
 
-    if (m_backup)
-    {
-        glBufferSubData(GL_ARRAY_BUFFER,
-            m_bufferOffset * sizeof(Vertex2D),
-            m_currentCount * sizeof(Vertex2D),
-            m_buffer.data());
-    }
-    else
-    {
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-    }
+    m_device->GetStreamBuffer()->Unmap();
+
+    BindStreamBuffer();
 
     glUseProgram(m_program);
 
@@ -267,14 +219,32 @@ bool CGL33UIRenderer::EndPrimitive()
     else
         glMultiDrawArrays(TranslateGfxPrimitive(m_type), m_first.data(), m_count.data(), m_drawCount);
 
-    m_bufferOffset += m_currentCount;
-
     m_mapped = false;
-    m_backup = false;
 
     return true;
 }
 
+void CGL33UIRenderer::BindStreamBuffer()
+{
+    glBindVertexArray(m_bufferVAO);
+
+    // Vertex attributes are set up once, and again if the stream buffer was reallocated
+    GLuint vbo = m_device->GetStreamBuffer()->GetVBO();
+    if (m_bufferVBO == vbo) return;
+
+    m_bufferVBO = vbo;
+    glBindBuffer(GL_ARRAY_BUFFER, m_bufferVBO);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D),
+        reinterpret_cast<void*>(offsetof(Vertex2D, position)));
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D),
+        reinterpret_cast<void*>(offsetof(Vertex2D, uv)));
+
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex2D),
+        reinterpret_cast<void*>(offsetof(Vertex2D, color)));
+}
+
 void CGL33UIRenderer::UpdateUniforms()
 {
     if (!m_uniformsDirty) return;
@@ -54,6 +54,8 @@ public:
 
 private:
     void UpdateUniforms();
+    //! Binds the vertex array object, pointing to the stream buffer of the device
+    void BindStreamBuffer();
 
     CGL33Device* const m_device;
 
@@ -71,14 +73,10 @@ private:
     // Uniform buffer object
     GLuint m_uniformBuffer = 0;
 
-    // Vertex buffer object
+    // Stream buffer object the vertex array object points to
     GLuint m_bufferVBO = 0;
     // Vertex array object
     GLuint m_bufferVAO = 0;
-    // VBO capacity
-    GLsizei m_bufferCapacity = 128 * 1024;
-    // Buffer offset
-    GLsizei m_bufferOffset = 0;
 
     // Buffer mapping state
     PrimitiveType m_type = {};
@@ -92,11 +90,6 @@ private:
     std::vector<GLsizei> m_count;
     // True means currently drawing
     bool m_mapped = false;
-    // True means mapping failed, using auxiliary buffer
-    bool m_backup = false;
-
-    // Buffered vertex data
-    std::vector<Vertex2D> m_buffer;
 
     // Shader program
     GLuint m_program = 0;
@@ -522,6 +522,79 @@ std::unique_ptr<CFrameBufferPixels> GetGLFrameBufferPixels(const glm::ivec2& siz
     return pixels;
 }
 
+class CGLFrameBufferReadback : public CFrameBufferReadback
+{
+public:
+    CGLFrameBufferReadback(const glm::ivec2& size)
+        : m_size(size)
+    {
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, 4 * size.x * size.y, nullptr, GL_STREAM_READ);
+
+        // with a pixel pack buffer bound, the copy is only queued and the call returns at once
+        glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    ~CGLFrameBufferReadback() override
+    {
+        if (m_fence != nullptr) glDeleteSync(m_fence);
+        glDeleteBuffers(1, &m_buffer);
+    }
+
+    bool IsReady() override
+    {
+        if (m_fence == nullptr) return true;
+
+        GLenum result = glClientWaitSync(m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (result == GL_TIMEOUT_EXPIRED) return false;
+
+        glDeleteSync(m_fence);
+        m_fence = nullptr;
+        return true;
+    }
+
+    std::unique_ptr<CFrameBufferPixels> GetPixels() override
+    {
+        std::size_t count = m_size.x * m_size.y;
+        auto pixels = std::make_unique<CGLFrameBufferPixels>(4 * count);
+        GLuint* p = static_cast<GLuint*>(pixels->GetPixelsData());
+
+        // mapping waits for the copy if it is still in progress
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+        auto source = static_cast<const GLuint*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, 4 * count, GL_MAP_READ_BIT));
+
+        if (source != nullptr)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                p[i] = source[i] | 0xFF000000;
+
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        else
+        {
+            GetLogger()->Error("Could not map the screen readback buffer\n");
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        return pixels;
+    }
+
+private:
+    glm::ivec2 m_size;
+    GLuint m_buffer = 0;
+    GLsync m_fence = nullptr;
+};
+
+std::unique_ptr<CFrameBufferReadback> StartGLFrameBufferReadback(const glm::ivec2& size)
+{
+    return std::make_unique<CGLFrameBufferReadback>(size);
+}
+
 PreparedTextureData PrepareTextureData(ImageData* imageData, TextureFormat format)
 {
     PreparedTextureData texData;
@@ -40,6 +40,7 @@ namespace Gfx
 
 class CDevice;
 class CFrameBufferPixels;
+class CFrameBufferReadback;
 struct DeviceConfig;
 enum class PrimitiveType : unsigned char;
 enum class Type : unsigned char;
@@ -103,4 +104,7 @@ PreparedTextureData PrepareTextureData(ImageData* imageData, TextureFormat forma
 
 std::unique_ptr<CFrameBufferPixels> GetGLFrameBufferPixels(const glm::ivec2& size);
 
+//! Starts copying the screen to a pixel buffer, see CFrameBufferReadback
+std::unique_ptr<CFrameBufferReadback> StartGLFrameBufferReadback(const glm::ivec2& size);
+
 } // namespace Gfx
@@ -0,0 +1,43 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+// FRAGMENT SHADER - BLUR FILTER, DOWNSAMPLING
+#version 330 core
+
+uniform sampler2D uni_Texture;
+
+// Size of one texel of the source texture
+uniform vec2 uni_Step;
+
+in VertexData
+{
+    vec2 TexCoord;
+} data;
+
+out vec4 out_FragColor;
+
+void main()
+{
+    // each bilinear sample averages 2x2 texels, the four samples
+    // cover the 4x4 block of the source under this pixel
+    out_FragColor = 0.25 * (texture(uni_Texture, data.TexCoord + vec2(-uni_Step.x, -uni_Step.y))
+                          + texture(uni_Texture, data.TexCoord + vec2( uni_Step.x, -uni_Step.y))
+                          + texture(uni_Texture, data.TexCoord + vec2(-uni_Step.x,  uni_Step.y))
+                          + texture(uni_Texture, data.TexCoord + vec2( uni_Step.x,  uni_Step.y)));
+}
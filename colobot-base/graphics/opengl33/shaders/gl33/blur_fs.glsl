@@ -0,0 +1,49 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+// FRAGMENT SHADER - BLUR FILTER, GAUSSIAN BLUR
+#version 330 core
+
+uniform sampler2D uni_Texture;
+
+// Direction of the blur, one texel long
+uniform vec2 uni_Step;
+
+in VertexData
+{
+    vec2 TexCoord;
+} data;
+
+out vec4 out_FragColor;
+
+// 7-tap Gaussian kernel, applied once horizontally and once vertically
+const float weights[4] = float[4](0.474431, 0.233923, 0.028041, 0.000817);
+
+void main()
+{
+    vec4 color = weights[0] * texture(uni_Texture, data.TexCoord);
+
+    for (int i = 1; i < 4; i++)
+    {
+        color += weights[i] * texture(uni_Texture, data.TexCoord + float(i) * uni_Step);
+        color += weights[i] * texture(uni_Texture, data.TexCoord - float(i) * uni_Step);
+    }
+
+    out_FragColor = color;
+}
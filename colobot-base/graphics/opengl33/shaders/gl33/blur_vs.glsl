@@ -0,0 +1,36 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+// VERTEX SHADER - BLUR FILTER
+#version 330 core
+
+out VertexData
+{
+    vec2 TexCoord;
+} data;
+
+void main()
+{
+    // one triangle covering the whole viewport, drawn without vertex buffer
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+
+    gl_Position = vec4(2.0 * position - 1.0, 0.0, 1.0);
+
+    data.TexCoord = position;
+}
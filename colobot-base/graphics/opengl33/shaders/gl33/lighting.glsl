@@ -30,6 +30,17 @@ uniform vec3 uni_LightColor;
 uniform float uni_SkyIntensity;
 uniform vec3 uni_SkyColor;
 
+// Point and spot lights affecting the object, see CLightManager
+const int MAX_DYNAMIC_LIGHTS = 4;
+
+uniform int uni_DynamicLightCount;
+// xyz: position, w: cosine of the spot angle, -1 for point lights
+uniform vec4 uni_DynamicLightPosition[MAX_DYNAMIC_LIGHTS];
+// xyz: direction of spot lights, w: spot exponent
+uniform vec4 uni_DynamicLightDirection[MAX_DYNAMIC_LIGHTS];
+uniform vec3 uni_DynamicLightColor[MAX_DYNAMIC_LIGHTS];
+uniform vec3 uni_DynamicLightAttenuation[MAX_DYNAMIC_LIGHTS];
+
 const float PI = 3.1415926;
 
 vec3 SchlickFresnel(float LdH, float metalness, vec3 color)
@@ -85,5 +96,25 @@ vec3 CalculateLighting(
     vec3 diffuseSpecular = (diffuseBrdf + PI * specBrdf) * uni_LightIntensity * uni_LightColor * NdL * shadow;
     vec3 ambient = albedo * uni_SkyColor * uni_SkyIntensity * ambientOcclusion;
 
+    // Dynamic lights are diffuse only and cast no shadows
+    for (int i = 0; i < uni_DynamicLightCount; i++)
+    {
+        vec3 toLight = uni_DynamicLightPosition[i].xyz - position;
+        float lightDistance = length(toLight);
+        vec3 lightDir = toLight / max(lightDistance, 0.001);
+
+        vec3 attenuation = uni_DynamicLightAttenuation[i];
+        float factor = 1.0 / max(attenuation.x + (attenuation.y + attenuation.z * lightDistance) * lightDistance, 0.001);
+
+        float cutoff = uni_DynamicLightPosition[i].w;
+        if (cutoff > -1.0)
+        {
+            float spot = dot(-lightDir, uni_DynamicLightDirection[i].xyz);
+            factor *= spot < cutoff ? 0.0 : pow(max(spot, 0.0001), uni_DynamicLightDirection[i].w);
+        }
+
+        diffuseSpecular += diffuseBrdf * uni_DynamicLightColor[i] * max(dot(normal, lightDir), 0.0) * factor;
+    }
+
     return ambient + emissive + diffuseSpecular;
 }
@@ -22,7 +22,6 @@
 uniform vec2 uni_FogRange;
 uniform vec3 uni_FogColor;
 
-uniform vec4 uni_AlbedoColor;
 uniform sampler2D uni_AlbedoTexture;
 uniform sampler2D uni_DetailTexture;
 
@@ -41,7 +40,6 @@ uniform float uni_AlphaScissor;
 
 uniform bool uni_Recolor;
 uniform vec3 uni_RecolorFrom;
-uniform vec3 uni_RecolorTo;
 uniform float uni_RecolorThreshold;
 
 in VertexData
@@ -54,6 +52,8 @@ in VertexData
     vec3 VertexNormal;
     vec3 Position;
     vec3 ShadowCoords[4];
+    flat vec4 AlbedoColor;
+    flat vec3 RecolorTo;
 } data;
 
 out vec4 out_FragColor;
@@ -91,7 +91,7 @@ vec3 hsv2rgb(vec3 c)
 
 void main()
 {
-    vec4 albedo = data.Color * uni_AlbedoColor;
+    vec4 albedo = data.Color * data.AlbedoColor;
 
     vec4 texColor = texture(uni_AlbedoTexture, data.TexCoord0);
 
@@ -101,7 +101,7 @@ void main()
 
         if (abs(hsv.x - uni_RecolorFrom.x) < uni_RecolorThreshold)
         {
-            hsv += (uni_RecolorTo - uni_RecolorFrom);
+            hsv += (data.RecolorTo - uni_RecolorFrom);
 
             if (hsv.x < 0.0) hsv.x += 1.0;
             if (hsv.x > 1.0) hsv.x -= 1.0;
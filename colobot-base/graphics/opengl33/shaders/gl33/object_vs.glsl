@@ -27,12 +27,29 @@ uniform mat3 uni_NormalMatrix;
 uniform vec2 uni_UVOffset;
 uniform vec2 uni_UVScale;
 
+uniform vec4 uni_AlbedoColor;
+uniform vec3 uni_RecolorTo;
+
+uniform bool uni_Instanced;
+
+// Wave animation of water surfaces: time, height, glint
+uniform bool uni_Waves;
+uniform vec3 uni_WaveParams;
+// Lowers the vertices by z times their squared distance from point (x, y) on the XZ plane
+uniform vec3 uni_Curvature;
+
 layout(location = 0) in vec4 in_VertexCoord;
 layout(location = 1) in vec3 in_Normal;
 layout(location = 2) in vec4 in_Color;
 layout(location = 3) in vec2 in_TexCoord0;
 layout(location = 4) in vec2 in_TexCoord1;
 
+// Per-instance attributes, used only if uni_Instanced is set
+layout(location = 5) in mat4 in_InstanceMatrix;
+layout(location = 9) in vec4 in_InstanceColor;
+layout(location = 10) in vec3 in_InstanceRecolor;
+layout(location = 11) in mat3 in_InstanceNormalMatrix;
+
 out VertexData
 {
     vec4 Color;
@@ -43,20 +60,55 @@ out VertexData
     vec3 VertexNormal;
     vec3 Position;
     vec3 ShadowCoords[4];
+    flat vec4 AlbedoColor;
+    flat vec3 RecolorTo;
 } data;
 
 void main()
 {
-    vec4 position = uni_ModelMatrix * in_VertexCoord;
+    mat4 modelMatrix = uni_ModelMatrix;
+    mat3 normalMatrix = uni_NormalMatrix;
+
+    data.AlbedoColor = uni_AlbedoColor;
+    data.RecolorTo = uni_RecolorTo;
+
+    if (uni_Instanced)
+    {
+        modelMatrix = in_InstanceMatrix;
+        normalMatrix = in_InstanceNormalMatrix;
+
+        data.AlbedoColor = in_InstanceColor;
+        data.RecolorTo = in_InstanceRecolor;
+    }
+
+    vec4 vertex = in_VertexCoord;
+    vec3 normal = in_Normal;
+
+    if (uni_Waves)
+    {
+        float time = uni_WaveParams.x;
+        vertex.y += sin(time * 1.5 + vertex.x * 0.1 * vertex.z * 0.2) * uni_WaveParams.y;
+
+        // the sign of the normal tells which side of the surface is seen
+        normal = vec3(sin(time * 0.50 + vertex.x * 2.1 + vertex.z * 1.1) * uni_WaveParams.z,
+                      in_Normal.y,
+                      sin(time * 0.75 + vertex.x * 2.0 + vertex.z * 1.0) * uni_WaveParams.z);
+    }
+
+    vec4 position = modelMatrix * vertex;
+
+    vec2 offset = position.xz - uni_Curvature.xy;
+    position.y -= dot(offset, offset) * uni_Curvature.z;
+
     vec4 eyeSpace = uni_ViewMatrix * position;
     gl_Position = uni_ProjectionMatrix * eyeSpace;
 
     data.Color = in_Color;
     data.TexCoord0 = in_TexCoord0 * uni_UVScale + uni_UVOffset;
     data.TexCoord1 = in_TexCoord1;
-    data.Normal = normalize(mat3(uni_NormalMatrix) * in_Normal);
-    data.VertexCoord = in_VertexCoord.xyz;
-    data.VertexNormal = in_Normal;
+    data.Normal = normalize(normalMatrix * normal);
+    data.VertexCoord = vertex.xyz;
+    data.VertexNormal = normal;
     data.Position = position.xyz;
     data.ShadowCoords = ProjectShadows(position.xyz);
 }
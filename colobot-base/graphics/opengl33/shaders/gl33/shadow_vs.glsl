@@ -24,9 +24,14 @@ uniform mat4 uni_ProjectionMatrix;
 uniform mat4 uni_ViewMatrix;
 uniform mat4 uni_ModelMatrix;
 
+uniform bool uni_Instanced;
+
 layout(location = 0) in vec4 in_VertexCoord;
 layout(location = 3) in vec2 in_TexCoord0;
 
+// Per-instance model matrix, used only if uni_Instanced is set
+layout(location = 5) in mat4 in_InstanceMatrix;
+
 out VertexData
 {
     vec2 TexCoord;
@@ -34,7 +39,9 @@ out VertexData
 
 void main()
 {
-    gl_Position = uni_ProjectionMatrix * uni_ViewMatrix * uni_ModelMatrix * in_VertexCoord;
+    mat4 modelMatrix = uni_Instanced ? in_InstanceMatrix : uni_ModelMatrix;
+
+    gl_Position = uni_ProjectionMatrix * uni_ViewMatrix * modelMatrix * in_VertexCoord;
 
     data.TexCoord = in_TexCoord0;
 }
@@ -31,7 +31,9 @@
 
 #include "level/parser/parserexceptions.h"
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <exception>
 #include <sstream>
 #include <iomanip>
@@ -157,29 +159,27 @@ void CLevelParser::Load()
 
     char lang = CApplication::GetInstancePointer()->GetLanguageChar();
 
-    std::string line;
+    std::string buffer;
     int lineNumber = 0;
     std::set<std::string> translatableLines;
-    while (getline(file, line))
+    while (getline(file, buffer))
     {
         lineNumber++;
 
-        line = StrUtils::Replace(line, "\t", " "); // replace tab by space
+        std::replace(buffer.begin(), buffer.end(), '\t', ' '); // replace tab by space
 
-        StrUtils::RemoveComments(line);
-
-        StrUtils::Trim(line);
+        // The line is split into views of the buffer, strings are only created for the parts that are kept
+        std::string_view line = StrUtils::TrimView(StrUtils::RemoveCommentsView(buffer));
 
         size_t pos = line.find_first_of(" \t\n");
-        std::string command = line.substr(0, pos);
-        if (pos != std::string::npos)
+        std::string command(line.substr(0, pos));
+        if (pos != std::string_view::npos)
         {
-            line = line.substr(pos + 1);
-            StrUtils::Trim(line);
+            line = StrUtils::TrimView(line.substr(pos + 1));
         }
         else
         {
-            line = "";
+            line = std::string_view();
         }
 
         if (command.empty())
@@ -210,6 +210,7 @@ void CLevelParser::Load()
                             return line->GetCommand() == baseCommand;
                         });
                     m_lines.erase(it, m_lines.end());
+                    m_commandIndex.erase(baseCommand);
                 }
 
                 translatableLines.insert(baseCommand);
@@ -223,30 +224,28 @@ void CLevelParser::Load()
         while (!line.empty())
         {
             pos = line.find_first_of("=");
-            std::string paramName = line.substr(0, pos);
-            StrUtils::Trim(paramName);
-            line = line.substr(pos + 1);
-            StrUtils::Trim(line);
+            std::string_view paramName = StrUtils::TrimView(line.substr(0, pos));
+            line = StrUtils::TrimView(line.substr(pos + 1));
 
-            if (line[0] == '\"')
+            if (!line.empty() && line[0] == '\"')
             {
                 pos = line.find_first_of("\"", 1);
-                if (pos == std::string::npos)
+                if (pos == std::string_view::npos)
                     throw CLevelParserException("Unclosed \" in " + m_filename + ":" + StrUtils::ToString(lineNumber));
             }
-            else if (line[0] == '\'')
+            else if (!line.empty() && line[0] == '\'')
             {
                 pos = line.find_first_of("'", 1);
-                if (pos == std::string::npos)
+                if (pos == std::string_view::npos)
                     throw CLevelParserException("Unclosed ' in " + m_filename + ":" + StrUtils::ToString(lineNumber));
             }
             else
             {
                 pos = line.find_first_of("=");
-                if (pos != std::string::npos)
+                if (pos != std::string_view::npos)
                 {
                     std::size_t pos2 = line.find_last_of(" \t\n", line.find_last_not_of(" \t\n", pos-1));
-                    if (pos2 != std::string::npos)
+                    if (pos2 != std::string_view::npos)
                         pos = pos2;
                 }
                 else
@@ -254,15 +253,14 @@ void CLevelParser::Load()
                     pos = line.length()-1;
                 }
             }
-            std::string paramValue = line.substr(0, pos + 1);
-            StrUtils::Trim(paramValue);
+            std::string_view paramValue = StrUtils::TrimView(line.substr(0, pos + 1));
 
-            parserLine->AddParam(paramName, std::make_unique<CLevelParserParam>(paramName, paramValue));
+            std::string name(paramName);
+            parserLine->AddParam(name, std::make_unique<CLevelParserParam>(name, std::string(paramValue)));
 
-            if (pos == std::string::npos)
+            if (pos == std::string_view::npos)
                 break;
-            line = line.substr(pos + 1);
-            StrUtils::Trim(line);
+            line = StrUtils::TrimView(line.substr(pos + 1));
         }
 
         if (parserLine->GetCommand().length() > 1 && parserLine->GetCommand()[0] == '#')
@@ -346,6 +344,7 @@ const std::string& CLevelParser::GetFilename()
 void CLevelParser::AddLine(CLevelParserLineUPtr line)
 {
     line->SetLevel(this);
+    m_commandIndex[line->GetCommand()].push_back(line.get());
     m_lines.push_back(std::move(line));
 }
 
@@ -359,21 +358,16 @@ CLevelParserLine* CLevelParser::Get(const std::string& command)
 
 CLevelParserLine* CLevelParser::GetIfDefined(const std::string& command)
 {
-    for (auto& line : m_lines)
-    {
-        if (line->GetCommand() == command)
-            return line.get();
-    }
-    return nullptr;
+    auto it = m_commandIndex.find(command);
+    if (it == m_commandIndex.end() || it->second.empty())
+        return nullptr;
+    return it->second.front();
 }
 
 int CLevelParser::CountLines(const std::string& command)
 {
-    int count = 0;
-    for (auto& line : m_lines)
-    {
-        if (line->GetCommand() == command)
-            count++;
-    }
-    return count;
+    auto it = m_commandIndex.find(command);
+    if (it == m_commandIndex.end())
+        return 0;
+    return static_cast<int>(it->second.size());
 }
@@ -34,6 +34,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 class CLevelParser
 {
@@ -95,6 +96,8 @@ public:
 private:
     std::string m_filename;
     std::vector<CLevelParserLineUPtr> m_lines;
+    //! Lines grouped by command, in file order
+    std::unordered_map<std::string, std::vector<CLevelParserLine*>> m_commandIndex;
 
     std::string m_pathCat;
     std::string m_pathChap;
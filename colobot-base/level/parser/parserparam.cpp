@@ -33,6 +33,9 @@
 
 #include "level/parser/parser.h"
 
+#include <string_view>
+#include <unordered_map>
+
 CLevelParserParam::CLevelParserParam(std::string name, std::string value)
   : m_name(name)
   , m_value(value)
@@ -334,216 +337,230 @@ glm::vec3 CLevelParserParam::AsPoint(glm::vec3 def)
 }
 
 
+namespace
+{
+
+//! Names of object types, as used in level files
+const std::unordered_map<std::string_view, ObjectType> OBJECT_TYPE_NAMES =
+{
+    { "All",                OBJECT_NULL }, // For use in NewScript
+    { "Any",                OBJECT_NULL }, // For use in type= in ending conditions
+    { "Portico",            OBJECT_PORTICO },
+    { "SpaceShip",          OBJECT_BASE },
+    { "PracticeBot",        OBJECT_MOBILEwt },
+    { "WingedTrainer",      OBJECT_MOBILEft },
+    { "TrackedTrainer",     OBJECT_MOBILEtt },
+    { "WheeledTrainer",     OBJECT_MOBILEwt },
+    { "LeggedTrainer",      OBJECT_MOBILEit },
+    { "HeavyTrainer",       OBJECT_MOBILErp },
+    { "AmphibiousTrainer",  OBJECT_MOBILEst },
+    { "WingedGrabber",      OBJECT_MOBILEfa },
+    { "TrackedGrabber",     OBJECT_MOBILEta },
+    { "WheeledGrabber",     OBJECT_MOBILEwa },
+    { "LeggedGrabber",      OBJECT_MOBILEia },
+    { "WingedShooter",      OBJECT_MOBILEfc },
+    { "TrackedShooter",     OBJECT_MOBILEtc },
+    { "WheeledShooter",     OBJECT_MOBILEwc },
+    { "LeggedShooter",      OBJECT_MOBILEic },
+    { "WingedOrgaShooter",  OBJECT_MOBILEfi },
+    { "TrackedOrgaShooter", OBJECT_MOBILEti },
+    { "WheeledOrgaShooter", OBJECT_MOBILEwi },
+    { "LeggedOrgaShooter",  OBJECT_MOBILEii },
+    { "WingedSniffer",      OBJECT_MOBILEfs },
+    { "TrackedSniffer",     OBJECT_MOBILEts },
+    { "WheeledSniffer",     OBJECT_MOBILEws },
+    { "LeggedSniffer",      OBJECT_MOBILEis },
+    { "WingedBuilder",      OBJECT_MOBILEfb },
+    { "TrackedBuilder",     OBJECT_MOBILEtb },
+    { "WheeledBuilder",     OBJECT_MOBILEwb },
+    { "LeggedBuilder",      OBJECT_MOBILEib },
+    { "Thumper",            OBJECT_MOBILErt },
+    { "PhazerShooter",      OBJECT_MOBILErc },
+    { "Recycler",           OBJECT_MOBILErr },
+    { "Shielder",           OBJECT_MOBILErs },
+    { "Subber",             OBJECT_MOBILEsa },
+    { "TargetBot",          OBJECT_MOBILEtg },
+    { "Scribbler",          OBJECT_MOBILEdr },
+    { "PowerSpot",          OBJECT_MARKPOWER },
+    { "TitaniumSpot",       OBJECT_MARKSTONE },
+    { "UraniumSpot",        OBJECT_MARKURANIUM },
+    { "PlatinumSpot",       OBJECT_MARKURANIUM },
+    { "KeyASpot",           OBJECT_MARKKEYa },
+    { "KeyBSpot",           OBJECT_MARKKEYb },
+    { "KeyCSpot",           OBJECT_MARKKEYc },
+    { "KeyDSpot",           OBJECT_MARKKEYd },
+    { "WayPoint",           OBJECT_WAYPOINT },
+    { "BlueFlag",           OBJECT_FLAGb },
+    { "RedFlag",            OBJECT_FLAGr },
+    { "GreenFlag",          OBJECT_FLAGg },
+    { "YellowFlag",         OBJECT_FLAGy },
+    { "VioletFlag",         OBJECT_FLAGv },
+    { "PowerCell",          OBJECT_POWER },
+    { "FuelCellPlant",      OBJECT_NUCLEAR },
+    { "FuelCell",           OBJECT_ATOMIC },
+    { "NuclearCell",        OBJECT_ATOMIC },
+    { "TitaniumOre",        OBJECT_STONE },
+    { "UraniumOre",         OBJECT_URANIUM },
+    { "PlatinumOre",        OBJECT_URANIUM },
+    { "Titanium",           OBJECT_METAL },
+    { "OrgaMatter",         OBJECT_BULLET },
+    { "BlackBox",           OBJECT_BBOX },
+    { "KeyA",               OBJECT_KEYa },
+    { "KeyB",               OBJECT_KEYb },
+    { "KeyC",               OBJECT_KEYc },
+    { "KeyD",               OBJECT_KEYd },
+    { "TNT",                OBJECT_TNT },
+    { "Mine",               OBJECT_BOMB },
+    { "Firework",           OBJECT_WINFIRE },
+    { "Bag",                OBJECT_BAG },
+    { "Greenery0",          OBJECT_PLANT0 },
+    { "Greenery1",          OBJECT_PLANT1 },
+    { "Greenery2",          OBJECT_PLANT2 },
+    { "Greenery3",          OBJECT_PLANT3 },
+    { "Greenery4",          OBJECT_PLANT4 },
+    { "Greenery5",          OBJECT_PLANT5 },
+    { "Greenery6",          OBJECT_PLANT6 },
+    { "Greenery7",          OBJECT_PLANT7 },
+    { "Greenery8",          OBJECT_PLANT8 },
+    { "Greenery9",          OBJECT_PLANT9 },
+    { "Greenery10",         OBJECT_PLANT10 },
+    { "Greenery11",         OBJECT_PLANT11 },
+    { "Greenery12",         OBJECT_PLANT12 },
+    { "Greenery13",         OBJECT_PLANT13 },
+    { "Greenery14",         OBJECT_PLANT14 },
+    { "Greenery15",         OBJECT_PLANT15 },
+    { "Greenery16",         OBJECT_PLANT16 },
+    { "Greenery17",         OBJECT_PLANT17 },
+    { "Greenery18",         OBJECT_PLANT18 },
+    { "Greenery19",         OBJECT_PLANT19 },
+    { "Tree0",              OBJECT_TREE0 },
+    { "Tree1",              OBJECT_TREE1 },
+    { "Tree2",              OBJECT_TREE2 },
+    { "Tree3",              OBJECT_TREE3 },
+    { "Tree4",              OBJECT_TREE4 },
+    { "Tree5",              OBJECT_TREE5 },
+    { "Mushroom1",          OBJECT_MUSHROOM1 },
+    { "Mushroom2",          OBJECT_MUSHROOM2 },
+    { "Home",               OBJECT_HOME1 },
+    { "Derrick",            OBJECT_DERRICK },
+    { "BotFactory",         OBJECT_FACTORY },
+    { "PowerStation",       OBJECT_STATION },
+    { "Converter",          OBJECT_CONVERT },
+    { "RepairCenter",       OBJECT_REPAIR },
+    { "Destroyer",          OBJECT_DESTROYER },
+    { "DefenseTower",       OBJECT_TOWER },
+    { "AlienNest",          OBJECT_NEST },
+    { "ResearchCenter",     OBJECT_RESEARCH },
+    { "RadarStation",       OBJECT_RADAR },
+    { "ExchangePost",       OBJECT_INFO },
+    { "PowerPlant",         OBJECT_ENERGY },
+    { "AutoLab",            OBJECT_LABO },
+    { "NuclearPlant",       OBJECT_NUCLEAR },
+    { "PowerCaptor",        OBJECT_PARA },
+    { "Vault",              OBJECT_SAFE },
+    { "Houston",            OBJECT_HUSTON },
+    { "Target1",            OBJECT_TARGET1 },
+    { "Target2",            OBJECT_TARGET2 },
+    { "StartArea",          OBJECT_START },
+    { "GoalArea",           OBJECT_END },
+    { "AlienQueen",         OBJECT_MOTHER },
+    { "AlienEgg",           OBJECT_EGG },
+    { "AlienAnt",           OBJECT_ANT },
+    { "AlienSpider",        OBJECT_SPIDER },
+    { "AlienWasp",          OBJECT_BEE },
+    { "AlienWorm",          OBJECT_WORM },
+    { "WreckBotw1",         OBJECT_RUINmobilew1 },
+    { "WreckBotw2",         OBJECT_RUINmobilew2 },
+    { "WreckBott1",         OBJECT_RUINmobilet1 },
+    { "WreckBott2",         OBJECT_RUINmobilet2 },
+    { "WreckBotr1",         OBJECT_RUINmobiler1 },
+    { "WreckBotr2",         OBJECT_RUINmobiler2 },
+    { "RuinBotFactory",     OBJECT_RUINfactory },
+    { "RuinDoor",           OBJECT_RUINdoor },
+    { "RuinSupport",        OBJECT_RUINsupport },
+    { "RuinRadar",          OBJECT_RUINradar },
+    { "RuinConvert",        OBJECT_RUINconvert },
+    { "RuinBaseCamp",       OBJECT_RUINbase },
+    { "RuinHeadCamp",       OBJECT_RUINhead },
+    { "Barrier0",           OBJECT_BARRIER0 },
+    { "Barrier1",           OBJECT_BARRIER1 },
+    { "Barrier2",           OBJECT_BARRIER2 },
+    { "Barrier3",           OBJECT_BARRIER3 },
+    { "Barricade0",         OBJECT_BARRICADE0 },
+    { "Barricade1",         OBJECT_BARRICADE1 },
+    { "Teen0",              OBJECT_TEEN0 },
+    { "Teen1",              OBJECT_TEEN1 },
+    { "Teen2",              OBJECT_TEEN2 },
+    { "Teen3",              OBJECT_TEEN3 },
+    { "Teen4",              OBJECT_TEEN4 },
+    { "Teen5",              OBJECT_TEEN5 },
+    { "Teen6",              OBJECT_TEEN6 },
+    { "Teen7",              OBJECT_TEEN7 },
+    { "Teen8",              OBJECT_TEEN8 },
+    { "Teen9",              OBJECT_TEEN9 },
+    { "Teen10",             OBJECT_TEEN10 },
+    { "Teen11",             OBJECT_TEEN11 },
+    { "Teen12",             OBJECT_TEEN12 },
+    { "Teen13",             OBJECT_TEEN13 },
+    { "Teen14",             OBJECT_TEEN14 },
+    { "Teen15",             OBJECT_TEEN15 },
+    { "Teen16",             OBJECT_TEEN16 },
+    { "Teen17",             OBJECT_TEEN17 },
+    { "Teen18",             OBJECT_TEEN18 },
+    { "Teen19",             OBJECT_TEEN19 },
+    { "Teen20",             OBJECT_TEEN20 },
+    { "Teen21",             OBJECT_TEEN21 },
+    { "Teen22",             OBJECT_TEEN22 },
+    { "Teen23",             OBJECT_TEEN23 },
+    { "Teen24",             OBJECT_TEEN24 },
+    { "Teen25",             OBJECT_TEEN25 },
+    { "Teen26",             OBJECT_TEEN26 },
+    { "Teen27",             OBJECT_TEEN27 },
+    { "Teen28",             OBJECT_TEEN28 },
+    { "Teen29",             OBJECT_TEEN29 },
+    { "Teen30",             OBJECT_TEEN30 },
+    { "Teen31",             OBJECT_TEEN31 },
+    { "Teen32",             OBJECT_TEEN32 },
+    { "Teen33",             OBJECT_TEEN33 },
+    { "Stone",              OBJECT_TEEN34 },
+    { "Teen35",             OBJECT_TEEN35 },
+    { "Teen36",             OBJECT_TEEN36 },
+    { "Teen37",             OBJECT_TEEN37 },
+    { "Teen38",             OBJECT_TEEN38 },
+    { "Teen39",             OBJECT_TEEN39 },
+    { "Teen40",             OBJECT_TEEN40 },
+    { "Teen41",             OBJECT_TEEN41 },
+    { "Teen42",             OBJECT_TEEN42 },
+    { "Teen43",             OBJECT_TEEN43 },
+    { "Teen44",             OBJECT_TEEN44 },
+    { "Quartz0",            OBJECT_QUARTZ0 },
+    { "Quartz1",            OBJECT_QUARTZ1 },
+    { "Quartz2",            OBJECT_QUARTZ2 },
+    { "Quartz3",            OBJECT_QUARTZ3 },
+    { "MegaStalk0",         OBJECT_ROOT0 },
+    { "MegaStalk1",         OBJECT_ROOT1 },
+    { "MegaStalk2",         OBJECT_ROOT2 },
+    { "MegaStalk3",         OBJECT_ROOT3 },
+    { "MegaStalk4",         OBJECT_ROOT4 },
+    { "MegaStalk5",         OBJECT_ROOT5 },
+    { "ApolloLEM",          OBJECT_APOLLO1 },
+    { "ApolloJeep",         OBJECT_APOLLO2 },
+    { "ApolloFlag",         OBJECT_APOLLO3 },
+    { "ApolloModule",       OBJECT_APOLLO4 },
+    { "ApolloAntenna",      OBJECT_APOLLO5 },
+    { "Me",                 OBJECT_HUMAN },
+    { "Tech",               OBJECT_TECH },
+    { "MissionController",  OBJECT_CONTROLLER },
+};
+
+} // anonymous namespace
+
 ObjectType CLevelParserParam::ToObjectType(std::string value)
 {
-    if (value == "All"               ) return OBJECT_NULL; // For use in NewScript
-    if (value == "Any"               ) return OBJECT_NULL; // For use in type= in ending conditions
-    if (value == "Portico"           ) return OBJECT_PORTICO;
-    if (value == "SpaceShip"         ) return OBJECT_BASE;
-    if (value == "PracticeBot"       ) return OBJECT_MOBILEwt;
-    if (value == "WingedTrainer"     ) return OBJECT_MOBILEft;
-    if (value == "TrackedTrainer"    ) return OBJECT_MOBILEtt;
-    if (value == "WheeledTrainer"    ) return OBJECT_MOBILEwt;
-    if (value == "LeggedTrainer"     ) return OBJECT_MOBILEit;
-    if (value == "HeavyTrainer"      ) return OBJECT_MOBILErp;
-    if (value == "AmphibiousTrainer" ) return OBJECT_MOBILEst;
-    if (value == "WingedGrabber"     ) return OBJECT_MOBILEfa;
-    if (value == "TrackedGrabber"    ) return OBJECT_MOBILEta;
-    if (value == "WheeledGrabber"    ) return OBJECT_MOBILEwa;
-    if (value == "LeggedGrabber"     ) return OBJECT_MOBILEia;
-    if (value == "WingedShooter"     ) return OBJECT_MOBILEfc;
-    if (value == "TrackedShooter"    ) return OBJECT_MOBILEtc;
-    if (value == "WheeledShooter"    ) return OBJECT_MOBILEwc;
-    if (value == "LeggedShooter"     ) return OBJECT_MOBILEic;
-    if (value == "WingedOrgaShooter" ) return OBJECT_MOBILEfi;
-    if (value == "TrackedOrgaShooter") return OBJECT_MOBILEti;
-    if (value == "WheeledOrgaShooter") return OBJECT_MOBILEwi;
-    if (value == "LeggedOrgaShooter" ) return OBJECT_MOBILEii;
-    if (value == "WingedSniffer"     ) return OBJECT_MOBILEfs;
-    if (value == "TrackedSniffer"    ) return OBJECT_MOBILEts;
-    if (value == "WheeledSniffer"    ) return OBJECT_MOBILEws;
-    if (value == "LeggedSniffer"     ) return OBJECT_MOBILEis;
-    if (value == "WingedBuilder"     ) return OBJECT_MOBILEfb;
-    if (value == "TrackedBuilder"    ) return OBJECT_MOBILEtb;
-    if (value == "WheeledBuilder"    ) return OBJECT_MOBILEwb;
-    if (value == "LeggedBuilder"     ) return OBJECT_MOBILEib;
-    if (value == "Thumper"           ) return OBJECT_MOBILErt;
-    if (value == "PhazerShooter"     ) return OBJECT_MOBILErc;
-    if (value == "Recycler"          ) return OBJECT_MOBILErr;
-    if (value == "Shielder"          ) return OBJECT_MOBILErs;
-    if (value == "Subber"            ) return OBJECT_MOBILEsa;
-    if (value == "TargetBot"         ) return OBJECT_MOBILEtg;
-    if (value == "Scribbler"         ) return OBJECT_MOBILEdr;
-    if (value == "PowerSpot"         ) return OBJECT_MARKPOWER;
-    if (value == "TitaniumSpot"      ) return OBJECT_MARKSTONE;
-    if (value == "UraniumSpot"       ) return OBJECT_MARKURANIUM;
-    if (value == "PlatinumSpot"      ) return OBJECT_MARKURANIUM;
-    if (value == "KeyASpot"          ) return OBJECT_MARKKEYa;
-    if (value == "KeyBSpot"          ) return OBJECT_MARKKEYb;
-    if (value == "KeyCSpot"          ) return OBJECT_MARKKEYc;
-    if (value == "KeyDSpot"          ) return OBJECT_MARKKEYd;
-    if (value == "WayPoint"          ) return OBJECT_WAYPOINT;
-    if (value == "BlueFlag"          ) return OBJECT_FLAGb;
-    if (value == "RedFlag"           ) return OBJECT_FLAGr;
-    if (value == "GreenFlag"         ) return OBJECT_FLAGg;
-    if (value == "YellowFlag"        ) return OBJECT_FLAGy;
-    if (value == "VioletFlag"        ) return OBJECT_FLAGv;
-    if (value == "PowerCell"         ) return OBJECT_POWER;
-    if (value == "FuelCellPlant"     ) return OBJECT_NUCLEAR;
-    if (value == "FuelCell"          ) return OBJECT_ATOMIC;
-    if (value == "NuclearCell"       ) return OBJECT_ATOMIC;
-    if (value == "TitaniumOre"       ) return OBJECT_STONE;
-    if (value == "UraniumOre"        ) return OBJECT_URANIUM;
-    if (value == "PlatinumOre"       ) return OBJECT_URANIUM;
-    if (value == "Titanium"          ) return OBJECT_METAL;
-    if (value == "OrgaMatter"        ) return OBJECT_BULLET;
-    if (value == "BlackBox"          ) return OBJECT_BBOX;
-    if (value == "KeyA"              ) return OBJECT_KEYa;
-    if (value == "KeyB"              ) return OBJECT_KEYb;
-    if (value == "KeyC"              ) return OBJECT_KEYc;
-    if (value == "KeyD"              ) return OBJECT_KEYd;
-    if (value == "TNT"               ) return OBJECT_TNT;
-    if (value == "Mine"              ) return OBJECT_BOMB;
-    if (value == "Firework"          ) return OBJECT_WINFIRE;
-    if (value == "Bag"               ) return OBJECT_BAG;
-    if (value == "Greenery0"         ) return OBJECT_PLANT0;
-    if (value == "Greenery1"         ) return OBJECT_PLANT1;
-    if (value == "Greenery2"         ) return OBJECT_PLANT2;
-    if (value == "Greenery3"         ) return OBJECT_PLANT3;
-    if (value == "Greenery4"         ) return OBJECT_PLANT4;
-    if (value == "Greenery5"         ) return OBJECT_PLANT5;
-    if (value == "Greenery6"         ) return OBJECT_PLANT6;
-    if (value == "Greenery7"         ) return OBJECT_PLANT7;
-    if (value == "Greenery8"         ) return OBJECT_PLANT8;
-    if (value == "Greenery9"         ) return OBJECT_PLANT9;
-    if (value == "Greenery10"        ) return OBJECT_PLANT10;
-    if (value == "Greenery11"        ) return OBJECT_PLANT11;
-    if (value == "Greenery12"        ) return OBJECT_PLANT12;
-    if (value == "Greenery13"        ) return OBJECT_PLANT13;
-    if (value == "Greenery14"        ) return OBJECT_PLANT14;
-    if (value == "Greenery15"        ) return OBJECT_PLANT15;
-    if (value == "Greenery16"        ) return OBJECT_PLANT16;
-    if (value == "Greenery17"        ) return OBJECT_PLANT17;
-    if (value == "Greenery18"        ) return OBJECT_PLANT18;
-    if (value == "Greenery19"        ) return OBJECT_PLANT19;
-    if (value == "Tree0"             ) return OBJECT_TREE0;
-    if (value == "Tree1"             ) return OBJECT_TREE1;
-    if (value == "Tree2"             ) return OBJECT_TREE2;
-    if (value == "Tree3"             ) return OBJECT_TREE3;
-    if (value == "Tree4"             ) return OBJECT_TREE4;
-    if (value == "Tree5"             ) return OBJECT_TREE5;
-    if (value == "Mushroom1"         ) return OBJECT_MUSHROOM1;
-    if (value == "Mushroom2"         ) return OBJECT_MUSHROOM2;
-    if (value == "Home"              ) return OBJECT_HOME1;
-    if (value == "Derrick"           ) return OBJECT_DERRICK;
-    if (value == "BotFactory"        ) return OBJECT_FACTORY;
-    if (value == "PowerStation"      ) return OBJECT_STATION;
-    if (value == "Converter"         ) return OBJECT_CONVERT;
-    if (value == "RepairCenter"      ) return OBJECT_REPAIR;
-    if (value == "Destroyer"         ) return OBJECT_DESTROYER;
-    if (value == "DefenseTower"      ) return OBJECT_TOWER;
-    if (value == "AlienNest"         ) return OBJECT_NEST;
-    if (value == "ResearchCenter"    ) return OBJECT_RESEARCH;
-    if (value == "RadarStation"      ) return OBJECT_RADAR;
-    if (value == "ExchangePost"      ) return OBJECT_INFO;
-    if (value == "PowerPlant"        ) return OBJECT_ENERGY;
-    if (value == "AutoLab"           ) return OBJECT_LABO;
-    if (value == "NuclearPlant"      ) return OBJECT_NUCLEAR;
-    if (value == "PowerCaptor"       ) return OBJECT_PARA;
-    if (value == "Vault"             ) return OBJECT_SAFE;
-    if (value == "Houston"           ) return OBJECT_HUSTON;
-    if (value == "Target1"           ) return OBJECT_TARGET1;
-    if (value == "Target2"           ) return OBJECT_TARGET2;
-    if (value == "StartArea"         ) return OBJECT_START;
-    if (value == "GoalArea"          ) return OBJECT_END;
-    if (value == "AlienQueen"        ) return OBJECT_MOTHER;
-    if (value == "AlienEgg"          ) return OBJECT_EGG;
-    if (value == "AlienAnt"          ) return OBJECT_ANT;
-    if (value == "AlienSpider"       ) return OBJECT_SPIDER;
-    if (value == "AlienWasp"         ) return OBJECT_BEE;
-    if (value == "AlienWorm"         ) return OBJECT_WORM;
-    if (value == "WreckBotw1"        ) return OBJECT_RUINmobilew1;
-    if (value == "WreckBotw2"        ) return OBJECT_RUINmobilew2;
-    if (value == "WreckBott1"        ) return OBJECT_RUINmobilet1;
-    if (value == "WreckBott2"        ) return OBJECT_RUINmobilet2;
-    if (value == "WreckBotr1"        ) return OBJECT_RUINmobiler1;
-    if (value == "WreckBotr2"        ) return OBJECT_RUINmobiler2;
-    if (value == "RuinBotFactory"    ) return OBJECT_RUINfactory;
-    if (value == "RuinDoor"          ) return OBJECT_RUINdoor;
-    if (value == "RuinSupport"       ) return OBJECT_RUINsupport;
-    if (value == "RuinRadar"         ) return OBJECT_RUINradar;
-    if (value == "RuinConvert"       ) return OBJECT_RUINconvert;
-    if (value == "RuinBaseCamp"      ) return OBJECT_RUINbase;
-    if (value == "RuinHeadCamp"      ) return OBJECT_RUINhead;
-    if (value == "Barrier0"          ) return OBJECT_BARRIER0;
-    if (value == "Barrier1"          ) return OBJECT_BARRIER1;
-    if (value == "Barrier2"          ) return OBJECT_BARRIER2;
-    if (value == "Barrier3"          ) return OBJECT_BARRIER3;
-    if (value == "Barricade0"        ) return OBJECT_BARRICADE0;
-    if (value == "Barricade1"        ) return OBJECT_BARRICADE1;
-    if (value == "Teen0"             ) return OBJECT_TEEN0;
-    if (value == "Teen1"             ) return OBJECT_TEEN1;
-    if (value == "Teen2"             ) return OBJECT_TEEN2;
-    if (value == "Teen3"             ) return OBJECT_TEEN3;
-    if (value == "Teen4"             ) return OBJECT_TEEN4;
-    if (value == "Teen5"             ) return OBJECT_TEEN5;
-    if (value == "Teen6"             ) return OBJECT_TEEN6;
-    if (value == "Teen7"             ) return OBJECT_TEEN7;
-    if (value == "Teen8"             ) return OBJECT_TEEN8;
-    if (value == "Teen9"             ) return OBJECT_TEEN9;
-    if (value == "Teen10"            ) return OBJECT_TEEN10;
-    if (value == "Teen11"            ) return OBJECT_TEEN11;
-    if (value == "Teen12"            ) return OBJECT_TEEN12;
-    if (value == "Teen13"            ) return OBJECT_TEEN13;
-    if (value == "Teen14"            ) return OBJECT_TEEN14;
-    if (value == "Teen15"            ) return OBJECT_TEEN15;
-    if (value == "Teen16"            ) return OBJECT_TEEN16;
-    if (value == "Teen17"            ) return OBJECT_TEEN17;
-    if (value == "Teen18"            ) return OBJECT_TEEN18;
-    if (value == "Teen19"            ) return OBJECT_TEEN19;
-    if (value == "Teen20"            ) return OBJECT_TEEN20;
-    if (value == "Teen21"            ) return OBJECT_TEEN21;
-    if (value == "Teen22"            ) return OBJECT_TEEN22;
-    if (value == "Teen23"            ) return OBJECT_TEEN23;
-    if (value == "Teen24"            ) return OBJECT_TEEN24;
-    if (value == "Teen25"            ) return OBJECT_TEEN25;
-    if (value == "Teen26"            ) return OBJECT_TEEN26;
-    if (value == "Teen27"            ) return OBJECT_TEEN27;
-    if (value == "Teen28"            ) return OBJECT_TEEN28;
-    if (value == "Teen29"            ) return OBJECT_TEEN29;
-    if (value == "Teen30"            ) return OBJECT_TEEN30;
-    if (value == "Teen31"            ) return OBJECT_TEEN31;
-    if (value == "Teen32"            ) return OBJECT_TEEN32;
-    if (value == "Teen33"            ) return OBJECT_TEEN33;
-    if (value == "Stone"             ) return OBJECT_TEEN34;
-    if (value == "Teen35"            ) return OBJECT_TEEN35;
-    if (value == "Teen36"            ) return OBJECT_TEEN36;
-    if (value == "Teen37"            ) return OBJECT_TEEN37;
-    if (value == "Teen38"            ) return OBJECT_TEEN38;
-    if (value == "Teen39"            ) return OBJECT_TEEN39;
-    if (value == "Teen40"            ) return OBJECT_TEEN40;
-    if (value == "Teen41"            ) return OBJECT_TEEN41;
-    if (value == "Teen42"            ) return OBJECT_TEEN42;
-    if (value == "Teen43"            ) return OBJECT_TEEN43;
-    if (value == "Teen44"            ) return OBJECT_TEEN44;
-    if (value == "Quartz0"           ) return OBJECT_QUARTZ0;
-    if (value == "Quartz1"           ) return OBJECT_QUARTZ1;
-    if (value == "Quartz2"           ) return OBJECT_QUARTZ2;
-    if (value == "Quartz3"           ) return OBJECT_QUARTZ3;
-    if (value == "MegaStalk0"        ) return OBJECT_ROOT0;
-    if (value == "MegaStalk1"        ) return OBJECT_ROOT1;
-    if (value == "MegaStalk2"        ) return OBJECT_ROOT2;
-    if (value == "MegaStalk3"        ) return OBJECT_ROOT3;
-    if (value == "MegaStalk4"        ) return OBJECT_ROOT4;
-    if (value == "MegaStalk5"        ) return OBJECT_ROOT5;
-    if (value == "ApolloLEM"         ) return OBJECT_APOLLO1;
-    if (value == "ApolloJeep"        ) return OBJECT_APOLLO2;
-    if (value == "ApolloFlag"        ) return OBJECT_APOLLO3;
-    if (value == "ApolloModule"      ) return OBJECT_APOLLO4;
-    if (value == "ApolloAntenna"     ) return OBJECT_APOLLO5;
-    if (value == "Me"                ) return OBJECT_HUMAN;
-    if (value == "Tech"              ) return OBJECT_TECH;
-    if (value == "MissionController" ) return OBJECT_CONTROLLER;
+    auto it = OBJECT_TYPE_NAMES.find(value);
+    if (it != OBJECT_TYPE_NAMES.end())
+        return it->second;
+
     return static_cast<ObjectType>(Cast<int>(value, "object"));
 }
 
@@ -768,15 +785,29 @@ ObjectType CLevelParserParam::AsObjectType(ObjectType def)
 }
 
 
+namespace
+{
+
+//! Names of drive types, as used in level files
+const std::unordered_map<std::string_view, DriveType> DRIVE_TYPE_NAMES =
+{
+    { "Wheeled",    DriveType::Wheeled },
+    { "Tracked",    DriveType::Tracked },
+    { "Winged",     DriveType::Winged },
+    { "Legged",     DriveType::Legged },
+    { "Heavy",      DriveType::Heavy },
+    { "Amphibious", DriveType::Amphibious },
+    { "Other",      DriveType::Other },
+};
+
+} // anonymous namespace
+
 DriveType CLevelParserParam::ToDriveType(std::string value)
 {
-    if (value == "Wheeled"   ) return DriveType::Wheeled;
-    if (value == "Tracked"   ) return DriveType::Tracked;
-    if (value == "Winged"    ) return DriveType::Winged;
-    if (value == "Legged"    ) return DriveType::Legged;
-    if (value == "Heavy"     ) return DriveType::Heavy;
-    if (value == "Amphibious") return DriveType::Amphibious;
-    if (value == "Other"     ) return DriveType::Other;
+    auto it = DRIVE_TYPE_NAMES.find(value);
+    if (it != DRIVE_TYPE_NAMES.end())
+        return it->second;
+
     return static_cast<DriveType>(Cast<int>(value, "drive"));
 }
 
@@ -795,14 +826,28 @@ DriveType CLevelParserParam::AsDriveType(DriveType def)
 }
 
 
+namespace
+{
+
+//! Names of tool types, as used in level files
+const std::unordered_map<std::string_view, ToolType> TOOL_TYPE_NAMES =
+{
+    { "Grabber",     ToolType::Grabber },
+    { "Sniffer",     ToolType::Sniffer },
+    { "Shooter",     ToolType::Shooter },
+    { "OrgaShooter", ToolType::OrganicShooter },
+    { "Builder",     ToolType::Builder },
+    { "Other",       ToolType::Other },
+};
+
+} // anonymous namespace
+
 ToolType CLevelParserParam::ToToolType(std::string value)
 {
-    if (value == "Grabber"    ) return ToolType::Grabber;
-    if (value == "Sniffer"    ) return ToolType::Sniffer;
-    if (value == "Shooter"    ) return ToolType::Shooter;
-    if (value == "OrgaShooter") return ToolType::OrganicShooter;
-    if (value == "Builder"    ) return ToolType::Builder;
-    if (value == "Other"      ) return ToolType::Other;
+    auto it = TOOL_TYPE_NAMES.find(value);
+    if (it != TOOL_TYPE_NAMES.end())
+        return it->second;
+
     return static_cast<ToolType>(Cast<int>(value, "tool"));
 }
 
@@ -31,12 +31,15 @@
 #include "common/restext.h"
 #include "common/settings.h"
 #include "common/stringutils.h"
+#include "common/timeutils.h"
 #include "common/version.h"
 
 #include "common/resources/inputstream.h"
 #include "common/resources/outputstream.h"
 #include "common/resources/resourcemanager.h"
 
+#include "common/thread/worker_pool.h"
+
 #include "graphics/core/material.h"
 
 #include "graphics/engine/camera.h"
@@ -86,6 +89,7 @@
 #include "physics/physics.h"
 
 #include "script/cbottoken.h"
+#include "script/scheduler.h"
 #include "script/script.h"
 #include "script/scriptfunc.h"
 
@@ -154,6 +158,7 @@ CRobotMain::CRobotMain()
     m_modelManager = std::make_unique<Gfx::CModelManager>();
     m_settings    = std::make_unique<CSettings>();
     m_pause       = std::make_unique<CPauseManager>();
+    m_scriptScheduler = std::make_unique<CScriptScheduler>();
     m_interface   = std::make_unique<Ui::CInterface>();
     m_terrain     = std::make_unique<Gfx::CTerrain>();
     m_camera      = std::make_unique<Gfx::CCamera>();
@@ -310,6 +315,11 @@ CPauseManager* CRobotMain::GetPauseManager()
     return m_pause.get();
 }
 
+CScriptScheduler* CRobotMain::GetScriptScheduler()
+{
+    return m_scriptScheduler.get();
+}
+
 std::string PhaseToString(Phase phase)
 {
     if (phase == PHASE_WELCOME1) return "PHASE_WELCOME1";
@@ -2397,6 +2407,8 @@ bool CRobotMain::EventFrame(const Event &event)
     CObject* toto = nullptr;
     if (!m_pause->IsPauseType(PAUSE_OBJECT_UPDATES))
     {
+        m_scriptScheduler->BeginFrame();
+
         // Advances all the robots, but not toto.
         for (CObject* obj : m_objMan->GetAllObjects())
         {
@@ -2836,15 +2848,42 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
     {
         m_ui->GetLoadingScreen()->SetProgress(0.05f, RT_LOADING_PROCESSING);
         GetLogger()->Info("Loading level: %s\n", m_levelFile.c_str());
+        TimeUtils::TimeStamp loadStart = std::chrono::high_resolution_clock::now();
         CLevelParser levelParser(m_levelFile);
         levelParser.SetLevelPaths(m_levelCategory, m_levelChap, m_levelRank);
         levelParser.Load();
+        TimeUtils::TimeStamp parseEnd = std::chrono::high_resolution_clock::now();
+        TimeUtils::TimeStamp sceneEnd = parseEnd;
+        bool objectsBegun = false;
         int numObjects = levelParser.CountLines("CreateObject");
         m_ui->GetLoadingScreen()->SetProgress(0.1f, RT_LOADING_LEVEL_SETTINGS);
 
+        // Decode the terrain images and read the models of the last load of this level in parallel
+        std::string modelListFile = "cache/" + m_levelFile + ".models";
+        {
+            CWorkerPool pool;
+
+            if (!resetObject)
+            {
+                std::vector<std::string> images;
+                for (auto& line : levelParser.GetLines())
+                {
+                    if (line->GetCommand() == "TerrainRelief" || line->GetCommand() == "TerrainResource")
+                        images.push_back(line->GetParam("image")->AsPath("textures"));
+                }
+                m_terrain->PreloadImages(images, pool);
+            }
+
+            m_oldModelManager->PreloadModels(modelListFile, pool);
+            pool.Wait();
+        }
+
         int rankObj = 0;
         CObject* sel = nullptr;
 
+        // The programs of the objects are compiled together once they are all created
+        CScript::BeginCompileBatch();
+
         for (auto& line : levelParser.GetLines())
         {
             if (line->GetCommand() == "Title" && !resetObject)
@@ -3370,6 +3409,8 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
 
             if (line->GetCommand() == "BeginObject")
             {
+                sceneEnd = std::chrono::high_resolution_clock::now();
+                objectsBegun = true;
                 InitEye();
                 SetMovieLock(false);
 
@@ -3768,6 +3809,19 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
             throw CLevelParserException("Unknown command: '" + line->GetCommand() + "' in " + line->GetLevelFilename() + ":" + StrUtils::ToString(line->GetLineNumber()));
         }
 
+        CScript::EndCompileBatch();
+
+        m_oldModelManager->ClearPreloadedModels();
+        m_oldModelManager->WriteModelList(modelListFile);
+
+        TimeUtils::TimeStamp objectsEnd = std::chrono::high_resolution_clock::now();
+        if (!objectsBegun)
+            sceneEnd = objectsEnd;  // no objects, all the time went to the scene
+
+        // Textures of the objects were decoded in the background, make sure they are all there
+        m_engine->UpdateTextureStreaming(true);
+        m_engine->TrimTextureCache();
+
         // Do this here to prevent the first frame from taking a long time to render
         m_engine->UpdateGroundSpotTextures();
 
@@ -3788,6 +3842,14 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
                                     backgroundFull);
         }
 
+        TimeUtils::TimeStamp loadEnd = std::chrono::high_resolution_clock::now();
+        GetLogger()->Info("Level loaded in %.2f ms (parse %.2f ms, scene %.2f ms, objects %.2f ms, finish %.2f ms)\n",
+                          TimeUtils::Diff(loadStart, loadEnd, TimeUtils::TimeUnit::MILLISECONDS),
+                          TimeUtils::Diff(loadStart, parseEnd, TimeUtils::TimeUnit::MILLISECONDS),
+                          TimeUtils::Diff(parseEnd, sceneEnd, TimeUtils::TimeUnit::MILLISECONDS),
+                          TimeUtils::Diff(sceneEnd, objectsEnd, TimeUtils::TimeUnit::MILLISECONDS),
+                          TimeUtils::Diff(objectsEnd, loadEnd, TimeUtils::TimeUnit::MILLISECONDS));
+
         if (m_levelCategory == LevelCategory::Missions && !resetObject)  // mission?
         {
             m_playerProfile->SetFreeGameResearchUnlock(m_playerProfile->GetFreeGameResearchUnlock() | m_researchDone[0]);
@@ -3869,6 +3931,7 @@ void CRobotMain::CreateScene(bool soluce, bool fixScene, bool resetObject)
     }
     catch (...)
     {
+        CScript::EndCompileBatch();
         m_sceneReadPath = "";
         throw;
     }
@@ -3921,6 +3984,7 @@ int CRobotMain::CreateSpot(glm::vec3 pos, Gfx::Color color)
 {
     if (!m_engine->GetLightMode()) return -1;
 
+    float height = pos.y;
     pos.y += m_terrain->GetFloorLevel(pos);
 
     Gfx::Light light;
@@ -3934,6 +3998,7 @@ int CRobotMain::CreateSpot(glm::vec3 pos, Gfx::Color color)
     light.attenuation0  = 2.0f;
     light.attenuation1  = 0.0f;
     light.attenuation2  = 0.0f;
+    light.range         = Gfx::CLightManager::GetSpotRange(light, height);
     int obj = m_lightMan->CreateLight(Gfx::LIGHT_PRI_HIGH);
     m_lightMan->SetLight(obj, light);
 
@@ -5002,6 +5067,9 @@ CObject* CRobotMain::IOReadScene(std::string filename, std::string filecbot)
 
     m_ui->GetLoadingScreen()->SetProgress(0.95f, RT_LOADING_CBOT_SAVE);
 
+    // The stacks are restored into compiled programs
+    CScript::EndCompileBatch();
+
     // Reads the file of stacks of execution.
     CInputStream istr(filecbot);
 
@@ -97,6 +97,7 @@ class CPlayerProfile;
 class CSettings;
 class COldObject;
 class CPauseManager;
+class CScriptScheduler;
 struct ActivePause;
 
 namespace Gfx
@@ -193,6 +194,7 @@ public:
     Ui::CInterface* GetInterface();
     Ui::CDisplayText* GetDisplayText();
     CPauseManager* GetPauseManager();
+    CScriptScheduler* GetScriptScheduler();
 
     /**
      * \name Phase management
@@ -584,6 +586,7 @@ protected:
     std::unique_ptr<CObjectManager> m_objMan;
     std::unique_ptr<CMainMovie> m_movie;
     std::unique_ptr<CPauseManager> m_pause;
+    std::unique_ptr<CScriptScheduler> m_scriptScheduler;
     std::unique_ptr<Gfx::CModelManager> m_modelManager;
     std::unique_ptr<Gfx::CTerrain> m_terrain;
     std::unique_ptr<Gfx::CCamera> m_camera;
@@ -593,6 +593,71 @@ inline bool IntersectY(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &
     return true;
 }
 
+//! Calculates the intersection of the ray from \a origin along \a dir with the triangle abc
+/**
+ * Both faces of the triangle are hit.
+ * \param t  distance to the intersection, in lengths of \a dir
+ * \returns true if the ray hits the triangle in front of \a origin
+ */
+inline bool IntersectRay(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c,
+                         const glm::vec3 &origin, const glm::vec3 &dir, float &t)
+{
+    glm::vec3 edge1 = b - a;
+    glm::vec3 edge2 = c - a;
+
+    glm::vec3 p = glm::cross(dir, edge2);
+    float det = glm::dot(edge1, p);
+    if (det == 0.0f)
+        return false;
+
+    float invDet = 1.0f / det;
+
+    glm::vec3 s = origin - a;
+    float u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    glm::vec3 q = glm::cross(s, edge1);
+    float v = glm::dot(dir, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    t = glm::dot(edge2, q) * invDet;
+    return t >= 0.0f;
+}
+
+//! Clips the ray from \a origin along \a dir to the box \a min - \a max
+/**
+ * \param tNear,tFar  part of the ray to test, in lengths of \a dir; reduced to the part inside the box
+ * \returns true if this part of the ray crosses the box
+ */
+inline bool IntersectRayBox(const glm::vec3 &min, const glm::vec3 &max,
+                            const glm::vec3 &origin, const glm::vec3 &dir, float &tNear, float &tFar)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (dir[i] == 0.0f)
+        {
+            if (origin[i] < min[i] || origin[i] > max[i])
+                return false;
+
+            continue;
+        }
+
+        float t1 = (min[i] - origin[i]) / dir[i];
+        float t2 = (max[i] - origin[i]) / dir[i];
+        if (t1 > t2)
+            std::swap(t1, t2);
+
+        tNear = Math::Max(tNear, t1);
+        tFar  = Math::Min(tFar, t2);
+        if (tNear > tFar)
+            return false;
+    }
+
+    return true;
+}
+
 //! Calculates the end point
 inline glm::vec3 LookatPoint(const glm::vec3 &eye, float angleH, float angleV, float length)
 {
@@ -39,6 +39,7 @@
 
 #include "physics/physics.h"
 
+#include "script/scheduler.h"
 #include "script/script.h"
 
 #include "ui/controls/edit.h"
@@ -78,7 +79,10 @@ bool CProgrammableObjectImpl::EventProcess(const Event &event)
             CProfiler::StartPerformanceCounter(PCNT_UPDATE_CBOT);
             if ( IsProgram() )  // current program?
             {
-                if ( m_currentProgram->script->Continue() )
+                bool selected = m_object->Implements(ObjectInterfaceType::Controllable) &&
+                                dynamic_cast<CControllableObject&>(*m_object).GetSelect();
+                CScriptScheduler* scheduler = CRobotMain::GetInstancePointer()->GetScriptScheduler();
+                if ( scheduler->Continue(m_currentProgram->script.get(), selected) )
                 {
                     StopProgram();
                 }
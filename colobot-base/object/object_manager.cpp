@@ -31,9 +31,34 @@
 
 #include "object/auto/auto.h"
 
+#include "object/subclass/shielder.h"
+
 #include "physics/physics.h"
 
 #include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+//! Horizontal size of the cells of the spatial index
+const float INDEX_CELL_SIZE = 16.0f;
+//! Objects and queries spanning more cells in one direction don't use the cells
+const int INDEX_MAX_CELLS = 8;
+//! Margin around the position of an object in the spatial index
+const float INDEX_MARGIN = 4.0f;
+
+int IndexCell(float coord)
+{
+    return static_cast<int>(std::floor(coord / INDEX_CELL_SIZE));
+}
+
+long long IndexKey(int x, int z)
+{
+    return (static_cast<long long>(x) << 32) ^ static_cast<unsigned int>(z);
+}
+
+} // namespace
 
 CObjectManager::CObjectManager(Gfx::CEngine* engine,
                                Gfx::CTerrain* terrain,
@@ -69,6 +94,7 @@ bool CObjectManager::DeleteObject(CObject* instance)
     {
         it->second.reset();
         m_shouldCleanRemovedObjects = true;
+        m_indexValid = false;
         return true;
     } else assert(false);
 
@@ -107,6 +133,7 @@ void CObjectManager::DeleteAllObjects()
     }
 
     m_objects.clear();
+    m_indexValid = false;
 
     m_nextId = 0;
 }
@@ -153,6 +180,7 @@ CObject* CObjectManager::CreateObject(ObjectCreateParams params)
     CObject* objectPtr = objectUPtr.get();
 
     m_objects[params.id] = std::move(objectUPtr);
+    m_indexValid = false;
 
     return objectPtr;
 }
@@ -462,3 +490,107 @@ CObject*  CObjectManager::FindNearest(CObject* pThis, glm::vec3 thisPosition, st
 {
     return Radar(pThis, thisPosition, 0.0f, type, 0.0f, Math::PI*2.0f, 0.0f, maxDist, false, FILTER_NONE, cbotTypes);
 }
+
+void CObjectManager::UpdateSpatialIndex()
+{
+    m_indexEntries.clear();
+    m_indexCells.clear();
+    m_indexLarge.clear();
+
+    for (CObject* obj : GetAllObjects())
+    {
+        IndexEntry entry;
+        entry.object = obj;
+        entry.min = obj->GetPosition() - glm::vec3(INDEX_MARGIN);
+        entry.max = obj->GetPosition() + glm::vec3(INDEX_MARGIN);
+        entry.stamp = 0;
+
+        for (const auto& crashSphere : obj->GetAllCrashSpheres())
+        {
+            glm::vec3 radius(crashSphere.sphere.radius);
+            entry.min = glm::min(entry.min, crashSphere.sphere.pos - radius);
+            entry.max = glm::max(entry.max, crashSphere.sphere.pos + radius);
+        }
+
+        if (obj->GetType() == OBJECT_MOBILErs)
+        {
+            glm::vec3 radius(dynamic_cast<CShielder&>(*obj).GetActiveShieldRadius());
+            entry.min = glm::min(entry.min, obj->GetPosition() - radius);
+            entry.max = glm::max(entry.max, obj->GetPosition() + radius);
+        }
+
+        int rank = static_cast<int>(m_indexEntries.size());
+        m_indexEntries.push_back(entry);
+
+        int x1 = IndexCell(entry.min.x), x2 = IndexCell(entry.max.x);
+        int z1 = IndexCell(entry.min.z), z2 = IndexCell(entry.max.z);
+        if (x2 - x1 >= INDEX_MAX_CELLS || z2 - z1 >= INDEX_MAX_CELLS)
+        {
+            m_indexLarge.push_back(rank);
+            continue;
+        }
+
+        for (int x = x1; x <= x2; x++)
+        {
+            for (int z = z1; z <= z2; z++)
+            {
+                m_indexCells[IndexKey(x, z)].push_back(rank);
+            }
+        }
+    }
+
+    m_indexStamp = 0;
+    m_indexValid = true;
+}
+
+void CObjectManager::GetObjectsInBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<CObject*>& result)
+{
+    result.clear();
+
+    if (!m_indexValid)
+        UpdateSpatialIndex();
+
+    m_indexStamp++;
+    m_indexFound.clear();
+
+    auto test = [&](int rank)
+    {
+        IndexEntry& entry = m_indexEntries[rank];
+        if (entry.stamp == m_indexStamp)  return;  // already seen in another cell
+        entry.stamp = m_indexStamp;
+
+        if ( entry.max.x < boxMin.x || entry.min.x > boxMax.x ||
+             entry.max.y < boxMin.y || entry.min.y > boxMax.y ||
+             entry.max.z < boxMin.z || entry.min.z > boxMax.z )  return;
+
+        m_indexFound.push_back(rank);
+    };
+
+    int x1 = IndexCell(boxMin.x), x2 = IndexCell(boxMax.x);
+    int z1 = IndexCell(boxMin.z), z2 = IndexCell(boxMax.z);
+    if (x2 - x1 >= INDEX_MAX_CELLS || z2 - z1 >= INDEX_MAX_CELLS)
+    {
+        for (int rank = 0; rank < static_cast<int>(m_indexEntries.size()); rank++)
+            test(rank);
+    }
+    else
+    {
+        for (int x = x1; x <= x2; x++)
+        {
+            for (int z = z1; z <= z2; z++)
+            {
+                auto it = m_indexCells.find(IndexKey(x, z));
+                if (it == m_indexCells.end())  continue;
+                for (int rank : it->second)
+                    test(rank);
+            }
+        }
+        for (int rank : m_indexLarge)
+            test(rank);
+    }
+
+    // the ranks follow the order of GetAllObjects()
+    std::sort(m_indexFound.begin(), m_indexFound.end());
+    for (int rank : m_indexFound)
+        result.push_back(m_indexEntries[rank].object);
+}
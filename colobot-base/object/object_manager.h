@@ -37,6 +37,7 @@
 #include <glm/glm.hpp>
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -303,6 +304,26 @@ public:
                           bool cbotTypes = false);
     //@}
 
+    //! Spatial queries
+    //@{
+    /**
+     * \brief Builds the spatial index used by GetObjectsInBox()
+     *
+     * The index keeps the bounds of the objects at the time of the call: their position,
+     * their crash spheres and their shield. It must be updated once the objects have moved,
+     * for example once per frame before the queries of the particles. Creating or deleting
+     * an object invalidates the index, it is then rebuilt by the next query.
+     */
+    void      UpdateSpatialIndex();
+    /**
+     * \brief Finds the objects whose bounds intersect a box
+     *
+     * The result may contain objects that don't touch the box, the caller tests them
+     * exactly. The objects are in the same order as in GetAllObjects().
+     */
+    void      GetObjectsInBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<CObject*>& result);
+    //@}
+
 private:
     //! Prevents creation of overcharged power cells
     float ClampPower(ObjectType type, float power);
@@ -314,4 +335,19 @@ private:
     int m_nextId;
     int m_activeObjectIterators;
     bool m_shouldCleanRemovedObjects;
+
+    //! Bounds of an object in the spatial index
+    struct IndexEntry
+    {
+        CObject*  object;
+        glm::vec3 min;
+        glm::vec3 max;
+        int       stamp;      // last query finding the object
+    };
+    std::vector<IndexEntry> m_indexEntries;     // in the order of GetAllObjects()
+    std::unordered_map<long long, std::vector<int>> m_indexCells;   // entries of each horizontal cell
+    std::vector<int> m_indexLarge;              // entries too large for the cells
+    std::vector<int> m_indexFound;
+    int m_indexStamp = 0;
+    bool m_indexValid = false;
 };
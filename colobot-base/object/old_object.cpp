@@ -1890,6 +1890,7 @@ bool COldObject::CreateShadowLight(float height, Gfx::Color color)
     light.attenuation1  = 0.0f;
     light.attenuation2  = 0.0f;
     light.spotAngle = 90.0f*Math::PI/180.0f;
+    light.range = Gfx::CLightManager::GetSpotRange(light, height);
 
     m_shadowLight = m_lightMan->CreateLight();
     if ( m_shadowLight == -1 )  return false;
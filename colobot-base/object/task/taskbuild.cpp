@@ -162,6 +162,7 @@ void CTaskBuild::CreateLight()
         light.attenuation1 = 0.0f;
         light.attenuation2 = 0.0f;
         light.spotAngle = 90.0f*Math::PI/180.0f;
+        light.range = Gfx::CLightManager::GetSpotRange(light, pos.y-center.y);
         m_lightMan->SetLight(m_lightRank[i], light);
 
         color.r = -1.0f;
@@ -527,6 +527,8 @@ bool CTaskShield::CreateLight(glm::vec3 pos)
     light.attenuation1 = 0.0f;
     light.attenuation2 = 0.0f;
     light.spotAngle = 90.0f*Math::PI/180.0f;
+    // The light bobs up to 2.2 radius above the shield, see EventProcess()
+    light.range = Gfx::CLightManager::GetSpotRange(light, RADIUS_SHIELD_MAX*2.2f);
 
     m_effectLight = m_lightMan->CreateLight();
     if ( m_effectLight == -1 )  return false;
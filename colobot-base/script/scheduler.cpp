@@ -0,0 +1,125 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+#include "script/scheduler.h"
+
+#include "common/timeutils.h"
+
+#include "script/script.h"
+
+#include <algorithm>
+
+
+// Default CBot time per frame, in seconds.
+const float DEFAULT_BUDGET = 0.008f;
+
+// Number of frames after which a deferred program runs whatever the budget.
+const int MAX_WAITING = 10;
+
+// Weight of the last quantum in the moving average.
+const float AVERAGE_WEIGHT = 0.1f;
+
+
+CScriptScheduler::CScriptScheduler()
+{
+    m_budget = DEFAULT_BUDGET;
+}
+
+CScriptScheduler::~CScriptScheduler()
+{
+}
+
+
+void CScriptScheduler::SetBudget(float budget)
+{
+    m_budget = std::max(budget, 0.0f);
+}
+
+float CScriptScheduler::GetBudget()
+{
+    return m_budget;
+}
+
+
+// Starts a new frame, the programs deferred in the previous one are served first.
+
+void CScriptScheduler::BeginFrame()
+{
+    m_used = 0.0f;
+    m_reserved = m_nextReserved;
+    m_nextReserved = 0.0f;
+}
+
+float CScriptScheduler::GetFrameTime()
+{
+    return m_used;
+}
+
+
+// Runs a quantum of the program, or defers it to the next frame.
+// Returns true when execution is finished.
+
+bool CScriptScheduler::Continue(CScript* script, bool priority)
+{
+    ScriptTimeStats& stats = script->GetTimeStats();
+
+    if ( stats.waiting > 0 )  // reserved time of this program?
+    {
+        m_reserved = std::max(m_reserved - stats.averageTime, 0.0f);
+    }
+
+    if ( !CanRun(stats, priority) )
+    {
+        stats.waiting ++;
+        stats.deferred ++;
+        m_nextReserved += stats.averageTime;
+        return false;
+    }
+
+    TimeUtils::TimeStamp start = std::chrono::high_resolution_clock::now();
+    bool finished = script->Continue();
+    float time = TimeUtils::Diff(start, std::chrono::high_resolution_clock::now());
+
+    m_used += time;
+
+    stats.lastTime = time;
+    if ( stats.quanta == 0 )  stats.averageTime = time;
+    else  stats.averageTime += (time - stats.averageTime) * AVERAGE_WEIGHT;
+    stats.totalTime += time;
+    stats.quanta ++;
+    stats.waiting = 0;
+
+    return finished;
+}
+
+// Checks whether a program fits in the rest of the budget.
+
+bool CScriptScheduler::CanRun(const ScriptTimeStats& stats, bool priority)
+{
+    if ( m_budget <= 0.0f )  return true;  // no limit?
+    if ( priority )  return true;
+    if ( stats.waiting >= MAX_WAITING )  return true;
+    if ( m_used == 0.0f && m_reserved == 0.0f )  return true;  // at least one program per frame
+
+    if ( stats.waiting > 0 )  // deferred program, only the time used counts
+    {
+        return m_used + stats.averageTime <= m_budget;
+    }
+    return m_used + m_reserved + stats.averageTime <= m_budget;
+}
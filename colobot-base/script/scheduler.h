@@ -0,0 +1,94 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/**
+ * \file script/scheduler.h
+ * \brief CScriptScheduler - sharing the CBot time of a frame between the programs
+ */
+
+#pragma once
+
+class CScript;
+
+/**
+ * \struct ScriptTimeStats
+ * \brief Time used by a program, see CScriptScheduler
+ */
+struct ScriptTimeStats
+{
+    //! Time of the last quantum, in seconds
+    float lastTime = 0.0f;
+    //! Moving average of the time of a quantum, in seconds
+    float averageTime = 0.0f;
+    //! Time of all the quanta since the program started, in seconds
+    float totalTime = 0.0f;
+    //! Number of quanta run since the program started
+    int quanta = 0;
+    //! Number of quanta deferred to a later frame since the program started
+    int deferred = 0;
+    //! Number of frames the program has been waiting for its next quantum
+    int waiting = 0;
+};
+
+/**
+ * \class CScriptScheduler
+ * \brief Limits the time spent running CBot programs in one frame
+ *
+ * Each running program gets one quantum per frame: a call to CScript::Continue(), which runs
+ * the number of instructions set with ipf(). The scheduler measures the time of each quantum
+ * and, once the budget of the frame is used, defers the quanta of the remaining programs to
+ * the next frame. A deferred program is then served first: the time it is expected to take
+ * is reserved until its quantum runs, so the other programs can't use it again. After
+ * MAX_WAITING frames, a deferred program runs whatever the budget.
+ *
+ * The program of the selected robot is never deferred. When the budget is not exceeded, all
+ * programs run every frame in the usual order, as without the scheduler.
+ */
+class CScriptScheduler
+{
+public:
+    CScriptScheduler();
+    ~CScriptScheduler();
+
+    //! Sets the CBot time per frame, in seconds, 0 for no limit
+    void        SetBudget(float budget);
+    float       GetBudget();
+
+    //! Starts a new frame
+    void        BeginFrame();
+    //! Time used by the programs in the current frame, in seconds
+    float       GetFrameTime();
+
+    //! Runs a quantum of the program, unless it is deferred
+    //! \param priority true for the program of the selected robot
+    //! \return true when the program is finished, see CScript::Continue()
+    bool        Continue(CScript* script, bool priority);
+
+protected:
+    bool        CanRun(const ScriptTimeStats& stats, bool priority);
+
+protected:
+    float       m_budget = 0.0f;
+    //! Time used in the current frame
+    float       m_used = 0.0f;
+    //! Time reserved for the programs deferred in the previous frames
+    float       m_reserved = 0.0f;
+    //! Time to reserve in the next frame
+    float       m_nextReserved = 0.0f;
+};
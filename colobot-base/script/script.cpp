@@ -22,6 +22,7 @@
 
 #include "CBot/CBot.h"
 
+#include "common/logger.h"
 #include "common/restext.h"
 #include "common/stringutils.h"
 
@@ -44,10 +45,20 @@
 #include "ui/controls/interface.h"
 #include "ui/controls/list.h"
 
+#include <algorithm>
+
 #include <libintl.h>
 
 const int CBOT_IPF = 100;       // CBOT: default number of instructions / frame
 
+namespace
+{
+
+bool g_compileBatch = false;                // compilations deferred, see CScript::BeginCompileBatch()
+std::vector<CScript*> g_pendingScripts;     // scripts waiting for CScript::EndCompileBatch()
+
+} // anonymous namespace
+
 
 // Object's constructor.
 
@@ -67,6 +78,7 @@ CScript::CScript(COldObject* object)
 
     m_ipf = CBOT_IPF;
     m_errMode = ERM_STOP;
+    m_timeStats = ScriptTimeStats();
     m_len = 0;
     m_bRun = false;
     m_bStepMode = false;
@@ -79,6 +91,10 @@ CScript::CScript(COldObject* object)
 
 CScript::~CScript()
 {
+    if (m_bPending)
+    {
+        g_pendingScripts.erase(std::find(g_pendingScripts.begin(), g_pendingScripts.end(), this));
+    }
     m_len = 0;
 }
 
@@ -87,6 +103,7 @@ CScript::~CScript()
 
 void CScript::PutScript(Ui::CEdit* edit, const char* name)
 {
+    CompilePending();
     if ( m_script == nullptr )
     {
         New(edit, name);
@@ -136,6 +153,7 @@ bool CScript::GetScript(Ui::CEdit* edit)
 
 bool CScript::GetCompile()
 {
+    CompilePending();
     return m_bCompile;
 }
 
@@ -229,6 +247,12 @@ bool CScript::Compile()
     m_mainFunction.clear();
     m_bCompile = false;
 
+    if (m_bPending)
+    {
+        g_pendingScripts.erase(std::find(g_pendingScripts.begin(), g_pendingScripts.end(), this));
+        m_bPending = false;
+    }
+
     if ( IsEmpty() )  // program exist?
     {
         m_botProg.reset();
@@ -238,9 +262,25 @@ bool CScript::Compile()
     if (m_botProg == nullptr)
     {
         m_botProg = std::make_unique<CBot::CBotProgram>(m_object->GetBotVar());
+        m_botProg->SetProfiler(m_bProfiling);
+    }
+
+    if (g_compileBatch)
+    {
+        m_bPending = true;
+        g_pendingScripts.push_back(this);
+        return true;
     }
 
-    if ( m_botProg->Compile(m_script.get(), functionList, this) )
+    bool ok = m_botProg->Compile(m_script.get(), functionList, this);
+    return EndCompile(ok, functionList);
+}
+
+// Takes the result of the compilation.
+
+bool CScript::EndCompile(bool ok, const std::vector<std::string>& functionList)
+{
+    if ( ok )
     {
         if (functionList.empty())
         {
@@ -278,11 +318,58 @@ bool CScript::Compile()
     }
 }
 
+// Compiles the script now if its compilation was deferred.
+
+void CScript::CompilePending()
+{
+    if ( !m_bPending )  return;
+
+    g_pendingScripts.erase(std::find(g_pendingScripts.begin(), g_pendingScripts.end(), this));
+    m_bPending = false;
+
+    std::vector<std::string> functionList;
+    bool ok = m_botProg->Compile(m_script.get(), functionList, this);
+    EndCompile(ok, functionList);
+}
+
+void CScript::BeginCompileBatch()
+{
+    g_compileBatch = true;
+}
+
+void CScript::EndCompileBatch()
+{
+    g_compileBatch = false;
+    if (g_pendingScripts.empty())  return;
+
+    std::vector<CScript*> scripts;
+    scripts.swap(g_pendingScripts);
+
+    std::vector<CBot::CBotProgram::BatchItem> items(scripts.size());
+    for (std::size_t i = 0; i < scripts.size(); i++)
+    {
+        scripts[i]->m_bPending = false;
+        items[i].program = scripts[i]->m_botProg.get();
+        items[i].code = scripts[i]->m_script.get();
+        items[i].user = scripts[i];
+    }
+
+    CBot::CBotProgram::CompileBatch(items);
+
+    for (std::size_t i = 0; i < scripts.size(); i++)
+    {
+        scripts[i]->EndCompile(items[i].ok, items[i].externFunctions);
+    }
+
+    GetLogger()->Debug("Compiled %d scripts together\n", static_cast<int>(scripts.size()));
+}
+
 
 // Returns the title of the script.
 
 const std::string& CScript::GetTitle()
 {
+    CompilePending();
     return m_title;
 }
 
@@ -304,6 +391,7 @@ bool CScript::GetStepMode()
 
 bool CScript::Run()
 {
+    CompilePending();
     if (m_botProg == nullptr)  return false;
     if ( m_script == nullptr || m_len == 0 )  return false;
     if ( m_mainFunction.empty() ) return false;
@@ -589,6 +677,95 @@ void CScript::UpdateList(Ui::CList* list)
     list->SetState(Ui::STATE_ENABLE);
 }
 
+// Enables or disables the sampling profiler of the program.
+
+void CScript::SetProfiling(bool profile)
+{
+    m_bProfiling = profile;
+    if (m_botProg != nullptr)  m_botProg->SetProfiler(profile);
+}
+
+bool CScript::GetProfiling()
+{
+    return m_bProfiling;
+}
+
+// Returns the time used by the program, see CScriptScheduler.
+
+ScriptTimeStats& CScript::GetTimeStats()
+{
+    return m_timeStats;
+}
+
+// Fills a list with the results of the profiler:
+// the functions and then the lines of this program taking the most time.
+
+void CScript::UpdateProfileList(Ui::CList* list)
+{
+    const int MAX_ITEMS = 10;
+
+    if (m_botProg == nullptr) return;
+    CBot::CBotProfiler* profiler = m_botProg->GetProfiler();
+    if (profiler == nullptr) return;
+
+    int select = list->GetSelect();
+    int rank = 0;
+
+    list->Flush();  // empty list
+
+    long total = std::max(profiler->GetTicks(), 1L);
+    list->SetItemName(rank++, StrUtils::Format("%ld ticks, %.1f ms", profiler->GetTicks(), profiler->GetSeconds()*1000.0));
+    list->SetItemName(rank++, StrUtils::Format("%.2f ms/frame, %d frames deferred", m_timeStats.averageTime*1000.0, m_timeStats.deferred));
+
+    int count = 0;
+    for (const CBot::CBotProfileEntry& entry : profiler->GetFunctions())
+    {
+        if ( count++ == MAX_ITEMS )  break;
+        list->SetItemName(rank++, StrUtils::Format("%5.1f%%  %s()  %.1f ms", entry.ticks*100.0/total, entry.name.c_str(), entry.seconds*1000.0));
+    }
+
+    count = 0;
+    for (const CBot::CBotProfileEntry& entry : profiler->GetRanges())
+    {
+        if ( entry.program != m_botProg.get() )  continue;  // public function of another robot
+        if ( entry.start < 0 || entry.start > m_len )  continue;
+        if ( count++ == MAX_ITEMS )  break;
+
+        int line = 1 + static_cast<int>(std::count(m_script.get(), m_script.get()+entry.start, '\n'));
+        list->SetItemName(rank++, StrUtils::Format("%5.1f%%  line %d  (%s)", entry.ticks*100.0/total, line, entry.name.c_str()));
+    }
+
+    for (const CBot::CBotProfileEntry& entry : profiler->GetExternalCalls())
+    {
+        list->SetItemName(rank++, StrUtils::Format("%s  %ld calls  %.1f ms", entry.name.c_str(), entry.count, entry.seconds*1000.0));
+    }
+
+    if ( select < rank )
+    {
+        list->SetSelect(select);
+    }
+
+    list->SetTooltip("");
+    list->SetState(Ui::STATE_ENABLE);
+}
+
+// Writes the call stacks sampled by the profiler for flame graph tools.
+// Returns the name of the written file.
+
+bool CScript::WriteProfile(std::string& filename)
+{
+    if (m_botProg == nullptr) return false;
+    CBot::CBotProfiler* profiler = m_botProg->GetProfiler();
+    if (profiler == nullptr) return false;
+
+    CResourceManager::CreateNewDirectory("profile");
+    filename = StrUtils::Format("profile/%s_%d.folded", m_mainFunction.c_str(), m_object->GetID());
+
+    COutputStream ostr(filename);
+    if (!ostr.is_open()) return false;
+    return profiler->WriteCollapsed(ostr, true);
+}
+
 // Colorize a string or character literal with escape sequences also colored
 
 static void HighlightString(Ui::CEdit* edit, const std::string& s, int start)
@@ -821,6 +998,7 @@ bool CScript::IntroduceVirus()
 
 int CScript::GetError()
 {
+    CompilePending();
     return m_error;
 }
 
@@ -828,6 +1006,7 @@ int CScript::GetError()
 
 void CScript::GetError(std::string& error)
 {
+    CompilePending();
     if ( m_error == 0 )
     {
         error.clear();
@@ -1037,6 +1216,8 @@ bool CScript::ReadStack(std::istream &istr)
 {
     int     nb;
 
+    CompilePending();
+
     if (!CBot::ReadInt(istr, nb)) return false;
     if (!CBot::ReadInt(istr, m_ipf)) return false;
     if (!CBot::ReadInt(istr, m_errMode)) return false;
@@ -1055,6 +1236,8 @@ bool CScript::WriteStack(std::ostream &ostr)
 {
     int     nb;
 
+    CompilePending();
+
     nb = 2;
     if (!CBot::WriteInt(ostr, nb)) return false;
     if (!CBot::WriteInt(ostr, m_ipf)) return false;
@@ -26,10 +26,13 @@
 
 #include "CBot/CBot.h"
 
+#include "script/scheduler.h"
+
 #include <limits>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 class COldObject;
 class CTaskExecutorObject;
@@ -78,7 +81,17 @@ public:
     bool        IsContinue();
     bool        GetCursor(int &cursor1, int &cursor2);
     void        UpdateList(Ui::CList* list);
+    void        SetProfiling(bool profile);
+    bool        GetProfiling();
+    ScriptTimeStats& GetTimeStats();
+    void        UpdateProfileList(Ui::CList* list);
+    bool        WriteProfile(std::string& filename);
     static void ColorizeScript(Ui::CEdit* edit, int rangeStart = 0, int rangeEnd = std::numeric_limits<int>::max());
+
+    //! Defers the compilation of the scripts until EndCompileBatch(), used while loading a scene
+    static void BeginCompileBatch();
+    //! Compiles the deferred scripts together, see CBot::CBotProgram::CompileBatch()
+    static void EndCompileBatch();
     bool        IntroduceVirus();
 
     int         GetError();
@@ -99,6 +112,8 @@ protected:
     bool        IsEmpty();
     bool        CheckToken();
     bool        Compile();
+    bool        EndCompile(bool ok, const std::vector<std::string>& functionList);
+    void        CompilePending();
 
 protected:
     COldObject*          m_object = nullptr;
@@ -119,6 +134,9 @@ protected:
     bool    m_bStepMode = false;        // step by step
     bool    m_bContinue = false;        // external function to continue
     bool    m_bCompile = false;     // compilation ok?
+    bool    m_bPending = false;     // compilation deferred to EndCompileBatch()?
+    bool    m_bProfiling = false;   // sampling profiler enabled?
+    ScriptTimeStats m_timeStats;    // time used, see CScriptScheduler
     std::string m_title = "";        // script title
     std::string m_mainFunction = "";
     std::string m_filename = "";     // file name
@@ -25,7 +25,9 @@
 
 #include "common/event.h"
 #include "common/logger.h"
+#include "common/restext.h"
 #include "common/settings.h"
+#include "common/stringutils.h"
 
 #include "common/resources/resourcemanager.h"
 
@@ -247,6 +249,26 @@ bool CStudio::EventProcess(const Event &event)
         m_script->Step();
     }
 
+    if ( event.type == EVENT_STUDIO_PROFILE )  // profile?
+    {
+        if ( m_script->GetProfiling() )
+        {
+            std::string filename;
+            if ( m_script->WriteProfile(filename) )
+            {
+                std::string res;
+                GetResource(RES_TEXT, RT_STUDIO_PROFILE, res);
+                SetInfoText(StrUtils::Format(res.c_str(), filename.c_str()), false);
+            }
+            m_script->SetProfiling(false);
+        }
+        else
+        {
+            m_script->SetProfiling(true);
+        }
+        UpdateButtons();
+    }
+
     if ( event.type == EVENT_WINDOW3 )  // window is moved?
     {
         m_editActualPos = m_editFinalPos = pw->GetPos();
@@ -401,7 +423,14 @@ bool CStudio::EventFrame(const Event &event)
             edit->ShowSelect();
         }
 
-        m_script->UpdateList(list);  // updates the list of variables
+        if ( m_script->GetProfiling() )
+        {
+            m_script->UpdateProfileList(list);  // updates the results of the profiler
+        }
+        else
+        {
+            m_script->UpdateList(list);  // updates the list of variables
+        }
     }
     else
     {
@@ -683,6 +712,8 @@ void CStudio::StartEditScript(CScript *script, std::string name, Program* progra
     button->SetState(STATE_SHADOW);
     button = pw->CreateButton(pos, dim, 64+29, EVENT_STUDIO_STEP);
     button->SetState(STATE_SHADOW);
+    button = pw->CreateButton(pos, dim, 40, EVENT_STUDIO_PROFILE);
+    button->SetState(STATE_SHADOW);
 
     if (!m_program->runnable)
     {
@@ -894,6 +925,13 @@ void CStudio::AdjustEditScript()
         button->SetPos(pos);
         button->SetDim(dim);
     }
+    pos.x = wpos.x+0.28f+dim.x*4;
+    button = static_cast< CButton* >(pw->SearchControl(EVENT_STUDIO_PROFILE));
+    if ( button != nullptr )
+    {
+        button->SetPos(pos);
+        button->SetDim(dim);
+    }
 }
 
 // Ends edition of a program.
@@ -1202,6 +1240,10 @@ void CStudio::UpdateButtons()
     if ( button == nullptr )  return;
     button->SetState(STATE_ENABLE, (m_bRunning && !m_bRealTime && !m_script->IsContinue()));
 
+    button = static_cast< CButton* >(pw->SearchControl(EVENT_STUDIO_PROFILE));
+    if ( button == nullptr )  return;
+    button->SetState(STATE_CHECK, m_script->GetProfiling());
+    button->SetState(STATE_ENABLE, m_program->runnable);
 
     button = static_cast< CButton* >(pw->SearchControl(EVENT_STUDIO_NEW));
     if ( button == nullptr )  return;
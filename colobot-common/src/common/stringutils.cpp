@@ -137,7 +137,25 @@ void StrUtils::Trim(std::string& str)
     TrimRight(str);
 }
 
+std::string_view StrUtils::TrimView(std::string_view str)
+{
+    auto isSpace = [](unsigned char ch) { return std::isspace(ch) != 0; };
+
+    while (!str.empty() && isSpace(str.front()))
+        str.remove_prefix(1);
+
+    while (!str.empty() && isSpace(str.back()))
+        str.remove_suffix(1);
+
+    return str;
+}
+
 void StrUtils::RemoveComments(std::string& text)
+{
+    text.resize(RemoveCommentsView(text).size());
+}
+
+std::string_view StrUtils::RemoveCommentsView(std::string_view text)
 {
     for (size_t i = 0; i < text.size(); i++)
     {
@@ -157,11 +175,12 @@ void StrUtils::RemoveComments(std::string& text)
 
             i = j;
         }
-        // If a comment of form // comment, remove and end processing
-        else if (text[i] == '/' && text[i + 1] == '/')
+        // If a comment of form // comment, cut off and end processing
+        else if (c == '/' && i + 1 < text.size() && text[i + 1] == '/')
         {
-            text.erase(std::next(text.begin(), i), text.end());
-            break;
+            return text.substr(0, i);
         }
     }
+
+    return text;
 }
@@ -82,9 +82,15 @@ void TrimRight(std::string& str);
 //! Remove whitespace from both ends of the given string (in place)
 void Trim(std::string& str);
 
+//! Returns a view of the given string without whitespace at both ends
+std::string_view TrimView(std::string_view str);
+
 //! Removes comments of form // comment
 void RemoveComments(std::string& text);
 
+//! Returns a view of the given text with comments of form // comment cut off
+std::string_view RemoveCommentsView(std::string_view text);
+
 //! Converts a wide Unicode char to a single UTF-8 encoded char
 std::string UnicodeCharToUtf8(unsigned int ch);
 
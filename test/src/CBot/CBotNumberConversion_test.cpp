@@ -0,0 +1,150 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+#include "CBot/CBotNumberConversion.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+
+// conversions with streams, which CBot used before
+template<typename T>
+std::string StreamToString(T value)
+{
+    std::ostringstream s;
+    s.imbue(std::locale::classic());
+    s << std::boolalpha << value;
+    return s.str();
+}
+
+template<typename T>
+T StreamFromString(const std::string& str)
+{
+    std::istringstream s(str);
+    s.imbue(std::locale::classic());
+    T value{};
+    s >> value;
+    return value;
+}
+
+const char* const STRINGS[] = {
+    "", "0", "1", "-1", "+1", " 42", "\t-7x", "12abc", "abc", "1e3", "1e", "1.", ".5", ".", "-", "+", "+-1",
+    "1.5e+", "2.5", "-2.5e-3", "1e50", "-1e50", "1e-50", "-1e-50", "1e-40", "99999999999", "-99999999999",
+    "2147483647", "2147483648", "-2147483648", "-2147483649", "9223372036854775807", "9223372036854775808",
+    "-9223372036854775809", "0x10", "inf", "nan", "-inf", "1,5", "3.14159265358979", "1e308", "1e309", "-1e309",
+    "1e-400", "4294967295", "4294967296", "-5", "32767", "32768", "-32769", "true", "1 2", "00012", "-0", "0.1e1",
+    "1E2", "  +3.5  ", "e5", "1.e5", "0.000000000000000000000000000000000000000000001",
+};
+
+} // namespace
+
+namespace CBot
+{
+
+template<typename T>
+void TestNumberToString(T value)
+{
+    EXPECT_EQ(StreamToString(value), NumberToString(value)) << "value " << +value;
+}
+
+template<typename T>
+void TestStringToNumber()
+{
+    for (const char* str : STRINGS)
+    {
+        T value{};
+        StringToNumber(str, value);
+        T expected = StreamFromString<T>(str);
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            EXPECT_EQ(std::signbit(expected), std::signbit(value)) << "string \"" << str << "\"";
+        }
+        EXPECT_EQ(expected, value) << "string \"" << str << "\"";
+    }
+}
+
+TEST(CBotNumberConversionTest, IntegersToString)
+{
+    for (long value : {0L, 1L, -1L, 65L, 127L, -128L, 1000000L, -32768L, 2147483647L, -2147483648L})
+    {
+        TestNumberToString(static_cast<signed char>(value));
+        TestNumberToString(static_cast<short>(value));
+        TestNumberToString(static_cast<uint32_t>(value));
+        TestNumberToString(static_cast<int>(value));
+        TestNumberToString(value);
+    }
+    TestNumberToString(std::numeric_limits<long>::min());
+    TestNumberToString(std::numeric_limits<long>::max());
+    TestNumberToString(true);
+    TestNumberToString(false);
+}
+
+TEST(CBotNumberConversionTest, FloatsToString)
+{
+    const double values[] = {
+        0.0, -0.0, 1.0, 0.1, 1.0 / 3, 123456.0, 1234567.0, 1e-5, 1e-4, 123.456, 1e20, -2.5, 100000.0, 999999.5,
+        1e6, 0.0001234, 9.9999999, 0.000099999, 1e300, 5e-324, std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::min(), std::numeric_limits<float>::denorm_min(),
+        std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+    };
+    for (double value : values)
+    {
+        TestNumberToString(static_cast<float>(value));
+        TestNumberToString(value);
+    }
+    EXPECT_EQ("nan", NumberToString(std::numeric_limits<float>::quiet_NaN()));
+}
+
+TEST(CBotNumberConversionTest, StringToIntegers)
+{
+    TestStringToNumber<short>();
+    TestStringToNumber<uint32_t>();
+    TestStringToNumber<int>();
+    TestStringToNumber<long>();
+    TestStringToNumber<bool>();
+    TestStringToNumber<signed char>();
+}
+
+TEST(CBotNumberConversionTest, StringToFloats)
+{
+    TestStringToNumber<float>();
+    TestStringToNumber<double>();
+}
+
+TEST(CBotNumberConversionTest, RoundTrip)
+{
+    for (int value : {0, 7, -42, 65535, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()})
+    {
+        int result = 0;
+        StringToNumber(NumberToString(value), result);
+        EXPECT_EQ(value, result);
+    }
+    for (float value : {0.0f, 0.5f, -2.25f, 1e10f, 3e-7f})
+    {
+        float result = 0;
+        StringToNumber(NumberToString(value), result);
+        EXPECT_EQ(value, result);
+    }
+}
+
+} // namespace CBot
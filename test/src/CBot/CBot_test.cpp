@@ -22,10 +22,14 @@
 #include <gtest/gtest.h>
 #include <limits>
 #include <stdexcept>
+#include <thread>
 
 extern bool g_cbotTestSaveState;
 bool g_cbotTestSaveState = false;
 
+extern bool g_cbotTestBytecode;
+bool g_cbotTestBytecode = false;
+
 using namespace CBot;
 
 class CBotUT : public testing::Test
@@ -219,13 +223,14 @@ private:
     }
 
 protected:
-    std::unique_ptr<CBotProgram> ExecuteTest(const std::string& code, CBotError expectedError = CBotNoErr)
+    std::unique_ptr<CBotProgram> ExecuteTest(const std::string& code, CBotError expectedError = CBotNoErr, bool bytecode = false)
     {
         CBotError expectedCompileError = expectedError < 6000 ? expectedError : CBotNoErr;
         CBotError expectedRuntimeError = expectedError >= 6000 ? expectedError : CBotNoErr;
 
         auto program = std::unique_ptr<CBotProgram>(new CBotProgram());
         std::vector<std::string> tests;
+        program->SetBytecode(bytecode || g_cbotTestBytecode);
         program->Compile(code, tests);
 
         CBotError error;
@@ -1967,6 +1972,61 @@ TEST_F(CBotUT, StringFunctions)
     );
 }
 
+TEST_F(CBotUT, StringSharedValues)
+{
+    ExecuteTest(
+        "void Append(string s)\n"
+        "{\n"
+        "    s += \"!\";\n"
+        "    ASSERT(s == \"abc!\");\n"
+        "}\n"
+        "extern void StringCopies()\n"
+        "{\n"
+        "    string s = \"abc\";\n"
+        "    string a = s;\n"
+        "    a += \"d\";\n"
+        "    s += \"e\";\n"
+        "    ASSERT(a == \"abcd\");\n"
+        "    ASSERT(s == \"abce\");\n"
+        "    string b = s + \"f\";\n"
+        "    string c = s + \"g\";\n"
+        "    ASSERT(b == \"abcef\");\n"
+        "    ASSERT(c == \"abceg\");\n"
+        "    ASSERT(s == \"abce\");\n"
+        "    s += s;\n"
+        "    ASSERT(s == \"abceabce\");\n"
+        "    string t = \"abc\";\n"
+        "    Append(t);\n"
+        "    ASSERT(t == \"abc\");\n"
+        "    for (int i = 0; i < 3; i++) t = \"x\" + t;\n"
+        "    ASSERT(t == \"xxxabc\");\n"
+        "}\n"
+        "extern void StringLiterals()\n"
+        "{\n"
+        "    for (int i = 0; i < 3; i++)\n"
+        "    {\n"
+        "        string s = \"lit\";\n"
+        "        s += i;\n"
+        "        ASSERT(s == \"lit\" + i);\n"
+        "        ASSERT(strlen(s) == 4);\n"
+        "    }\n"
+        "}\n"
+        "extern void StringSubstrings()\n"
+        "{\n"
+        "    string s = \"Colobot Gold Edition\";\n"
+        "    string left = strleft(s, 12);\n"
+        "    string mid = strmid(s, 8, 4);\n"
+        "    left += \"!\";\n"
+        "    mid += \"?\";\n"
+        "    ASSERT(left == \"Colobot Gold!\");\n"
+        "    ASSERT(mid == \"Gold?\");\n"
+        "    ASSERT(s == \"Colobot Gold Edition\");\n"
+        "    ASSERT(strright(strleft(s, 12), 4) == \"Gold\");\n"
+        "    ASSERT(strfind(strmid(s, 8), \"Edition\") == 5);\n"
+        "}\n"
+    );
+}
+
 TEST_F(CBotUT, LiteralCharacters)
 {
     ExecuteTest(
@@ -3327,3 +3387,612 @@ TEST_F(CBotUT, ClassTestSaveInheritedMembers)
         "}\n"
     );
 }
+
+TEST_F(CBotUT, BytecodeArithmetic)
+{
+    ExecuteTest(
+        "int Sum(int n)\n"
+        "{\n"
+        "    int s = 0;\n"
+        "    for (int i = 1; i <= n; i++) s += i;\n"
+        "    return s;\n"
+        "}\n"
+        "float Average(int a, float b)\n"
+        "{\n"
+        "    float c = (a + b) / 2;\n"
+        "    return c;\n"
+        "}\n"
+        "int Bits(int a)\n"
+        "{\n"
+        "    int b = a;\n"
+        "    b <<= 2; b |= 1; b ^= 16; b = b >>> 1;\n"
+        "    return -b % 5 + (~a & 3) + 2 ** 3;\n"
+        "}\n"
+        "int Swap(int a)\n"
+        "{\n"
+        "    int b = a + (a = 10);\n"
+        "    return b * 100 + a++ + ++a;\n"
+        "}\n"
+        "extern void BytecodeArithmetic()\n"
+        "{\n"
+        "    ASSERT(Sum(100) == 5050);\n"
+        "    ASSERT(Average(3, 4.5) == 3.75);\n"
+        "    ASSERT(Bits(5) == 8);\n"
+        "    ASSERT(Swap(5) == 1522);\n"
+        "}\n",
+        CBotNoErr, true
+    );
+}
+
+TEST_F(CBotUT, BytecodeControlFlow)
+{
+    ExecuteTest(
+        "int Collatz(int n)\n"
+        "{\n"
+        "    int steps = 0;\n"
+        "    while (n != 1)\n"
+        "    {\n"
+        "        if (n % 2 == 0) n = n / 2;\n"
+        "        else n = 3 * n + 1;\n"
+        "        steps++;\n"
+        "    }\n"
+        "    return steps;\n"
+        "}\n"
+        "int Loops()\n"
+        "{\n"
+        "    int s = 0;\n"
+        "    int i = 0;\n"
+        "    do { i++; if (i == 3) continue; if (i > 6) break; s += i; } while (true);\n"
+        "    for (int j = 0; j < 10; j++) { if (j % 2 == 1) continue; s += j > 4 ? 100 : 1; }\n"
+        "    return s;\n"
+        "}\n"
+        "bool Logic(int a)\n"
+        "{\n"
+        "    bool r = a > 0 && 10 / a > 2;\n"
+        "    return r || !(a != 0);\n"
+        "}\n"
+        "extern void BytecodeControlFlow()\n"
+        "{\n"
+        "    ASSERT(Collatz(27) == 111);\n"
+        "    ASSERT(Loops() == 221);\n"
+        "    ASSERT(Logic(0));\n"
+        "    ASSERT(Logic(3));\n"
+        "    ASSERT(!Logic(4));\n"
+        "}\n",
+        CBotNoErr, true
+    );
+}
+
+TEST_F(CBotUT, BytecodeErrors)
+{
+    ExecuteTest(
+        "int Divide(int a, int b)\n"
+        "{\n"
+        "    return a / b;\n"
+        "}\n"
+        "extern void BytecodeDivideByZero()\n"
+        "{\n"
+        "    Divide(1, 0);\n"
+        "}\n",
+        CBotErrZeroDiv, true
+    );
+
+    ExecuteTest(
+        "float Modulo(float a, float b)\n"
+        "{\n"
+        "    float c = a;\n"
+        "    c %= b;\n"
+        "    return c;\n"
+        "}\n"
+        "extern void BytecodeModuloByZero()\n"
+        "{\n"
+        "    Modulo(1.5, 0);\n"
+        "}\n",
+        CBotErrZeroDiv, true
+    );
+
+    ExecuteTest(
+        "int Undefined(bool b)\n"
+        "{\n"
+        "    int a;\n"
+        "    if (b) a = 1;\n"
+        "    return a;\n"
+        "}\n"
+        "extern void BytecodeUndefined()\n"
+        "{\n"
+        "    ASSERT(Undefined(true) == 1);\n"
+        "    Undefined(false);\n"
+        "}\n",
+        CBotErrNotInit, true
+    );
+
+    ExecuteTest(
+        "bool IsNan(float a)\n"
+        "{\n"
+        "    return a == nan;\n"
+        "}\n"
+        "float Add(float a, float b)\n"
+        "{\n"
+        "    return a + b;\n"
+        "}\n"
+        "extern void BytecodeNan()\n"
+        "{\n"
+        "    ASSERT(IsNan(nan));\n"
+        "    Add(1, nan);\n"
+        "}\n",
+        CBotErrNan, true
+    );
+}
+
+TEST_F(CBotUT, BytecodeEmptyLoop)
+{
+    ExecuteTest(
+        "int Count(int n)\n"
+        "{\n"
+        "    int i = 0;\n"
+        "    while (i++ < n);\n"
+        "    return i;\n"
+        "}\n"
+        "extern void BytecodeEmptyLoop()\n"
+        "{\n"
+        "    ASSERT(Count(10) == 11);\n"
+        "}\n",
+        CBotNoErr, true
+    );
+}
+
+TEST_F(CBotUT, BytecodeTicks)
+{
+    // ipf() has to preempt the same amount of work with and without bytecode
+    const std::string code =
+        "int Loops(int n)\n"
+        "{\n"
+        "    int s = 0, t;\n"
+        "    for (int i = 0; i < n; i++)\n"
+        "    {\n"
+        "        if (i % 3 == 0) continue;\n"
+        "        if (i > 50 && s < 0 || i == 90) break;\n"
+        "        s += i > 10 ? i * 2 : -i;\n"
+        "    }\n"
+        "    t = 0;\n"
+        "    while (t < n) { t++; if (t % 2 == 0) continue; ++s; }\n"
+        "    do { t -= 3; } while (t > 0);\n"
+        "    float f = 1.5, g;\n"
+        "    bool b = !(f > 2.0) && true;\n"
+        "    if (b) g = f / 2; else g = f;\n"
+        "    int k = 2;\n"
+        "    k *= 3;\n"
+        "    return s + t + k - (g > 0.5 ? 1 : 0);\n"
+        "}\n"
+        "void Empty() {}\n"
+        "extern void Main()\n"
+        "{\n"
+        "    for (int i = 0; i < 5; i++) ASSERT(Loops(100 + i) != 0);\n"
+        "    Empty();\n"
+        "}\n";
+
+    long ticks[2] = {};
+    for (int bytecode = 0; bytecode < 2; ++bytecode)
+    {
+        std::unique_ptr<CBotProgram> program{new CBotProgram()};
+        program->SetBytecode(bytecode != 0);
+
+        std::vector<std::string> externFunctions;
+        ASSERT_TRUE(program->Compile(code, externFunctions, nullptr));
+        ASSERT_TRUE(program->Start("Main"));
+        while (!program->Run(nullptr, 37));
+        ASSERT_EQ(program->GetError(), CBotNoErr);
+
+        ticks[bytecode] = program->GetTicks();
+    }
+    EXPECT_GT(ticks[0], 0);
+    EXPECT_EQ(ticks[0], ticks[1]);
+}
+
+TEST_F(CBotUT, ConstantFolding)
+{
+    ExecuteTest(
+        "extern void ConstantFolding()\n"
+        "{\n"
+        "    ASSERT(2 + 3 * 4 == 14);\n"
+        "    ASSERT(-(2 + 3) == -5);\n"
+        "    ASSERT(7 / 2 == 3);\n"
+        "    ASSERT(7 / 2.0 == 3.5);\n"
+        "    ASSERT(~0 == -1);\n"
+        "    ASSERT(-1 >>> 28 == 15);\n"
+        "    ASSERT(2 ** 10 == 1024);\n"
+        "    ASSERT((1 < 2) == true);\n"
+        "    ASSERT(!(true && false));\n"
+        "    ASSERT(CBotErrZeroDiv + 1 == 6001);\n"
+        "    string s = \"a\" + 1 + 2;\n"
+        "    ASSERT(s == \"a12\");\n"
+        "    float f = 1;\n"
+        "    ASSERT(f * 3 + 0.5 == 3.5);\n"
+        "}\n"
+    );
+    ExecuteTest(
+        "extern void ConstantDivideByZero()\n"
+        "{\n"
+        "    int a = 1 + 4 / 0;\n"
+        "}\n",
+        CBotErrZeroDiv
+    );
+    ExecuteTest(
+        "extern void ConstantNan()\n"
+        "{\n"
+        "    ASSERT(nan == nan);\n"
+        "    float a = 1 + nan;\n"
+        "}\n",
+        CBotErrNan
+    );
+}
+
+TEST_F(CBotUT, Profiler)
+{
+    std::unique_ptr<CBotProgram> program{new CBotProgram()};
+    program->SetBytecode(g_cbotTestBytecode);
+    program->SetProfiler(true);
+    ASSERT_NE(program->GetProfiler(), nullptr);
+
+    std::vector<std::string> externFunctions;
+    ASSERT_TRUE(program->Compile(
+        "int Light()\n"
+        "{\n"
+        "    return 1;\n"
+        "}\n"
+        "int Heavy(int n)\n"
+        "{\n"
+        "    int s = 0;\n"
+        "    for (int i = 0; i < n; i++) s += i;\n"
+        "    return s;\n"
+        "}\n"
+        "extern void Main()\n"
+        "{\n"
+        "    for (int i = 0; i < 10; i++)\n"
+        "    {\n"
+        "        ASSERT(Heavy(200) == 19900);\n"
+        "        ASSERT(Light() == 1);\n"
+        "    }\n"
+        "}\n",
+        externFunctions, nullptr));
+
+    ASSERT_TRUE(program->Start("Main"));
+    while (!program->Run(nullptr, 50));
+    ASSERT_EQ(program->GetError(), CBotNoErr);
+
+    CBotProfiler* profiler = program->GetProfiler();
+    EXPECT_EQ(profiler->GetTicks(), program->GetTicks());
+
+    std::map<std::string, long> ticks;
+    for (const CBotProfileEntry& entry : profiler->GetFunctions()) ticks[entry.name] = entry.ticks;
+    ASSERT_GT(ticks["Heavy"], 0);
+    EXPECT_GT(ticks["Heavy"], ticks["Light"] * 10);
+    EXPECT_EQ(profiler->GetFunctions().front().name, "Heavy");
+
+    for (const CBotProfileEntry& entry : profiler->GetRanges())
+    {
+        EXPECT_EQ(entry.program, program.get());
+        EXPECT_LE(entry.start, entry.end);
+    }
+
+    auto calls = profiler->GetExternalCalls();
+    ASSERT_EQ(calls.size(), 1u);
+    EXPECT_EQ(calls[0].name, "ASSERT");
+    EXPECT_EQ(calls[0].count, 20);
+
+    std::stringstream collapsed;
+    ASSERT_TRUE(profiler->WriteCollapsed(collapsed));
+    std::string text = collapsed.str();
+    EXPECT_NE(text.find("Main;Heavy "), std::string::npos);
+    EXPECT_EQ(text.find("[extern]"), std::string::npos);
+
+    program->SetProfiler(false);
+    EXPECT_EQ(program->GetProfiler(), nullptr);
+}
+
+TEST_F(CBotUT, InstanceHeap)
+{
+    std::unique_ptr<CBotProgram> program{new CBotProgram()};
+    program->SetBytecode(g_cbotTestBytecode);
+    CBotInstanceHeap* heap = program->GetHeap();
+    ASSERT_NE(heap, nullptr);
+
+    std::vector<std::string> externFunctions;
+    ASSERT_TRUE(program->Compile(
+        "public class HeapNode\n"
+        "{\n"
+        "    HeapNode next;\n"
+        "    int value;\n"
+        "}\n"
+        "extern void Cycles()\n"
+        "{\n"
+        "    for (int i = 0; i < 100; i++)\n"
+        "    {\n"
+        "        HeapNode a = new HeapNode();\n"
+        "        HeapNode b = new HeapNode();\n"
+        "        a.next = b;\n"
+        "        b.next = a;\n"
+        "    }\n"
+        "}\n"
+        "extern void Live()\n"
+        "{\n"
+        "    HeapNode a = new HeapNode();\n"
+        "    a.value = 1;\n"
+        "    a.next = new HeapNode();\n"
+        "    a.next.value = 2;\n"
+        "    a.next.next = a;\n"
+        "    for (int i = 0; i < 20; i++) ASSERT(a.next.next.value == 1);\n"
+        "    ASSERT(a.next.value == 2);\n"
+        "}\n"
+        "extern void Limit()\n"
+        "{\n"
+        "    HeapNode[] nodes;\n"
+        "    for (int i = 0; i < 100; i++) nodes[i] = new HeapNode();\n"
+        "}\n",
+        externFunctions, nullptr));
+
+    // the cycles survive the reference counting
+    ASSERT_TRUE(program->Start("Cycles"));
+    while (!program->Run(nullptr, 100));
+    ASSERT_EQ(program->GetError(), CBotNoErr);
+    EXPECT_EQ(heap->GetCount(), 200);
+    EXPECT_EQ(heap->GetCreatedCount(), 200);
+    EXPECT_GT(heap->GetMemoryUsed(), 0u);
+
+    EXPECT_EQ(heap->Collect(), 200);
+    EXPECT_EQ(heap->GetCount(), 0);
+    EXPECT_EQ(heap->GetPeakCount(), 200);
+    EXPECT_EQ(heap->GetMemoryUsed(), 0u);
+
+    // a cycle referenced from the stack of a suspended program is kept
+    ASSERT_TRUE(program->Start("Live"));
+    while (!program->Run(nullptr, 1))
+    {
+        EXPECT_EQ(heap->Collect(), 0);
+    }
+    ASSERT_EQ(program->GetError(), CBotNoErr);
+    EXPECT_EQ(heap->Collect(), 2);
+
+    heap->SetLimit(50);
+    ASSERT_TRUE(program->Start("Limit"));
+    while (!program->Run(nullptr, 100));
+    EXPECT_EQ(program->GetError(), CBotErrOutOfMemory);
+    heap->SetLimit(0);
+    EXPECT_EQ(heap->GetCount(), 0);
+}
+
+namespace
+{
+
+CBotTypResult cContextReport(CBotVar* &var, void* user)
+{
+    if (var == nullptr) return CBotTypResult(CBotErrLowParam);
+    if (var->GetType() != CBotTypInt) return CBotTypResult(CBotErrBadNum);
+    var = var->GetNext();
+    return CBotTypResult(CBotTypVoid);
+}
+
+bool rContextReport(CBotVar* var, CBotVar* result, int& exception, void* user)
+{
+    *static_cast<int*>(user) = var->GetValInt();
+    return true;
+}
+
+} // namespace
+
+TEST_F(CBotUT, Contexts)
+{
+    const int CONTEXTS = 2;
+    std::unique_ptr<CBotContext> contexts[CONTEXTS];
+    std::unique_ptr<CBotProgram> programs[CONTEXTS];
+    int results[CONTEXTS] = {};
+
+    for (int i = 0; i < CONTEXTS; i++)
+    {
+        contexts[i].reset(new CBotContext());
+        contexts[i]->Init();
+
+        CBotContext::Scope scope(contexts[i].get());
+        CBotProgram::DefineNum("CTX_ID", i + 1);
+        CBotProgram::AddFunction("REPORT", rContextReport, cContextReport);
+
+        // the same public names in each context
+        programs[i].reset(new CBotProgram(contexts[i].get(), nullptr));
+        EXPECT_EQ(programs[i]->GetContext(), contexts[i].get());
+        std::vector<std::string> externFunctions;
+        ASSERT_TRUE(programs[i]->Compile(
+            "public class CtxNode\n"
+            "{\n"
+            "    int value = CTX_ID;\n"
+            "    CtxNode next = null;\n"
+            "}\n"
+            "public int CtxValue()\n"
+            "{\n"
+            "    return CTX_ID;\n"
+            "}\n"
+            "extern void Main()\n"
+            "{\n"
+            "    int sum = 0;\n"
+            "    CtxNode last = null;\n"
+            "    for (int i = 0; i < 500; i++)\n"
+            "    {\n"
+            "        CtxNode node = new CtxNode();\n"
+            "        node.next = last;\n"
+            "        last = node;\n"
+            "        sum += node.value + CtxValue();\n"
+            "    }\n"
+            "    REPORT(sum);\n"
+            "}\n",
+            externFunctions, nullptr));
+        ASSERT_TRUE(programs[i]->Start("Main"));
+    }
+
+    // nothing leaks into the default context
+    EXPECT_EQ(CBotClass::Find("CtxNode"), nullptr);
+    std::unique_ptr<CBotProgram> other{new CBotProgram()};
+    std::vector<std::string> externFunctions;
+    EXPECT_FALSE(other->Compile("extern void Main() { REPORT(CtxValue()); }", externFunctions, nullptr));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < CONTEXTS; i++)
+    {
+        threads.emplace_back([&programs, &results, i]()
+        {
+            while (!programs[i]->Run(&results[i], 10));
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    for (int i = 0; i < CONTEXTS; i++)
+    {
+        EXPECT_EQ(programs[i]->GetError(), CBotNoErr);
+        EXPECT_EQ(results[i], 500 * 2 * (i + 1));
+        programs[i].reset();
+        contexts[i].reset();
+    }
+}
+
+TEST_F(CBotUT, CompileBatch)
+{
+    const std::string broken =
+        "extern void Broken()\n"
+        "{\n"
+        "    int a = ;\n"
+        "}\n";
+
+    std::vector<std::unique_ptr<CBotProgram>> programs;
+    std::vector<CBotProgram::BatchItem> items(3);
+    for (CBotProgram::BatchItem& item : items)
+    {
+        programs.emplace_back(new CBotProgram());
+        item.program = programs.back().get();
+    }
+    // the first program calls a public function of the last one
+    items[0].code =
+        "extern void Main()\n"
+        "{\n"
+        "    ASSERT(BatchTwice(21) == 42);\n"
+        "}\n";
+    items[1].code = broken;
+    items[2].code =
+        "public int BatchTwice(int a)\n"
+        "{\n"
+        "    return 2 * a;\n"
+        "}\n";
+
+    CBotProgram::CompileBatch(items, 4);
+
+    EXPECT_TRUE(items[0].ok);
+    EXPECT_EQ(items[0].externFunctions, std::vector<std::string>{"Main"});
+    EXPECT_TRUE(items[2].ok);
+    EXPECT_TRUE(items[2].externFunctions.empty());
+
+    // the errors are the same as with Compile()
+    std::unique_ptr<CBotProgram> single{new CBotProgram()};
+    std::vector<std::string> externFunctions;
+    EXPECT_FALSE(single->Compile(broken, externFunctions, nullptr));
+    CBotError error, batchError;
+    int start, end, batchStart, batchEnd;
+    single->GetError(error, start, end);
+    programs[1]->GetError(batchError, batchStart, batchEnd);
+    EXPECT_FALSE(items[1].ok);
+    EXPECT_NE(batchError, CBotNoErr);
+    EXPECT_EQ(batchError, error);
+    EXPECT_EQ(batchStart, start);
+    EXPECT_EQ(batchEnd, end);
+
+    ASSERT_TRUE(programs[0]->Start("Main"));
+    while (!programs[0]->Run());
+    EXPECT_EQ(programs[0]->GetError(), CBotNoErr);
+}
+
+TEST_F(CBotUT, CompileBatchBodies)
+{
+    const std::vector<std::string> codes = {
+        // class with a method defined outside of it, instances created in the bodies
+        "class BatchPoint\n"
+        "{\n"
+        "    int x = 1;\n"
+        "    int Get();\n"
+        "}\n"
+        "int BatchPoint::Get() { return x; }\n"
+        "extern void Main()\n"
+        "{\n"
+        "    BatchPoint p = new BatchPoint();\n"
+        "    ASSERT(Helper(p) == 3);\n"
+        "    int[] a;\n"
+        "    a[2] = 5;\n"
+        "    ASSERT(sizeof(a) == 3);\n"
+        "}\n"
+        "int Helper(BatchPoint p)\n"
+        "{\n"
+        "    p.x = 2;\n"
+        "    return p.Get() + 1;\n"
+        "}\n",
+        // the error in the body of Second() comes before the one in the declaration of Third()
+        "extern void Main() { Second(); }\n"
+        "void Second() { int b = \"x\"; }\n"
+        "void BatchNope::Third() { }\n",
+        "extern void Main() { }\n"
+        "void BatchNope::Third() { }\n",
+        "extern void Main() { }\n"
+        "int NoReturn() { }\n",
+        "extern void Main() { x = 1; }\n",
+        "extern void Main()\n"
+        "{\n"
+        "    int total = 0;\n"
+        "    for (int i = 0; i < 10; i++) total += Add(i, i);\n"
+        "    ASSERT(total == 90);\n"
+        "}\n"
+        "int Add(int a, int b) { int c = a + b; return c; }\n",
+    };
+
+    struct Result
+    {
+        bool ok;
+        std::vector<std::string> externFunctions;
+        CBotError error;
+        int start, end;
+    };
+
+    std::vector<Result> expected;
+    for (const std::string& code : codes)
+    {
+        std::unique_ptr<CBotProgram> program{new CBotProgram()};
+        Result result;
+        result.ok = program->Compile(code, result.externFunctions, nullptr);
+        program->GetError(result.error, result.start, result.end);
+        expected.push_back(result);
+    }
+
+    for (int threads : {1, 8})
+    {
+        std::vector<std::unique_ptr<CBotProgram>> programs;
+        std::vector<CBotProgram::BatchItem> items(codes.size());
+        for (std::size_t i = 0; i < codes.size(); i++)
+        {
+            programs.emplace_back(new CBotProgram());
+            items[i].program = programs.back().get();
+            items[i].code = codes[i];
+        }
+
+        CBotProgram::CompileBatch(items, threads);
+
+        for (std::size_t i = 0; i < codes.size(); i++)
+        {
+            CBotError error;
+            int start, end;
+            programs[i]->GetError(error, start, end);
+            EXPECT_EQ(items[i].ok, expected[i].ok) << "program " << i << ", " << threads << " threads";
+            EXPECT_EQ(items[i].externFunctions, expected[i].externFunctions) << "program " << i;
+            EXPECT_EQ(error, expected[i].error) << "program " << i;
+            EXPECT_EQ(start, expected[i].start) << "program " << i;
+            EXPECT_EQ(end, expected[i].end) << "program " << i;
+
+            if (!items[i].ok) continue;
+            ASSERT_TRUE(programs[i]->Start("Main"));
+            while (!programs[i]->Run());
+            EXPECT_EQ(programs[i]->GetError(), CBotNoErr) << "program " << i;
+        }
+    }
+}
@@ -97,6 +97,23 @@ TEST(StringUtilTests, RemoveComments)
     EXPECT_EQ(text, R"('qwerty')");
 }
 
+TEST(StringUtilTests, RemoveCommentsView)
+{
+    EXPECT_EQ(StrUtils::RemoveCommentsView("qwerty"), "qwerty");
+    EXPECT_EQ(StrUtils::RemoveCommentsView(R"(qwerty // comment)"), "qwerty ");
+    EXPECT_EQ(StrUtils::RemoveCommentsView(R"(qwerty "test // test")"), R"(qwerty "test // test")");
+    EXPECT_EQ(StrUtils::RemoveCommentsView(R"('qwerty'//comment)"), R"('qwerty')");
+    EXPECT_EQ(StrUtils::RemoveCommentsView("qwerty /"), "qwerty /");
+}
+
+TEST(StringUtilTests, TrimView)
+{
+    EXPECT_EQ(StrUtils::TrimView(""), "");
+    EXPECT_EQ(StrUtils::TrimView("   "), "");
+    EXPECT_EQ(StrUtils::TrimView("qwerty"), "qwerty");
+    EXPECT_EQ(StrUtils::TrimView(" \t qwerty test \n"), "qwerty test");
+}
+
 TEST(StringUtilTests, SplitSingle)
 {
     std::string text = "CreateObject test value  123";
@@ -24,6 +24,7 @@
 #include <clocale>
 
 extern bool g_cbotTestSaveState;
+extern bool g_cbotTestBytecode;
 
 int main(int argc, char* argv[])
 {
@@ -39,6 +40,8 @@ int main(int argc, char* argv[])
         std::string arg(argv[i]);
         if (arg == "--CBotUT_TestSaveState")
             g_cbotTestSaveState = true;
+        if (arg == "--CBotUT_TestBytecode")
+            g_cbotTestBytecode = true;
     }
 
     return RUN_ALL_TESTS();
@@ -50,6 +50,44 @@ TEST(GeometryTest, RotateAngleTest)
     EXPECT_TRUE(Math::IsEqual(Math::RotateAngle(1.0f, -1.0f), 1.75f * Math::PI, TEST_TOLERANCE));
 }
 
+TEST(GeometryTest, IntersectRayTest)
+{
+    glm::vec3 a(0.0f, 0.0f, 5.0f), b(2.0f, 0.0f, 5.0f), c(0.0f, 2.0f, 5.0f);
+    float t = 0.0f;
+
+    EXPECT_TRUE(Math::IntersectRay(a, b, c, glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, 2.0f), t));
+    EXPECT_TRUE(Math::IsEqual(t, 2.5f, TEST_TOLERANCE));
+
+    // other face
+    EXPECT_TRUE(Math::IntersectRay(a, b, c, glm::vec3(0.5f, 0.5f, 10.0f), glm::vec3(0.0f, 0.0f, -1.0f), t));
+    EXPECT_TRUE(Math::IsEqual(t, 5.0f, TEST_TOLERANCE));
+
+    // outside of the triangle, behind the origin, parallel
+    EXPECT_FALSE(Math::IntersectRay(a, b, c, glm::vec3(1.5f, 1.5f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), t));
+    EXPECT_FALSE(Math::IntersectRay(a, b, c, glm::vec3(0.5f, 0.5f, 10.0f), glm::vec3(0.0f, 0.0f, 1.0f), t));
+    EXPECT_FALSE(Math::IntersectRay(a, b, c, glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), t));
+}
+
+TEST(GeometryTest, IntersectRayBoxTest)
+{
+    glm::vec3 min(-1.0f, -1.0f, -1.0f), max(1.0f, 1.0f, 1.0f);
+
+    float tNear = 0.0f, tFar = 100.0f;
+    EXPECT_TRUE(Math::IntersectRayBox(min, max, glm::vec3(-5.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), tNear, tFar));
+    EXPECT_TRUE(Math::IsEqual(tNear, 4.0f, TEST_TOLERANCE));
+    EXPECT_TRUE(Math::IsEqual(tFar, 6.0f, TEST_TOLERANCE));
+
+    // the part of the ray to test ends before the box
+    tNear = 0.0f;
+    tFar = 3.0f;
+    EXPECT_FALSE(Math::IntersectRayBox(min, max, glm::vec3(-5.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), tNear, tFar));
+
+    // parallel to a face, outside of the box
+    tNear = 0.0f;
+    tFar = 100.0f;
+    EXPECT_FALSE(Math::IntersectRayBox(min, max, glm::vec3(-5.0f, 2.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), tNear, tFar));
+}
+
 // Tests for other altered, complex or uncertain functions
 
 /*
@@ -0,0 +1,631 @@
+/*
+ * This file is part of the Colobot: Gold Edition source code
+ * Copyright (C) 2001-2023, Daniel Roux, EPSITEC SA & TerranovaTeam
+ * http://epsitec.ch; http://colobot.info; http://github.com/colobot
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://gnu.org/licenses
+ */
+
+/*
+ * Micro-benchmarks of the CBot interpreter
+ *
+ * Runs a fixed corpus of programs and reports, for each of them, the compile time,
+ * the number of timer ticks executed per second, the number of allocations per tick,
+ * the peak heap memory and the peak size of the CBot stack while running. Use --json to get results for scripts.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CBot/CBot.h"
+
+using namespace CBot;
+
+namespace
+{
+
+//! Counters of the global operator new, see below
+struct AllocationCounters
+{
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+    std::size_t live = 0;
+    std::size_t peak = 0;
+};
+
+AllocationCounters g_allocations;
+
+//! Size of the header storing the size of each allocation, keeps the alignment of operator new
+const std::size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+void* Allocate(std::size_t size)
+{
+    void* block = std::malloc(size + ALLOCATION_HEADER);
+    if (block == nullptr) throw std::bad_alloc();
+
+    *static_cast<std::size_t*>(block) = size;
+    g_allocations.count++;
+    g_allocations.bytes += size;
+    g_allocations.live += size;
+    g_allocations.peak = std::max(g_allocations.peak, g_allocations.live);
+    return static_cast<char*>(block) + ALLOCATION_HEADER;
+}
+
+void Deallocate(void* ptr)
+{
+    if (ptr == nullptr) return;
+
+    void* block = static_cast<char*>(ptr) - ALLOCATION_HEADER;
+    g_allocations.live -= *static_cast<std::size_t*>(block);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return Allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    Deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    Deallocate(ptr);
+}
+
+namespace
+{
+
+struct Benchmark
+{
+    //! Name used in the results and with --filter
+    const char* name;
+    //! Code compiled in a separate program before the benchmark, for public functions, may be nullptr
+    const char* library;
+    //! Code of the benchmark, starts with the extern function "Run"
+    const char* code;
+    //! Save and restore the state of the program each time it is suspended
+    bool saveState;
+};
+
+const Benchmark BENCHMARKS[] =
+{
+    {
+        "scalar_loops",
+        nullptr,
+        "extern void Run()\n"
+        "{\n"
+        "    int sum = 0;\n"
+        "    float f = 0;\n"
+        "    for (int i = 0; i < 20000; i++)\n"
+        "    {\n"
+        "        sum = (sum + i * 7) % 100003;\n"
+        "        if ((i & 3) == 0) f = f * 0.5 + i;\n"
+        "        else f -= 1.5;\n"
+        "    }\n"
+        "}\n",
+        false
+    },
+    {
+        "array_loops",
+        nullptr,
+        "extern void Run()\n"
+        "{\n"
+        "    int a[];\n"
+        "    for (int i = 0; i < 1000; i++) a[i] = i;\n"
+        "    float b[];\n"
+        "    for (int i = 0; i < 1000; i++) b[i] = a[999 - i] * 0.5;\n"
+        "    int sum = 0;\n"
+        "    for (int pass = 0; pass < 10; pass++)\n"
+        "    {\n"
+        "        for (int i = 0; i < sizeof(a); i++) sum += a[i] * pass;\n"
+        "        for (int i = 1; i < sizeof(b); i++) b[i] = b[i - 1] + b[i];\n"
+        "    }\n"
+        "}\n",
+        false
+    },
+    {
+        "string_building",
+        nullptr,
+        "extern void Run()\n"
+        "{\n"
+        "    string s = \"\";\n"
+        "    for (int i = 0; i < 3000; i++)\n"
+        "    {\n"
+        "        s += \"x\" + i;\n"
+        "        if (strlen(s) > 200) s = strright(s, 100);\n"
+        "    }\n"
+        "    string parts[];\n"
+        "    for (int i = 0; i < 500; i++) parts[i] = \"item\" + i;\n"
+        "    string joined = \"\";\n"
+        "    for (int i = 0; i < sizeof(parts); i++) joined += parts[i] + \",\";\n"
+        "    int found = 0;\n"
+        "    for (int i = 0; i < 200; i++) found += strfind(joined, \"item\" + i);\n"
+        "}\n",
+        false
+    },
+    {
+        "number_formatting",
+        nullptr,
+        "extern void Run()\n"
+        "{\n"
+        "    string s;\n"
+        "    int length = 0;\n"
+        "    for (int i = 0; i < 2000; i++)\n"
+        "    {\n"
+        "        float f = i / 7.0;\n"
+        "        s = \"i=\" + i + \" f=\" + f + \" b=\" + (i % 2 == 0);\n"
+        "        length += strlen(s);\n"
+        "    }\n"
+        "}\n",
+        false
+    },
+    {
+        "classes",
+        nullptr,
+        "public class BenchShape\n"
+        "{\n"
+        "    float x = 0, y = 0;\n"
+        "    float Area() { return 0; }\n"
+        "    void Move(float dx, float dy) { x += dx; y += dy; }\n"
+        "}\n"
+        "public class BenchRect extends BenchShape\n"
+        "{\n"
+        "    float w, h;\n"
+        "    void BenchRect(float rw, float rh) { w = rw; h = rh; }\n"
+        "    float Area() { return w * h; }\n"
+        "}\n"
+        "public class BenchCircle extends BenchShape\n"
+        "{\n"
+        "    float r;\n"
+        "    void BenchCircle(float cr) { r = cr; }\n"
+        "    float Area() { return 3.14159 * r * r; }\n"
+        "}\n"
+        "extern void Run()\n"
+        "{\n"
+        "    BenchShape shapes[];\n"
+        "    for (int i = 0; i < 200; i++)\n"
+        "    {\n"
+        "        if (i % 2 == 0) shapes[i] = new BenchRect(i, 2);\n"
+        "        else shapes[i] = new BenchCircle(i);\n"
+        "    }\n"
+        "    float total = 0;\n"
+        "    for (int pass = 0; pass < 10; pass++)\n"
+        "    {\n"
+        "        for (int i = 0; i < sizeof(shapes); i++)\n"
+        "        {\n"
+        "            shapes[i].Move(1, -1);\n"
+        "            total += shapes[i].Area() + shapes[i].x;\n"
+        "        }\n"
+        "    }\n"
+        "}\n",
+        false
+    },
+    {
+        "instances",
+        nullptr,
+        "public class BenchNode\n"
+        "{\n"
+        "    int value = 0;\n"
+        "    BenchNode next = null, prev = null, left = null, right = null;\n"
+        "}\n"
+        "BenchNode Tree(int depth)\n"
+        "{\n"
+        "    BenchNode n = new BenchNode();\n"
+        "    n.value = depth;\n"
+        "    if (depth > 0)\n"
+        "    {\n"
+        "        n.left = Tree(depth - 1);\n"
+        "        n.right = Tree(depth - 1);\n"
+        "    }\n"
+        "    return n;\n"
+        "}\n"
+        "extern void Run()\n"
+        "{\n"
+        "    int sum = 0;\n"
+        "    for (int pass = 0; pass < 10; pass++)\n"
+        "    {\n"
+        "        BenchNode head = new BenchNode();\n"
+        "        BenchNode tail = head;\n"
+        "        for (int i = 0; i < 100; i++)\n"
+        "        {\n"
+        "            BenchNode n = new BenchNode();\n"
+        "            n.value = i;\n"
+        "            n.prev = tail;\n"
+        "            tail.next = n;\n"
+        "            tail = n;\n"
+        "        }\n"
+        "        BenchNode p = head;\n"
+        "        while (p != null)\n"
+        "        {\n"
+        "            sum += p.value;\n"
+        "            p = p.next;\n"
+        "        }\n"
+        "        BenchNode root = Tree(6);\n"
+        "        sum += root.left.right.value;\n"
+        "    }\n"
+        "}\n",
+        false
+    },
+    {
+        "recursion",
+        nullptr,
+        "int Fib(int n)\n"
+        "{\n"
+        "    if (n < 2) return n;\n"
+        "    return Fib(n - 1) + Fib(n - 2);\n"
+        "}\n"
+        "extern void Run()\n"
+        "{\n"
+        "    int r = 0;\n"
+        "    for (int i = 0; i < 4; i++) r += Fib(16);\n"
+        "}\n",
+        false
+    },
+    {
+        "public_dispatch",
+        "public int BenchScale(int v, int k)\n"
+        "{\n"
+        "    return v * k + 1;\n"
+        "}\n"
+        "public float BenchMix(float a, float b)\n"
+        "{\n"
+        "    return (a + b) / 2;\n"
+        "}\n",
+        "extern void Run()\n"
+        "{\n"
+        "    int s = 0;\n"
+        "    float f = 0;\n"
+        "    for (int i = 0; i < 3000; i++)\n"
+        "    {\n"
+        "        s = BenchScale(s, 3) % 1000;\n"
+        "        f = BenchMix(f, i);\n"
+        "    }\n"
+        "}\n",
+        false
+    },
+    {
+        "save_restore",
+        nullptr,
+        "int Depth(int n, string tag)\n"
+        "{\n"
+        "    int local[];\n"
+        "    local[0] = n;\n"
+        "    if (n == 0)\n"
+        "    {\n"
+        "        int s = 0;\n"
+        "        for (int i = 0; i < 20; i++) s += i;\n"
+        "        return s;\n"
+        "    }\n"
+        "    return Depth(n - 1, tag + n) + local[0];\n"
+        "}\n"
+        "extern void Run()\n"
+        "{\n"
+        "    int total = 0;\n"
+        "    for (int i = 0; i < 20; i++) total += Depth(20, \"d\");\n"
+        "}\n",
+        true
+    },
+};
+
+struct Options
+{
+    int iterations = 5;
+    int timer = 1000;
+    bool bytecode = false;
+    bool json = false;
+    std::string filter;
+    //! File receiving the collapsed stacks of the profiler, see CBotProfiler::WriteCollapsed()
+    std::string profile;
+};
+
+struct Result
+{
+    std::string name;
+    CBotError error = CBotNoErr;
+    double compileSeconds = std::numeric_limits<double>::infinity();
+    double runSeconds = std::numeric_limits<double>::infinity();
+    long ticks = 0;
+    int runs = 0;
+    std::size_t allocations = 0;
+    std::size_t allocatedBytes = 0;
+    std::size_t peakHeap = 0;
+    std::size_t peakStack = 0;
+    std::string profile;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double Seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::unique_ptr<CBotProgram> Compile(const char* code, bool bytecode, CBotError& error)
+{
+    std::unique_ptr<CBotProgram> program{new CBotProgram(nullptr)};
+    program->SetBytecode(bytecode);
+
+    std::vector<std::string> externFunctions;
+    program->Compile(code, externFunctions, nullptr);
+
+    int start, end;
+    program->GetError(error, start, end);
+    return program;
+}
+
+bool SaveAndRestore(CBotProgram* program)
+{
+    std::stringstream data;
+    return program->SaveState(data) && CBotClass::SaveStaticState(data) &&
+           program->RestoreState(data) && CBotClass::RestoreStaticState(data);
+}
+
+Result RunBenchmark(const Benchmark& benchmark, const Options& options)
+{
+    Result result;
+    result.name = benchmark.name;
+
+    std::unique_ptr<CBotProgram> library;
+    if (benchmark.library != nullptr)
+    {
+        library = Compile(benchmark.library, options.bytecode, result.error);
+        if (result.error != CBotNoErr) return result;
+    }
+
+    for (int i = 0; i < options.iterations; i++)
+    {
+        auto start = Clock::now();
+        std::unique_ptr<CBotProgram> program = Compile(benchmark.code, options.bytecode, result.error);
+        result.compileSeconds = std::min(result.compileSeconds, Seconds(start));
+        if (result.error != CBotNoErr) return result;
+
+        program->SetProfiler(!options.profile.empty());
+        if (!program->Start("Run"))
+        {
+            int cursor1, cursor2;
+            program->GetError(result.error, cursor1, cursor2);
+            return result;
+        }
+
+        g_allocations.count = 0;
+        g_allocations.bytes = 0;
+        g_allocations.peak = g_allocations.live;
+        std::size_t baseMemory = g_allocations.live;
+
+        int runs = 1;
+        long ticks = 0;
+        std::size_t peakStack = 0;
+        start = Clock::now();
+        while (!program->Run(nullptr, options.timer))
+        {
+            runs++;
+            if (benchmark.saveState)
+            {
+                ticks += program->GetTicks(); // restarted by RestoreState()
+                peakStack = std::max(peakStack, program->GetPeakStackSize());
+                if (!SaveAndRestore(program.get()))
+                {
+                    result.error = CBotErrRead;
+                    return result;
+                }
+            }
+        }
+        result.runSeconds = std::min(result.runSeconds, Seconds(start));
+
+        int cursor1, cursor2;
+        program->GetError(result.error, cursor1, cursor2);
+        if (result.error != CBotNoErr) return result;
+
+        result.ticks = ticks + program->GetTicks();
+        result.runs = runs;
+        result.allocations = g_allocations.count;
+        result.allocatedBytes = g_allocations.bytes;
+        result.peakHeap = g_allocations.peak - baseMemory;
+        result.peakStack = std::max(peakStack, program->GetPeakStackSize());
+
+        if (program->GetProfiler() != nullptr)
+        {
+            std::stringstream collapsed;
+            program->GetProfiler()->WriteCollapsed(collapsed);
+            result.profile.clear();
+            std::string line;
+            while (std::getline(collapsed, line)) result.profile += result.name + ";" + line + "\n";
+        }
+    }
+    return result;
+}
+
+double PerTick(double value, const Result& result)
+{
+    return result.ticks > 0 ? value / result.ticks : 0.0;
+}
+
+double TicksPerSecond(const Result& result)
+{
+    return result.runSeconds > 0 ? result.ticks / result.runSeconds : 0.0;
+}
+
+void PrintText(const std::vector<Result>& results, const Options& options)
+{
+    std::cout << "CBot benchmarks (best of " << options.iterations << ", timer " << options.timer
+              << (options.bytecode ? ", bytecode" : "") << ")" << std::endl;
+    std::cout << std::left << std::setw(18) << "benchmark" << std::right
+              << std::setw(12) << "compile ms"
+              << std::setw(12) << "ticks"
+              << std::setw(12) << "run ms"
+              << std::setw(14) << "Mticks/s"
+              << std::setw(14) << "allocs/tick"
+              << std::setw(14) << "heap KiB"
+              << std::setw(14) << "stack KiB" << std::endl;
+
+    for (const Result& result : results)
+    {
+        std::cout << std::left << std::setw(18) << result.name << std::right;
+        if (result.error != CBotNoErr)
+        {
+            std::cout << "  error " << result.error << std::endl;
+            continue;
+        }
+        std::cout << std::fixed
+                  << std::setw(12) << std::setprecision(3) << result.compileSeconds * 1000.0
+                  << std::setw(12) << result.ticks
+                  << std::setw(12) << std::setprecision(3) << result.runSeconds * 1000.0
+                  << std::setw(14) << std::setprecision(3) << TicksPerSecond(result) / 1000000.0
+                  << std::setw(14) << std::setprecision(3) << PerTick(result.allocations, result)
+                  << std::setw(14) << std::setprecision(1) << result.peakHeap / 1024.0
+                  << std::setw(14) << std::setprecision(1) << result.peakStack / 1024.0 << std::endl;
+    }
+}
+
+void PrintJson(const std::vector<Result>& results, const Options& options)
+{
+    std::cout << std::setprecision(9);
+    std::cout << "{\n";
+    std::cout << "  \"iterations\": " << options.iterations << ",\n";
+    std::cout << "  \"timer\": " << options.timer << ",\n";
+    std::cout << "  \"bytecode\": " << (options.bytecode ? "true" : "false") << ",\n";
+    std::cout << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const Result& result = results[i];
+        std::cout << "    {\"name\": \"" << result.name << "\""
+                  << ", \"error\": " << result.error;
+        if (result.error == CBotNoErr)
+        {
+            std::cout << ", \"compile_seconds\": " << result.compileSeconds
+                      << ", \"run_seconds\": " << result.runSeconds
+                      << ", \"ticks\": " << result.ticks
+                      << ", \"runs\": " << result.runs
+                      << ", \"ticks_per_second\": " << TicksPerSecond(result)
+                      << ", \"allocations\": " << result.allocations
+                      << ", \"allocations_per_tick\": " << PerTick(result.allocations, result)
+                      << ", \"allocated_bytes_per_tick\": " << PerTick(result.allocatedBytes, result)
+                      << ", \"peak_heap_bytes\": " << result.peakHeap
+                      << ", \"peak_stack_bytes\": " << result.peakStack;
+        }
+        std::cout << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n";
+    std::cout << "}" << std::endl;
+}
+
+void PrintUsage(const char* name)
+{
+    std::cerr << "Usage: " << name << " [options]\n"
+              << "  --json              print the results as JSON\n"
+              << "  --iterations=N      run each benchmark N times and keep the best times (default 5)\n"
+              << "  --timer=N           timer ticks executed by each call to CBotProgram::Run() (default 1000)\n"
+              << "  --bytecode          translate the functions to bytecode, see CBotProgram::SetBytecode()\n"
+              << "  --filter=TEXT       run only the benchmarks whose name contains TEXT\n"
+              << "  --profile=FILE      sample the programs and write their stacks to FILE for flame graph tools\n"
+              << "  --list              list the benchmarks\n";
+}
+
+bool ParseInt(const char* text, int& value)
+{
+    char* end = nullptr;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || parsed < 0 || parsed > std::numeric_limits<int>::max()) return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg == "--json") options.json = true;
+        else if (arg == "--bytecode") options.bytecode = true;
+        else if (arg.compare(0, 13, "--iterations=") == 0) ok = ParseInt(argv[i] + 13, options.iterations) && options.iterations > 0;
+        else if (arg.compare(0, 8, "--timer=") == 0) ok = ParseInt(argv[i] + 8, options.timer);
+        else if (arg.compare(0, 9, "--filter=") == 0) options.filter = arg.substr(9);
+        else if (arg.compare(0, 10, "--profile=") == 0) ok = !(options.profile = arg.substr(10)).empty();
+        else if (arg == "--list")
+        {
+            for (const Benchmark& benchmark : BENCHMARKS) std::cout << benchmark.name << std::endl;
+            return 0;
+        }
+        else ok = false;
+
+        if (!ok)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    CBotProgram::Init();
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : BENCHMARKS)
+    {
+        if (std::string(benchmark.name).find(options.filter) == std::string::npos) continue;
+        results.push_back(RunBenchmark(benchmark, options));
+    }
+
+    CBotProgram::Free();
+
+    if (options.json) PrintJson(results, options);
+    else PrintText(results, options);
+
+    if (!options.profile.empty())
+    {
+        std::ofstream profile(options.profile);
+        for (const Result& result : results) profile << result.profile;
+        if (!profile)
+        {
+            std::cerr << "Failed to write " << options.profile << std::endl;
+            return 1;
+        }
+    }
+
+    bool failed = std::any_of(results.begin(), results.end(), [](const Result& result) { return result.error != CBotNoErr; });
+    return failed ? 2 : 0;
+}